@@ -34,9 +34,21 @@
 
 #include <Arduino.h>
 
-extern const uint8_t default_icon[];
-extern const uint8_t wifi_connect_qr[];
-extern const uint8_t wifi_failed_qr[];
+/**
+ * An image built into the firmware: rows of (width + 7) / 8 bytes from the
+ * top, LZSS-compressed (see lzss.h). Generated by scripts/compress_assets.py.
+ */
+typedef struct
+{
+  const uint8_t *data;
+  uint32_t size;
+  uint16_t width;
+  uint16_t height;
+} CompressedImage;
+
+extern const CompressedImage default_icon;
+extern const CompressedImage wifi_connect_qr;
+extern const CompressedImage wifi_failed_qr;
 
 #endif
 /* FILE END */
@@ -19,9 +19,11 @@
 #define PREFERENCES_DEVICE_REGISTERED_KEY "plugin"
 #define PREFERENCES_SF_KEY "sf"
 #define PREFERENCES_FILENAME_KEY "filename"
+#define PREFERENCES_LAST_FILENAME_KEY "last_filename"
 #define PREFERENCES_LAST_SLEEP_TIME "last_sleep"
 #define PREFERENCES_CONNECT_API_RETRY_COUNT "retry_count"
 #define PREFERENCES_CONNECT_WIFI_RETRY_COUNT "wifi_retry"
+#define PREFERENCES_OTA_PROGRESS_KEY "ota_progress"
 
 #define WIFI_CONNECTION_RSSI (-100)
 
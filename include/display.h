@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include "fonts.h"
 #include "DEV_Config.h"
+#include <prop_font.h>
 
 enum MSG
 {
@@ -25,11 +26,21 @@ enum MSG
 
 /**
  * @brief Function to init the display
+ * Only sets up the pins and SPI; the panel is reset and powered on by the first draw.
  * @param none
  * @return none
  */
 void display_init(void);
 
+/**
+ * @brief Function to start initializing the panel in the background
+ * Call it once a draw is known to follow, so the panel reset and power-on overlap
+ * network I/O. Draws wait for the init to finish.
+ * @param none
+ * @return none
+ */
+void display_prepare(void);
+
 /**
  * @brief Function to reset the display
  * @param none
@@ -49,13 +60,26 @@ uint16_t display_height();
  */
 uint16_t display_width();
 
+/**
+ * @brief Function to draw UTF-8 text in a proportional font
+ * @param x_start X coordinate of the pen
+ * @param y_start Y coordinate of the top of the text
+ * @param text UTF-8 text
+ * @param length number of bytes to draw
+ * @param font Font to use
+ * @param color_fg Foreground color
+ * @param color_bg Background color, FONT_BACKGROUND to leave it
+ * @return none
+ */
+void Paint_DrawPropText(UWORD x_start, UWORD y_start, const char *text, size_t length,
+                        const PropFont &font, UWORD color_fg, UWORD color_bg);
+
 /**
  * @brief Function to draw multi-line text onto the display
  * @param x_start X coordinate to start drawing
  * @param y_start Y coordinate to start drawing
- * @param message Text message to draw
+ * @param message UTF-8 text message to draw
  * @param max_width Maximum width in pixels for each line
- * @param font_width Width of a single character in pixels
  * @param color_fg Foreground color
  * @param color_bg Background color
  * @param font Font to use
@@ -63,21 +87,63 @@ uint16_t display_width();
  * @return none
  */
 void Paint_DrawMultilineText(UWORD x_start, UWORD y_start, const char *message,
-                             uint16_t max_width, uint16_t font_width,
-                             UWORD color_fg, UWORD color_bg, sFONT *font,
-                             bool is_center_aligned);
+                             uint16_t max_width, UWORD color_fg, UWORD color_bg,
+                             const PropFont &font, bool is_center_aligned);
 
 /**
  * @brief Function to show the image on the display
- * @param image_buffer pointer to the uint8_t image buffer
+ * @param image_buffer pointer to the uint8_t image buffer, nullptr for the built-in logo
  * @param reverse shows if the color scheme is reverse
  * @return none
  */
 void display_show_image(uint8_t *image_buffer, bool reverse, bool isPNG);
 
+/**
+ * Called by display_show_image() with the panel-ready framebuffer, after it is
+ * sent to the panel and while the panel refreshes.
+ */
+typedef void (*DisplayFramebufferObserver)(const uint8_t *framebuffer, size_t size);
+
+/**
+ * @brief Function to set the function that receives every framebuffer shown by display_show_image()
+ * @param observer function to call, or nullptr
+ * @return none
+ */
+void display_set_framebuffer_observer(DisplayFramebufferObserver observer);
+
+/**
+ * @brief Function to start sending a framebuffer to the display piece by piece
+ * @param none
+ * @return none
+ */
+void display_stream_begin(void);
+
+/**
+ * @brief Function to send the next piece of a framebuffer
+ * @param data framebuffer bytes, as passed to the framebuffer observer
+ * @param size number of bytes
+ * @return none
+ */
+void display_stream_write(const uint8_t *data, size_t size);
+
+/**
+ * @brief Function to refresh the display with the framebuffer sent since display_stream_begin()
+ * @param none
+ * @return none
+ */
+void display_stream_end(void);
+
+/**
+ * @brief Function to drop the framebuffer sent since display_stream_begin() without refreshing
+ * The panel is powered off, so the next draw initializes it again.
+ * @param none
+ * @return none
+ */
+void display_stream_abort(void);
+
 /**
  * @brief Function to show the image with message on the display
- * @param image_buffer pointer to the uint8_t image buffer
+ * @param image_buffer pointer to the uint8_t image buffer, nullptr for the built-in logo
  * @param message_type type of message that will show on the screen
  * @return none
  */
@@ -85,7 +151,7 @@ void display_show_msg(uint8_t *image_buffer, MSG message_type);
 
 /**
  * @brief Function to show the image with message on the display
- * @param image_buffer pointer to the uint8_t image buffer
+ * @param image_buffer pointer to the uint8_t image buffer, nullptr for the built-in logo
  * @param message_type type of message that will show on the screen
  * @param friendly_id device friendly ID
  * @param id shows if ID exists
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include <FS.h>
 
 /**
  * @brief Function to init the filesystem
@@ -24,6 +25,21 @@ void filesystem_deinit(void);
  */
 bool filesystem_read_from_file(const char *name, uint8_t *out_buffer, size_t size);
 
+/**
+ * Receives the pieces of a file read by filesystem_read_chunks().
+ */
+typedef void (*FilesystemChunkReader)(const uint8_t *data, size_t size);
+
+/**
+ * @brief Function to read a file piece by piece without buffering all of it
+ * @param name filename
+ * @param chunk buffer for one piece
+ * @param chunk_size size of the buffer
+ * @param reader function called with each piece
+ * @return size_t number of bytes read
+ */
+size_t filesystem_read_chunks(const char *name, uint8_t *chunk, size_t chunk_size, FilesystemChunkReader reader);
+
 /**
  * @brief Function to write data to file
  * @param name filename
@@ -33,6 +49,16 @@ bool filesystem_read_from_file(const char *name, uint8_t *out_buffer, size_t siz
  */
 size_t filesystem_write_to_file(const char *name, uint8_t *in_buffer, size_t size);
 
+/**
+ * @brief Function to write a file so that it holds either its old or its new content, even on power loss
+ * The data goes to a temporary file first, which is synced and then renamed over name.
+ * @param name filename
+ * @param in_buffer pointer to input buffer
+ * @param size size of the input buffer
+ * @return size of written bytes, 0 if the file was left unchanged
+ */
+size_t filesystem_write_atomic(const char *name, uint8_t *in_buffer, size_t size);
+
 /**
  * @brief Function to check if file exists
  * @param name filename
@@ -55,4 +81,26 @@ bool filesystem_file_delete(const char *name);
  */
 bool filesystem_file_rename(const char *old_name, const char *new_name);
 
+/**
+ * @brief Function to rename a file over another one
+ * @param old_name old filename
+ * @param new_name new filename, replaced if it exists
+ * @return result - true if success; false - if failed
+ */
+bool filesystem_file_replace(const char *old_name, const char *new_name);
+
+/**
+ * @brief Function to read the free space of the filesystem
+ * @param none
+ * @return size_t free bytes
+ */
+size_t filesystem_free_space(void);
+
+/**
+ * @brief Function to get the mounted filesystem, for code that streams files itself
+ * @param none
+ * @return fs::FS& filesystem
+ */
+fs::FS &filesystem_fs(void);
+
 void list_files();
\ No newline at end of file
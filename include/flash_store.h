@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Images kept in a raw "frames" data partition at fixed offsets. They are
+ * mapped into the address space, so the display reads them straight from
+ * flash without a heap buffer.
+ *
+ * Only a device flashed over serial with a partition table that has "frames"
+ * uses it: frames_partition.csv, built by the trmnl_framebuffers environment.
+ * The shipping environments use min_spiffs.csv, which has none, and OTA
+ * cannot change a device's partition table, so devices in the field keep
+ * using files.
+ *
+ * Each slot starts with a FlashStoreHeader, written after the data, so a slot
+ * whose write was interrupted is simply empty.
+ */
+
+#define FLASH_STORE_PARTITION "frames"
+#define FLASH_STORE_SLOT_SIZE 0xC000 // a full BMP or framebuffer plus the header, in whole sectors
+#define FLASH_STORE_LOGO 0           // the slots after the logo hold cached framebuffers
+
+struct FlashStoreHeader
+{
+  uint32_t magic;
+  uint32_t size;
+  uint32_t hash; // wake_state_crc32() of the data
+};
+
+/**
+ * @brief Function to find the partition; works before the filesystem is mounted
+ * @param none
+ * @return bool true if the partition table has a "frames" partition
+ */
+bool flash_store_init(void);
+
+/**
+ * @brief Function to get the number of slots, the logo slot included
+ * @param none
+ * @return size_t slot count, 0 without the partition
+ */
+size_t flash_store_slot_count(void);
+
+/**
+ * @brief Function to read the header of a slot
+ * @param slot slot index
+ * @param header set to the header of the slot
+ * @return bool true if the slot holds data
+ */
+bool flash_store_header(size_t slot, FlashStoreHeader &header);
+
+/**
+ * @brief Function to map a slot, checking its CRC the first time
+ * @param slot slot index
+ * @param size set to the data size
+ * @return const uint8_t* data in flash, valid until the slot is written, or nullptr if the slot is empty or corrupt
+ */
+const uint8_t *flash_store_map(size_t slot, size_t &size);
+
+/**
+ * @brief Function to erase a slot and write new data to it
+ * @param slot slot index
+ * @param data data to store
+ * @param size data size, at most FLASH_STORE_SLOT_SIZE - sizeof(FlashStoreHeader)
+ * @return bool true on success; false if there is no such slot or the write failed
+ */
+bool flash_store_write(size_t slot, const uint8_t *data, size_t size);
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <Arduino.h>
+#include <image_cache.h>
+
+/**
+ * Images received from the API, cached on the filesystem by the filename the
+ * server gives them (see image_cache.h), so a playlist that comes back to an
+ * image is redrawn without downloading it again. The index is read by
+ * image_store_init() and written back by image_store_commit() before sleep.
+ * Each image is stored once: the image on screen and the one before it are
+ * found in the cache by their filenames (see image_store_find()), and only
+ * an image the cache cannot take is kept as /current.*, then /last.*.
+ */
+
+/**
+ * @brief Function to read the cache index; the filesystem must be mounted
+ * @param none
+ * @return none
+ */
+void image_store_init(void);
+
+/**
+ * @brief Function to store a new image as the current one, keeping the previous one as the last
+ * The image goes to the cache, evicting the least recently used images, the
+ * last one included, if there is no room. If the cache cannot take it, it is
+ * written as /current.png or /current.bmp under a pending name first, and
+ * image_store_init() finishes a move cut short by a reset.
+ * Either way the new file is complete before the old ones are touched.
+ * @param name filename from the API response
+ * @param data image file contents
+ * @param size image size in bytes
+ * @param isPNG image format
+ * @return bool true on success; on failure the current and last images are unchanged
+ */
+bool image_store_set_current(const char *name, uint8_t *data, size_t size, bool isPNG);
+
+/**
+ * @brief Function to make a cached image the current one without writing it again
+ * Only the bookkeeping changes: /current.*, if any, becomes /last.*.
+ * @param name filename from the API response
+ * @return bool true if the image is cached; false and nothing changed otherwise
+ */
+bool image_store_set_current_cached(const char *name);
+
+/**
+ * @brief Function to find the file holding the current image or the one before it
+ * @param last true for the image before the current one
+ * @param name filename from the API response of that image
+ * @param path set to the file path; at least IMAGE_CACHE_PATH_SIZE bytes
+ * @param isPNG set to the image format
+ * @return bool true if the image is stored as a BMP or PNG file
+ */
+bool image_store_find(bool last, const char *name, char *path, bool &isPNG);
+
+/**
+ * @brief Function to read a cached image into a new buffer
+ * @param name filename from the API response
+ * @param size set to the image size on a hit
+ * @param isPNG set to the image format on a hit
+ * @return uint8_t* buffer to free with heap_trace_free(), or nullptr if the image is not cached as a BMP or PNG
+ */
+uint8_t *image_store_load(const char *name, size_t &size, bool &isPNG);
+
+/**
+ * @brief Function to replace the cached copy of an image by its panel-ready framebuffer
+ * Does nothing unless the firmware is built with IMAGE_CACHE_FRAMEBUFFERS: a
+ * framebuffer takes several times the flash of a PNG, but redraws without decoding.
+ * It goes to a free slot of the "frames" partition if there is one (see flash_store.h).
+ * @param name filename from the API response
+ * @param framebuffer framebuffer as passed to the display framebuffer observer
+ * @param size framebuffer size in bytes
+ * @return none
+ */
+void image_store_save_framebuffer(const char *name, const uint8_t *framebuffer, size_t size);
+
+/**
+ * @brief Function to stream a cached framebuffer from flash to the display
+ * @param name filename from the API response
+ * @return bool true if the image was shown; false if only its source, or nothing, is cached
+ */
+bool image_store_show_framebuffer(const char *name);
+
+/**
+ * @brief Function to drop an image from the cache, e.g. when it failed to decode
+ * @param name filename from the API response
+ * @return none
+ */
+void image_store_forget(const char *name);
+
+/**
+ * @brief Function to write the cache index if it changed
+ * @param none
+ * @return none
+ */
+void image_store_commit(void);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Preferences.h>
+
+/**
+ * Firmware update written straight into the next app partition as it is
+ * downloaded. Progress is saved every OTA_CHECKPOINT_SIZE bytes (see
+ * ota_progress.h), so a download cut short by a stall or a lost connection
+ * continues from the last checkpoint with a Range request, in the same wake
+ * or a later one. The image only becomes the boot partition once it is
+ * complete and matches the SHA-256 the server sent.
+ *
+ * When the server also offers a patch against the running image (see
+ * ota_delta.h), the patch is downloaded instead and applied as it comes.
+ * A patch that does not apply, e.g. because the device runs another
+ * version, is given up for the whole image.
+ */
+
+#define OTA_CONNECT_ATTEMPTS 3 // connections per wake before leaving the rest for the next wake
+#define OTA_BUFFER_SIZE 1024
+
+enum OtaResult
+{
+  OTA_DONE,   // the new firmware boots on the next restart
+  OTA_RETRY,  // interrupted, the download continues on the next call
+  OTA_FAILED, // the image is unusable; progress is cleared
+};
+
+/**
+ * @brief Function to download, check and activate a firmware image
+ * @param url firmware URL
+ * @param patch_url URL of a patch from the running firmware, empty if there is none
+ * @param sha256_hex expected SHA-256 of the image in hex; if empty only the image itself is checked
+ * @param preferences opened Preferences instance that keeps the progress
+ * @param starting called before connecting when the download starts from the first byte, e.g. to tell the user
+ * @return OtaResult outcome
+ */
+OtaResult ota_update(const char *url, const char *patch_url, const char *sha256_hex, Preferences &preferences,
+                     void (*starting)(void));
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * E-paper panels the firmware can drive. display.cpp only talks to the
+ * selected Panel; each panel wraps its Waveshare driver, which sends through
+ * the shared SPI transport in DEV_Config. The panel is picked by name from
+ * the registry in panel.cpp, DISPLAY_PANEL at build time by default.
+ */
+
+#ifndef DISPLAY_PANEL
+#define DISPLAY_PANEL "7in5_v2"
+#endif
+
+enum PanelMode : uint8_t
+{
+  PANEL_MODE_FULL = 1 << 0,    // full refresh, no ghosting
+  PANEL_MODE_FAST = 1 << 1,    // shorter waveform, may leave ghosting
+  PANEL_MODE_PARTIAL = 1 << 2, // refresh of a window only
+  PANEL_MODE_GRAY4 = 1 << 3,   // 2 bits per pixel
+};
+
+struct Panel
+{
+  const char *name;
+  uint16_t width;
+  uint16_t height;
+  uint8_t modes; // PanelMode flags the panel supports
+
+  /** Resets the controller and loads the waveform of mode, one of modes */
+  void (*init)(PanelMode mode);
+  /** Starts sending a 1bpp framebuffer, rows of width / 8 bytes with 1 for white */
+  void (*write_begin)(void);
+  /** Sends the next bytes of the framebuffer in one SPI transfer */
+  void (*write)(const uint8_t *data, uint32_t size);
+  /** Refreshes the panel with the framebuffer sent */
+  void (*write_end)(void);
+  /** Makes the whole panel white */
+  void (*clear)(void);
+  /** Refreshes the panel with the framebuffer it already has */
+  void (*refresh)(void);
+  /** Powers the panel off until the next init */
+  void (*sleep)(void);
+};
+
+/**
+ * @brief Function to find a panel in the registry
+ * @param name panel name, e.g. "7in5_v2"
+ * @return const Panel* the panel, nullptr if there is no panel with that name
+ */
+const Panel *panel_find(const char *name);
+
+/**
+ * @brief Function to get the panel the firmware was built for
+ * @param none
+ * @return const Panel& the DISPLAY_PANEL panel, else the first panel of the registry
+ */
+const Panel &panel_default(void);
+
+/**
+ * @brief Function to send a whole framebuffer and refresh the panel
+ * @param panel panel
+ * @param framebuffer width / 8 * height bytes
+ * @return none
+ */
+void panel_show(const Panel &panel, const uint8_t *framebuffer);
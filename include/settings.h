@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Preferences.h>
+#include <settings_cache.h>
+
+/**
+ * Settings in the "data" NVS namespace, cached in RAM for the whole wake.
+ * Loaded by settings_init() once Preferences is open and written back by
+ * settings_commit() before deep sleep or a restart. Retry counters, the last
+ * sleep time, the current and previous filenames and the special function are
+ * written to an RTC memory block instead of NVS (see wake_state.h).
+ */
+extern SettingsCache settings;
+
+/**
+ * @brief Function to load every cached setting from NVS
+ * @param preferences opened Preferences instance
+ * @return none
+ */
+void settings_init(Preferences &preferences);
+
+/**
+ * @brief Function to forget the RTC copy of the settings and reload them, e.g. after Preferences::clear()
+ * @param none
+ * @return none
+ */
+void settings_reset(void);
+
+/**
+ * @brief Function to write the changed settings to RTC memory or NVS
+ * @param none
+ * @return size_t number of NVS entries written
+ */
+size_t settings_commit(void);
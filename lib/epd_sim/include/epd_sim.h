@@ -0,0 +1,144 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Host-side model of the UC8179 controller of the 7.5" V2 panel, for the
+ * native tests. It replaces the SPI backend of DEV_Config (DEV_Module_Init,
+ * DEV_SPI_WriteByte, DEV_SPI_Write_nByte), so the Waveshare driver and
+ * everything above it run unchanged and their command stream lands here:
+ *
+ *   0x10 / 0x13   old / new image data, into the controller RAM
+ *   0x12          refresh: the screen takes the new image, inside the
+ *                 partial window if 0x91 (partial in) is active
+ *   0x90          partial window, 0x91 / 0x92 partial in / out
+ *   0x04 / 0x02   power on / off, 0x07 0xA5 deep sleep until the next reset
+ *   0xE0 0x02     forced temperature, which is how Init_Fast selects the
+ *                 fast waveform
+ *
+ * Everything else is counted and ignored. Time only moves when the code
+ * under test waits: delay()/delayMicroseconds() must be routed to
+ * epd_sim_delay_us() (ArduinoFake in the tests), SPI transfers add their
+ * time at EPD_SIM_SPI_HZ, and the BUSY pin stays low for the EPD_SIM_*_MS
+ * durations below. The durations are rough figures for this panel, meant
+ * for comparing the display paths with each other rather than absolute times.
+ *
+ * Include this header before a driver source: the drivers write the GPIO
+ * registers and read BUSY directly, and the macros below send those to the
+ * simulator.
+ */
+
+#ifndef EPD_SIM_FULL_REFRESH_MS
+#define EPD_SIM_FULL_REFRESH_MS 3500
+#endif
+
+#ifndef EPD_SIM_FAST_REFRESH_MS
+#define EPD_SIM_FAST_REFRESH_MS 1500
+#endif
+
+#ifndef EPD_SIM_PARTIAL_REFRESH_MS
+#define EPD_SIM_PARTIAL_REFRESH_MS 400
+#endif
+
+#define EPD_SIM_POWER_ON_MS 60
+#define EPD_SIM_POWER_OFF_MS 30
+#define EPD_SIM_SPI_HZ 20000000
+
+#define EPD_SIM_WIDTH 800
+#define EPD_SIM_HEIGHT 480
+
+#ifndef REG_WRITE
+#define GPIO_OUT_W1TS_REG 1
+#define GPIO_OUT_W1TC_REG 0
+#define REG_WRITE(reg, mask) epd_sim_gpio_write((reg) == GPIO_OUT_W1TS_REG, mask)
+typedef int gpio_num_t;
+#define gpio_get_level(pin) epd_sim_gpio_level(pin)
+#endif
+
+struct EpdSimStats
+{
+  uint32_t resets;
+  uint32_t commands;
+  uint32_t data_bytes;    // bytes sent with DC high
+  uint32_t ignored_bytes; // data for no known command, or while asleep
+  uint32_t busy_writes;   // bytes sent while BUSY was low
+  uint32_t full_refreshes;
+  uint32_t fast_refreshes;
+  uint32_t partial_refreshes;
+  uint64_t time_us;    // since epd_sim_begin()
+  uint64_t spi_us;     // of which spent sending bytes
+  uint64_t refresh_us; // of which the panel was refreshing
+};
+
+/**
+ * @brief Function to start a simulation: blank white panel, controller in reset state, zeroed stats
+ * @param none
+ * @return none
+ */
+void epd_sim_begin(void);
+
+/**
+ * @brief Function to start a simulation where a previous one left the panel, for a device waking up
+ * @param screen what the panel shows, EPD_SIM_WIDTH / 8 * EPD_SIM_HEIGHT bytes, 1 for white
+ * @param asleep true if the controller is in deep sleep and needs a reset before it listens
+ * @return none
+ */
+void epd_sim_resume(const uint8_t *screen, bool asleep);
+
+/**
+ * @brief Function to get the counters of the simulation
+ * @param none
+ * @return const EpdSimStats& counters
+ */
+const EpdSimStats &epd_sim_stats(void);
+
+/**
+ * @brief Function to get what the panel shows
+ * @param none
+ * @return const uint8_t* EPD_SIM_WIDTH / 8 * EPD_SIM_HEIGHT bytes, 1 for white like the framebuffers of GUI_Paint
+ */
+const uint8_t *epd_sim_screen(void);
+
+/**
+ * @brief Function to tell if the controller is in deep sleep
+ * @param none
+ * @return bool true after 0x07 0xA5 until the next reset
+ */
+bool epd_sim_asleep(void);
+
+/**
+ * @brief Function to encode the screen as a 1 bit grayscale PNG
+ * @param out destination, nullptr to only get the size
+ * @param capacity size of out
+ * @return size_t size of the PNG, 0 if it does not fit in capacity
+ */
+size_t epd_sim_png(uint8_t *out, size_t capacity);
+
+/**
+ * @brief Function to save the screen as a PNG file
+ * @param path file to write
+ * @return bool true on success
+ */
+bool epd_sim_write_png(const char *path);
+
+/**
+ * @brief Function to let time pass, for delay() and delayMicroseconds()
+ * @param us microseconds
+ * @return none
+ */
+void epd_sim_delay_us(uint32_t us);
+
+/**
+ * @brief Function to set or clear output pins, for REG_WRITE() and digitalWrite()
+ * @param high true to set the pins, false to clear them
+ * @param mask 1 << pin for each pin
+ * @return none
+ */
+void epd_sim_gpio_write(bool high, uint32_t mask);
+
+/**
+ * @brief Function to read a pin, for gpio_get_level()
+ * @param pin pin number
+ * @return int level; BUSY reads 0 while the panel is busy
+ */
+int epd_sim_gpio_level(int pin);
@@ -0,0 +1,391 @@
+#include <epd_sim.h>
+#include <DEV_Config.h>
+#include <wake_state.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROW_BYTES (EPD_SIM_WIDTH / 8)
+#define FRAME_BYTES (ROW_BYTES * EPD_SIM_HEIGHT)
+#define SPI_BYTE_NS (8ULL * 1000000000ULL / EPD_SIM_SPI_HZ)
+
+struct Controller
+{
+  bool asleep;
+  bool powered;
+  bool fast;    // temperature forced by 0xE0, the fast waveform
+  bool partial; // between 0x91 and 0x92
+  uint8_t command;
+  uint32_t index; // data bytes received for the command
+  uint8_t args[9];
+  uint16_t window[4]; // partial window: first and last byte column, first and last row
+  uint64_t busy_until_ns;
+};
+
+static Controller controller;
+static bool reset_low; // pins
+static bool dc;
+static uint8_t old_ram[FRAME_BYTES]; // 1 for black, as the panel receives it
+static uint8_t new_ram[FRAME_BYTES];
+static uint8_t screen[FRAME_BYTES]; // 1 for white
+static EpdSimStats stats;
+static uint64_t now_ns;
+static uint64_t spi_ns;
+static uint64_t refresh_ns;
+
+static void controller_reset(void)
+{
+  memset(&controller, 0, sizeof(controller));
+  controller.window[1] = ROW_BYTES - 1;
+  controller.window[3] = EPD_SIM_HEIGHT - 1;
+}
+
+static bool busy(void)
+{
+  return now_ns < controller.busy_until_ns;
+}
+
+static void start_busy(uint32_t ms)
+{
+  controller.busy_until_ns = now_ns + ms * 1000000ULL;
+}
+
+/**
+ * @brief Function to find where the next image byte goes in the controller RAM
+ * @param index image bytes received since the 0x10 / 0x13 command
+ * @return int32_t offset in the RAM, -1 past the end of the frame or window
+ */
+static int32_t ram_offset(uint32_t index)
+{
+  if (!controller.partial)
+    return index < FRAME_BYTES ? (int32_t)index : -1;
+
+  uint32_t width = controller.window[1] - controller.window[0] + 1;
+  uint32_t row = controller.window[2] + index / width;
+  if (row > controller.window[3])
+    return -1;
+  return row * ROW_BYTES + controller.window[0] + index % width;
+}
+
+static void refresh(void)
+{
+  uint16_t first_column = 0, last_column = ROW_BYTES - 1, first_row = 0, last_row = EPD_SIM_HEIGHT - 1;
+  uint32_t ms;
+  if (controller.partial)
+  {
+    first_column = controller.window[0];
+    last_column = controller.window[1];
+    first_row = controller.window[2];
+    last_row = controller.window[3];
+    ms = EPD_SIM_PARTIAL_REFRESH_MS;
+    stats.partial_refreshes++;
+  }
+  else if (controller.fast)
+  {
+    ms = EPD_SIM_FAST_REFRESH_MS;
+    stats.fast_refreshes++;
+  }
+  else
+  {
+    ms = EPD_SIM_FULL_REFRESH_MS;
+    stats.full_refreshes++;
+  }
+
+  for (uint32_t row = first_row; row <= last_row; row++)
+  {
+    for (uint32_t column = first_column; column <= last_column; column++)
+    {
+      uint32_t offset = row * ROW_BYTES + column;
+      screen[offset] = ~new_ram[offset];
+      old_ram[offset] = new_ram[offset];
+    }
+  }
+  start_busy(ms);
+  refresh_ns += ms * 1000000ULL;
+}
+
+static void command(uint8_t command)
+{
+  stats.commands++;
+  if (controller.asleep)
+    return;
+
+  controller.command = command;
+  controller.index = 0;
+  switch (command)
+  {
+  case 0x02: // power off
+    controller.powered = false;
+    start_busy(EPD_SIM_POWER_OFF_MS);
+    break;
+  case 0x04: // power on
+    controller.powered = true;
+    start_busy(EPD_SIM_POWER_ON_MS);
+    break;
+  case 0x12: // display refresh, which needs the power on
+    if (controller.powered)
+      refresh();
+    break;
+  case 0x91: // partial in
+    controller.partial = true;
+    break;
+  case 0x92: // partial out
+    controller.partial = false;
+    break;
+  }
+}
+
+static void data(uint8_t data)
+{
+  stats.data_bytes++;
+  if (controller.asleep)
+  {
+    stats.ignored_bytes++;
+    return;
+  }
+
+  uint32_t index = controller.index++;
+  int32_t offset;
+  switch (controller.command)
+  {
+  case 0x07: // deep sleep
+    if (data == 0xA5)
+      controller.asleep = true;
+    break;
+  case 0x10: // old image
+  case 0x13: // new image
+    offset = ram_offset(index);
+    if (offset < 0)
+      stats.ignored_bytes++;
+    else
+      (controller.command == 0x10 ? old_ram : new_ram)[offset] = data;
+    break;
+  case 0x90: // partial window, 9 bits per coordinate in two bytes, then the scan mode
+    if (index >= sizeof(controller.args))
+    {
+      stats.ignored_bytes++;
+      break;
+    }
+    controller.args[index] = data;
+    if (index == 7)
+    {
+      for (int i = 0; i < 4; i++)
+        controller.window[i] = (controller.args[i * 2] & 0x03) << 8 | controller.args[i * 2 + 1];
+      controller.window[0] /= 8;
+      controller.window[1] /= 8;
+      if (controller.window[1] >= ROW_BYTES)
+        controller.window[1] = ROW_BYTES - 1;
+      if (controller.window[3] >= EPD_SIM_HEIGHT)
+        controller.window[3] = EPD_SIM_HEIGHT - 1;
+    }
+    break;
+  case 0xE0: // cascade setting, bit 1 forces the temperature set by 0xE5
+    if (index == 0)
+      controller.fast = data & 0x02;
+    break;
+  case 0x00: // panel setting
+  case 0x01: // power setting
+  case 0x06: // booster soft start
+  case 0x15: // dual SPI
+  case 0x50: // VCOM and data interval
+  case 0x60: // TCON
+  case 0x61: // resolution, fixed to the size of the model
+  case 0xE5: // forced temperature
+    break;
+  default:
+    stats.ignored_bytes++;
+    break;
+  }
+}
+
+static void spi_byte(uint8_t byte)
+{
+  now_ns += SPI_BYTE_NS;
+  spi_ns += SPI_BYTE_NS;
+  if (busy())
+    stats.busy_writes++;
+  if (dc)
+    data(byte);
+  else
+    command(byte);
+}
+
+void epd_sim_begin(void)
+{
+  memset(&stats, 0, sizeof(stats));
+  memset(old_ram, 0, sizeof(old_ram));
+  memset(new_ram, 0, sizeof(new_ram));
+  memset(screen, 0xFF, sizeof(screen));
+  now_ns = spi_ns = refresh_ns = 0;
+  reset_low = dc = false;
+  controller_reset();
+}
+
+void epd_sim_resume(const uint8_t *screen_in, bool asleep)
+{
+  epd_sim_begin();
+  memcpy(screen, screen_in, sizeof(screen));
+  // the last refresh left the image in both RAMs
+  for (size_t i = 0; i < FRAME_BYTES; i++)
+    old_ram[i] = new_ram[i] = ~screen[i];
+  controller.asleep = asleep;
+}
+
+const EpdSimStats &epd_sim_stats(void)
+{
+  stats.time_us = now_ns / 1000;
+  stats.spi_us = spi_ns / 1000;
+  stats.refresh_us = refresh_ns / 1000;
+  return stats;
+}
+
+const uint8_t *epd_sim_screen(void)
+{
+  return screen;
+}
+
+bool epd_sim_asleep(void)
+{
+  return controller.asleep;
+}
+
+void epd_sim_delay_us(uint32_t us)
+{
+  now_ns += us * 1000ULL;
+}
+
+void epd_sim_gpio_write(bool high, uint32_t mask)
+{
+  if (mask & (1UL << EPD_DC_PIN))
+    dc = high;
+  if (mask & (1UL << EPD_RST_PIN))
+  {
+    if (high && reset_low)
+    {
+      stats.resets++;
+      controller_reset();
+    }
+    reset_low = !high;
+  }
+}
+
+int epd_sim_gpio_level(int pin)
+{
+  if (pin == EPD_BUSY_PIN)
+    return busy() ? 0 : 1;
+  return 0;
+}
+
+struct PngWriter
+{
+  uint8_t *out;
+  size_t capacity;
+  size_t size;
+  uint32_t crc; // of the current chunk
+};
+
+static void png_put(PngWriter &writer, const uint8_t *data, size_t size)
+{
+  if (writer.out && writer.size + size <= writer.capacity)
+    memcpy(writer.out + writer.size, data, size);
+  writer.size += size;
+  writer.crc = wake_state_crc32_update(writer.crc, data, size);
+}
+
+static void png_put32(PngWriter &writer, uint32_t value)
+{
+  uint8_t bytes[4] = {(uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value};
+  png_put(writer, bytes, sizeof(bytes));
+}
+
+static void png_chunk_begin(PngWriter &writer, uint32_t size, const char *type)
+{
+  png_put32(writer, size);
+  writer.crc = 0;
+  png_put(writer, (const uint8_t *)type, 4);
+}
+
+static void png_chunk_end(PngWriter &writer)
+{
+  png_put32(writer, writer.crc);
+}
+
+size_t epd_sim_png(uint8_t *out, size_t capacity)
+{
+  // rows are stored unfiltered in a single uncompressed deflate block
+  const uint32_t raw_size = (1 + ROW_BYTES) * EPD_SIM_HEIGHT;
+  static_assert((1 + ROW_BYTES) * EPD_SIM_HEIGHT <= 0xFFFF, "the image must fit in one stored block");
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  PngWriter writer = {out, capacity, 0, 0};
+
+  png_put(writer, signature, sizeof(signature));
+
+  png_chunk_begin(writer, 13, "IHDR");
+  png_put32(writer, EPD_SIM_WIDTH);
+  png_put32(writer, EPD_SIM_HEIGHT);
+  const uint8_t format[5] = {1, 0, 0, 0, 0}; // 1 bit grayscale, deflate, no filter, no interlace
+  png_put(writer, format, sizeof(format));
+  png_chunk_end(writer);
+
+  png_chunk_begin(writer, 2 + 5 + raw_size + 4, "IDAT");
+  const uint8_t header[7] = {0x78, 0x01, 0x01, (uint8_t)raw_size, (uint8_t)(raw_size >> 8),
+                             (uint8_t)~raw_size, (uint8_t)(~raw_size >> 8)};
+  png_put(writer, header, sizeof(header));
+  uint32_t a = 1, b = 0; // Adler-32 of the raw rows
+  for (uint32_t row = 0; row < EPD_SIM_HEIGHT; row++)
+  {
+    const uint8_t filter = 0;
+    png_put(writer, &filter, 1);
+    png_put(writer, screen + row * ROW_BYTES, ROW_BYTES);
+    b = (b + a) % 65521;
+    for (uint32_t i = 0; i < ROW_BYTES; i++)
+    {
+      a = (a + screen[row * ROW_BYTES + i]) % 65521;
+      b = (b + a) % 65521;
+    }
+  }
+  png_put32(writer, b << 16 | a);
+  png_chunk_end(writer);
+
+  png_chunk_begin(writer, 0, "IEND");
+  png_chunk_end(writer);
+
+  if (out && writer.size > capacity)
+    return 0;
+  return writer.size;
+}
+
+bool epd_sim_write_png(const char *path)
+{
+  size_t size = epd_sim_png(nullptr, 0);
+  uint8_t *png = (uint8_t *)malloc(size);
+  if (!png)
+    return false;
+  epd_sim_png(png, size);
+
+  FILE *file = fopen(path, "wb");
+  bool written = file && fwrite(png, 1, size, file) == size;
+  if (file)
+    written = fclose(file) == 0 && written;
+  free(png);
+  return written;
+}
+
+/******************************************************************************
+ DEV_Config backend: the bytes go to the model instead of the SPI peripheral
+******************************************************************************/
+UBYTE DEV_Module_Init(void)
+{
+  return 0;
+}
+
+void DEV_SPI_WriteByte(UBYTE data)
+{
+  spi_byte(data);
+}
+
+void DEV_SPI_Write_nByte(const UBYTE *pData, UDOUBLE Len, UBYTE Xor)
+{
+  for (UDOUBLE i = 0; i < Len; i++)
+    spi_byte(pData[i] ^ Xor);
+}
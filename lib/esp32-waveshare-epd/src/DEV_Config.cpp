@@ -95,3 +95,31 @@ void DEV_SPI_WriteByte(UBYTE data)
 
     // SPI.endTransaction();
 }
+
+/******************************************************************************
+function:
+            SPI write of a buffer
+info:
+    CS stays low for the whole buffer and the bytes go to the SPI peripheral
+    in chunks instead of one transfer per byte.
+parameter:
+    pData : Bytes to send
+    Len   : Number of bytes
+    Xor   : Mask applied to every byte, 0xFF to send them inverted
+******************************************************************************/
+void DEV_SPI_Write_nByte(const UBYTE *pData, UDOUBLE Len, UBYTE Xor)
+{
+    UBYTE Chunk[64];
+
+    REG_WRITE(GPIO_OUT_W1TC_REG, 1 << EPD_CS_PIN);
+    while (Len)
+    {
+        UDOUBLE Count = Len < sizeof(Chunk) ? Len : sizeof(Chunk);
+        for (UDOUBLE i = 0; i < Count; i++)
+            Chunk[i] = pData[i] ^ Xor;
+        display_spi->writeBytes(Chunk, Count);
+        pData += Count;
+        Len -= Count;
+    }
+    REG_WRITE(GPIO_OUT_W1TS_REG, 1 << EPD_CS_PIN);
+}
@@ -100,5 +100,6 @@
 /*------------------------------------------------------------------------------------------------------*/
 UBYTE DEV_Module_Init(void);
 void DEV_SPI_WriteByte(UBYTE data);
+void DEV_SPI_Write_nByte(const UBYTE *pData, UDOUBLE Len, UBYTE Xor);
 
 #endif
@@ -85,6 +85,8 @@
 
 PAINT Paint;
 
+static void Paint_SelectPixel(void);
+
 /******************************************************************************
 function: Create Image
 parameter:
@@ -120,6 +122,7 @@ void Paint_NewImage(UBYTE *image, UWORD Width, UWORD Height, UWORD Rotate, UWORD
         Paint.Width = Height;
         Paint.Height = Width;
     }
+    Paint_SelectPixel();
 }
 
 /******************************************************************************
@@ -143,6 +146,7 @@ void Paint_SetRotate(UWORD Rotate)
     {
         // Debug("Set image Rotate %d\r\n", Rotate);
         Paint.Rotate = Rotate;
+        Paint_SelectPixel();
     }
     else
     {
@@ -162,6 +166,7 @@ void Paint_SetMirroring(UBYTE mirror)
     {
         // Debug("mirror image x:%s, y:%s\r\n",(mirror & 0x01)? "mirror":"none", ((mirror >> 1) & 0x01)? "mirror":"none");
         Paint.Mirror = mirror;
+        Paint_SelectPixel();
     }
     else
     {
@@ -192,15 +197,16 @@ void Paint_SetScale(UBYTE scale)
         Debug("Set Scale Input parameter error\r\n");
         Debug("Scale Only support: 2 4 7\r\n");
     }
+    Paint_SelectPixel();
 }
 /******************************************************************************
-function: Draw Pixels
+function: Draw Pixels, for any rotation, mirror and scale
 parameter:
     Xpoint : At point X
     Ypoint : At point Y
     Color  : Painted colors
 ******************************************************************************/
-void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
+static void Paint_SetPixel_Generic(UWORD Xpoint, UWORD Ypoint, UWORD Color)
 {
     if (Xpoint > Paint.Width || Ypoint > Paint.Height)
     {
@@ -331,6 +337,119 @@ void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
     }
 }
 
+/******************************************************************************
+function: Draw Pixels on a 1bpp image
+info:
+    Rotation and mirror are template parameters, so all that is left per
+    pixel is the bounds check, one shift and one mask.
+parameter:
+    Xpoint : At point X
+    Ypoint : At point Y
+    Color  : Painted colors
+******************************************************************************/
+template <UWORD Rotate, UBYTE Mirror>
+static void Paint_SetPixel_1bpp(UWORD Xpoint, UWORD Ypoint, UWORD Color)
+{
+    if (Xpoint >= Paint.Width || Ypoint >= Paint.Height)
+    {
+        Debug("Exceeding display boundaries\r\n");
+        return;
+    }
+
+    UWORD X = Xpoint, Y = Ypoint;
+    if (Rotate == ROTATE_90)
+    {
+        X = Paint.WidthMemory - Ypoint - 1;
+        Y = Xpoint;
+    }
+    else if (Rotate == ROTATE_180)
+    {
+        X = Paint.WidthMemory - Xpoint - 1;
+        Y = Paint.HeightMemory - Ypoint - 1;
+    }
+    else if (Rotate == ROTATE_270)
+    {
+        X = Ypoint;
+        Y = Paint.HeightMemory - Xpoint - 1;
+    }
+    if (Mirror & MIRROR_HORIZONTAL)
+        X = Paint.WidthMemory - X - 1;
+    if (Mirror & MIRROR_VERTICAL)
+        Y = Paint.HeightMemory - Y - 1;
+
+    UBYTE *Byte = &Paint.Image[X / 8 + (UDOUBLE)Y * Paint.WidthByte];
+    UBYTE Bit = 0x80 >> (X % 8);
+    if (Color == BLACK)
+        *Byte &= ~Bit;
+    else
+        *Byte |= Bit;
+}
+
+typedef void (*PAINT_PIXEL)(UWORD Xpoint, UWORD Ypoint, UWORD Color);
+
+static PAINT_PIXEL Paint_Pixel = Paint_SetPixel_Generic;
+
+template <UWORD Rotate>
+static PAINT_PIXEL Paint_SelectPixel_1bpp(UWORD Mirror)
+{
+    switch (Mirror)
+    {
+    case MIRROR_NONE:
+        return Paint_SetPixel_1bpp<Rotate, MIRROR_NONE>;
+    case MIRROR_HORIZONTAL:
+        return Paint_SetPixel_1bpp<Rotate, MIRROR_HORIZONTAL>;
+    case MIRROR_VERTICAL:
+        return Paint_SetPixel_1bpp<Rotate, MIRROR_VERTICAL>;
+    case MIRROR_ORIGIN:
+        return Paint_SetPixel_1bpp<Rotate, MIRROR_ORIGIN>;
+    default:
+        return Paint_SetPixel_Generic;
+    }
+}
+
+/******************************************************************************
+function: Pick the Paint_SetPixel() implementation for the current image,
+          called whenever its rotation, mirror or scale changes
+******************************************************************************/
+static void Paint_SelectPixel(void)
+{
+    if (Paint.Scale != 2)
+    {
+        Paint_Pixel = Paint_SetPixel_Generic;
+        return;
+    }
+    switch (Paint.Rotate)
+    {
+    case ROTATE_0:
+        Paint_Pixel = Paint_SelectPixel_1bpp<ROTATE_0>(Paint.Mirror);
+        break;
+    case ROTATE_90:
+        Paint_Pixel = Paint_SelectPixel_1bpp<ROTATE_90>(Paint.Mirror);
+        break;
+    case ROTATE_180:
+        Paint_Pixel = Paint_SelectPixel_1bpp<ROTATE_180>(Paint.Mirror);
+        break;
+    case ROTATE_270:
+        Paint_Pixel = Paint_SelectPixel_1bpp<ROTATE_270>(Paint.Mirror);
+        break;
+    default:
+        Paint_Pixel = Paint_SetPixel_Generic;
+        break;
+    }
+}
+
+/******************************************************************************
+function: Draw Pixels
+parameter:
+    Xpoint : At point X
+    Ypoint : At point Y
+    Color  : Painted colors
+******************************************************************************/
+void Paint_SetPixel(UWORD Xpoint, UWORD Ypoint, UWORD Color)
+{
+    Paint_Pixel(Xpoint, Ypoint, Color);
+}
+
 /******************************************************************************
 function: Clear the color of the picture
 parameter:
@@ -340,31 +459,25 @@ void Paint_Clear(UWORD Color)
 {
     if (Paint.Scale == 2 || Paint.Scale == 4)
     {
-        for (UWORD Y = 0; Y < Paint.HeightByte; Y++)
-        {
-            for (UWORD X = 0; X < Paint.WidthByte; X++)
-            { // 8 pixel =  1 byte
-                UDOUBLE Addr = X + Y * Paint.WidthByte;
-                Paint.Image[Addr] = Color;
-            }
-        }
+        // 8 pixel =  1 byte
+        memset(Paint.Image, (UBYTE)Color, (UDOUBLE)Paint.WidthByte * Paint.HeightByte);
     }
     if (Paint.Scale == 7)
     {
         Color = (UBYTE)Color;
         UWORD Width = (Paint.WidthMemory * 3 % 8 == 0) ? (Paint.WidthMemory * 3 / 8) : (Paint.WidthMemory * 3 / 8 + 1);
-        for (UWORD Y = 0; Y < Paint.HeightByte; Y++)
+        UDOUBLE Size = (UDOUBLE)Width * Paint.HeightByte;
+        // 8 pixels of 3 bits = 3 bytes, repeated over the whole buffer
+        UBYTE Pattern[3] = {(UBYTE)((Color << 5) | (Color << 2) | (Color >> 1)),
+                            (UBYTE)((Color << 7) | (Color << 4) | (Color << 1) | (Color >> 2)),
+                            (UBYTE)((Color << 6) | (Color << 3) | Color)};
+        UDOUBLE Filled = Size < 3 ? Size : 3;
+        memcpy(Paint.Image, Pattern, Filled);
+        while (Filled < Size)
         {
-            for (UWORD X = 0; X < Width; X++)
-            {
-                UDOUBLE Addr = X + Y * Width;
-                if ((X + Y * Width) % 3 == 0)
-                    Paint.Image[Addr] = ((Color << 5) | (Color << 2) | (Color >> 1));
-                else if ((X + Y * Width) % 3 == 1)
-                    Paint.Image[Addr] = ((Color << 7) | (Color << 4) | (Color << 1) | (Color >> 2));
-                else if ((X + Y * Width) % 3 == 2)
-                    Paint.Image[Addr] = ((Color << 6) | (Color << 3) | Color);
-            }
+            UDOUBLE Copy = (Size - Filled < Filled) ? Size - Filled : Filled;
+            memcpy(Paint.Image + Filled, Paint.Image, Copy);
+            Filled += Copy;
         }
     }
 }
@@ -381,6 +494,36 @@ parameter:
 void Paint_ClearWindows(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color)
 {
     UWORD X, Y;
+    if (Paint.Scale == 2 && Paint.Rotate == ROTATE_0 && Paint.Mirror == MIRROR_NONE)
+    {
+        // Whole bytes with memset, masks for the partial bytes at both ends of each row
+        if (Xend > Paint.Width)
+            Xend = Paint.Width;
+        if (Yend > Paint.Height)
+            Yend = Paint.Height;
+        if (Xstart >= Xend || Ystart >= Yend)
+            return;
+
+        UBYTE Fill = Color == BLACK ? 0x00 : 0xFF;
+        UWORD First = Xstart / 8, Last = (Xend - 1) / 8;
+        UBYTE FirstMask = 0xFF >> (Xstart % 8);
+        UBYTE LastMask = 0xFF << (7 - (Xend - 1) % 8);
+        if (First == Last)
+            FirstMask &= LastMask;
+
+        for (Y = Ystart; Y < Yend; Y++)
+        {
+            UBYTE *Row = Paint.Image + (UDOUBLE)Y * Paint.WidthByte;
+            Row[First] = (Row[First] & ~FirstMask) | (Fill & FirstMask);
+            if (First == Last)
+                continue;
+            if (Last - First > 1)
+                memset(Row + First + 1, Fill, Last - First - 1);
+            Row[Last] = (Row[Last] & ~LastMask) | (Fill & LastMask);
+        }
+        return;
+    }
+
     for (Y = Ystart; Y < Yend; Y++)
     {
         for (X = Xstart; X < Xend; X++)
@@ -617,32 +760,104 @@ void Paint_DrawCircle(UWORD X_Center, UWORD Y_Center, UWORD Radius,
 }
 
 /******************************************************************************
-function: Show English characters
+function: Draw a glyph a byte at a time
+info:
+    Only for 1bpp images without rotation or mirroring: each font byte is
+    shifted into the two framebuffer bytes it straddles instead of going
+    through Paint_SetPixel() one pixel at a time. Columns and rows past the
+    edge of the image are clipped.
 parameter:
     Xpoint           ：X coordinate
     Ypoint           ：Y coordinate
-    Acsii_Char       ：To display the English characters
-    Font             ：A structure pointer that displays a character size
-    Color_Foreground : Select the foreground color
-    Color_Background : Select the background color
+    ptr              ：First row of the glyph bitmap
+    Width            ：Glyph width, at most MAX_WIDTH_FONT
+    Height           ：Glyph height
+    Color_Foreground : Color of the set bits
+    Color_Background : Color of the clear bits, FONT_BACKGROUND to leave them
 ******************************************************************************/
-void Paint_DrawChar(UWORD Xpoint, UWORD Ypoint, const char Acsii_Char,
-                    sFONT *Font, UWORD Color_Foreground, UWORD Color_Background)
+static void Paint_BlitGlyph(UWORD Xpoint, UWORD Ypoint, const unsigned char *ptr, UWORD Width, UWORD Height,
+                            UWORD Color_Foreground, UWORD Color_Background)
+{
+    UWORD RowBytes = Width / 8 + (Width % 8 ? 1 : 0);
+    bool Opaque = FONT_BACKGROUND != Color_Background;
+    UBYTE Foreground = Color_Foreground == BLACK ? 0x00 : 0xFF;
+    UBYTE Background = Color_Background == BLACK ? 0x00 : 0xFF;
+
+    // Columns of each font byte that belong to the glyph and fit in the image
+    UBYTE Cover[MAX_WIDTH_FONT / 8];
+    for (UWORD Byte = 0; Byte < RowBytes; Byte++)
+    {
+        UWORD Column = Byte * 8;
+        UWORD X = Xpoint + Column;
+        UBYTE Mask = 0xFF;
+        if (Width - Column < 8)
+            Mask = 0xFF << (8 - (Width - Column));
+        if (X >= Paint.Width)
+            Mask = 0;
+        else if (Paint.Width - X < 8)
+            Mask &= 0xFF << (8 - (Paint.Width - X));
+        Cover[Byte] = Mask;
+    }
+
+    UWORD Rows = Height;
+    if (Ypoint + Rows > Paint.Height)
+        Rows = Paint.Height - Ypoint;
+
+    for (UWORD Page = 0; Page < Rows; Page++, ptr += RowBytes)
+    {
+        UBYTE *Row = Paint.Image + (UDOUBLE)(Ypoint + Page) * Paint.WidthByte;
+        for (UWORD Byte = 0; Byte < RowBytes; Byte++)
+        {
+            UBYTE Mask = Opaque ? Cover[Byte] : (ptr[Byte] & Cover[Byte]);
+            if (!Mask)
+                continue;
+            UBYTE Bits = ((ptr[Byte] & Foreground) | (~ptr[Byte] & Background)) & Mask;
+
+            UWORD X = Xpoint + Byte * 8;
+            UBYTE *Dst = Row + X / 8;
+            UBYTE Shift = X % 8;
+            Dst[0] = (Dst[0] & ~(Mask >> Shift)) | (Bits >> Shift);
+            UBYTE Spill = (UBYTE)(Mask << (8 - Shift));
+            if (Shift && Spill)
+                Dst[1] = (Dst[1] & ~Spill) | (UBYTE)(Bits << (8 - Shift));
+        }
+    }
+}
+
+/******************************************************************************
+function: Draw a glyph bitmap
+info:
+    The bitmap is Height rows of (Width + 7) / 8 bytes, most significant bit
+    first, the layout of both the sFONT tables and proportional fonts.
+parameter:
+    Xpoint           ：X coordinate
+    Ypoint           ：Y coordinate
+    ptr              ：First row of the glyph bitmap
+    Width            ：Glyph width
+    Height           ：Glyph height
+    Color_Foreground : Color of the set bits
+    Color_Background : Color of the clear bits, FONT_BACKGROUND to leave them
+******************************************************************************/
+void Paint_DrawGlyph(UWORD Xpoint, UWORD Ypoint, const unsigned char *ptr, UWORD Width, UWORD Height,
+                     UWORD Color_Foreground, UWORD Color_Background)
 {
     UWORD Page, Column;
 
     if (Xpoint > Paint.Width || Ypoint > Paint.Height)
     {
-        Debug("Paint_DrawChar Input exceeds the normal display range\r\n");
+        Debug("Paint_DrawGlyph Input exceeds the normal display range\r\n");
         return;
     }
 
-    uint32_t Char_Offset = (Acsii_Char - ' ') * Font->Height * (Font->Width / 8 + (Font->Width % 8 ? 1 : 0));
-    const unsigned char *ptr = &Font->table[Char_Offset];
+    if (Paint.Scale == 2 && Paint.Rotate == ROTATE_0 && Paint.Mirror == MIRROR_NONE && Width <= MAX_WIDTH_FONT)
+    {
+        Paint_BlitGlyph(Xpoint, Ypoint, ptr, Width, Height, Color_Foreground, Color_Background);
+        return;
+    }
 
-    for (Page = 0; Page < Font->Height; Page++)
+    for (Page = 0; Page < Height; Page++)
     {
-        for (Column = 0; Column < Font->Width; Column++)
+        for (Column = 0; Column < Width; Column++)
         {
 
             // To determine whether the font background color and screen background color is consistent
@@ -669,11 +884,35 @@ void Paint_DrawChar(UWORD Xpoint, UWORD Ypoint, const char Acsii_Char,
             if (Column % 8 == 7)
                 ptr++;
         } // Write a line
-        if (Font->Width % 8 != 0)
+        if (Width % 8 != 0)
             ptr++;
     } // Write all
 }
 
+/******************************************************************************
+function: Show English characters
+parameter:
+    Xpoint           ：X coordinate
+    Ypoint           ：Y coordinate
+    Acsii_Char       ：To display the English characters
+    Font             ：A structure pointer that displays a character size
+    Color_Foreground : Select the foreground color
+    Color_Background : Select the background color
+******************************************************************************/
+void Paint_DrawChar(UWORD Xpoint, UWORD Ypoint, const char Acsii_Char,
+                    sFONT *Font, UWORD Color_Foreground, UWORD Color_Background)
+{
+    if (Xpoint > Paint.Width || Ypoint > Paint.Height)
+    {
+        Debug("Paint_DrawChar Input exceeds the normal display range\r\n");
+        return;
+    }
+
+    uint32_t Char_Offset = (Acsii_Char - ' ') * Font->Height * (Font->Width / 8 + (Font->Width % 8 ? 1 : 0));
+    Paint_DrawGlyph(Xpoint, Ypoint, &Font->table[Char_Offset], Font->Width, Font->Height,
+                    Color_Foreground, Color_Background);
+}
+
 /******************************************************************************
 function:	Display the string
 parameter:
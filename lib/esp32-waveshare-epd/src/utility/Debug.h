@@ -14,7 +14,7 @@
 #ifndef __DEBUG_H
 #define __DEBUG_H
 
-#include <Wire.h>
+#include <Arduino.h>
 
 #define USE_DEBUG 1
 #if USE_DEBUG
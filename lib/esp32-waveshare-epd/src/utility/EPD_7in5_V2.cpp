@@ -316,6 +316,33 @@ static void EPD_SendData(UBYTE Data)
     DEV_SPI_WriteByte(Data);
 }
 
+/******************************************************************************
+function :	send a buffer of data
+parameter:
+    pData : Data to write
+    Len   : Number of bytes
+    Xor   : Mask applied to every byte
+******************************************************************************/
+static void EPD_SendDataBuffer(const UBYTE *pData, UDOUBLE Len, UBYTE Xor)
+{
+    REG_WRITE(GPIO_OUT_W1TS_REG, 1 << EPD_DC_PIN);
+
+    DEV_SPI_Write_nByte(pData, Len, Xor);
+}
+
+/******************************************************************************
+function :	send the same data byte for every pixel of the panel
+parameter:
+    Data : Write data
+******************************************************************************/
+static void EPD_SendDataFill(UBYTE Data)
+{
+    UBYTE Row[EPD_7IN5_V2_WIDTH / 8];
+    memset(Row, Data, sizeof(Row));
+    for (UWORD j = 0; j < EPD_7IN5_V2_HEIGHT; j++)
+        EPD_SendDataBuffer(Row, sizeof(Row), 0x00);
+}
+
 static void EPD_SendData2(uint16_t Data)
 {
     DEV_Digital_Write(EPD_DC_PIN, 1);
@@ -334,7 +361,8 @@ static void EPD_WaitUntilIdle(void)
     unsigned char busy;
     do
     {
-        delayMicroseconds(100);
+        // sleep rather than spin, so other tasks run while the panel is busy
+        DEV_Delay_ms(1);
         //EPD_SendCommand(0x71);
         //busy = DEV_Digital_Read(EPD_BUSY_PIN);
         busy = gpio_get_level( (gpio_num_t)EPD_BUSY_PIN );
@@ -556,21 +584,13 @@ void EPD_7IN5_V2_ClearBlack(void)
 {
     EPD_WaitUntilIdle();
 
-    UWORD Width, Height;
-    Width = (EPD_7IN5_V2_WIDTH % 8 == 0) ? (EPD_7IN5_V2_WIDTH / 8) : (EPD_7IN5_V2_WIDTH / 8 + 1);
-    Height = EPD_7IN5_V2_HEIGHT;
-
-    UWORD i;
     // EPD_SendCommand(0x10);
     // for (i = 0; i < Height * Width; i++)
     // {
     //     EPD_SendData(0x00);
     // }
     EPD_SendCommand(0x13);
-    for (i = 0; i < Height * Width; i++)
-    {
-        EPD_SendData(0xFF);
-    }
+    EPD_SendDataFill(0xFF);
     EPD_7IN5_V2_TurnOnDisplay();
 }
 
@@ -578,21 +598,13 @@ void EPD_7IN5_V2_ClearWhite(void)
 {
     EPD_WaitUntilIdle();
 
-    UWORD Width, Height;
-    Width = (EPD_7IN5_V2_WIDTH % 8 == 0) ? (EPD_7IN5_V2_WIDTH / 8) : (EPD_7IN5_V2_WIDTH / 8 + 1);
-    Height = EPD_7IN5_V2_HEIGHT;
-
-    UWORD i;
     // EPD_SendCommand(0x10);
     // for (i = 0; i < Height * Width; i++)
     // {
     //     EPD_SendData(0x00);
     // }
     EPD_SendCommand(0x13);
-    for (i = 0; i < Height * Width; i++)
-    {
-        EPD_SendData(0x00);
-    }
+    EPD_SendDataFill(0x00);
     EPD_7IN5_V2_TurnOnDisplay();
 }
 
@@ -618,13 +630,28 @@ void EPD_7IN5_V2_Display(const UBYTE *blackimage)
     
     // send black data
     EPD_SendCommand(0x13);
-    for (UDOUBLE j = 0; j < Height; j++)
-    {
-        for (UDOUBLE i = 0; i < Width; i++)
-        {
-            EPD_SendData(~blackimage[i + j * Width]);
-        }
-    }
+    EPD_SendDataBuffer(blackimage, Width * Height, 0xFF);
+    EPD_7IN5_V2_TurnOnDisplay();
+}
+
+/******************************************************************************
+function :	Sends the image to e-Paper in pieces, e.g. while reading it from flash,
+			and displays it. Nothing is displayed unless _End is called.
+parameter:
+******************************************************************************/
+void EPD_7IN5_V2_Display_Begin(void)
+{
+    EPD_WaitUntilIdle();
+    EPD_SendCommand(0x13);
+}
+
+void EPD_7IN5_V2_Display_Write(const UBYTE *blackimage, UDOUBLE size)
+{
+    EPD_SendDataBuffer(blackimage, size, 0xFF);
+}
+
+void EPD_7IN5_V2_Display_End(void)
+{
     EPD_7IN5_V2_TurnOnDisplay();
 }
 
@@ -47,6 +47,9 @@ void EPD_7IN5_V2_Clear(void);
 void EPD_7IN5_V2_ClearBlack(void);
 void EPD_7IN5_V2_ClearWhite(void);
 void EPD_7IN5_V2_Display(const UBYTE *blackimage);
+void EPD_7IN5_V2_Display_Begin(void);
+void EPD_7IN5_V2_Display_Write(const UBYTE *blackimage, UDOUBLE size);
+void EPD_7IN5_V2_Display_End(void);
 void EPD_7IN5_V2_Sleep(void);
 
 #endif
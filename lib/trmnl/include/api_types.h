@@ -37,7 +37,11 @@ struct ApiDisplayResponse
   String filename;
   bool update_firmware;
   String firmware_url;
+  String firmware_sha256;
+  String firmware_patch_url;
   uint64_t refresh_rate;
+  uint16_t quiet_start; // minutes after midnight UTC
+  uint16_t quiet_end;   // same as quiet_start when there are no quiet hours
   bool reset_firmware;
   SPECIAL_FUNCTION special_function;
   String action;
@@ -93,4 +97,5 @@ struct LogWithDetails
   String filenameNew;
   bool logRetry;
   int retryAttempt;
+  const char *flightRecord; // report about an abnormal previous wake, nullptr if none
 };
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Arduino.h>
+
+#ifndef FILE_INDEX_MAX_FILES
+#define FILE_INDEX_MAX_FILES 24
+#endif
+
+#ifndef FILE_INDEX_NAME_SIZE
+#define FILE_INDEX_NAME_SIZE 32
+#endif
+
+enum FileIndexLookup : uint8_t
+{
+  FILE_INDEX_ABSENT,
+  FILE_INDEX_PRESENT,
+  FILE_INDEX_UNKNOWN, // the index cannot tell, ask the filesystem
+};
+
+/**
+ * RAM list of the files in the root directory, filled by one directory walk
+ * at mount time and kept up to date by the filesystem wrappers, so checking
+ * whether a file exists does not search the flash. Names are stored without
+ * the leading slash. Files in subdirectories are never indexed, and once a
+ * name does not fit the index is marked incomplete: a miss is then unknown
+ * rather than absent.
+ */
+struct FileIndex
+{
+  bool complete; // false until the walk is done, or after a name did not fit
+  uint8_t count;
+  char names[FILE_INDEX_MAX_FILES][FILE_INDEX_NAME_SIZE];
+};
+
+/**
+ * @brief Function to empty the index before the directory walk
+ * @param index file index
+ * @param complete true if the filesystem is known to hold no other files
+ * @return none
+ */
+void file_index_reset(FileIndex &index, bool complete);
+
+/**
+ * @brief Function to record a file that was found or created
+ * @param index file index
+ * @param name file path
+ * @return none
+ */
+void file_index_add(FileIndex &index, const char *name);
+
+/**
+ * @brief Function to record a file that was deleted
+ * @param index file index
+ * @param name file path
+ * @return none
+ */
+void file_index_remove(FileIndex &index, const char *name);
+
+/**
+ * @brief Function to record a rename, which replaces new_name if it exists
+ * @param index file index
+ * @param old_name old file path
+ * @param new_name new file path
+ * @return none
+ */
+void file_index_rename(FileIndex &index, const char *old_name, const char *new_name);
+
+/**
+ * @brief Function to check whether a file exists
+ * @param index file index
+ * @param name file path
+ * @return FileIndexLookup FILE_INDEX_UNKNOWN if only the filesystem knows
+ */
+FileIndexLookup file_index_lookup(const FileIndex &index, const char *name);
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef FLIGHT_RECORDER_LOG_IDS
+#define FLIGHT_RECORDER_LOG_IDS 8 // number of most recent log ids kept
+#endif
+
+#ifndef FLIGHT_RECORDER_REPORT_SIZE
+#define FLIGHT_RECORDER_REPORT_SIZE 192 // bytes kept for the report of an abnormal wake
+#endif
+
+#define FLIGHT_RECORDER_MAGIC 0x54524D4Cu // "TRML"
+
+enum FlightPhase : uint8_t
+{
+  FLIGHT_PHASE_BOOT,
+  FLIGHT_PHASE_LOGO,
+  FLIGHT_PHASE_FILESYSTEM,
+  FLIGHT_PHASE_WIFI,
+  FLIGHT_PHASE_API,
+  FLIGHT_PHASE_DOWNLOAD,
+  FLIGHT_PHASE_DECODE,
+  FLIGHT_PHASE_DISPLAY,
+  FLIGHT_PHASE_FIRMWARE_UPDATE,
+  FLIGHT_PHASE_LOG_SUBMIT,
+  FLIGHT_PHASE_SLEEP,   // about to enter deep sleep
+  FLIGHT_PHASE_RESTART, // about to call ESP.restart() on purpose
+  FLIGHT_PHASE_COUNT
+};
+
+/**
+ * State of the current wake, meant to live in RTC_NOINIT memory so that it
+ * survives panics, watchdog and software resets. On the next boot the previous
+ * wake is checked, and when it did not end in a planned sleep or restart a
+ * short text report is kept until it can be attached to a submitted log.
+ */
+struct FlightRecord
+{
+  uint32_t magic;
+  uint32_t wake_count;
+  uint8_t phase;
+  uint8_t max_alloc_low_phase; // phase in which max_alloc_low_water was sampled
+  uint8_t log_head;            // next slot in log_ids
+  uint8_t log_count;
+  uint32_t log_ids[FLIGHT_RECORDER_LOG_IDS];
+  uint32_t heap_low_water;      // lowest free heap seen during the wake
+  uint32_t max_alloc_low_water; // smallest largest-free-block seen during the wake
+  uint16_t report_length;       // 0 when no report is pending
+  char report[FLIGHT_RECORDER_REPORT_SIZE];
+};
+
+/**
+ * @brief Function to check whether a record holds data written by this firmware
+ * @param record record to check
+ * @return bool true if the magic matches and every field is in range
+ */
+bool flight_recorder_valid(const FlightRecord &record);
+
+/**
+ * @brief Function to evaluate the previous wake and start recording a new one
+ * @param record record retained from the previous wake (may be uninitialised memory)
+ * @param reset_reason value of esp_reset_reason()
+ * @param free_heap current free heap
+ * @param max_alloc current largest free block
+ * @return bool true if a report about the previous wake is pending
+ */
+bool flight_recorder_boot(FlightRecord &record, int reset_reason, uint32_t free_heap, uint32_t max_alloc);
+
+/**
+ * @brief Function to enter a new phase and sample the heap
+ * @param record record of the current wake
+ * @param phase phase being entered
+ * @param free_heap lowest free heap known so far (e.g. ESP.getMinFreeHeap())
+ * @param max_alloc current largest free block
+ * @return none
+ */
+void flight_recorder_phase(FlightRecord &record, FlightPhase phase, uint32_t free_heap, uint32_t max_alloc);
+
+/**
+ * @brief Function to remember a log call and the heap low-water mark at that point
+ * @param record record of the current wake
+ * @param log_id id of the log call (address of its format string)
+ * @param free_heap lowest free heap known so far
+ * @return none
+ */
+void flight_recorder_log(FlightRecord &record, uint32_t log_id, uint32_t free_heap);
+
+/**
+ * @brief Function to take the pending report, if any
+ * @param record record of the current wake
+ * @param out output buffer, always NUL-terminated
+ * @param out_size size of the output buffer
+ * @return size_t report length, 0 if no report was pending
+ */
+size_t flight_recorder_take_report(FlightRecord &record, char *out, size_t out_size);
+
+/**
+ * @brief Function to get the name of a phase
+ * @param phase phase
+ * @return const char* name, "unknown" when out of range
+ */
+const char *flight_phase_name(uint8_t phase);
+
+/**
+ * @brief Function to get the name of an esp_reset_reason_t value
+ * @param reset_reason value of esp_reset_reason()
+ * @return const char* name, "unknown" when not recognised
+ */
+const char *reset_reason_name(int reset_reason);
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef HEAP_TRACE_MAX_ALLOCS
+#define HEAP_TRACE_MAX_ALLOCS 24 // traced allocations kept per wake; later ones are only counted
+#endif
+
+#ifndef HEAP_TRACE_MAX_PHASES
+#define HEAP_TRACE_MAX_PHASES 12 // phases kept per wake
+#endif
+
+#ifndef HEAP_TRACE_THRESHOLD
+#define HEAP_TRACE_THRESHOLD 1024 // allocations smaller than this are not traced
+#endif
+
+/**
+ * Heap the tracer allocates from and samples. On the device this is malloc/free and
+ * heap_caps_get_free_size()/heap_caps_get_largest_free_block(); tests use a simulated heap.
+ */
+struct HeapTraceAllocator
+{
+  void *(*alloc)(size_t size);
+  void (*free)(void *ptr);
+  size_t (*free_size)(void);
+  size_t (*largest_free_block)(void);
+  uint32_t (*now_ms)(void);
+};
+
+struct HeapTraceAlloc
+{
+  const void *ptr; // nullptr once freed
+  const char *tag; // call-site tag, a string literal
+  uint32_t size;
+  uint32_t alloc_ms;
+  uint32_t free_ms;
+  uint32_t largest_free_block; // largest free block right before the allocation
+  bool failed;
+};
+
+struct HeapTracePhase
+{
+  const char *name; // string literal
+  uint32_t free_before;
+  uint32_t largest_before;
+  uint32_t free_after;
+  uint32_t largest_after;
+  bool ended;
+};
+
+typedef void (*HeapTraceSink)(const char *line);
+
+/**
+ * @brief Function to start tracing a wake, dropping whatever was recorded before
+ * @param allocator heap to allocate from and sample, or nullptr to stop tracing
+ * @param threshold smallest allocation size recorded
+ * @return none
+ */
+void heap_trace_begin(const HeapTraceAllocator *allocator, size_t threshold = HEAP_TRACE_THRESHOLD);
+
+/**
+ * @brief Function to check whether tracing is active
+ * @return bool true between heap_trace_begin() with an allocator and the next begin with nullptr
+ */
+bool heap_trace_active(void);
+
+/**
+ * @brief Function to allocate memory, recording the allocation when it is at least the threshold
+ * @param size number of bytes
+ * @param tag call-site tag (string literal), e.g. "download_buffer"
+ * @return void* memory or nullptr; plain malloc() when tracing is not active
+ */
+void *heap_trace_malloc(size_t size, const char *tag);
+
+/**
+ * @brief Function to free memory from heap_trace_malloc(), recording its lifetime
+ * @param ptr memory to free, may be nullptr
+ * @return none
+ */
+void heap_trace_free(void *ptr);
+
+/**
+ * @brief Function to end the current phase and start the next one, sampling the heap at the boundary
+ * @param name name of the phase being entered (string literal), or nullptr to only end the current one
+ * @return none
+ */
+void heap_trace_phase(const char *name);
+
+/**
+ * @brief Function to get a recorded allocation
+ * @param index index, in allocation order
+ * @return const HeapTraceAlloc* allocation or nullptr when out of range
+ */
+const HeapTraceAlloc *heap_trace_alloc_at(size_t index);
+
+/**
+ * @brief Function to get a recorded phase
+ * @param index index, in the order the phases were entered
+ * @return const HeapTracePhase* phase or nullptr when out of range
+ */
+const HeapTracePhase *heap_trace_phase_at(size_t index);
+
+/**
+ * @brief Function to get the number of traced allocations that did not fit the table
+ * @return size_t number of dropped records
+ */
+size_t heap_trace_dropped(void);
+
+/**
+ * @brief Function to write the phase table and every traced allocation, one line each
+ * @param sink callback receiving each line
+ * @return none
+ */
+void heap_trace_dump(HeapTraceSink sink);
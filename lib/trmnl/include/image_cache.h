@@ -0,0 +1,117 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define IMAGE_CACHE_VERSION 1
+
+#ifndef IMAGE_CACHE_MAX_ENTRIES
+#define IMAGE_CACHE_MAX_ENTRIES 8
+#endif
+
+#ifndef IMAGE_CACHE_KEY_SIZE
+#define IMAGE_CACHE_KEY_SIZE 64 // longer filenames are not cached
+#endif
+
+#define IMAGE_CACHE_PATH_SIZE 24
+
+enum ImageCacheFormat : uint8_t
+{
+  IMAGE_CACHE_BMP,
+  IMAGE_CACHE_PNG,
+  IMAGE_CACHE_FRAMEBUFFER, // decoded and panel-ready, sent to the display as is
+};
+
+struct ImageCacheEntry
+{
+  char key[IMAGE_CACHE_KEY_SIZE]; // filename from the API response, empty for a free entry
+  uint8_t format;
+  uint32_t size;
+  uint32_t hash;      // CRC-32 of the image file, which is also its name on flash
+  uint32_t last_used; // value of ImageCacheIndex::clock when the entry was stored or last hit
+};
+
+/**
+ * Index of the images kept on flash, written to the index file as is. It is
+ * only trusted when the version and CRC match. Files are named after the hash
+ * of their content, so two filenames with the same image share one file.
+ */
+struct ImageCacheIndex
+{
+  uint32_t version;
+  uint32_t crc;
+  uint32_t clock;
+  ImageCacheEntry entries[IMAGE_CACHE_MAX_ENTRIES];
+};
+
+/**
+ * Called for every image file that is no longer referenced by the index and can be deleted.
+ */
+typedef void (*ImageCacheEvict)(const ImageCacheEntry &entry);
+
+/**
+ * @brief Function to check whether the index was written by this firmware
+ * @param index index read from flash
+ * @return bool true if version and CRC match
+ */
+bool image_cache_valid(const ImageCacheIndex &index);
+
+/**
+ * @brief Function to empty the index and make it valid
+ * @param index index to reset
+ * @return none
+ */
+void image_cache_reset(ImageCacheIndex &index);
+
+/**
+ * @brief Function to update the CRC before the index is written to flash
+ * @param index index to seal
+ * @return none
+ */
+void image_cache_seal(ImageCacheIndex &index);
+
+/**
+ * @brief Function to look up an image and mark it as the most recently used
+ * @param index cache index
+ * @param key filename from the API response
+ * @return ImageCacheEntry* entry, or nullptr on a miss
+ */
+ImageCacheEntry *image_cache_lookup(ImageCacheIndex &index, const char *key);
+
+/**
+ * @brief Function to add an image, evicting the least recently used ones until it fits
+ * @param index cache index
+ * @param key filename from the API response
+ * @param format image format
+ * @param size image size in bytes
+ * @param hash CRC-32 of the image
+ * @param budget maximum number of bytes the cached files may take
+ * @param evict called for each file that has to be deleted
+ * @param write_file set to false if a file with the same content is already cached
+ * @return ImageCacheEntry* new entry, or nullptr if the key is too long or the image is larger than the budget
+ */
+ImageCacheEntry *image_cache_insert(ImageCacheIndex &index, const char *key, ImageCacheFormat format, uint32_t size,
+                                    uint32_t hash, uint32_t budget, ImageCacheEvict evict, bool &write_file);
+
+/**
+ * @brief Function to remove an image, e.g. when its file turned out to be unreadable
+ * @param index cache index
+ * @param key filename from the API response
+ * @param evict called if the file has to be deleted
+ * @return bool true if the key was cached
+ */
+bool image_cache_remove(ImageCacheIndex &index, const char *key, ImageCacheEvict evict);
+
+/**
+ * @brief Function to sum the size of the cached files, counting shared files once
+ * @param index cache index
+ * @return uint32_t bytes on flash
+ */
+uint32_t image_cache_bytes(const ImageCacheIndex &index);
+
+/**
+ * @brief Function to build the flash path of an entry's file
+ * @param entry cache entry
+ * @param path output buffer of at least IMAGE_CACHE_PATH_SIZE bytes
+ * @return none
+ */
+void image_cache_path(const ImageCacheEntry &entry, char *path);
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#ifndef LOG_RING_CAPACITY
+#define LOG_RING_CAPACITY 32 // number of records kept; the oldest record is overwritten when full
+#endif
+
+#ifndef LOG_RING_MAX_ARGS
+#define LOG_RING_MAX_ARGS 6 // arguments beyond this are dropped and their conversions printed verbatim
+#endif
+
+#ifndef LOG_RING_TEXT_SIZE
+#define LOG_RING_TEXT_SIZE 48 // bytes per record for copies of %s arguments
+#endif
+
+#define LOG_RING_TRUNCATED "..." // ends a %s argument that did not fit in the record
+
+/**
+ * One deferred log call. The format string is not copied: its address in flash
+ * serves as the id, so only the raw arguments are captured at the call site.
+ */
+struct LogRingRecord
+{
+  const char *format;
+  const char *file; // nullptr when built with LOG_STRIP_FILE_LINE
+  uint16_t line;
+  uint8_t level;
+  uint8_t argc;
+  uint8_t text_used;
+  uint64_t args[LOG_RING_MAX_ARGS];
+  char text[LOG_RING_TEXT_SIZE];
+};
+
+typedef void (*LogRingSink)(uint8_t level, const char *line);
+typedef void (*LogRingObserver)(const LogRingRecord &record);
+
+/**
+ * @brief Function to reserve the next record in the ring, overwriting the oldest one when full
+ * @return LogRingRecord& record with format, file, line and level unset and no arguments
+ */
+LogRingRecord &log_ring_next(void);
+
+/**
+ * @brief Function to set a callback run after every push, e.g. to keep the ids of recent calls elsewhere
+ * @param observer callback, or nullptr to remove it
+ * @return none
+ */
+void log_ring_set_observer(LogRingObserver observer);
+
+/**
+ * @brief Function to hand a freshly pushed record to the observer, if any
+ * @param record record that was pushed
+ * @return none
+ */
+void log_ring_notify(const LogRingRecord &record);
+
+/**
+ * @brief Function to hand a call that is formatted right away, not pushed, to the observer, if any
+ * @param level ArduinoLog level of the call
+ * @param file source file or nullptr
+ * @param line source line
+ * @param format printf-style format string literal
+ * @return none
+ */
+void log_ring_observe(uint8_t level, const char *file, int line, const char *format);
+
+/**
+ * @brief Function to get the number of records currently held
+ * @return size_t number of records
+ */
+size_t log_ring_count(void);
+
+/**
+ * @brief Function to drop all records
+ * @return none
+ */
+void log_ring_clear(void);
+
+/**
+ * @brief Function to format a record the way printf would have formatted it at the call site
+ * @param record record to format
+ * @param out output buffer, always NUL-terminated
+ * @param out_size size of the output buffer
+ * @return size_t number of characters written, excluding the terminator
+ */
+size_t log_ring_format(const LogRingRecord &record, char *out, size_t out_size);
+
+/**
+ * @brief Function to format every record, oldest first, hand it to the sink and clear the ring
+ * @param sink callback receiving the level and the formatted line ("file [line]: message")
+ * @return size_t number of records dumped
+ */
+size_t log_ring_dump(LogRingSink sink);
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+log_ring_capture(LogRingRecord &record, T value)
+{
+  record.args[record.argc++] = (uint64_t)(int64_t)value;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type
+log_ring_capture(LogRingRecord &record, T value)
+{
+  double d = value;
+  memcpy(&record.args[record.argc++], &d, sizeof(d));
+}
+
+inline void log_ring_capture(LogRingRecord &record, const char *value)
+{
+  // %s arguments may point at stack buffers, so the characters are copied; the
+  // argument slot holds the offset into record.text. Arguments that do not fit
+  // (URLs, long filenames) are cut and end in LOG_RING_TRUNCATED.
+  const size_t marker = sizeof(LOG_RING_TRUNCATED) - 1;
+  size_t offset = record.text_used;
+  size_t room = sizeof(record.text) - offset;
+  if (!value)
+    value = "(null)";
+  if (room > marker)
+  {
+    size_t len = strnlen(value, room - 1);
+    memcpy(record.text + offset, value, len);
+    if (value[len] != '\0')
+      memcpy(record.text + offset + len - marker, LOG_RING_TRUNCATED, marker);
+    record.text[offset + len] = '\0';
+    record.text_used += len + 1;
+  }
+  else if (*value)
+  {
+    offset = sizeof(record.text); // no room left at all: formatted as LOG_RING_TRUNCATED
+  }
+  else if (offset > 0)
+  {
+    offset--; // the terminator of the previous argument
+  }
+  record.args[record.argc++] = offset;
+}
+
+inline void log_ring_capture(LogRingRecord &record, char *value)
+{
+  log_ring_capture(record, (const char *)value);
+}
+
+inline void log_ring_capture(LogRingRecord &record, const String &value)
+{
+  log_ring_capture(record, value.c_str());
+}
+
+inline void log_ring_capture(LogRingRecord &record, const void *value)
+{
+  record.args[record.argc++] = (uintptr_t)value;
+}
+
+inline void log_ring_capture_all(LogRingRecord &record) {}
+
+template <typename T, typename... Rest>
+inline void log_ring_capture_all(LogRingRecord &record, const T &value, const Rest &...rest)
+{
+  if (record.argc >= LOG_RING_MAX_ARGS)
+    return;
+  log_ring_capture(record, value);
+  log_ring_capture_all(record, rest...);
+}
+
+/**
+ * @brief Function to store a log call without formatting it
+ * @param level ArduinoLog level of the call
+ * @param file source file or nullptr
+ * @param line source line
+ * @param format printf-style format string literal
+ * @return none
+ */
+template <typename... Args>
+void log_ring_push(uint8_t level, const char *file, int line, const char *format, const Args &...args)
+{
+  LogRingRecord &record = log_ring_next();
+  record.format = format;
+  record.file = file;
+  record.line = line;
+  record.level = level;
+  log_ring_capture_all(record, args...);
+  log_ring_notify(record);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * LZSS with a 256 byte window, used for the images built into the firmware
+ * (see scripts/compress_assets.py). The stream is a sequence of operations,
+ * each starting with a control byte c:
+ *
+ *   c < 0x80   c + 1 literal bytes follow
+ *   c >= 0x80  (c & 0x7F) + 3 bytes are copied from d + 1 bytes back, d is the next byte
+ *
+ * A copy may overlap the bytes it produces, so a copy from 1 byte back is a run.
+ * The decoder keeps the window itself and can stop anywhere, so the output
+ * is produced in pieces straight into its destination, e.g. a framebuffer row
+ * at a time.
+ */
+
+#define LZSS_WINDOW 256
+#define LZSS_MIN_MATCH 3
+#define LZSS_MAX_MATCH (0x7F + LZSS_MIN_MATCH)
+#define LZSS_MAX_LITERALS 0x80
+
+struct LzssDecoder
+{
+  const uint8_t *src;
+  const uint8_t *end;
+  uint32_t produced; // bytes decoded so far, copies may not reach further back
+  uint8_t window[LZSS_WINDOW];
+  uint8_t literals; // literal bytes left of the current operation
+  uint8_t copy;     // bytes left to copy of the current operation
+  uint8_t distance; // of the current copy, minus one
+  bool error;
+};
+
+/**
+ * @brief Function to start decoding a stream
+ * @param decoder decoder state
+ * @param data compressed stream, must stay valid while decoding
+ * @param size size of the stream
+ * @return none
+ */
+void lzss_decoder_init(LzssDecoder &decoder, const uint8_t *data, size_t size);
+
+/**
+ * @brief Function to decode the next bytes of the stream
+ * @param decoder decoder state
+ * @param out destination
+ * @param size number of bytes wanted
+ * @return size_t bytes written; less than size at the end of the stream or if it is corrupt (decoder.error)
+ */
+size_t lzss_decode(LzssDecoder &decoder, uint8_t *out, size_t size);
@@ -17,6 +17,12 @@ private:
 public:
   Logging() {}
 
+  // ArduinoLog's setup; the mock always prints to stdout
+  template <typename Printer>
+  void begin(int level, Printer *output)
+  {
+  }
+
   void fatal(const char *msg, ...)
   {
     va_list args;
@@ -33,6 +39,14 @@ public:
     va_end(args);
   }
 
+  void warning(const char *msg, ...)
+  {
+    va_list args;
+    va_start(args, msg);
+    logImpl("WARNING", msg, args);
+    va_end(args);
+  }
+
   void info(const char *msg, ...)
   {
     va_list args;
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <lzss.h>
+#include <sha256.h>
+
+/**
+ * Firmware patch: the new image described against the one the device runs,
+ * made by scripts/make_firmware_patch.py. It is a header followed by one
+ * block per OTA_DELTA_BLOCK_SIZE bytes of the new image, the last one
+ * shorter. All numbers are little endian.
+ *
+ *   header  magic, source size, SHA-256 of the source image, target size
+ *   block   source offset, packed size, then packed bytes
+ *
+ * The packed bytes are an LZSS stream (see lzss.h) of the block's length.
+ * With a source offset they are the difference, byte by byte modulo 256,
+ * between the new image and the running one from that offset: code that
+ * only moved or had a few addresses change is mostly zeros, which LZSS
+ * turns into runs. With OTA_DELTA_NO_SOURCE they are the new bytes.
+ *
+ * A block is one flash sector, applied on its own, so a patch can be
+ * applied as it is downloaded and resumed between any two blocks.
+ */
+
+#define OTA_DELTA_MAGIC 0x50445254 // "TRDP"
+#define OTA_DELTA_BLOCK_SIZE 4096
+#define OTA_DELTA_NO_SOURCE 0xFFFFFFFF
+#define OTA_DELTA_HEADER_SIZE (4 + 4 + SHA256_DIGEST_SIZE + 4)
+#define OTA_DELTA_BLOCK_HEADER_SIZE (4 + 4)
+// a block of literals only
+#define OTA_DELTA_MAX_PACKED (OTA_DELTA_BLOCK_SIZE + OTA_DELTA_BLOCK_SIZE / LZSS_MAX_LITERALS)
+
+struct OtaDeltaHeader
+{
+  uint32_t source_size;
+  uint8_t source_sha256[SHA256_DIGEST_SIZE];
+  uint32_t target_size;
+};
+
+struct OtaDeltaBlock
+{
+  uint32_t source; // offset in the running image, OTA_DELTA_NO_SOURCE for new bytes
+  uint32_t packed; // size of the LZSS stream that follows
+};
+
+/**
+ * @brief Function to read the header of a patch
+ * @param data OTA_DELTA_HEADER_SIZE bytes
+ * @param header set to the header
+ * @return bool false if this is not a firmware patch
+ */
+bool ota_delta_header(const uint8_t *data, OtaDeltaHeader &header);
+
+/**
+ * @brief Function to get the length of the block that produces the image from an offset
+ * @param target_size size of the new image
+ * @param offset offset in the new image, a multiple of OTA_DELTA_BLOCK_SIZE
+ * @return uint32_t bytes of the new image in the block, 0 past the end
+ */
+uint32_t ota_delta_block_length(uint32_t target_size, uint32_t offset);
+
+/**
+ * @brief Function to read and check the header of a block
+ * @param data OTA_DELTA_BLOCK_HEADER_SIZE bytes
+ * @param length bytes the block produces, from ota_delta_block_length()
+ * @param source_size size of the running image
+ * @param block set to the block header
+ * @return bool false if the block reads outside the running image or its packed size is impossible
+ */
+bool ota_delta_block(const uint8_t *data, uint32_t length, uint32_t source_size, OtaDeltaBlock &block);
+
+/**
+ * @brief Function to produce the next bytes of a block
+ * @param decoder decoder started with lzss_decoder_init() on the packed bytes of the block
+ * @param source the same number of bytes of the running image, nullptr for a block without source
+ * @param out destination
+ * @param size number of bytes wanted
+ * @return size_t bytes produced; less than size if the packed bytes are corrupt or too short
+ */
+size_t ota_delta_decode(LzssDecoder &decoder, const uint8_t *source, uint8_t *out, size_t size);
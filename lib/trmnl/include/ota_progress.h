@@ -0,0 +1,87 @@
+#pragma once
+
+#include <sha256.h>
+
+/**
+ * Progress of a firmware download, saved so that an interrupted one picks up
+ * where it stopped instead of starting over. The image is written straight
+ * into the next app partition and hashed as it comes; at every checkpoint
+ * the byte count and the SHA-256 state are saved, and the next attempt asks
+ * the server for the rest with a Range header. Checkpoints fall on flash
+ * sector and SHA-256 block boundaries, so nothing else needs saving.
+ *
+ * The download is the image itself or a patch against the running image
+ * (see ota_delta.h); for a patch the bytes received and the bytes written
+ * differ, and checkpoints fall between its blocks.
+ *
+ * A progress record only resumes the download of the same image: the same
+ * URL with the same expected hash.
+ */
+
+#define OTA_PROGRESS_MAGIC 0x4F544150 // "OTAP"
+
+#ifndef OTA_CHECKPOINT_SIZE
+#define OTA_CHECKPOINT_SIZE 0x10000 // 16 flash sectors
+#endif
+
+struct OtaProgress
+{
+  uint32_t magic;
+  uint32_t image;        // ota_image_id() of the download
+  uint32_t size;         // image size, 0 until a response told it
+  uint32_t written;      // bytes in the partition and the hash, a multiple of OTA_CHECKPOINT_SIZE
+  uint32_t sha_state[8]; // Sha256::state after written bytes
+  uint32_t attempts;     // connections made for this image
+  uint32_t received;     // bytes of the download at the checkpoint, written for a whole image
+  uint32_t length;       // size of the download, 0 until a response told it
+};
+
+/**
+ * @brief Function to identify an image
+ * @param url firmware URL
+ * @param sha256_hex expected SHA-256, empty if the server sent none
+ * @return uint32_t identifier
+ */
+uint32_t ota_image_id(const char *url, const char *sha256_hex);
+
+/**
+ * @brief Function to start the progress of a download from the first byte
+ * @param progress progress to reset
+ * @param image ota_image_id() of the download
+ * @return none
+ */
+void ota_progress_start(OtaProgress &progress, uint32_t image);
+
+/**
+ * @brief Function to check that saved progress belongs to a download and can be resumed
+ * @param progress saved progress
+ * @param image ota_image_id() of the download
+ * @return bool true if the download can continue from progress.written
+ */
+bool ota_progress_resumes(const OtaProgress &progress, uint32_t image);
+
+/**
+ * @brief Function to record a checkpoint
+ * @param progress progress to update
+ * @param sha hash of the bytes written so far
+ * @param received bytes of the download that produced them
+ * @return bool false, and progress unchanged, if the hash is not at a checkpoint
+ */
+bool ota_progress_checkpoint(OtaProgress &progress, const Sha256 &sha, uint32_t received);
+
+/**
+ * @brief Function to continue the hash of a download from its progress
+ * @param progress progress
+ * @param sha context to set up
+ * @return none
+ */
+void ota_progress_hash(const OtaProgress &progress, Sha256 &sha);
+
+/**
+ * @brief Function to parse the Content-Range header of a 206 response
+ * @param header e.g. "bytes 65536-1310719/1310720"
+ * @param start set to the first byte of the body
+ * @param total set to the size of the whole file
+ * @return bool false if the header is missing, malformed or does not give the total size
+ */
+bool ota_parse_content_range(const char *header, uint32_t &start, uint32_t &total);
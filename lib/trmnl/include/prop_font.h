@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Proportional 1bpp bitmap fonts with UTF-8 text. Each glyph has its own
+ * width and advance; its bitmap is `height` rows of (width + 7) / 8 bytes,
+ * most significant bit first. Codepoints map to glyphs through a short list
+ * of ranges. Fonts are generated by scripts/prop_font.py.
+ */
+
+struct PropGlyph
+{
+  uint16_t offset; // first byte of the bitmap in PropFont::bitmaps
+  uint8_t width;   // bitmap width in pixels, 0 for blank glyphs
+  uint8_t advance; // pen movement after the glyph
+  int8_t x_offset; // bitmap position relative to the pen
+};
+
+struct PropFontRange
+{
+  uint32_t first; // first codepoint of the range
+  uint16_t count;
+  uint16_t glyph; // glyph index of the first codepoint
+};
+
+struct PropFont
+{
+  const uint8_t *bitmaps;
+  const PropGlyph *glyphs;
+  const PropFontRange *ranges;
+  uint8_t range_count;
+  uint8_t height;
+  uint16_t fallback; // glyph drawn for codepoints the font does not have
+};
+
+/** A line of wrapped text: a slice of the original string */
+struct PropFontLine
+{
+  const char *start;
+  uint16_t length; // bytes
+  uint16_t width;  // pixels
+};
+
+extern const PropFont PropFont24;
+
+#define UTF8_REPLACEMENT 0xFFFD
+
+/**
+ * @brief Function to decode the next character of a UTF-8 string
+ * @param text read position, moved past the character; never moved past the terminating NUL
+ * @return uint32_t codepoint, 0 at the end, UTF8_REPLACEMENT for a malformed sequence
+ */
+uint32_t utf8_next(const char *&text);
+
+/**
+ * @brief Function to find the glyph of a codepoint
+ * Accented Latin-1 letters the font lacks are drawn as their base letter.
+ * @param font font
+ * @param codepoint Unicode codepoint
+ * @return const PropGlyph& glyph, the fallback glyph if there is none
+ */
+const PropGlyph &prop_font_glyph(const PropFont &font, uint32_t codepoint);
+
+/**
+ * @brief Function to measure a piece of text
+ * @param font font
+ * @param text UTF-8 text
+ * @param length number of bytes to measure
+ * @return uint16_t sum of the advances in pixels
+ */
+uint16_t prop_font_text_width(const PropFont &font, const char *text, size_t length);
+
+/**
+ * @brief Function to break text into lines at spaces and newlines
+ * Words wider than a line are broken between characters. Text that does not
+ * fit in max_lines is dropped.
+ * @param font font
+ * @param text UTF-8 text
+ * @param max_width line width in pixels
+ * @param lines output lines
+ * @param max_lines size of lines
+ * @return size_t number of lines filled
+ */
+size_t prop_font_wrap(const PropFont &font, const char *text, uint16_t max_width, PropFontLine *lines, size_t max_lines);
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Choice between the fast and the full (standard) waveform for each panel
+ * refresh. Fast refreshes leave a little ghosting that adds up, so a full
+ * refresh is forced every REFRESH_FULL_EVERY refreshes, on any wake that is
+ * not the timer, when the temperature moved since the last full refresh and
+ * when most of the image changed.
+ *
+ * The image on the panel is remembered as a CRC per horizontal band, which
+ * is enough to estimate how much of it changed without keeping the previous
+ * framebuffer. RefreshState is meant to live in RTC_DATA_ATTR memory; it is
+ * zeroed on power-on, which never validates, so the first refresh is full.
+ */
+
+#ifndef REFRESH_FULL_EVERY
+#define REFRESH_FULL_EVERY 10 // fast refreshes between two full ones
+#endif
+
+#ifndef REFRESH_TEMPERATURE_DELTA
+#define REFRESH_TEMPERATURE_DELTA 5 // degrees C away from the last full refresh
+#endif
+
+#ifndef REFRESH_DIRTY_PERCENT
+#define REFRESH_DIRTY_PERCENT 50 // share of the bands that changed
+#endif
+
+#define REFRESH_BANDS 48
+#define REFRESH_NO_TEMPERATURE INT16_MIN
+#define REFRESH_STATE_MAGIC 0x52465348
+
+enum RefreshChoice : uint8_t
+{
+  REFRESH_FAST,
+  REFRESH_FULL_FIRST,       // nothing is known about the image on the panel
+  REFRESH_FULL_WAKE,        // woken by the button or power-on
+  REFRESH_FULL_COUNT,       // REFRESH_FULL_EVERY fast refreshes in a row
+  REFRESH_FULL_TEMPERATURE, // waveforms depend on temperature
+  REFRESH_FULL_DIRTY,       // most of the image changed
+};
+
+struct RefreshState
+{
+  uint32_t magic;
+  uint16_t fast_count;           // fast refreshes since the last full one
+  int16_t temperature;           // at the last full refresh
+  uint8_t dirty_percent;         // of the last refresh, 0 if unknown: a guess for the next one before its image is known
+  uint32_t bands[REFRESH_BANDS]; // CRC of each band of the image on the panel
+};
+
+/**
+ * @brief Function to add framebuffer bytes to the band CRCs
+ * Start with bands zeroed; the framebuffer can be passed whole or in pieces.
+ * @param bands REFRESH_BANDS CRCs
+ * @param frame_size size of the whole framebuffer
+ * @param offset position of data in the framebuffer
+ * @param data framebuffer bytes
+ * @param size number of bytes
+ * @return none
+ */
+void refresh_bands_update(uint32_t *bands, size_t frame_size, size_t offset, const uint8_t *data, size_t size);
+
+/**
+ * @brief Function to estimate how much of the image changes
+ * @param state state of the panel
+ * @param bands band CRCs of the new image
+ * @return uint8_t percentage of the bands that differ, 100 if the image on the panel is unknown
+ */
+uint8_t refresh_dirty_percent(const RefreshState &state, const uint32_t *bands);
+
+/**
+ * @brief Function to choose the waveform of the next refresh
+ * @param state state of the panel
+ * @param timer_wake true if the device woke up from the sleep timer
+ * @param temperature degrees C, REFRESH_NO_TEMPERATURE if unknown
+ * @param dirty_percent from refresh_dirty_percent(), 0 if unknown
+ * @return RefreshChoice REFRESH_FAST or the reason for a full refresh
+ */
+RefreshChoice refresh_choose(const RefreshState &state, bool timer_wake, int16_t temperature, uint8_t dirty_percent);
+
+/**
+ * @brief Function to remember a refresh
+ * @param state state of the panel
+ * @param full true for a full refresh
+ * @param temperature degrees C, REFRESH_NO_TEMPERATURE if unknown
+ * @param bands band CRCs of the image shown
+ * @return none
+ */
+void refresh_record(RefreshState &state, bool full, int16_t temperature, const uint32_t *bands);
+
+/**
+ * @brief Function to name a choice for the log
+ * @param choice choice
+ * @return const char* short name
+ */
+const char *refresh_choice_name(RefreshChoice choice);
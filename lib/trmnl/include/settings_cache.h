@@ -0,0 +1,111 @@
+#pragma once
+
+#include <Arduino.h>
+
+#ifndef SETTINGS_CACHE_MAX_ENTRIES
+#define SETTINGS_CACHE_MAX_ENTRIES 16
+#endif
+
+enum class SettingType : uint8_t
+{
+  Bool,
+  Int,
+  UInt,
+  String,
+};
+
+struct SettingDef
+{
+  const char *key;
+  SettingType type;
+  bool volatile_state; // only needs to survive deep sleep: kept in the volatile store when there is one
+};
+
+/**
+ * Persistent key-value store behind the cache; on the device this wraps Preferences (NVS).
+ * Getters are only called for keys that exist.
+ */
+class SettingsStore
+{
+public:
+  virtual ~SettingsStore() {}
+  virtual bool isKey(const char *key) = 0;
+  virtual bool getBool(const char *key) = 0;
+  virtual int32_t getInt(const char *key) = 0;
+  virtual uint32_t getUInt(const char *key) = 0;
+  virtual String getString(const char *key) = 0;
+  virtual size_t putBool(const char *key, bool value) = 0;
+  virtual size_t putInt(const char *key, int32_t value) = 0;
+  virtual size_t putUInt(const char *key, uint32_t value) = 0;
+  virtual size_t putString(const char *key, const String &value) = 0;
+  virtual bool remove(const char *key) = 0;
+};
+
+/**
+ * RAM copy of the settings listed in a SettingDef table, loaded once per wake.
+ * Reads never touch flash; writes only mark the entry dirty (and only when the
+ * value actually changes) and are written to the store together by commit().
+ * Keys missing from the table are passed through to the store unchanged.
+ *
+ * Entries marked volatile_state are read from and written to the optional
+ * volatile store (RTC memory on the device) instead; they fall back to the
+ * persistent store when the volatile store does not hold them, e.g. after a
+ * power loss, or when a value does not fit in it.
+ *
+ * The put* functions return what Preferences would have returned for a
+ * successful write (the number of bytes), so existing checks keep working.
+ */
+class SettingsCache
+{
+public:
+  SettingsCache(SettingsStore &store, const SettingDef *defs, size_t count, SettingsStore *volatile_store = nullptr);
+
+  /**
+   * @brief Function to read every key in the table from the store, dropping unsaved changes
+   * @return none
+   */
+  void load(void);
+
+  /**
+   * @brief Function to write every changed entry to its store
+   * @return size_t number of entries written to the persistent store
+   */
+  size_t commit(void);
+
+  /**
+   * @brief Function to check for changes not yet written to the store
+   * @return bool true if commit() has something to write
+   */
+  bool dirty(void) const;
+
+  bool isKey(const char *key);
+  bool getBool(const char *key, bool default_value = false);
+  int32_t getInt(const char *key, int32_t default_value = 0);
+  uint32_t getUInt(const char *key, uint32_t default_value = 0);
+  String getString(const char *key, const String &default_value = String());
+  size_t putBool(const char *key, bool value);
+  size_t putInt(const char *key, int32_t value);
+  size_t putUInt(const char *key, uint32_t value);
+  size_t putString(const char *key, const String &value);
+  bool remove(const char *key);
+
+private:
+  struct Entry
+  {
+    const SettingDef *def;
+    bool present;
+    bool dirty;
+    int64_t number; // Bool, Int and UInt values
+    String text;    // String values
+  };
+
+  Entry *find(const char *key);
+  size_t putNumber(const char *key, int64_t value, size_t size);
+  static void read(SettingsStore &from, Entry &entry);
+  static size_t write(SettingsStore &to, const Entry &entry);
+
+  SettingsStore &store;
+  SettingsStore *volatile_store;
+  Entry entries[SETTINGS_CACHE_MAX_ENTRIES];
+  size_t entry_count;
+};
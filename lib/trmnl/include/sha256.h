@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_DIGEST_SIZE 32
+#define SHA256_BLOCK_SIZE 64
+
+/**
+ * SHA-256 (FIPS 180-4) fed in pieces. The state after a whole number of
+ * blocks is just the eight words of state, so a hash can be saved and
+ * resumed later with sha256_resume().
+ */
+struct Sha256
+{
+  uint32_t state[8];
+  uint64_t length; // bytes hashed so far
+  uint8_t block[SHA256_BLOCK_SIZE];
+};
+
+/**
+ * @brief Function to start a hash
+ * @param sha context
+ * @return none
+ */
+void sha256_init(Sha256 &sha);
+
+/**
+ * @brief Function to continue a hash saved at a block boundary
+ * @param sha context
+ * @param state sha.state when it was saved
+ * @param length bytes hashed when it was saved, a multiple of SHA256_BLOCK_SIZE
+ * @return bool false if length is not on a block boundary
+ */
+bool sha256_resume(Sha256 &sha, const uint32_t *state, uint64_t length);
+
+/**
+ * @brief Function to hash more bytes
+ * @param sha context
+ * @param data input bytes
+ * @param size number of bytes
+ * @return none
+ */
+void sha256_update(Sha256 &sha, const uint8_t *data, size_t size);
+
+/**
+ * @brief Function to end a hash
+ * @param sha context, to be started again before reuse
+ * @param digest SHA256_DIGEST_SIZE bytes
+ * @return none
+ */
+void sha256_finish(Sha256 &sha, uint8_t *digest);
+
+/**
+ * @brief Function to compare a digest with its hex form
+ * @param digest SHA256_DIGEST_SIZE bytes
+ * @param hex 64 hex digits, either case
+ * @return bool true if they match
+ */
+bool sha256_matches_hex(const uint8_t *digest, const char *hex);
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Length of the timer sleep after a successful /api/display poll. The
+ * server's refresh rate is the shortest sleep; the device stretches it when
+ * waking up that often is wasted:
+ *   - the image is polled at half the interval it was seen to change at, so
+ *     a screen that changes hourly is not polled every 15 minutes,
+ *   - as the battery drops from SCHEDULE_BATTERY_FULL_MV to
+ *     SCHEDULE_BATTERY_LOW_MV the sleep grows up to SCHEDULE_BATTERY_STRETCH
+ *     times,
+ *   - during the server's quiet hours the device sleeps until they end.
+ * Apart from quiet hours the sleep stays under SCHEDULE_MAX_STRETCH times the
+ * refresh rate, so a new image still shows within that.
+ *
+ * ScheduleState is meant to live in RTC_DATA_ATTR memory; it is zeroed on
+ * power-on, which never validates, so the change interval is learnt again.
+ */
+
+#ifndef SCHEDULE_MAX_STRETCH
+#define SCHEDULE_MAX_STRETCH 4 // longest sleep, in refresh rates
+#endif
+
+#ifndef SCHEDULE_BATTERY_FULL_MV
+#define SCHEDULE_BATTERY_FULL_MV 3700 // no stretch above
+#endif
+
+#ifndef SCHEDULE_BATTERY_LOW_MV
+#define SCHEDULE_BATTERY_LOW_MV 3400 // full stretch below
+#endif
+
+#ifndef SCHEDULE_BATTERY_STRETCH
+#define SCHEDULE_BATTERY_STRETCH 3
+#endif
+
+#define SCHEDULE_CHANGES_TO_LEARN 2 // changes seen before the interval between them is trusted
+#define SCHEDULE_NO_TIME -1
+#define SCHEDULE_DAY_S 86400
+#define SCHEDULE_STATE_MAGIC 0x53434844
+
+enum ScheduleReason : uint8_t
+{
+  SCHEDULE_SERVER,      // the refresh rate as it is
+  SCHEDULE_CHANGE_RATE, // the image changes less often than it is polled
+  SCHEDULE_BATTERY,     // the battery is low
+  SCHEDULE_QUIET,       // quiet hours
+};
+
+struct ScheduleState
+{
+  uint32_t magic;
+  uint32_t unchanged_s;       // slept since the image last changed
+  uint32_t change_interval_s; // average time between two changes
+  uint32_t sleep_s;           // last sleep scheduled
+  uint16_t changes;           // changes seen, up to SCHEDULE_CHANGES_TO_LEARN
+};
+
+struct ScheduleInputs
+{
+  uint32_t refresh_rate; // seconds, from the server
+  uint32_t battery_mv;   // 0 if unknown
+  int32_t time_of_day;   // seconds after midnight UTC, SCHEDULE_NO_TIME if the clock is not set
+  uint16_t quiet_start;  // minutes after midnight UTC
+  uint16_t quiet_end;    // same as quiet_start for no quiet hours
+};
+
+/**
+ * @brief Function to remember the outcome of a poll
+ * @param state schedule state
+ * @param changed true if the server sent a new image
+ * @param slept_s time slept before this poll, 0 if unknown to use the last sleep scheduled
+ * @return none
+ */
+void schedule_observe(ScheduleState &state, bool changed, uint32_t slept_s);
+
+/**
+ * @brief Function to choose the next sleep
+ * The sleep is remembered for schedule_observe().
+ * @param state schedule state
+ * @param inputs refresh rate, battery and time
+ * @param reason set to what made the sleep longer than the refresh rate
+ * @return uint32_t seconds to sleep, never less than the refresh rate
+ */
+uint32_t schedule_sleep(ScheduleState &state, const ScheduleInputs &inputs, ScheduleReason &reason);
+
+/**
+ * @brief Function to name a reason for the log
+ * @param reason reason
+ * @return const char* short name
+ */
+const char *schedule_reason_name(ScheduleReason reason);
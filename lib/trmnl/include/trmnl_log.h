@@ -1,3 +1,4 @@
+#pragma once
 
 #ifdef PIO_UNIT_TESTING
 #include <mock_log.h>
@@ -5,10 +6,144 @@
 #include <ArduinoLog.h>
 #endif
 
-#define Log_verbose(format, ...) Log.verbose("%s [%d]: " format "\r\n", __FILE__, __LINE__, ##__VA_ARGS__)
+#include <log_ring.h>
 
-#define Log_info(format, ...) Log.info("%s [%d]: " format "\r\n", __FILE__, __LINE__, ##__VA_ARGS__)
+/*
+ * Build options (platformio.ini build_flags):
+ *   LOG_MIN_LEVEL=<level>  drop every call below this level at compile time (default: verbose)
+ *   LOG_STRIP_FILE_LINE    don't emit __FILE__/__LINE__, keeping the path strings out of flash
+ *   LOG_DEFERRED           store calls in the RAM log ring (log_ring.h) instead of formatting
+ *                          them to serial; the ring is formatted only by Log_flush()
+ *
+ * A module can raise its own floor by defining LOG_MODULE_LEVEL before including this header.
+ */
 
-#define Log_error(format, ...) Log.error("%s [%d]: " format "\r\n", __FILE__, __LINE__, ##__VA_ARGS__)
+#ifndef LOG_LEVEL_VERBOSE
+#define LOG_LEVEL_SILENT 0
+#define LOG_LEVEL_FATAL 1
+#define LOG_LEVEL_ERROR 2
+#define LOG_LEVEL_WARNING 3
+#define LOG_LEVEL_INFO 4
+#define LOG_LEVEL_TRACE 5
+#define LOG_LEVEL_VERBOSE 6
+#endif
+
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_VERBOSE
+#endif
+
+#if !defined(LOG_MODULE_LEVEL) || LOG_MODULE_LEVEL > LOG_MIN_LEVEL
+#undef LOG_MODULE_LEVEL
+#define LOG_MODULE_LEVEL LOG_MIN_LEVEL
+#endif
+
+#ifdef LOG_STRIP_FILE_LINE
+#define LOG_SOURCE_FILE nullptr
+#define Log_immediate(method, format, ...) Log.method(format "\r\n", ##__VA_ARGS__)
+#else
+#define LOG_SOURCE_FILE __FILE__
+#define Log_immediate(method, format, ...) Log.method("%s [%d]: " format "\r\n", __FILE__, __LINE__, ##__VA_ARGS__)
+#endif
+
+#define Log_deferred(level, format, ...) log_ring_push(level, LOG_SOURCE_FILE, __LINE__, format, ##__VA_ARGS__)
+
+// Either way the ring observer sees the call, so the ids of recent calls are kept in every build
+#ifdef LOG_DEFERRED
+#define Log_at(method, level, format, ...) Log_deferred(level, format, ##__VA_ARGS__)
+#else
+#define Log_at(method, level, format, ...)                      \
+  do                                                            \
+  {                                                             \
+    log_ring_observe(level, LOG_SOURCE_FILE, __LINE__, format); \
+    Log_immediate(method, format, ##__VA_ARGS__);               \
+  } while (0)
+#endif
+
+// Replays a ring record at the level it was logged with, as an immediate build would have
+inline void log_ring_print_line(uint8_t level, const char *line)
+{
+  switch (level)
+  {
+  case LOG_LEVEL_FATAL:
+    Log.fatal("%s\r\n", line);
+    break;
+  case LOG_LEVEL_ERROR:
+    Log.error("%s\r\n", line);
+    break;
+  case LOG_LEVEL_WARNING:
+    Log.warning("%s\r\n", line);
+    break;
+  case LOG_LEVEL_INFO:
+    Log.info("%s\r\n", line);
+    break;
+  default:
+    Log.verbose("%s\r\n", line);
+    break;
+  }
+}
+
+// Formats whatever the ring holds; a no-op unless built with LOG_DEFERRED
+#ifdef LOG_DEFERRED
+#define Log_flush() log_ring_dump(log_ring_print_line)
+#else
+#define Log_flush() \
+  do                \
+  {                 \
+  } while (0)
+#endif
 
-#define Log_fatal(format, ...) Log.fatal("%s [%d]: " format "\r\n", __FILE__, __LINE__, ##__VA_ARGS__)
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_VERBOSE
+#define Log_verbose(format, ...) Log_at(verbose, LOG_LEVEL_VERBOSE, format, ##__VA_ARGS__)
+#else
+#define Log_verbose(format, ...) \
+  do                             \
+  {                              \
+  } while (0)
+#endif
+
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_INFO
+#define Log_info(format, ...) Log_at(info, LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#else
+#define Log_info(format, ...) \
+  do                          \
+  {                           \
+  } while (0)
+#endif
+
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_WARNING
+#define Log_warning(format, ...) Log_at(warning, LOG_LEVEL_WARNING, format, ##__VA_ARGS__)
+#else
+#define Log_warning(format, ...) \
+  do                             \
+  {                              \
+  } while (0)
+#endif
+
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_ERROR
+#define Log_error(format, ...) Log_at(error, LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#else
+#define Log_error(format, ...) \
+  do                           \
+  {                            \
+  } while (0)
+#endif
+
+// Fatal calls usually precede ESP.restart(), so they are never left unformatted:
+// deferred builds push the call (so ring observers see it) and flush right away
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_FATAL
+#ifdef LOG_DEFERRED
+#define Log_fatal(format, ...)                            \
+  do                                                      \
+  {                                                       \
+    Log_deferred(LOG_LEVEL_FATAL, format, ##__VA_ARGS__); \
+    Log_flush();                                          \
+  } while (0)
+#else
+#define Log_fatal(format, ...) Log_at(fatal, LOG_LEVEL_FATAL, format, ##__VA_ARGS__)
+#endif
+#else
+#define Log_fatal(format, ...) \
+  do                           \
+  {                            \
+  } while (0)
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <settings_cache.h>
+
+#define WAKE_STATE_VERSION 1
+
+#ifndef WAKE_STATE_SLOTS
+#define WAKE_STATE_SLOTS 6
+#endif
+
+#ifndef WAKE_STATE_TEXT_SIZE
+#define WAKE_STATE_TEXT_SIZE 80 // longer strings don't fit and are kept in NVS instead
+#endif
+
+struct WakeStateSlot
+{
+  char key[16]; // NVS keys are at most 15 characters
+  uint8_t is_text;
+  uint32_t number;
+  char text[WAKE_STATE_TEXT_SIZE];
+};
+
+/**
+ * Block of state that only has to survive deep sleep, meant to live in
+ * RTC_DATA_ATTR memory. It is only trusted when the version and CRC match:
+ * RTC memory is zeroed on power-on, which never validates.
+ */
+struct WakeState
+{
+  uint32_t version;
+  uint32_t crc;
+  WakeStateSlot slots[WAKE_STATE_SLOTS];
+};
+
+/**
+ * @brief Function to compute the CRC-32 (IEEE) of a buffer
+ * @param data input bytes
+ * @param size number of bytes
+ * @return uint32_t CRC
+ */
+uint32_t wake_state_crc32(const uint8_t *data, size_t size);
+
+/**
+ * @brief Function to extend a CRC-32 with more data, for buffers read in pieces
+ * @param crc CRC of the data so far, 0 for none
+ * @param data input bytes
+ * @param size number of bytes
+ * @return uint32_t CRC of all the data
+ */
+uint32_t wake_state_crc32_update(uint32_t crc, const uint8_t *data, size_t size);
+
+/**
+ * @brief Function to check whether the block holds state written by this firmware
+ * @param state block to check
+ * @return bool true if version and CRC match
+ */
+bool wake_state_valid(const WakeState &state);
+
+/**
+ * @brief Function to empty the block and make it valid
+ * @param state block to reset
+ * @return none
+ */
+void wake_state_reset(WakeState &state);
+
+/**
+ * SettingsStore over a WakeState block. An invalid block is reset on construction,
+ * so it reports no keys and every setting falls back to the persistent store.
+ */
+class WakeStateStore : public SettingsStore
+{
+public:
+  explicit WakeStateStore(WakeState &state);
+
+  bool isKey(const char *key) override;
+  bool getBool(const char *key) override;
+  int32_t getInt(const char *key) override;
+  uint32_t getUInt(const char *key) override;
+  String getString(const char *key) override;
+  size_t putBool(const char *key, bool value) override;
+  size_t putInt(const char *key, int32_t value) override;
+  size_t putUInt(const char *key, uint32_t value) override;
+  size_t putString(const char *key, const String &value) override;
+  bool remove(const char *key) override;
+
+  /**
+   * @brief Function to check whether the block was valid when the store was created
+   * @return bool false after a power loss or a firmware change of the layout
+   */
+  bool restored(void) const { return was_valid; }
+
+private:
+  WakeStateSlot *find(const char *key);
+  WakeStateSlot *slotFor(const char *key);
+  size_t putNumber(const char *key, uint32_t value, size_t size);
+  void seal(void);
+
+  WakeState &state;
+  bool was_valid;
+};
@@ -0,0 +1,66 @@
+#include <file_index.h>
+#include <string.h>
+
+/** Strips the leading slash; nullptr for a path in a subdirectory */
+static const char *root_name(const char *name)
+{
+  if (name[0] == '/')
+    name++;
+  return strchr(name, '/') ? nullptr : name;
+}
+
+static int find(const FileIndex &index, const char *name)
+{
+  for (int i = 0; i < index.count; i++)
+  {
+    if (strcmp(index.names[i], name) == 0)
+      return i;
+  }
+  return -1;
+}
+
+void file_index_reset(FileIndex &index, bool complete)
+{
+  memset(&index, 0, sizeof(index));
+  index.complete = complete;
+}
+
+void file_index_add(FileIndex &index, const char *name)
+{
+  name = root_name(name);
+  if (!name || find(index, name) >= 0)
+    return;
+  if (index.count >= FILE_INDEX_MAX_FILES || strlen(name) >= FILE_INDEX_NAME_SIZE)
+  {
+    index.complete = false;
+    return;
+  }
+  strcpy(index.names[index.count++], name);
+}
+
+void file_index_remove(FileIndex &index, const char *name)
+{
+  name = root_name(name);
+  if (!name)
+    return;
+  int i = find(index, name);
+  if (i < 0)
+    return;
+  index.count--;
+  if (i != index.count)
+    memcpy(index.names[i], index.names[index.count], FILE_INDEX_NAME_SIZE);
+}
+
+void file_index_rename(FileIndex &index, const char *old_name, const char *new_name)
+{
+  file_index_remove(index, old_name);
+  file_index_add(index, new_name);
+}
+
+FileIndexLookup file_index_lookup(const FileIndex &index, const char *name)
+{
+  name = root_name(name);
+  if (name && find(index, name) >= 0)
+    return FILE_INDEX_PRESENT;
+  return name && index.complete ? FILE_INDEX_ABSENT : FILE_INDEX_UNKNOWN;
+}
@@ -0,0 +1,172 @@
+#include <flight_recorder.h>
+#include <stdio.h>
+#include <string.h>
+
+struct ResetReasonNode
+{
+  const char *name;
+  int value; // esp_reset_reason_t
+};
+
+static const ResetReasonNode resetReasonMap[] = {
+    {"unknown", 0},   // ESP_RST_UNKNOWN
+    {"poweron", 1},   // ESP_RST_POWERON
+    {"external", 2},  // ESP_RST_EXT
+    {"software", 3},  // ESP_RST_SW
+    {"panic", 4},     // ESP_RST_PANIC
+    {"int_wdt", 5},   // ESP_RST_INT_WDT
+    {"task_wdt", 6},  // ESP_RST_TASK_WDT
+    {"wdt", 7},       // ESP_RST_WDT
+    {"deepsleep", 8}, // ESP_RST_DEEPSLEEP
+    {"brownout", 9},  // ESP_RST_BROWNOUT
+    {"sdio", 10},     // ESP_RST_SDIO
+};
+
+static const char *const phaseNames[FLIGHT_PHASE_COUNT] = {
+    "boot",
+    "logo",
+    "filesystem",
+    "wifi",
+    "api",
+    "download",
+    "decode",
+    "display",
+    "firmware_update",
+    "log_submit",
+    "sleep",
+    "restart",
+};
+
+const char *flight_phase_name(uint8_t phase)
+{
+  return phase < FLIGHT_PHASE_COUNT ? phaseNames[phase] : "unknown";
+}
+
+const char *reset_reason_name(int reset_reason)
+{
+  for (const ResetReasonNode &entry : resetReasonMap)
+  {
+    if (reset_reason == entry.value)
+      return entry.name;
+  }
+  return "unknown";
+}
+
+bool flight_recorder_valid(const FlightRecord &record)
+{
+  return record.magic == FLIGHT_RECORDER_MAGIC &&
+         record.phase < FLIGHT_PHASE_COUNT &&
+         record.max_alloc_low_phase < FLIGHT_PHASE_COUNT &&
+         record.log_head < FLIGHT_RECORDER_LOG_IDS &&
+         record.log_count <= FLIGHT_RECORDER_LOG_IDS &&
+         record.report_length < FLIGHT_RECORDER_REPORT_SIZE;
+}
+
+/**
+ * @brief Function to describe a wake that did not end in a planned sleep or restart
+ * @param record record of the previous wake
+ * @param reset_reason value of esp_reset_reason()
+ * @param out output buffer
+ * @param out_size size of the output buffer
+ * @return size_t report length
+ */
+static size_t write_report(const FlightRecord &record, int reset_reason, char *out, size_t out_size)
+{
+  int written = snprintf(out, out_size, "reset=%s phase=%s wake=%u heap_low=%u max_alloc_low=%u@%s logs=",
+                         reset_reason_name(reset_reason), flight_phase_name(record.phase),
+                         (unsigned)record.wake_count, (unsigned)record.heap_low_water,
+                         (unsigned)record.max_alloc_low_water, flight_phase_name(record.max_alloc_low_phase));
+  if (written < 0)
+    return 0;
+  size_t pos = (size_t)written < out_size ? (size_t)written : out_size - 1;
+
+  // oldest first, so the last id is the call right before the reset
+  size_t first = (record.log_head + FLIGHT_RECORDER_LOG_IDS - record.log_count) % FLIGHT_RECORDER_LOG_IDS;
+  for (size_t i = 0; i < record.log_count && pos + 1 < out_size; i++)
+  {
+    uint32_t id = record.log_ids[(first + i) % FLIGHT_RECORDER_LOG_IDS];
+    written = snprintf(out + pos, out_size - pos, i ? ",%08x" : "%08x", (unsigned)id);
+    if (written < 0)
+      break;
+    pos += (size_t)written;
+    if (pos >= out_size)
+      pos = out_size - 1;
+  }
+  return pos;
+}
+
+bool flight_recorder_boot(FlightRecord &record, int reset_reason, uint32_t free_heap, uint32_t max_alloc)
+{
+  uint32_t wake_count = 0;
+  char report[FLIGHT_RECORDER_REPORT_SIZE] = {0};
+  size_t report_length = 0;
+
+  if (flight_recorder_valid(record))
+  {
+    wake_count = record.wake_count + 1;
+
+    // a report that was never submitted is kept: the first failure is usually the interesting one
+    if (record.report_length > 0)
+    {
+      memcpy(report, record.report, record.report_length);
+      report_length = record.report_length;
+    }
+    else if (record.phase != FLIGHT_PHASE_SLEEP && record.phase != FLIGHT_PHASE_RESTART)
+    {
+      report_length = write_report(record, reset_reason, report, sizeof(report));
+    }
+  }
+
+  memset(&record, 0, sizeof(record));
+  record.magic = FLIGHT_RECORDER_MAGIC;
+  record.wake_count = wake_count;
+  record.phase = FLIGHT_PHASE_BOOT;
+  record.heap_low_water = free_heap;
+  record.max_alloc_low_water = max_alloc;
+  record.max_alloc_low_phase = FLIGHT_PHASE_BOOT;
+  memcpy(record.report, report, report_length);
+  record.report[report_length] = '\0';
+  record.report_length = report_length;
+
+  return report_length > 0;
+}
+
+void flight_recorder_phase(FlightRecord &record, FlightPhase phase, uint32_t free_heap, uint32_t max_alloc)
+{
+  record.phase = phase;
+  if (free_heap < record.heap_low_water)
+    record.heap_low_water = free_heap;
+  if (max_alloc < record.max_alloc_low_water)
+  {
+    record.max_alloc_low_water = max_alloc;
+    record.max_alloc_low_phase = phase;
+  }
+}
+
+void flight_recorder_log(FlightRecord &record, uint32_t log_id, uint32_t free_heap)
+{
+  record.log_ids[record.log_head] = log_id;
+  record.log_head = (record.log_head + 1) % FLIGHT_RECORDER_LOG_IDS;
+  if (record.log_count < FLIGHT_RECORDER_LOG_IDS)
+    record.log_count++;
+  if (free_heap < record.heap_low_water)
+    record.heap_low_water = free_heap;
+}
+
+size_t flight_recorder_take_report(FlightRecord &record, char *out, size_t out_size)
+{
+  if (out_size == 0 || record.report_length == 0)
+  {
+    if (out_size > 0)
+      out[0] = '\0';
+    return 0;
+  }
+
+  size_t length = record.report_length < out_size - 1 ? record.report_length : out_size - 1;
+  memcpy(out, record.report, length);
+  out[length] = '\0';
+
+  record.report_length = 0;
+  record.report[0] = '\0';
+  return length;
+}
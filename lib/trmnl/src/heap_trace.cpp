@@ -0,0 +1,172 @@
+#include <heap_trace.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const HeapTraceAllocator *trace_allocator = nullptr;
+static size_t trace_threshold = HEAP_TRACE_THRESHOLD;
+static HeapTraceAlloc trace_allocs[HEAP_TRACE_MAX_ALLOCS];
+static size_t trace_alloc_count = 0;
+static size_t trace_dropped = 0;
+static HeapTracePhase trace_phases[HEAP_TRACE_MAX_PHASES];
+static size_t trace_phase_count = 0;
+
+void heap_trace_begin(const HeapTraceAllocator *allocator, size_t threshold)
+{
+  trace_allocator = allocator;
+  trace_threshold = threshold;
+  trace_alloc_count = 0;
+  trace_dropped = 0;
+  trace_phase_count = 0;
+}
+
+bool heap_trace_active(void)
+{
+  return trace_allocator != nullptr;
+}
+
+/**
+ * @brief Function to reserve the next allocation record
+ * @return HeapTraceAlloc* record or nullptr when the table is full
+ */
+static HeapTraceAlloc *next_alloc_record(void)
+{
+  if (trace_alloc_count >= HEAP_TRACE_MAX_ALLOCS)
+  {
+    trace_dropped++;
+    return nullptr;
+  }
+  HeapTraceAlloc *record = &trace_allocs[trace_alloc_count++];
+  *record = HeapTraceAlloc{};
+  return record;
+}
+
+void *heap_trace_malloc(size_t size, const char *tag)
+{
+  if (!trace_allocator)
+    return malloc(size);
+
+  if (size < trace_threshold)
+    return trace_allocator->alloc(size);
+
+  uint32_t largest = trace_allocator->largest_free_block();
+  void *ptr = trace_allocator->alloc(size);
+
+  HeapTraceAlloc *record = next_alloc_record();
+  if (record)
+  {
+    record->ptr = ptr;
+    record->tag = tag;
+    record->size = size;
+    record->alloc_ms = trace_allocator->now_ms();
+    record->largest_free_block = largest;
+    record->failed = ptr == nullptr;
+  }
+  return ptr;
+}
+
+void heap_trace_free(void *ptr)
+{
+  if (!trace_allocator)
+  {
+    free(ptr);
+    return;
+  }
+  if (!ptr)
+    return;
+
+  // newest first: buffers are usually freed in the reverse order of allocation
+  for (size_t i = trace_alloc_count; i > 0; i--)
+  {
+    HeapTraceAlloc &record = trace_allocs[i - 1];
+    if (record.ptr == ptr)
+    {
+      record.ptr = nullptr;
+      record.free_ms = trace_allocator->now_ms();
+      break;
+    }
+  }
+  trace_allocator->free(ptr);
+}
+
+void heap_trace_phase(const char *name)
+{
+  if (!trace_allocator)
+    return;
+
+  uint32_t free_size = trace_allocator->free_size();
+  uint32_t largest = trace_allocator->largest_free_block();
+
+  if (trace_phase_count > 0)
+  {
+    HeapTracePhase &current = trace_phases[trace_phase_count - 1];
+    if (!current.ended)
+    {
+      current.free_after = free_size;
+      current.largest_after = largest;
+      current.ended = true;
+    }
+  }
+
+  if (!name || trace_phase_count >= HEAP_TRACE_MAX_PHASES)
+    return;
+
+  HeapTracePhase &next = trace_phases[trace_phase_count++];
+  next = HeapTracePhase{};
+  next.name = name;
+  next.free_before = free_size;
+  next.largest_before = largest;
+}
+
+const HeapTraceAlloc *heap_trace_alloc_at(size_t index)
+{
+  return index < trace_alloc_count ? &trace_allocs[index] : nullptr;
+}
+
+const HeapTracePhase *heap_trace_phase_at(size_t index)
+{
+  return index < trace_phase_count ? &trace_phases[index] : nullptr;
+}
+
+size_t heap_trace_dropped(void)
+{
+  return trace_dropped;
+}
+
+void heap_trace_dump(HeapTraceSink sink)
+{
+  char line[128];
+
+  for (size_t i = 0; i < trace_phase_count; i++)
+  {
+    const HeapTracePhase &phase = trace_phases[i];
+    if (phase.ended)
+      snprintf(line, sizeof(line), "phase %s: free %u -> %u, largest block %u -> %u",
+               phase.name, (unsigned)phase.free_before, (unsigned)phase.free_after,
+               (unsigned)phase.largest_before, (unsigned)phase.largest_after);
+    else
+      snprintf(line, sizeof(line), "phase %s: free %u, largest block %u (not ended)",
+               phase.name, (unsigned)phase.free_before, (unsigned)phase.largest_before);
+    sink(line);
+  }
+
+  for (size_t i = 0; i < trace_alloc_count; i++)
+  {
+    const HeapTraceAlloc &alloc = trace_allocs[i];
+    if (alloc.failed)
+      snprintf(line, sizeof(line), "alloc %s: %u bytes FAILED at %u ms, largest block %u",
+               alloc.tag, (unsigned)alloc.size, (unsigned)alloc.alloc_ms, (unsigned)alloc.largest_free_block);
+    else if (alloc.ptr)
+      snprintf(line, sizeof(line), "alloc %s: %u bytes at %u ms, still live",
+               alloc.tag, (unsigned)alloc.size, (unsigned)alloc.alloc_ms);
+    else
+      snprintf(line, sizeof(line), "alloc %s: %u bytes at %u ms, freed after %u ms",
+               alloc.tag, (unsigned)alloc.size, (unsigned)alloc.alloc_ms, (unsigned)(alloc.free_ms - alloc.alloc_ms));
+    sink(line);
+  }
+
+  if (trace_dropped > 0)
+  {
+    snprintf(line, sizeof(line), "%u allocations not recorded", (unsigned)trace_dropped);
+    sink(line);
+  }
+}
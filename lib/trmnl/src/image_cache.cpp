@@ -0,0 +1,154 @@
+#include <image_cache.h>
+#include <wake_state.h>
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t entries_crc(const ImageCacheIndex &index)
+{
+  uint32_t crc = wake_state_crc32((const uint8_t *)&index.clock, sizeof(index.clock));
+  return crc ^ wake_state_crc32((const uint8_t *)index.entries, sizeof(index.entries));
+}
+
+bool image_cache_valid(const ImageCacheIndex &index)
+{
+  return index.version == IMAGE_CACHE_VERSION && index.crc == entries_crc(index);
+}
+
+void image_cache_reset(ImageCacheIndex &index)
+{
+  memset(&index, 0, sizeof(index));
+  index.version = IMAGE_CACHE_VERSION;
+  image_cache_seal(index);
+}
+
+void image_cache_seal(ImageCacheIndex &index)
+{
+  index.crc = entries_crc(index);
+}
+
+static ImageCacheEntry *find(ImageCacheIndex &index, const char *key)
+{
+  for (ImageCacheEntry &entry : index.entries)
+  {
+    if (entry.key[0] && strncmp(entry.key, key, sizeof(entry.key)) == 0)
+      return &entry;
+  }
+  return nullptr;
+}
+
+static bool same_file(const ImageCacheEntry &a, uint32_t hash, uint8_t format)
+{
+  return a.key[0] && a.hash == hash && a.format == format;
+}
+
+static bool file_referenced(const ImageCacheIndex &index, uint32_t hash, uint8_t format)
+{
+  for (const ImageCacheEntry &entry : index.entries)
+  {
+    if (same_file(entry, hash, format))
+      return true;
+  }
+  return false;
+}
+
+/** Frees an entry and reports its file unless another entry, or the image being inserted, still uses it */
+static void drop(ImageCacheIndex &index, ImageCacheEntry &entry, ImageCacheEvict evict, uint32_t keep_hash, int keep_format)
+{
+  ImageCacheEntry dropped = entry;
+  memset(&entry, 0, sizeof(entry));
+  if (same_file(dropped, keep_hash, keep_format) || file_referenced(index, dropped.hash, dropped.format))
+    return;
+  if (evict)
+    evict(dropped);
+}
+
+ImageCacheEntry *image_cache_lookup(ImageCacheIndex &index, const char *key)
+{
+  ImageCacheEntry *entry = find(index, key);
+  if (entry)
+    entry->last_used = ++index.clock;
+  return entry;
+}
+
+uint32_t image_cache_bytes(const ImageCacheIndex &index)
+{
+  uint32_t bytes = 0;
+  for (size_t i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++)
+  {
+    const ImageCacheEntry &entry = index.entries[i];
+    if (!entry.key[0])
+      continue;
+
+    bool counted = false;
+    for (size_t j = 0; j < i && !counted; j++)
+      counted = same_file(index.entries[j], entry.hash, entry.format);
+    if (!counted)
+      bytes += entry.size;
+  }
+  return bytes;
+}
+
+ImageCacheEntry *image_cache_insert(ImageCacheIndex &index, const char *key, ImageCacheFormat format, uint32_t size,
+                                    uint32_t hash, uint32_t budget, ImageCacheEvict evict, bool &write_file)
+{
+  write_file = false;
+  size_t key_length = strlen(key);
+  if (key_length == 0 || key_length >= IMAGE_CACHE_KEY_SIZE || size > budget)
+    return nullptr;
+
+  // a file left behind by an evicted entry is still on flash and can be reused
+  bool file_exists = file_referenced(index, hash, format);
+
+  ImageCacheEntry *existing = find(index, key);
+  if (existing)
+    drop(index, *existing, evict, hash, format);
+
+  for (;;)
+  {
+    size_t used_entries = 0;
+    ImageCacheEntry *oldest = nullptr;
+    for (ImageCacheEntry &entry : index.entries)
+    {
+      if (!entry.key[0])
+        continue;
+      used_entries++;
+      if (!oldest || entry.last_used < oldest->last_used)
+        oldest = &entry;
+    }
+
+    uint32_t bytes = image_cache_bytes(index) + (file_referenced(index, hash, format) ? 0 : size);
+    if (used_entries < IMAGE_CACHE_MAX_ENTRIES && bytes <= budget)
+      break;
+    drop(index, *oldest, evict, hash, format);
+  }
+
+  for (ImageCacheEntry &entry : index.entries)
+  {
+    if (entry.key[0])
+      continue;
+    memcpy(entry.key, key, key_length + 1);
+    entry.format = format;
+    entry.size = size;
+    entry.hash = hash;
+    entry.last_used = ++index.clock;
+    write_file = !file_exists;
+    return &entry;
+  }
+  return nullptr;
+}
+
+bool image_cache_remove(ImageCacheIndex &index, const char *key, ImageCacheEvict evict)
+{
+  ImageCacheEntry *entry = find(index, key);
+  if (!entry)
+    return false;
+  drop(index, *entry, evict, 0, -1);
+  return true;
+}
+
+void image_cache_path(const ImageCacheEntry &entry, char *path)
+{
+  static const char *const extensions[] = {"bmp", "png", "fb"};
+  const char *extension = entry.format < sizeof(extensions) / sizeof(extensions[0]) ? extensions[entry.format] : "bin";
+  snprintf(path, IMAGE_CACHE_PATH_SIZE, "/img_%08x.%s", (unsigned)entry.hash, extension);
+}
@@ -0,0 +1,223 @@
+#include <log_ring.h>
+#include <stdio.h>
+
+static LogRingRecord log_ring[LOG_RING_CAPACITY];
+static size_t log_ring_head = 0;  // next slot to write
+static size_t log_ring_count_ = 0; // valid records, at most LOG_RING_CAPACITY
+static LogRingObserver log_ring_observer = nullptr;
+
+LogRingRecord &log_ring_next(void)
+{
+  LogRingRecord &record = log_ring[log_ring_head];
+  log_ring_head = (log_ring_head + 1) % LOG_RING_CAPACITY;
+  if (log_ring_count_ < LOG_RING_CAPACITY)
+    log_ring_count_++;
+
+  record.argc = 0;
+  record.text_used = 0;
+  record.text[0] = '\0';
+  return record;
+}
+
+void log_ring_set_observer(LogRingObserver observer)
+{
+  log_ring_observer = observer;
+}
+
+void log_ring_notify(const LogRingRecord &record)
+{
+  if (log_ring_observer)
+    log_ring_observer(record);
+}
+
+void log_ring_observe(uint8_t level, const char *file, int line, const char *format)
+{
+  if (!log_ring_observer)
+    return;
+  LogRingRecord record;
+  record.format = format;
+  record.file = file;
+  record.line = line;
+  record.level = level;
+  record.argc = 0;
+  record.text_used = 0;
+  record.text[0] = '\0';
+  log_ring_observer(record);
+}
+
+size_t log_ring_count(void)
+{
+  return log_ring_count_;
+}
+
+void log_ring_clear(void)
+{
+  log_ring_head = 0;
+  log_ring_count_ = 0;
+}
+
+/**
+ * @brief Function to format a single conversion with the captured argument
+ * @param spec conversion spec without length modifiers, e.g. "%08"; the conversion is appended in place
+ * @param spec_len length of spec
+ * @param length length modifier as written at the call site ("", "h", "hh", "l", "ll", "z", ...)
+ * @param conversion conversion character
+ * @param record record holding the argument
+ * @param arg captured argument
+ * @param out output buffer
+ * @param out_size size of the output buffer
+ * @return int snprintf result
+ */
+static int format_conversion(char *spec, size_t spec_len, const char *length, char conversion,
+                             const LogRingRecord &record, uint64_t arg, char *out, size_t out_size)
+{
+  // Integers are re-emitted with "ll" so one code path serves every width; the
+  // value is first narrowed to the width the call site's printf would have read
+  bool wide = strcmp(length, "ll") == 0 || strcmp(length, "j") == 0 ||
+              (sizeof(long) == 8 && (strcmp(length, "l") == 0 || strcmp(length, "z") == 0 || strcmp(length, "t") == 0));
+
+  switch (conversion)
+  {
+  case 'd':
+  case 'i':
+  {
+    spec[spec_len++] = 'l';
+    spec[spec_len++] = 'l';
+    spec[spec_len++] = conversion;
+    spec[spec_len] = '\0';
+    long long value = wide ? (long long)(int64_t)arg : (long long)(int32_t)arg;
+    return snprintf(out, out_size, spec, value);
+  }
+  case 'u':
+  case 'x':
+  case 'X':
+  case 'o':
+  {
+    spec[spec_len++] = 'l';
+    spec[spec_len++] = 'l';
+    spec[spec_len++] = conversion;
+    spec[spec_len] = '\0';
+    unsigned long long value = wide ? (unsigned long long)arg : (unsigned long long)(uint32_t)arg;
+    return snprintf(out, out_size, spec, value);
+  }
+  case 'c':
+    spec[spec_len++] = conversion;
+    spec[spec_len] = '\0';
+    return snprintf(out, out_size, spec, (int)arg);
+  case 'f':
+  case 'F':
+  case 'e':
+  case 'E':
+  case 'g':
+  case 'G':
+  {
+    double value;
+    memcpy(&value, &arg, sizeof(value));
+    spec[spec_len++] = conversion;
+    spec[spec_len] = '\0';
+    return snprintf(out, out_size, spec, value);
+  }
+  case 's':
+  {
+    const char *value = arg < sizeof(record.text) ? record.text + arg : LOG_RING_TRUNCATED;
+    spec[spec_len++] = conversion;
+    spec[spec_len] = '\0';
+    return snprintf(out, out_size, spec, value);
+  }
+  case 'p':
+    spec[spec_len++] = conversion;
+    spec[spec_len] = '\0';
+    return snprintf(out, out_size, spec, (void *)(uintptr_t)arg);
+  default:
+    return snprintf(out, out_size, "%s%s%c", spec, length, conversion);
+  }
+}
+
+size_t log_ring_format(const LogRingRecord &record, char *out, size_t out_size)
+{
+  if (out_size == 0)
+    return 0;
+
+  size_t pos = 0;
+  uint8_t arg_index = 0;
+  const char *p = record.format ? record.format : "";
+
+  while (*p && pos + 1 < out_size)
+  {
+    if (*p != '%')
+    {
+      out[pos++] = *p++;
+      continue;
+    }
+    if (p[1] == '%')
+    {
+      out[pos++] = '%';
+      p += 2;
+      continue;
+    }
+
+    // %[flags][width][.precision][length]conversion
+    const char *start = p++;
+    char spec[24];
+    size_t spec_len = 0;
+    spec[spec_len++] = '%';
+    while (*p && strchr("-+ #0123456789.", *p) && spec_len < sizeof(spec) - 6)
+      spec[spec_len++] = *p++;
+    spec[spec_len] = '\0';
+
+    char length[3] = {0};
+    size_t length_len = 0;
+    while (*p && strchr("hlzjtL", *p) && length_len < sizeof(length) - 1)
+      length[length_len++] = *p++;
+
+    char conversion = *p;
+    if (!conversion)
+      break;
+    p++;
+
+    int written;
+    if (arg_index < record.argc)
+    {
+      written = format_conversion(spec, spec_len, length, conversion, record, record.args[arg_index++], out + pos, out_size - pos);
+    }
+    else
+    {
+      // more conversions than captured arguments: show the conversion verbatim
+      written = snprintf(out + pos, out_size - pos, "%.*s", (int)(p - start), start);
+    }
+
+    if (written < 0)
+      break;
+    pos += (size_t)written;
+    if (pos >= out_size)
+      pos = out_size - 1;
+  }
+
+  out[pos] = '\0';
+  return pos;
+}
+
+size_t log_ring_dump(LogRingSink sink)
+{
+  size_t count = log_ring_count_;
+  size_t index = (log_ring_head + LOG_RING_CAPACITY - count) % LOG_RING_CAPACITY;
+  char line[256];
+
+  for (size_t i = 0; i < count; i++)
+  {
+    const LogRingRecord &record = log_ring[(index + i) % LOG_RING_CAPACITY];
+    size_t prefix = 0;
+    if (record.file)
+    {
+      int written = snprintf(line, sizeof(line), "%s [%d]: ", record.file, record.line);
+      prefix = written > 0 ? (size_t)written : 0;
+      if (prefix >= sizeof(line))
+        prefix = sizeof(line) - 1;
+    }
+    log_ring_format(record, line + prefix, sizeof(line) - prefix);
+    sink(record.level, line);
+  }
+
+  log_ring_clear();
+  return count;
+}
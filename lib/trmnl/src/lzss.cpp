@@ -0,0 +1,63 @@
+#include <lzss.h>
+
+void lzss_decoder_init(LzssDecoder &decoder, const uint8_t *data, size_t size)
+{
+  decoder.src = data;
+  decoder.end = data + size;
+  decoder.produced = 0;
+  decoder.literals = 0;
+  decoder.copy = 0;
+  decoder.distance = 0;
+  decoder.error = false;
+}
+
+size_t lzss_decode(LzssDecoder &decoder, uint8_t *out, size_t size)
+{
+  size_t written = 0;
+  while (written < size && !decoder.error)
+  {
+    uint8_t value;
+    if (decoder.literals)
+    {
+      if (decoder.src == decoder.end)
+      {
+        decoder.error = true;
+        break;
+      }
+      value = *decoder.src++;
+      decoder.literals--;
+    }
+    else if (decoder.copy)
+    {
+      // the window index wraps with the uint8_t arithmetic
+      value = decoder.window[(uint8_t)(decoder.produced - decoder.distance - 1)];
+      decoder.copy--;
+    }
+    else
+    {
+      if (decoder.src == decoder.end)
+        break;
+      uint8_t control = *decoder.src++;
+      if (control < 0x80)
+      {
+        decoder.literals = control + 1;
+      }
+      else
+      {
+        if (decoder.src == decoder.end || *decoder.src >= decoder.produced)
+        {
+          decoder.error = true;
+          break;
+        }
+        decoder.distance = *decoder.src++;
+        decoder.copy = (control & 0x7F) + LZSS_MIN_MATCH;
+      }
+      continue;
+    }
+
+    decoder.window[(uint8_t)decoder.produced] = value;
+    decoder.produced++;
+    out[written++] = value;
+  }
+  return written;
+}
@@ -0,0 +1,44 @@
+#include <ota_delta.h>
+#include <string.h>
+
+static uint32_t get32(const uint8_t *data)
+{
+  return data[0] | data[1] << 8 | data[2] << 16 | (uint32_t)data[3] << 24;
+}
+
+bool ota_delta_header(const uint8_t *data, OtaDeltaHeader &header)
+{
+  if (get32(data) != OTA_DELTA_MAGIC)
+    return false;
+  header.source_size = get32(data + 4);
+  memcpy(header.source_sha256, data + 8, SHA256_DIGEST_SIZE);
+  header.target_size = get32(data + 8 + SHA256_DIGEST_SIZE);
+  return header.source_size > 0 && header.target_size > 0;
+}
+
+uint32_t ota_delta_block_length(uint32_t target_size, uint32_t offset)
+{
+  if (offset >= target_size)
+    return 0;
+  return target_size - offset < OTA_DELTA_BLOCK_SIZE ? target_size - offset : OTA_DELTA_BLOCK_SIZE;
+}
+
+bool ota_delta_block(const uint8_t *data, uint32_t length, uint32_t source_size, OtaDeltaBlock &block)
+{
+  block.source = get32(data);
+  block.packed = get32(data + 4);
+  if (block.packed == 0 || block.packed > OTA_DELTA_MAX_PACKED)
+    return false;
+  return block.source == OTA_DELTA_NO_SOURCE || (block.source <= source_size && length <= source_size - block.source);
+}
+
+size_t ota_delta_decode(LzssDecoder &decoder, const uint8_t *source, uint8_t *out, size_t size)
+{
+  size_t n = lzss_decode(decoder, out, size);
+  if (source)
+  {
+    for (size_t i = 0; i < n; i++)
+      out[i] += source[i];
+  }
+  return n;
+}
@@ -0,0 +1,63 @@
+#include <ota_progress.h>
+#include <wake_state.h>
+#include <stdlib.h>
+#include <string.h>
+
+uint32_t ota_image_id(const char *url, const char *sha256_hex)
+{
+  uint32_t crc = wake_state_crc32_update(0, (const uint8_t *)url, strlen(url));
+  return wake_state_crc32_update(crc, (const uint8_t *)sha256_hex, strlen(sha256_hex));
+}
+
+void ota_progress_start(OtaProgress &progress, uint32_t image)
+{
+  Sha256 sha;
+  sha256_init(sha);
+  memset(&progress, 0, sizeof(progress));
+  progress.magic = OTA_PROGRESS_MAGIC;
+  progress.image = image;
+  memcpy(progress.sha_state, sha.state, sizeof(progress.sha_state));
+}
+
+bool ota_progress_resumes(const OtaProgress &progress, uint32_t image)
+{
+  return progress.magic == OTA_PROGRESS_MAGIC && progress.image == image &&
+         progress.written % OTA_CHECKPOINT_SIZE == 0 && (!progress.size || progress.written <= progress.size) &&
+         (!progress.length || progress.received <= progress.length);
+}
+
+bool ota_progress_checkpoint(OtaProgress &progress, const Sha256 &sha, uint32_t received)
+{
+  if (sha.length % OTA_CHECKPOINT_SIZE)
+    return false;
+  progress.written = sha.length;
+  progress.received = received;
+  memcpy(progress.sha_state, sha.state, sizeof(progress.sha_state));
+  return true;
+}
+
+void ota_progress_hash(const OtaProgress &progress, Sha256 &sha)
+{
+  sha256_resume(sha, progress.sha_state, progress.written);
+}
+
+bool ota_parse_content_range(const char *header, uint32_t &start, uint32_t &total)
+{
+  if (!header || strncmp(header, "bytes ", 6) != 0)
+    return false;
+  char *end;
+  unsigned long first = strtoul(header + 6, &end, 10);
+  if (end == header + 6 || *end != '-')
+    return false;
+  const char *last_text = end + 1;
+  unsigned long last = strtoul(last_text, &end, 10);
+  if (end == last_text || *end != '/' || last < first)
+    return false;
+  const char *total_text = end + 1;
+  unsigned long size = strtoul(total_text, &end, 10);
+  if (end == total_text || *end != '\0' || size <= last)
+    return false;
+  start = first;
+  total = size;
+  return true;
+}
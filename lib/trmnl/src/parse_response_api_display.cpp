@@ -27,7 +27,11 @@ ApiDisplayResponse parseResponse_apiDisplay(String &payload)
       .filename = doc["filename"] | "",
       .update_firmware = doc["update_firmware"],
       .firmware_url = doc["firmware_url"] | "",
+      .firmware_sha256 = doc["firmware_sha256"] | "",
+      .firmware_patch_url = doc["firmware_patch_url"] | "",
       .refresh_rate = doc["refresh_rate"],
+      .quiet_start = doc["quiet_start"] | 0,
+      .quiet_end = doc["quiet_end"] | 0,
       .reset_firmware = doc["reset_firmware"],
       .special_function = parseSpecialFunction(special_function_str),
       .action = doc["action"] | "",
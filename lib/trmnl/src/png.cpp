@@ -1,10 +1,11 @@
 #include <PNGdec.h>
 #include "png.h"
 #include <trmnl_log.h>
+#include <heap_trace.h>
 
 image_err_e processPNG(PNG *png, uint8_t *&decoded_buffer)
 {
-  if (!(decoded_buffer = (uint8_t *)malloc(48000)))
+  if (!(decoded_buffer = (uint8_t *)heap_trace_malloc(48000, "png_decoded")))
   {
     Log_error("PNG MALLOC FAILED");
     return PNG_MALLOC_FAILED;
@@ -0,0 +1,180 @@
+#include <prop_font.h>
+#include <string.h>
+
+uint32_t utf8_next(const char *&text)
+{
+  const uint8_t *s = (const uint8_t *)text;
+  uint8_t lead = s[0];
+  if (!lead)
+    return 0;
+  if (lead < 0x80)
+  {
+    text++;
+    return lead;
+  }
+
+  size_t extra;
+  uint32_t codepoint, minimum;
+  if ((lead & 0xE0) == 0xC0)
+  {
+    extra = 1;
+    codepoint = lead & 0x1F;
+    minimum = 0x80;
+  }
+  else if ((lead & 0xF0) == 0xE0)
+  {
+    extra = 2;
+    codepoint = lead & 0x0F;
+    minimum = 0x800;
+  }
+  else if ((lead & 0xF8) == 0xF0)
+  {
+    extra = 3;
+    codepoint = lead & 0x07;
+    minimum = 0x10000;
+  }
+  else
+  {
+    text++;
+    return UTF8_REPLACEMENT;
+  }
+
+  for (size_t i = 1; i <= extra; i++)
+  {
+    // also stops at the terminating NUL
+    if ((s[i] & 0xC0) != 0x80)
+    {
+      text += i;
+      return UTF8_REPLACEMENT;
+    }
+    codepoint = (codepoint << 6) | (s[i] & 0x3F);
+  }
+  text += extra + 1;
+
+  // overlong encodings and surrogates are malformed too
+  if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+    return UTF8_REPLACEMENT;
+  return codepoint;
+}
+
+static int find_glyph(const PropFont &font, uint32_t codepoint)
+{
+  for (uint8_t i = 0; i < font.range_count; i++)
+  {
+    const PropFontRange &range = font.ranges[i];
+    if (codepoint >= range.first && codepoint - range.first < range.count)
+      return range.glyph + (codepoint - range.first);
+  }
+  return -1;
+}
+
+/** ASCII stand-in for common characters, 0 if there is none */
+static uint32_t fold(uint32_t codepoint)
+{
+  // U+00C0 to U+00FF: accented Latin-1 letters as their base letter
+  static const char latin1[] = "AAAAAAACEEEEIIIIDNOOOOOxOUUUUYPsaaaaaaaceeeeiiiidnooooo/ouuuuypy";
+  if (codepoint >= 0xC0 && codepoint <= 0xFF)
+    return latin1[codepoint - 0xC0];
+
+  switch (codepoint)
+  {
+  case 0xA0: // no-break space
+    return ' ';
+  case 0x2010:
+  case 0x2011:
+  case 0x2012:
+  case 0x2013:
+  case 0x2014:
+    return '-';
+  case 0x2018:
+  case 0x2019:
+    return '\'';
+  case 0x201C:
+  case 0x201D:
+    return '"';
+  case 0x2026:
+    return '.';
+  default:
+    return 0;
+  }
+}
+
+const PropGlyph &prop_font_glyph(const PropFont &font, uint32_t codepoint)
+{
+  int glyph = find_glyph(font, codepoint);
+  if (glyph < 0)
+  {
+    uint32_t folded = fold(codepoint);
+    if (folded)
+      glyph = find_glyph(font, folded);
+  }
+  return font.glyphs[glyph < 0 ? font.fallback : glyph];
+}
+
+uint16_t prop_font_text_width(const PropFont &font, const char *text, size_t length)
+{
+  const char *end = text + length;
+  uint16_t width = 0;
+  while (text < end && *text)
+    width += prop_font_glyph(font, utf8_next(text)).advance;
+  return width;
+}
+
+size_t prop_font_wrap(const PropFont &font, const char *text, uint16_t max_width, PropFontLine *lines, size_t max_lines)
+{
+  size_t count = 0;
+  while (*text && count < max_lines)
+  {
+    while (*text == ' ')
+      text++;
+    if (!*text)
+      break;
+
+    // extend the line one character at a time, remembering the last word end that fit
+    const char *end = text;
+    uint16_t end_width = 0;
+    const char *pos = text;
+    uint16_t width = 0;
+    bool full = false;
+    while (*pos && *pos != '\n')
+    {
+      const char *next = pos;
+      uint32_t codepoint = utf8_next(next);
+      uint16_t advance = prop_font_glyph(font, codepoint).advance;
+      if (width + advance > max_width)
+      {
+        full = true;
+        break;
+      }
+      width += advance;
+      pos = next;
+      if (codepoint != ' ' && (*pos == ' ' || *pos == '\n' || !*pos))
+      {
+        end = pos;
+        end_width = width;
+      }
+    }
+
+    if (full && end == text)
+    {
+      // a single word wider than the line: break it, but always take one character
+      end = pos;
+      end_width = width;
+      if (end == text)
+      {
+        end_width = prop_font_glyph(font, utf8_next(end)).advance;
+      }
+    }
+
+    lines[count].start = text;
+    lines[count].length = end - text;
+    lines[count].width = end_width;
+    count++;
+
+    // a line that ended at a newline or the end drops its trailing spaces and the newline
+    text = full ? end : pos;
+    if (!full && *text == '\n')
+      text++;
+  }
+  return count;
+}
@@ -0,0 +1,304 @@
+// Generated by scripts/prop_font.py from font24.cpp, do not edit.
+#include <prop_font.h>
+
+static const uint8_t PropFont24_Bitmaps[] = {
+    // '!'
+    0x00, 0x00, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0x40, 0x40, 0x00, 0x00, 0xE0, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '"'
+    0x00, 0x00, 0x00, 0xE7, 0xE7, 0xE7, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '#'
+    0x00, 0x00, 0x00, 0x00, 0x19, 0x80, 0x19, 0x80, 0x19, 0x80, 0x19, 0x80, 0x19, 0x80, 0xFF, 0xE0, 0xFF, 0xE0, 0x19, 0x80, 0x33, 0x00, 0xFF, 0xE0, 0xFF, 0xE0, 0x33, 0x00, 0x33, 0x00, 0x33, 0x00, 0x33, 0x00, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '$'
+    0x00, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x3D, 0x80, 0x7F, 0x80, 0xC3, 0x80, 0xC3, 0x80, 0xE0, 0x00, 0x7C, 0x00, 0x3F, 0x00, 0x07, 0x80, 0xC1, 0x80, 0xE1, 0x80, 0xE3, 0x80, 0xFF, 0x00, 0xDE, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '%'
+    0x00, 0x00, 0x00, 0x00, 0x3C, 0x00, 0x7E, 0x00, 0xE7, 0x00, 0xC3, 0x00, 0xC3, 0x00, 0xE7, 0x00, 0x7F, 0xC0, 0x3F, 0x00, 0xFF, 0x80, 0x39, 0xC0, 0x30, 0xC0, 0x30, 0xC0, 0x39, 0xC0, 0x1F, 0x80, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '&'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x80, 0x3F, 0x80, 0x63, 0x00, 0x60, 0x00, 0x60, 0x00, 0x30, 0x00, 0x38, 0x00, 0x7C, 0xE0, 0xEF, 0xE0, 0xC7, 0x80, 0xC3, 0x80, 0x7F, 0xE0, 0x3E, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // "'"
+    0x00, 0x00, 0x00, 0xE0, 0xE0, 0xE0, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '('
+    0x00, 0x00, 0x0C, 0x1C, 0x38, 0x78, 0x70, 0x70, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0x70, 0x70, 0x38, 0x38, 0x1C, 0x0C, 0x00, 0x00, 0x00, 0x00,
+    // ')'
+    0x00, 0x00, 0xC0, 0xE0, 0x70, 0x70, 0x38, 0x38, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x38, 0x38, 0x78, 0x70, 0xE0, 0xC0, 0x00, 0x00, 0x00, 0x00,
+    // '*'
+    0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0xED, 0xC0, 0xFF, 0xC0, 0x3F, 0x00, 0x1E, 0x00, 0x1E, 0x00, 0x33, 0x00, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '+'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0xFF, 0xF0, 0xFF, 0xF0, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // ','
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x30, 0x70, 0x60, 0x60, 0xC0, 0xC0, 0x00, 0x00, 0x00,
+    // '-'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xC0, 0xFF, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '.'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0xF0, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '/'
+    0x00, 0xC0, 0x00, 0xC0, 0x01, 0xC0, 0x01, 0x80, 0x03, 0x80, 0x03, 0x00, 0x03, 0x00, 0x06, 0x00, 0x06, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x18, 0x00, 0x18, 0x00, 0x30, 0x00, 0x30, 0x00, 0x70, 0x00, 0x60, 0x00, 0xE0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '0'
+    0x00, 0x00, 0x00, 0x00, 0x1E, 0x00, 0x3F, 0x00, 0x61, 0x80, 0x61, 0x80, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x61, 0x80, 0x61, 0x80, 0x3F, 0x00, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '1'
+    0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x3C, 0x00, 0xFC, 0x00, 0xEC, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0xFF, 0xC0, 0xFF, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '2'
+    0x00, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x7F, 0xC0, 0xE0, 0xC0, 0xC0, 0x60, 0xC0, 0x60, 0x00, 0x60, 0x00, 0xC0, 0x01, 0x80, 0x07, 0x00, 0x0E, 0x00, 0x18, 0x00, 0x30, 0x00, 0x60, 0x00, 0xFF, 0xE0, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '3'
+    0x00, 0x00, 0x00, 0x00, 0x1E, 0x00, 0x7F, 0x00, 0x63, 0x80, 0x01, 0x80, 0x01, 0x80, 0x03, 0x00, 0x1E, 0x00, 0x1F, 0x00, 0x03, 0x80, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0xC1, 0xC0, 0xFF, 0x80, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '4'
+    0x00, 0x00, 0x00, 0x00, 0x03, 0x80, 0x07, 0x80, 0x07, 0x80, 0x0D, 0x80, 0x19, 0x80, 0x19, 0x80, 0x31, 0x80, 0x31, 0x80, 0x61, 0x80, 0xC1, 0x80, 0xFF, 0xE0, 0xFF, 0xE0, 0x01, 0x80, 0x0F, 0xE0, 0x0F, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '5'
+    0x00, 0x00, 0x00, 0x00, 0x7F, 0xC0, 0x7F, 0xC0, 0x60, 0x00, 0x60, 0x00, 0x60, 0x00, 0x6F, 0x00, 0x7F, 0xC0, 0x70, 0xC0, 0x00, 0x60, 0x00, 0x60, 0x00, 0x60, 0x00, 0x60, 0xC0, 0xC0, 0xFF, 0xC0, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '6'
+    0x00, 0x00, 0x00, 0x00, 0x07, 0xC0, 0x1F, 0xC0, 0x38, 0x00, 0x70, 0x00, 0x60, 0x00, 0xC0, 0x00, 0xDE, 0x00, 0xFF, 0x80, 0xE1, 0x80, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x61, 0xC0, 0x7F, 0x80, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '7'
+    0x00, 0x00, 0x00, 0x00, 0xFF, 0xC0, 0xFF, 0xC0, 0xC0, 0xC0, 0xC1, 0xC0, 0x01, 0x80, 0x01, 0x80, 0x03, 0x80, 0x03, 0x00, 0x03, 0x00, 0x07, 0x00, 0x06, 0x00, 0x06, 0x00, 0x0E, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '8'
+    0x00, 0x00, 0x00, 0x00, 0x3F, 0x00, 0x7F, 0x80, 0xE1, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x61, 0x80, 0x3F, 0x00, 0x3F, 0x00, 0x61, 0x80, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xE1, 0xC0, 0x7F, 0x80, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '9'
+    0x00, 0x00, 0x00, 0x00, 0x3E, 0x00, 0x7F, 0x80, 0xE1, 0x80, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x61, 0xC0, 0x7F, 0xC0, 0x1E, 0xC0, 0x00, 0xC0, 0x01, 0x80, 0x03, 0x80, 0x07, 0x00, 0xFE, 0x00, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // ':'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0xF0, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0xF0, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // ';'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3C, 0x3C, 0x3C, 0x00, 0x00, 0x00, 0x00, 0x38, 0x70, 0x60, 0x60, 0xC0, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '<'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1C, 0x00, 0x3C, 0x00, 0xF0, 0x03, 0xC0, 0x0F, 0x00, 0x3C, 0x00, 0xF0, 0x00, 0x3C, 0x00, 0x0F, 0x00, 0x03, 0xC0, 0x00, 0xF0, 0x00, 0x3C, 0x00, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '='
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xF8, 0xFF, 0xF8, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xF8, 0xFF, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '>'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0, 0x00, 0xF0, 0x00, 0x3C, 0x00, 0x0F, 0x00, 0x03, 0xC0, 0x00, 0xF0, 0x00, 0x3C, 0x00, 0xF0, 0x03, 0xC0, 0x0F, 0x00, 0x3C, 0x00, 0xF0, 0x00, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '?'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3E, 0x00, 0x7F, 0x00, 0xC3, 0x80, 0xC1, 0x80, 0xC1, 0x80, 0x03, 0x80, 0x07, 0x00, 0x1E, 0x00, 0x1C, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '@'
+    0x00, 0x00, 0x00, 0x00, 0x1F, 0x00, 0x3F, 0x80, 0x71, 0xC0, 0x60, 0xC0, 0xC3, 0xC0, 0xC7, 0xC0, 0xCE, 0xC0, 0xCC, 0xC0, 0xCC, 0xC0, 0xCC, 0xC0, 0xC7, 0xC0, 0xC3, 0xC0, 0xC0, 0x00, 0x60, 0x00, 0x70, 0xC0, 0x3F, 0xC0, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'A'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x80, 0x1F, 0xC0, 0x01, 0xC0, 0x03, 0x60, 0x03, 0x60, 0x06, 0x30, 0x06, 0x30, 0x0C, 0x30, 0x0F, 0xF8, 0x1F, 0xF8, 0x18, 0x0C, 0x30, 0x0C, 0xFC, 0x7F, 0xFC, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'B'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xC0, 0xFF, 0xE0, 0x30, 0x70, 0x30, 0x30, 0x30, 0x30, 0x30, 0x70, 0x3F, 0xE0, 0x3F, 0xF0, 0x30, 0x38, 0x30, 0x18, 0x30, 0x18, 0x30, 0x18, 0xFF, 0xF0, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'C'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0xB0, 0x3F, 0xF0, 0x70, 0x70, 0x60, 0x30, 0xC0, 0x30, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0x60, 0x30, 0x70, 0x70, 0x3F, 0xE0, 0x0F, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'D'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x80, 0xFF, 0xE0, 0x30, 0x70, 0x30, 0x30, 0x30, 0x18, 0x30, 0x18, 0x30, 0x18, 0x30, 0x18, 0x30, 0x18, 0x30, 0x18, 0x30, 0x30, 0x30, 0x70, 0xFF, 0xE0, 0xFF, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'E'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xF0, 0xFF, 0xF0, 0x30, 0x30, 0x30, 0x30, 0x33, 0x30, 0x33, 0x00, 0x3F, 0x00, 0x3F, 0x00, 0x33, 0x00, 0x33, 0x30, 0x30, 0x30, 0x30, 0x30, 0xFF, 0xF0, 0xFF, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'F'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xF0, 0xFF, 0xF0, 0x30, 0x30, 0x30, 0x30, 0x33, 0x30, 0x33, 0x00, 0x3F, 0x00, 0x3F, 0x00, 0x33, 0x00, 0x33, 0x00, 0x30, 0x00, 0x30, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'G'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0xB0, 0x3F, 0xF0, 0x70, 0x70, 0x60, 0x30, 0xC0, 0x30, 0xC0, 0x00, 0xC0, 0x00, 0xC3, 0xF8, 0xC3, 0xF8, 0xC0, 0x30, 0xE0, 0x30, 0x70, 0x70, 0x3F, 0xF0, 0x0F, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'H'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFC, 0xFC, 0xFC, 0xFC, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x3F, 0xF0, 0x3F, 0xF0, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0xFC, 0xFC, 0xFC, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'I'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xC0, 0xFF, 0xC0, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0xFF, 0xC0, 0xFF, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'J'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0xF8, 0x1F, 0xF8, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC1, 0x80, 0xFF, 0x80, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'K'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFE, 0x7C, 0xFE, 0x7C, 0x30, 0x60, 0x30, 0xC0, 0x31, 0x80, 0x33, 0x00, 0x37, 0x00, 0x3F, 0x80, 0x39, 0xC0, 0x30, 0xE0, 0x30, 0x60, 0x30, 0x70, 0xFE, 0x3E, 0xFE, 0x3E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'L'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0xFF, 0xF8, 0xFF, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'M'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x0F, 0xF8, 0x1F, 0x38, 0x1C, 0x3C, 0x3C, 0x3C, 0x3C, 0x36, 0x6C, 0x36, 0x6C, 0x33, 0xCC, 0x33, 0xCC, 0x31, 0x8C, 0x30, 0x0C, 0x30, 0x0C, 0xFE, 0x7F, 0xFE, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'N'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF1, 0xFC, 0xF1, 0xFC, 0x38, 0x30, 0x3C, 0x30, 0x3E, 0x30, 0x36, 0x30, 0x37, 0x30, 0x33, 0xB0, 0x31, 0xB0, 0x31, 0xF0, 0x30, 0xF0, 0x30, 0x70, 0xFE, 0x30, 0xFE, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'O'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x3F, 0xC0, 0x70, 0xE0, 0x60, 0x60, 0xE0, 0x70, 0xC0, 0x30, 0xC0, 0x30, 0xC0, 0x30, 0xC0, 0x30, 0xE0, 0x70, 0x60, 0x60, 0x70, 0xE0, 0x3F, 0xC0, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'P'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xC0, 0xFF, 0xE0, 0x30, 0x70, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x60, 0x3F, 0xE0, 0x3F, 0x80, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'Q'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x3F, 0xC0, 0x70, 0xE0, 0x60, 0x60, 0xE0, 0x70, 0xC0, 0x30, 0xC0, 0x30, 0xC0, 0x30, 0xC0, 0x30, 0xE0, 0x70, 0x60, 0x60, 0x70, 0xE0, 0x3F, 0xC0, 0x1F, 0x00, 0x1F, 0x30, 0x3F, 0xF0, 0x30, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'R'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xC0, 0xFF, 0xE0, 0x30, 0x70, 0x30, 0x30, 0x30, 0x30, 0x30, 0x70, 0x3F, 0xE0, 0x3F, 0x80, 0x31, 0xC0, 0x30, 0xE0, 0x30, 0x60, 0x30, 0x70, 0xFE, 0x3C, 0xFE, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'S'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3E, 0xC0, 0x7F, 0xC0, 0xE1, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xF0, 0x00, 0x7E, 0x00, 0x1F, 0x80, 0x03, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xE1, 0xC0, 0xFF, 0x80, 0xDF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'T'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xF0, 0xFF, 0xF0, 0xC6, 0x30, 0xC6, 0x30, 0xC6, 0x30, 0xC6, 0x30, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x3F, 0xC0, 0x3F, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'U'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFC, 0xFC, 0xFC, 0xFC, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x18, 0x60, 0x1F, 0xE0, 0x07, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'V'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFE, 0xFE, 0xFE, 0xFE, 0x30, 0x18, 0x18, 0x30, 0x18, 0x30, 0x18, 0x30, 0x0C, 0x60, 0x0C, 0x60, 0x06, 0xC0, 0x06, 0xC0, 0x06, 0xC0, 0x03, 0x80, 0x03, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'W'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFE, 0x3F, 0x80, 0xFE, 0x3F, 0x80, 0x30, 0x06, 0x00, 0x30, 0x06, 0x00, 0x30, 0x86, 0x00, 0x19, 0xCC, 0x00, 0x19, 0xCC, 0x00, 0x1B, 0x6C, 0x00, 0x1B, 0x6C, 0x00, 0x1E, 0x7C, 0x00, 0x0E, 0x38, 0x00, 0x0E, 0x38, 0x00, 0x0C, 0x18, 0x00, 0x0C, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'X'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFC, 0xFC, 0xFC, 0xFC, 0x30, 0x30, 0x18, 0x60, 0x0C, 0xC0, 0x07, 0x80, 0x03, 0x00, 0x03, 0x00, 0x07, 0x80, 0x0C, 0xC0, 0x18, 0x60, 0x30, 0x30, 0xFC, 0xFC, 0xFC, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'Y'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0xFC, 0xF8, 0xFC, 0x30, 0x30, 0x18, 0x60, 0x0C, 0xC0, 0x0C, 0xC0, 0x07, 0x80, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x1F, 0xE0, 0x1F, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'Z'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7F, 0xE0, 0x7F, 0xE0, 0x60, 0x60, 0x60, 0xC0, 0x61, 0x80, 0x63, 0x00, 0x06, 0x00, 0x0C, 0x00, 0x18, 0x60, 0x30, 0x60, 0x60, 0x60, 0xC0, 0x60, 0xFF, 0xE0, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '['
+    0x00, 0x00, 0xF8, 0xF8, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xF8, 0xF8, 0x00, 0x00, 0x00, 0x00,
+    // '\\'
+    0xC0, 0x00, 0xC0, 0x00, 0xE0, 0x00, 0x60, 0x00, 0x70, 0x00, 0x30, 0x00, 0x30, 0x00, 0x18, 0x00, 0x18, 0x00, 0x0C, 0x00, 0x0C, 0x00, 0x06, 0x00, 0x06, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x80, 0x01, 0x80, 0x01, 0xC0, 0x00, 0xC0, 0x00, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // ']'
+    0x00, 0x00, 0xF8, 0xF8, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0xF8, 0xF8, 0x00, 0x00, 0x00, 0x00,
+    // '^'
+    0x00, 0x00, 0x04, 0x00, 0x0E, 0x00, 0x1F, 0x00, 0x3B, 0x80, 0x31, 0x80, 0x60, 0xC0, 0xC0, 0x60, 0x80, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '_'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+    // '`'
+    0x00, 0xC0, 0xE0, 0x38, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'a'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x00, 0x7F, 0x80, 0x00, 0xC0, 0x00, 0xC0, 0x1F, 0xC0, 0x7F, 0xC0, 0xE0, 0xC0, 0xC0, 0xC0, 0xC1, 0xC0, 0x7F, 0xF0, 0x3E, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'b'
+    0x00, 0x00, 0x00, 0x00, 0xF0, 0x00, 0xF0, 0x00, 0x30, 0x00, 0x30, 0x00, 0x37, 0xC0, 0x3F, 0xF0, 0x38, 0x30, 0x30, 0x18, 0x30, 0x18, 0x30, 0x18, 0x30, 0x18, 0x30, 0x18, 0x38, 0x30, 0xFF, 0xF0, 0xF7, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'c'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0xB0, 0x3F, 0xF0, 0x70, 0x70, 0xE0, 0x30, 0xC0, 0x30, 0xC0, 0x00, 0xC0, 0x00, 0xE0, 0x30, 0x70, 0x70, 0x3F, 0xE0, 0x0F, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'd'
+    0x00, 0x00, 0x00, 0x00, 0x01, 0xE0, 0x01, 0xE0, 0x00, 0x60, 0x00, 0x60, 0x1F, 0x60, 0x7F, 0xE0, 0x60, 0xE0, 0xC0, 0x60, 0xC0, 0x60, 0xC0, 0x60, 0xC0, 0x60, 0xC0, 0x60, 0x60, 0xE0, 0x7F, 0xF8, 0x1F, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'e'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x80, 0x7F, 0xE0, 0x60, 0x60, 0xC0, 0x30, 0xFF, 0xF0, 0xFF, 0xF0, 0xC0, 0x00, 0xC0, 0x00, 0x60, 0x30, 0x7F, 0xF0, 0x1F, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'f'
+    0x00, 0x00, 0x00, 0x00, 0x07, 0xF0, 0x0F, 0xF0, 0x18, 0x00, 0x18, 0x00, 0xFF, 0xE0, 0xFF, 0xE0, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0xFF, 0xC0, 0xFF, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'g'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x78, 0x7F, 0xF8, 0x60, 0xE0, 0xC0, 0x60, 0xC0, 0x60, 0xC0, 0x60, 0xC0, 0x60, 0xC0, 0x60, 0x60, 0xE0, 0x7F, 0xE0, 0x1F, 0x60, 0x00, 0x60, 0x00, 0x60, 0x00, 0xE0, 0x3F, 0xC0, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'h'
+    0x00, 0x00, 0x00, 0x00, 0xF0, 0x00, 0xF0, 0x00, 0x30, 0x00, 0x30, 0x00, 0x37, 0xC0, 0x3F, 0xE0, 0x38, 0x70, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0xFC, 0xFC, 0xFC, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'i'
+    0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7E, 0x00, 0x7E, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0xFF, 0xF0, 0xFF, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'j'
+    0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x80, 0xFF, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x80, 0x01, 0x80, 0x03, 0x80, 0xFF, 0x00, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'k'
+    0x00, 0x00, 0x00, 0x00, 0xF0, 0x00, 0xF0, 0x00, 0x30, 0x00, 0x30, 0x00, 0x33, 0xE0, 0x33, 0xE0, 0x33, 0x00, 0x36, 0x00, 0x3E, 0x00, 0x3C, 0x00, 0x3E, 0x00, 0x37, 0x00, 0x33, 0x80, 0xF1, 0xF0, 0xF1, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'l'
+    0x00, 0x00, 0x00, 0x00, 0x7E, 0x00, 0x7E, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0x06, 0x00, 0xFF, 0xF0, 0xFF, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'm'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF7, 0x78, 0xFF, 0xFC, 0x39, 0xCC, 0x31, 0x8C, 0x31, 0x8C, 0x31, 0x8C, 0x31, 0x8C, 0x31, 0x8C, 0x31, 0x8C, 0xFD, 0xEF, 0xFD, 0xEF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'n'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF7, 0xC0, 0xFF, 0xE0, 0x38, 0x70, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0xFC, 0xFC, 0xFC, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'o'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x3F, 0xC0, 0x70, 0xE0, 0xE0, 0x70, 0xC0, 0x30, 0xC0, 0x30, 0xC0, 0x30, 0xE0, 0x70, 0x70, 0xE0, 0x3F, 0xC0, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'p'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF7, 0xC0, 0xFF, 0xF0, 0x38, 0x30, 0x30, 0x18, 0x30, 0x18, 0x30, 0x18, 0x30, 0x18, 0x30, 0x18, 0x38, 0x30, 0x3F, 0xF0, 0x37, 0xC0, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0xFE, 0x00, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'q'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x78, 0x7F, 0xF8, 0x60, 0xE0, 0xC0, 0x60, 0xC0, 0x60, 0xC0, 0x60, 0xC0, 0x60, 0xC0, 0x60, 0x60, 0xE0, 0x7F, 0xE0, 0x1F, 0x60, 0x00, 0x60, 0x00, 0x60, 0x00, 0x60, 0x03, 0xF8, 0x03, 0xF8, 0x00, 0x00, 0x00, 0x00,
+    // 'r'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF9, 0xE0, 0xFB, 0xF0, 0x1F, 0x30, 0x1C, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0x18, 0x00, 0xFF, 0xC0, 0xFF, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 's'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0xC0, 0x7F, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xFC, 0x00, 0x7F, 0x80, 0x07, 0xC0, 0xC0, 0xC0, 0xC1, 0xC0, 0xFF, 0x80, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 't'
+    0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0xFF, 0xC0, 0xFF, 0xC0, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x00, 0x30, 0x70, 0x1F, 0xF0, 0x0F, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'u'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0xF0, 0xF0, 0xF0, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x70, 0x1F, 0xFC, 0x0F, 0xBC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'v'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0x7C, 0xF8, 0x7C, 0x30, 0x30, 0x30, 0x30, 0x18, 0x60, 0x18, 0x60, 0x0C, 0xC0, 0x0C, 0xC0, 0x0F, 0xC0, 0x07, 0x80, 0x07, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'w'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x78, 0xF0, 0x78, 0x62, 0x30, 0x67, 0x30, 0x67, 0x30, 0x35, 0x60, 0x3D, 0xE0, 0x3D, 0xE0, 0x38, 0xC0, 0x18, 0xC0, 0x18, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'x'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF9, 0xF0, 0xF9, 0xF0, 0x30, 0xC0, 0x19, 0x80, 0x0F, 0x00, 0x06, 0x00, 0x0F, 0x00, 0x19, 0x80, 0x30, 0xC0, 0xF9, 0xF0, 0xF9, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // 'y'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFC, 0x3E, 0xFC, 0x3E, 0x30, 0x18, 0x18, 0x30, 0x18, 0x30, 0x0C, 0x60, 0x0C, 0x60, 0x06, 0xC0, 0x07, 0xC0, 0x03, 0x80, 0x01, 0x80, 0x03, 0x00, 0x03, 0x00, 0x06, 0x00, 0x7F, 0x80, 0x7F, 0x80, 0x00, 0x00, 0x00, 0x00,
+    // 'z'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xC0, 0xFF, 0xC0, 0xC1, 0x80, 0xC3, 0x00, 0x06, 0x00, 0x0C, 0x00, 0x18, 0x00, 0x30, 0xC0, 0x60, 0xC0, 0xFF, 0xC0, 0xFF, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '{'
+    0x00, 0x00, 0x1C, 0x3C, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x70, 0xE0, 0x70, 0x30, 0x30, 0x30, 0x30, 0x30, 0x3C, 0x1C, 0x00, 0x00, 0x00, 0x00,
+    // '|'
+    0x00, 0x00, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x00, 0x00, 0x00, 0x00,
+    // '}'
+    0x00, 0x00, 0xE0, 0xF0, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x38, 0x1C, 0x38, 0x30, 0x30, 0x30, 0x30, 0x30, 0xF0, 0xE0, 0x00, 0x00, 0x00, 0x00,
+    // '~'
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x7C, 0x60, 0xEE, 0xE0, 0xC7, 0xC0, 0x03, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const PropGlyph PropFont24_Glyphs[] = {
+    {0, 0, 8, 0}, // ' '
+    {0, 3, 5, 1}, // '!'
+    {24, 8, 10, 1}, // '"'
+    {48, 11, 13, 1}, // '#'
+    {96, 9, 11, 1}, // '$'
+    {144, 10, 12, 1}, // '%'
+    {192, 11, 13, 1}, // '&'
+    {240, 3, 5, 1}, // "'"
+    {264, 6, 8, 1}, // '('
+    {288, 6, 8, 1}, // ')'
+    {312, 10, 12, 1}, // '*'
+    {360, 12, 14, 1}, // '+'
+    {408, 5, 7, 1}, // ','
+    {432, 10, 12, 1}, // '-'
+    {480, 4, 6, 1}, // '.'
+    {504, 10, 12, 1}, // '/'
+    {552, 10, 12, 1}, // '0'
+    {600, 10, 12, 1}, // '1'
+    {648, 11, 13, 1}, // '2'
+    {696, 10, 12, 1}, // '3'
+    {744, 11, 13, 1}, // '4'
+    {792, 11, 13, 1}, // '5'
+    {840, 10, 12, 1}, // '6'
+    {888, 10, 12, 1}, // '7'
+    {936, 10, 12, 1}, // '8'
+    {984, 10, 12, 1}, // '9'
+    {1032, 4, 6, 1}, // ':'
+    {1056, 6, 8, 1}, // ';'
+    {1080, 14, 16, 1}, // '<'
+    {1128, 13, 15, 1}, // '='
+    {1176, 14, 16, 1}, // '>'
+    {1224, 9, 11, 1}, // '?'
+    {1272, 10, 12, 1}, // '@'
+    {1320, 16, 18, 1}, // 'A'
+    {1368, 13, 15, 1}, // 'B'
+    {1416, 12, 14, 1}, // 'C'
+    {1464, 13, 15, 1}, // 'D'
+    {1512, 12, 14, 1}, // 'E'
+    {1560, 12, 14, 1}, // 'F'
+    {1608, 13, 15, 1}, // 'G'
+    {1656, 14, 16, 1}, // 'H'
+    {1704, 10, 12, 1}, // 'I'
+    {1752, 13, 15, 1}, // 'J'
+    {1800, 15, 17, 1}, // 'K'
+    {1848, 13, 15, 1}, // 'L'
+    {1896, 16, 18, 1}, // 'M'
+    {1944, 14, 16, 1}, // 'N'
+    {1992, 12, 14, 1}, // 'O'
+    {2040, 12, 14, 1}, // 'P'
+    {2088, 12, 14, 1}, // 'Q'
+    {2136, 14, 16, 1}, // 'R'
+    {2184, 10, 12, 1}, // 'S'
+    {2232, 12, 14, 1}, // 'T'
+    {2280, 14, 16, 1}, // 'U'
+    {2328, 15, 17, 1}, // 'V'
+    {2376, 17, 19, 1}, // 'W'
+    {2448, 14, 16, 1}, // 'X'
+    {2496, 14, 16, 1}, // 'Y'
+    {2544, 11, 13, 1}, // 'Z'
+    {2592, 5, 7, 1}, // '['
+    {2616, 10, 12, 1}, // '\\'
+    {2664, 5, 7, 1}, // ']'
+    {2688, 11, 13, 1}, // '^'
+    {2736, 16, 18, 1}, // '_'
+    {2784, 5, 7, 1}, // '`'
+    {2808, 12, 14, 1}, // 'a'
+    {2856, 13, 15, 1}, // 'b'
+    {2904, 12, 14, 1}, // 'c'
+    {2952, 13, 15, 1}, // 'd'
+    {3000, 12, 14, 1}, // 'e'
+    {3048, 12, 14, 1}, // 'f'
+    {3096, 13, 15, 1}, // 'g'
+    {3144, 14, 16, 1}, // 'h'
+    {3192, 12, 14, 1}, // 'i'
+    {3240, 9, 11, 1}, // 'j'
+    {3288, 12, 14, 1}, // 'k'
+    {3336, 12, 14, 1}, // 'l'
+    {3384, 16, 18, 1}, // 'm'
+    {3432, 14, 16, 1}, // 'n'
+    {3480, 12, 14, 1}, // 'o'
+    {3528, 13, 15, 1}, // 'p'
+    {3576, 13, 15, 1}, // 'q'
+    {3624, 12, 14, 1}, // 'r'
+    {3672, 10, 12, 1}, // 's'
+    {3720, 12, 14, 1}, // 't'
+    {3768, 14, 16, 1}, // 'u'
+    {3816, 14, 16, 1}, // 'v'
+    {3864, 13, 15, 1}, // 'w'
+    {3912, 12, 14, 1}, // 'x'
+    {3960, 15, 17, 1}, // 'y'
+    {4008, 10, 12, 1}, // 'z'
+    {4056, 6, 8, 1}, // '{'
+    {4080, 2, 4, 1}, // '|'
+    {4104, 6, 8, 1}, // '}'
+    {4128, 11, 13, 1}, // '~'
+};
+
+static const PropFontRange PropFont24_Ranges[] = {
+    {0x20, 95, 0},
+};
+
+const PropFont PropFont24 = {
+    PropFont24_Bitmaps,
+    PropFont24_Glyphs,
+    PropFont24_Ranges,
+    1, /* ranges */
+    24, /* height */
+    31, /* fallback: '?' */
+};
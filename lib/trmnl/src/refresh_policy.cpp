@@ -0,0 +1,86 @@
+#include <refresh_policy.h>
+#include <wake_state.h>
+#include <string.h>
+
+void refresh_bands_update(uint32_t *bands, size_t frame_size, size_t offset, const uint8_t *data, size_t size)
+{
+  size_t band_size = (frame_size + REFRESH_BANDS - 1) / REFRESH_BANDS;
+  while (size && offset < frame_size)
+  {
+    size_t band = offset / band_size;
+    size_t count = band_size - offset % band_size;
+    if (count > size)
+      count = size;
+    bands[band] = wake_state_crc32_update(bands[band], data, count);
+    offset += count;
+    data += count;
+    size -= count;
+  }
+}
+
+uint8_t refresh_dirty_percent(const RefreshState &state, const uint32_t *bands)
+{
+  if (state.magic != REFRESH_STATE_MAGIC)
+    return 100;
+
+  unsigned changed = 0;
+  for (size_t i = 0; i < REFRESH_BANDS; i++)
+  {
+    if (state.bands[i] != bands[i])
+      changed++;
+  }
+  return changed * 100 / REFRESH_BANDS;
+}
+
+RefreshChoice refresh_choose(const RefreshState &state, bool timer_wake, int16_t temperature, uint8_t dirty_percent)
+{
+  if (state.magic != REFRESH_STATE_MAGIC)
+    return REFRESH_FULL_FIRST;
+  if (!timer_wake)
+    return REFRESH_FULL_WAKE;
+  if (state.fast_count >= REFRESH_FULL_EVERY)
+    return REFRESH_FULL_COUNT;
+  if (temperature != REFRESH_NO_TEMPERATURE && state.temperature != REFRESH_NO_TEMPERATURE &&
+      abs(temperature - state.temperature) >= REFRESH_TEMPERATURE_DELTA)
+    return REFRESH_FULL_TEMPERATURE;
+  if (dirty_percent > REFRESH_DIRTY_PERCENT)
+    return REFRESH_FULL_DIRTY;
+  return REFRESH_FAST;
+}
+
+void refresh_record(RefreshState &state, bool full, int16_t temperature, const uint32_t *bands)
+{
+  state.dirty_percent = state.magic == REFRESH_STATE_MAGIC ? refresh_dirty_percent(state, bands) : 0;
+  if (full || state.magic != REFRESH_STATE_MAGIC)
+  {
+    state.fast_count = 0;
+    state.temperature = temperature;
+  }
+  else
+  {
+    state.fast_count++;
+  }
+  memcpy(state.bands, bands, sizeof(state.bands));
+  state.magic = REFRESH_STATE_MAGIC;
+}
+
+const char *refresh_choice_name(RefreshChoice choice)
+{
+  switch (choice)
+  {
+  case REFRESH_FAST:
+    return "fast";
+  case REFRESH_FULL_FIRST:
+    return "full, first";
+  case REFRESH_FULL_WAKE:
+    return "full, not a timer wake";
+  case REFRESH_FULL_COUNT:
+    return "full, periodic";
+  case REFRESH_FULL_TEMPERATURE:
+    return "full, temperature";
+  case REFRESH_FULL_DIRTY:
+    return "full, large change";
+  default:
+    return "?";
+  }
+}
@@ -32,6 +32,11 @@ String serialize_log(const LogWithDetails &input)
     json_log["additional_info"]["retry_attempt"] = input.retryAttempt;
   }
 
+  if (input.flightRecord && input.flightRecord[0])
+  {
+    json_log["additional_info"]["flight_recorder"] = input.flightRecord;
+  }
+
   String json_string;
   serializeJson(json_log, json_string);
   return json_string;
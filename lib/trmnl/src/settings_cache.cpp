@@ -0,0 +1,220 @@
+#include <settings_cache.h>
+#include <string.h>
+
+SettingsCache::SettingsCache(SettingsStore &store, const SettingDef *defs, size_t count, SettingsStore *volatile_store)
+    : store(store), volatile_store(volatile_store), entry_count(0)
+{
+  for (size_t i = 0; i < count && i < SETTINGS_CACHE_MAX_ENTRIES; i++)
+  {
+    entries[entry_count].def = &defs[i];
+    entries[entry_count].present = false;
+    entries[entry_count].dirty = false;
+    entries[entry_count].number = 0;
+    entry_count++;
+  }
+}
+
+void SettingsCache::read(SettingsStore &from, Entry &entry)
+{
+  switch (entry.def->type)
+  {
+  case SettingType::Bool:
+    entry.number = from.getBool(entry.def->key);
+    break;
+  case SettingType::Int:
+    entry.number = from.getInt(entry.def->key);
+    break;
+  case SettingType::UInt:
+    entry.number = from.getUInt(entry.def->key);
+    break;
+  case SettingType::String:
+    entry.text = from.getString(entry.def->key);
+    break;
+  }
+}
+
+size_t SettingsCache::write(SettingsStore &to, const Entry &entry)
+{
+  switch (entry.def->type)
+  {
+  case SettingType::Bool:
+    return to.putBool(entry.def->key, entry.number != 0);
+  case SettingType::Int:
+    return to.putInt(entry.def->key, (int32_t)entry.number);
+  case SettingType::UInt:
+    return to.putUInt(entry.def->key, (uint32_t)entry.number);
+  case SettingType::String:
+    // an empty string is a successful write of 0 bytes
+    return to.putString(entry.def->key, entry.text) > 0 || entry.text.length() == 0;
+  }
+  return 0;
+}
+
+void SettingsCache::load(void)
+{
+  for (size_t i = 0; i < entry_count; i++)
+  {
+    Entry &entry = entries[i];
+    entry.dirty = false;
+    entry.number = 0;
+    entry.text = String();
+
+    SettingsStore *from = &store;
+    if (entry.def->volatile_state && volatile_store && volatile_store->isKey(entry.def->key))
+      from = volatile_store;
+
+    entry.present = from->isKey(entry.def->key);
+    if (entry.present)
+      read(*from, entry);
+  }
+}
+
+size_t SettingsCache::commit(void)
+{
+  size_t written = 0;
+  for (size_t i = 0; i < entry_count; i++)
+  {
+    Entry &entry = entries[i];
+    if (!entry.dirty)
+      continue;
+    entry.dirty = false;
+
+    bool use_volatile = entry.def->volatile_state && volatile_store;
+    if (!entry.present)
+    {
+      if (use_volatile)
+        volatile_store->remove(entry.def->key);
+      store.remove(entry.def->key);
+      written++;
+      continue;
+    }
+
+    if (use_volatile && write(*volatile_store, entry))
+      continue;
+
+    // no room in the volatile store: drop any stale copy there so the persistent value is read back
+    if (use_volatile)
+      volatile_store->remove(entry.def->key);
+    write(store, entry);
+    written++;
+  }
+  return written;
+}
+
+bool SettingsCache::dirty(void) const
+{
+  for (size_t i = 0; i < entry_count; i++)
+  {
+    if (entries[i].dirty)
+      return true;
+  }
+  return false;
+}
+
+SettingsCache::Entry *SettingsCache::find(const char *key)
+{
+  for (size_t i = 0; i < entry_count; i++)
+  {
+    if (strcmp(entries[i].def->key, key) == 0)
+      return &entries[i];
+  }
+  return nullptr;
+}
+
+bool SettingsCache::isKey(const char *key)
+{
+  Entry *entry = find(key);
+  return entry ? entry->present : store.isKey(key);
+}
+
+bool SettingsCache::getBool(const char *key, bool default_value)
+{
+  Entry *entry = find(key);
+  if (!entry)
+    return store.isKey(key) ? store.getBool(key) : default_value;
+  return entry->present ? entry->number != 0 : default_value;
+}
+
+int32_t SettingsCache::getInt(const char *key, int32_t default_value)
+{
+  Entry *entry = find(key);
+  if (!entry)
+    return store.isKey(key) ? store.getInt(key) : default_value;
+  return entry->present ? (int32_t)entry->number : default_value;
+}
+
+uint32_t SettingsCache::getUInt(const char *key, uint32_t default_value)
+{
+  Entry *entry = find(key);
+  if (!entry)
+    return store.isKey(key) ? store.getUInt(key) : default_value;
+  return entry->present ? (uint32_t)entry->number : default_value;
+}
+
+String SettingsCache::getString(const char *key, const String &default_value)
+{
+  Entry *entry = find(key);
+  if (!entry)
+    return store.isKey(key) ? store.getString(key) : default_value;
+  return entry->present ? entry->text : default_value;
+}
+
+size_t SettingsCache::putNumber(const char *key, int64_t value, size_t size)
+{
+  Entry *entry = find(key);
+  if (!entry->present || entry->number != value)
+  {
+    entry->number = value;
+    entry->present = true;
+    entry->dirty = true;
+  }
+  return size;
+}
+
+size_t SettingsCache::putBool(const char *key, bool value)
+{
+  if (!find(key))
+    return store.putBool(key, value);
+  return putNumber(key, value ? 1 : 0, sizeof(uint8_t));
+}
+
+size_t SettingsCache::putInt(const char *key, int32_t value)
+{
+  if (!find(key))
+    return store.putInt(key, value);
+  return putNumber(key, value, sizeof(int32_t));
+}
+
+size_t SettingsCache::putUInt(const char *key, uint32_t value)
+{
+  if (!find(key))
+    return store.putUInt(key, value);
+  return putNumber(key, value, sizeof(uint32_t));
+}
+
+size_t SettingsCache::putString(const char *key, const String &value)
+{
+  Entry *entry = find(key);
+  if (!entry)
+    return store.putString(key, value);
+  if (!entry->present || !entry->text.equals(value))
+  {
+    entry->text = value;
+    entry->present = true;
+    entry->dirty = true;
+  }
+  return value.length();
+}
+
+bool SettingsCache::remove(const char *key)
+{
+  Entry *entry = find(key);
+  if (!entry)
+    return store.remove(key);
+  if (entry->present)
+  {
+    entry->present = false;
+    entry->dirty = true;
+  }
+  return true;
+}
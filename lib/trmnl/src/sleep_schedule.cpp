@@ -0,0 +1,102 @@
+#include <sleep_schedule.h>
+#include <string.h>
+
+void schedule_observe(ScheduleState &state, bool changed, uint32_t slept_s)
+{
+  if (state.magic != SCHEDULE_STATE_MAGIC)
+  {
+    memset(&state, 0, sizeof(state));
+    state.magic = SCHEDULE_STATE_MAGIC;
+  }
+  if (slept_s == 0)
+    slept_s = state.sleep_s;
+  state.unchanged_s = UINT32_MAX - state.unchanged_s < slept_s ? UINT32_MAX : state.unchanged_s + slept_s;
+  if (!changed)
+    return;
+
+  // the first change ends an interval whose start is unknown
+  if (state.changes == SCHEDULE_CHANGES_TO_LEARN - 1)
+    state.change_interval_s = state.unchanged_s;
+  else if (state.changes >= SCHEDULE_CHANGES_TO_LEARN)
+    state.change_interval_s = (3 * (uint64_t)state.change_interval_s + state.unchanged_s) / 4;
+  if (state.changes < SCHEDULE_CHANGES_TO_LEARN)
+    state.changes++;
+  state.unchanged_s = 0;
+}
+
+uint32_t schedule_sleep(ScheduleState &state, const ScheduleInputs &inputs, ScheduleReason &reason)
+{
+  uint64_t sleep = inputs.refresh_rate;
+  reason = SCHEDULE_SERVER;
+
+  if (state.magic == SCHEDULE_STATE_MAGIC && state.changes >= SCHEDULE_CHANGES_TO_LEARN)
+  {
+    // an image unchanged for longer than usual changes less often than thought
+    uint32_t interval = state.unchanged_s > state.change_interval_s ? state.unchanged_s : state.change_interval_s;
+    if (interval / 2 > sleep)
+    {
+      sleep = interval / 2;
+      reason = SCHEDULE_CHANGE_RATE;
+    }
+  }
+
+  if (inputs.battery_mv && inputs.battery_mv < SCHEDULE_BATTERY_FULL_MV)
+  {
+    const uint32_t range = SCHEDULE_BATTERY_FULL_MV - SCHEDULE_BATTERY_LOW_MV;
+    uint32_t drop = SCHEDULE_BATTERY_FULL_MV - inputs.battery_mv;
+    if (drop > range)
+      drop = range;
+    uint64_t stretched = sleep * (range + (SCHEDULE_BATTERY_STRETCH - 1) * drop) / range;
+    if (stretched > sleep)
+    {
+      sleep = stretched;
+      reason = SCHEDULE_BATTERY;
+    }
+  }
+
+  uint64_t longest = (uint64_t)inputs.refresh_rate * SCHEDULE_MAX_STRETCH;
+  if (sleep > longest)
+    sleep = longest;
+
+  if (inputs.time_of_day != SCHEDULE_NO_TIME && inputs.quiet_start != inputs.quiet_end)
+  {
+    uint32_t now = inputs.time_of_day % SCHEDULE_DAY_S;
+    uint32_t start = inputs.quiet_start * 60 % SCHEDULE_DAY_S;
+    uint32_t length = (inputs.quiet_end * 60 + SCHEDULE_DAY_S - start) % SCHEDULE_DAY_S;
+    uint32_t since_start = (now + SCHEDULE_DAY_S - start) % SCHEDULE_DAY_S;
+    uint32_t to_start = (SCHEDULE_DAY_S - since_start) % SCHEDULE_DAY_S;
+
+    // inside the window, or the next wake would be: sleep until it ends
+    uint64_t wake = 0;
+    if (since_start < length)
+      wake = length - since_start;
+    else if (to_start <= sleep)
+      wake = to_start + length;
+    if (wake > sleep)
+    {
+      sleep = wake;
+      reason = SCHEDULE_QUIET;
+    }
+  }
+
+  if (sleep > UINT32_MAX)
+    sleep = UINT32_MAX;
+  state.sleep_s = sleep;
+  return sleep;
+}
+
+const char *schedule_reason_name(ScheduleReason reason)
+{
+  switch (reason)
+  {
+  case SCHEDULE_SERVER:
+    return "refresh rate";
+  case SCHEDULE_CHANGE_RATE:
+    return "image change rate";
+  case SCHEDULE_BATTERY:
+    return "low battery";
+  case SCHEDULE_QUIET:
+    return "quiet hours";
+  }
+  return "unknown";
+}
@@ -0,0 +1,157 @@
+#include <wake_state.h>
+#include <string.h>
+
+uint32_t wake_state_crc32(const uint8_t *data, size_t size)
+{
+  return wake_state_crc32_update(0, data, size);
+}
+
+uint32_t wake_state_crc32_update(uint32_t crc, const uint8_t *data, size_t size)
+{
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++)
+  {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
+
+static uint32_t slots_crc(const WakeState &state)
+{
+  return wake_state_crc32((const uint8_t *)state.slots, sizeof(state.slots));
+}
+
+bool wake_state_valid(const WakeState &state)
+{
+  return state.version == WAKE_STATE_VERSION && state.crc == slots_crc(state);
+}
+
+void wake_state_reset(WakeState &state)
+{
+  memset(&state, 0, sizeof(state));
+  state.version = WAKE_STATE_VERSION;
+  state.crc = slots_crc(state);
+}
+
+WakeStateStore::WakeStateStore(WakeState &state) : state(state), was_valid(wake_state_valid(state))
+{
+  if (!was_valid)
+    wake_state_reset(state);
+}
+
+void WakeStateStore::seal(void)
+{
+  state.crc = slots_crc(state);
+}
+
+WakeStateSlot *WakeStateStore::find(const char *key)
+{
+  for (WakeStateSlot &slot : state.slots)
+  {
+    if (slot.key[0] && strncmp(slot.key, key, sizeof(slot.key)) == 0)
+      return &slot;
+  }
+  return nullptr;
+}
+
+WakeStateSlot *WakeStateStore::slotFor(const char *key)
+{
+  if (strlen(key) >= sizeof(WakeStateSlot::key))
+    return nullptr;
+
+  WakeStateSlot *slot = find(key);
+  if (slot)
+    return slot;
+  for (WakeStateSlot &free_slot : state.slots)
+  {
+    if (!free_slot.key[0])
+    {
+      memset(&free_slot, 0, sizeof(free_slot));
+      strcpy(free_slot.key, key);
+      return &free_slot;
+    }
+  }
+  return nullptr;
+}
+
+bool WakeStateStore::isKey(const char *key)
+{
+  return find(key) != nullptr;
+}
+
+bool WakeStateStore::getBool(const char *key)
+{
+  WakeStateSlot *slot = find(key);
+  return slot && slot->number != 0;
+}
+
+int32_t WakeStateStore::getInt(const char *key)
+{
+  WakeStateSlot *slot = find(key);
+  return slot ? (int32_t)slot->number : 0;
+}
+
+uint32_t WakeStateStore::getUInt(const char *key)
+{
+  WakeStateSlot *slot = find(key);
+  return slot ? slot->number : 0;
+}
+
+String WakeStateStore::getString(const char *key)
+{
+  WakeStateSlot *slot = find(key);
+  return slot && slot->is_text ? String(slot->text) : String();
+}
+
+size_t WakeStateStore::putNumber(const char *key, uint32_t value, size_t size)
+{
+  WakeStateSlot *slot = slotFor(key);
+  if (!slot)
+    return 0;
+  slot->is_text = 0;
+  slot->number = value;
+  seal();
+  return size;
+}
+
+size_t WakeStateStore::putBool(const char *key, bool value)
+{
+  return putNumber(key, value ? 1 : 0, sizeof(uint8_t));
+}
+
+size_t WakeStateStore::putInt(const char *key, int32_t value)
+{
+  return putNumber(key, (uint32_t)value, sizeof(int32_t));
+}
+
+size_t WakeStateStore::putUInt(const char *key, uint32_t value)
+{
+  return putNumber(key, value, sizeof(uint32_t));
+}
+
+size_t WakeStateStore::putString(const char *key, const String &value)
+{
+  if (value.length() >= WAKE_STATE_TEXT_SIZE)
+    return 0;
+  WakeStateSlot *slot = slotFor(key);
+  if (!slot)
+    return 0;
+  slot->is_text = 1;
+  memset(slot->text, 0, sizeof(slot->text));
+  memcpy(slot->text, value.c_str(), value.length());
+  seal();
+  // like Preferences, report the bytes written; an empty string is stored but reports 0
+  return value.length();
+}
+
+bool WakeStateStore::remove(const char *key)
+{
+  WakeStateSlot *slot = find(key);
+  if (!slot)
+    return false;
+  memset(slot, 0, sizeof(*slot));
+  seal();
+  return true;
+}
@@ -475,7 +475,7 @@ std::vector<WifiCaptive::Network> WifiCaptive::getScannedUniqueNetworks(bool run
             {
                 if (network.ssid == ssid)
                 {
-                    Serial.println("Equal SSID");
+                    Log_verbose("Equal SSID %s", ssid.c_str());
                     found = true;
                     if (network.rssi < rssi)
                     {
@@ -494,7 +494,7 @@ std::vector<WifiCaptive::Network> WifiCaptive::getScannedUniqueNetworks(bool run
     Log_info("Unique networks found: %d", uniqueNetworks.size());
     for (auto &network : uniqueNetworks)
     {
-        Log_info("SSID: %s, RSSI: %d, Open: %d", network.ssid.c_str(), network.rssi, network.open);
+        Log_verbose("SSID: %s, RSSI: %d, Open: %d", network.ssid.c_str(), network.rssi, network.open);
     }
 
     return uniqueNetworks;
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""Compress the images built into the firmware into src/ImageData.c.
+
+Each asset is a 1bpp BMP or binary PBM, given as name=path. The rows are
+stored from the top, (width + 7) / 8 bytes each with 1 for a white pixel, as
+the framebuffer has them, and LZSS-compressed in the format of
+lib/trmnl/include/lzss.h so the firmware decodes them straight into the
+framebuffer.
+
+    scripts/compress_assets.py default_icon=logo.bmp \\
+        wifi_connect_qr=assets/wifi_connect_qr.pbm \\
+        wifi_failed_qr=assets/wifi_failed_qr.pbm > src/ImageData.c
+"""
+
+import argparse
+import struct
+import sys
+
+WINDOW = 256
+MIN_MATCH = 3
+MAX_MATCH = 0x7F + MIN_MATCH
+MAX_LITERALS = 0x80
+
+
+def read_bmp(data):
+    if data[:2] != b"BM":
+        raise ValueError("not a BMP")
+    offset = struct.unpack_from("<I", data, 10)[0]
+    header_size = struct.unpack_from("<I", data, 14)[0]
+    width, height, _, bpp = struct.unpack_from("<iiHH", data, 18)
+    if bpp != 1:
+        raise ValueError(f"{bpp} bits per pixel, only 1bpp BMPs are supported")
+    palette = data[14 + header_size : 14 + header_size + 8]
+    # 1 must be white on the panel, whatever the palette says
+    invert = palette[0] > palette[4]
+
+    row_bytes = (width + 7) // 8
+    stride = (row_bytes + 3) // 4 * 4
+    rows = [data[offset + y * stride : offset + y * stride + row_bytes] for y in range(abs(height))]
+    if height > 0:
+        rows.reverse()  # bottom-up
+    pixels = b"".join(rows)
+    if invert:
+        pixels = bytes(b ^ 0xFF for b in pixels)
+    return width, abs(height), pixels
+
+
+def read_pbm(data):
+    fields, pos = [], 0
+    while len(fields) < 3:
+        while data[pos : pos + 1].isspace() or data[pos : pos + 1] == b"#":
+            if data[pos : pos + 1] == b"#":
+                pos = data.index(b"\n", pos)
+            pos += 1
+        start = pos
+        while not data[pos : pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    if fields[0] != b"P4":
+        raise ValueError("not a binary PBM")
+    width, height = int(fields[1]), int(fields[2])
+    pixels = data[pos + 1 : pos + 1 + (width + 7) // 8 * height]
+    return width, height, bytes(b ^ 0xFF for b in pixels)  # PBM has 1 for black
+
+
+def compress(data):
+    out, literals = bytearray(), bytearray()
+
+    def flush():
+        if literals:
+            out.append(len(literals) - 1)
+            out.extend(literals)
+            literals.clear()
+
+    pos = 0
+    while pos < len(data):
+        best, best_distance = 0, 0
+        for distance in range(1, min(WINDOW, pos) + 1):
+            length = 0
+            while pos + length < len(data) and length < MAX_MATCH and data[pos + length] == data[pos + length - distance]:
+                length += 1
+            if length > best:
+                best, best_distance = length, distance
+        if best >= MIN_MATCH:
+            flush()
+            out.append(0x80 | (best - MIN_MATCH))
+            out.append(best_distance - 1)
+            pos += best
+        else:
+            literals.append(data[pos])
+            pos += 1
+            if len(literals) == MAX_LITERALS:
+                flush()
+    flush()
+    return bytes(out)
+
+
+def decompress(data):
+    out, pos = bytearray(), 0
+    while pos < len(data):
+        control = data[pos]
+        if control < 0x80:
+            out.extend(data[pos + 1 : pos + 2 + control])
+            pos += 2 + control
+        else:
+            distance = data[pos + 1] + 1
+            for _ in range((control & 0x7F) + MIN_MATCH):
+                out.append(out[-distance])
+            pos += 2
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("assets", nargs="+", metavar="name=path")
+    args = parser.parse_args()
+
+    out = sys.stdout
+    out.write("// Generated by scripts/compress_assets.py, do not edit.\n")
+    out.write('#include "ImageData.h"\n')
+    for asset in args.assets:
+        name, path = asset.split("=", 1)
+        data = open(path, "rb").read()
+        width, height, pixels = read_pbm(data) if path.endswith(".pbm") else read_bmp(data)
+        packed = compress(pixels)
+        assert decompress(packed) == pixels
+        print(f"{name}: {width}x{height}, {len(pixels)} -> {len(packed)} bytes", file=sys.stderr)
+
+        out.write(f"\n// {path}, {len(pixels)} bytes\n")
+        out.write(f"static const uint8_t {name}_data[{len(packed)}] = {{\n")
+        for start in range(0, len(packed), 16):
+            out.write("    " + ", ".join(f"0x{b:02x}" for b in packed[start : start + 16]) + ",\n")
+        out.write("};\n")
+        out.write(f"const CompressedImage {name} = {{{name}_data, sizeof({name}_data), {width}, {height}}};\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""Make a firmware patch that turns one application image into another.
+
+The device applies it against the image it runs, block by block as it is
+downloaded (see lib/trmnl/include/ota_delta.h). Each 4 kB block of the new
+image is matched against the old one: the byte differences from the best
+offset found are mostly zeros when the code only moved or a few addresses
+changed, and LZSS packs them into runs. Blocks with nothing alike in the
+old image are packed as they are.
+
+    scripts/make_firmware_patch.py old/firmware.bin new/firmware.bin patch.bin
+
+The server announces the patch as firmware_patch_url next to firmware_url,
+with firmware_sha256 the SHA-256 of the new image. The patch is checked by
+applying it here before it is written.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+from collections import Counter
+
+from compress_assets import MAX_LITERALS, MAX_MATCH, MIN_MATCH, WINDOW, decompress
+
+MAGIC = 0x50445254  # "TRDP"
+BLOCK_SIZE = 4096
+NO_SOURCE = 0xFFFFFFFF
+GRAM = 8  # bytes that locate a block in the old image
+SAMPLE_STEP = 16  # bytes of the block between two lookups
+CANDIDATES = 4
+CHAIN = 16  # earlier positions tried per match
+
+
+def compress(data):
+    """compress_assets.compress() with hash chains, fast enough for a whole image."""
+    out, literals = bytearray(), bytearray()
+    recent = {}
+
+    def flush():
+        if literals:
+            out.append(len(literals) - 1)
+            out.extend(literals)
+            literals.clear()
+
+    def remember(pos):
+        if pos + MIN_MATCH <= len(data):
+            chain = recent.setdefault(data[pos : pos + MIN_MATCH], [])
+            chain.append(pos)
+            if len(chain) > CHAIN:
+                del chain[0]
+
+    pos = 0
+    while pos < len(data):
+        best, best_distance = 0, 0
+        for start in reversed(recent.get(data[pos : pos + MIN_MATCH], ())):
+            distance = pos - start
+            if distance > WINDOW:
+                break
+            length = 0
+            while pos + length < len(data) and length < MAX_MATCH and data[pos + length] == data[pos + length - distance]:
+                length += 1
+            if length > best:
+                best, best_distance = length, distance
+        if best >= MIN_MATCH:
+            flush()
+            out.append(0x80 | (best - MIN_MATCH))
+            out.append(best_distance - 1)
+            for i in range(best):
+                remember(pos + i)
+            pos += best
+        else:
+            literals.append(data[pos])
+            remember(pos)
+            pos += 1
+            if len(literals) == MAX_LITERALS:
+                flush()
+    flush()
+    return bytes(out)
+
+
+def index_source(source):
+    index = {}
+    for pos in range(len(source) - GRAM + 1):
+        index.setdefault(source[pos : pos + GRAM], pos)
+    return index
+
+
+def candidates(source, index, block, offset, previous):
+    """Offsets of the old image where the block may come from, most likely first."""
+    votes = Counter()
+    for j in range(0, len(block) - GRAM + 1, SAMPLE_STEP):
+        pos = index.get(block[j : j + GRAM])
+        if pos is not None and pos >= j and pos - j + len(block) <= len(source):
+            votes[pos - j] += 1
+    found = [start for start, _ in votes.most_common(CANDIDATES)]
+    # where the previous block came from, and the same place
+    for start in (previous + BLOCK_SIZE if previous is not None else None, offset):
+        if start is not None and start + len(block) <= len(source) and start not in found:
+            found.append(start)
+    return found
+
+
+def difference(block, source, start):
+    return bytes((b - source[start + i]) & 0xFF for i, b in enumerate(block))
+
+
+def make_patch(source, target):
+    index = index_source(source)
+    out = bytearray(struct.pack("<II", MAGIC, len(source)) + hashlib.sha256(source).digest() + struct.pack("<I", len(target)))
+    previous, matched = None, 0
+    for offset in range(0, len(target), BLOCK_SIZE):
+        block = target[offset : offset + BLOCK_SIZE]
+        best_start, best_same = NO_SOURCE, 0
+        for start in candidates(source, index, block, offset, previous):
+            same = sum(1 for i, b in enumerate(block) if b == source[start + i])
+            if same > best_same:
+                best_start, best_same = start, same
+        packed = compress(block)
+        if best_start != NO_SOURCE:
+            diff = compress(difference(block, source, best_start))
+            if len(diff) < len(packed):
+                packed = diff
+                matched += 1
+            else:
+                best_start = NO_SOURCE
+        previous = best_start if best_start != NO_SOURCE else None
+        out += struct.pack("<II", best_start, len(packed)) + packed
+    return bytes(out), matched
+
+
+def apply_patch(source, patch):
+    magic, source_size = struct.unpack_from("<II", patch, 0)
+    assert magic == MAGIC and source_size == len(source)
+    assert patch[8:40] == hashlib.sha256(source).digest()
+    (target_size,) = struct.unpack_from("<I", patch, 40)
+    out, pos = bytearray(), 44
+    while len(out) < target_size:
+        start, size = struct.unpack_from("<II", patch, pos)
+        data = decompress(patch[pos + 8 : pos + 8 + size])
+        pos += 8 + size
+        if start != NO_SOURCE:
+            data = bytes((b + source[start + i]) & 0xFF for i, b in enumerate(data))
+        assert len(data) == min(BLOCK_SIZE, target_size - len(out))
+        out += data
+    assert pos == len(patch)
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("old", help="image the devices run")
+    parser.add_argument("new", help="image to update them to")
+    parser.add_argument("patch", help="patch to write")
+    args = parser.parse_args()
+
+    source = open(args.old, "rb").read()
+    target = open(args.new, "rb").read()
+    patch, matched = make_patch(source, target)
+    assert apply_patch(source, patch) == target
+    open(args.patch, "wb").write(patch)
+    blocks = (len(target) + BLOCK_SIZE - 1) // BLOCK_SIZE
+    print(
+        f"{len(target)} bytes -> {len(patch)} byte patch ({len(patch) * 100 // len(target)}%), "
+        f"{matched} of {blocks} blocks from the old image",
+        file=sys.stderr,
+    )
+    print(f"firmware_sha256: {hashlib.sha256(target).hexdigest()}", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""Convert a fixed-width Waveshare sFONT table into a proportional PropFont.
+
+Blank columns are trimmed from each glyph, its bitmap is packed to the new
+width, and its advance is the trimmed width plus the spacing, so text is
+measured by summing advances (see lib/trmnl/include/prop_font.h).
+
+    scripts/prop_font.py lib/esp32-waveshare-epd/src/font24.cpp PropFont24 \
+        > lib/trmnl/src/prop_font24.cpp
+"""
+
+import argparse
+import re
+import sys
+
+
+def read_sfont(path):
+    """Returns (width, height, glyphs) with each glyph a list of rows of 0/1 pixels."""
+    source = open(path, encoding="utf-8").read()
+    match = re.search(r"sFONT\s+\w+\s*=\s*\{\s*\w+\s*,\s*(\d+)\s*,.*?(\d+)\s*,", source, re.S)
+    if not match:
+        sys.exit(f"{path}: no sFONT definition")
+    width, height = int(match.group(1)), int(match.group(2))
+
+    table_start = re.search(r"uint8_t\s+\w+\s*\[\]\s*=\s*\{", source)
+    table = source[table_start.end() : match.start()]
+    data = [int(byte, 16) for byte in re.findall(r"0x([0-9A-Fa-f]{2})", re.sub(r"//.*", "", table))]
+    row_bytes = (width + 7) // 8
+    glyph_bytes = row_bytes * height
+
+    glyphs = []
+    for start in range(0, len(data) - glyph_bytes + 1, glyph_bytes):
+        rows = []
+        for row in range(height):
+            bits = data[start + row * row_bytes : start + (row + 1) * row_bytes]
+            rows.append([(bits[x // 8] >> (7 - x % 8)) & 1 for x in range(width)])
+        glyphs.append(rows)
+    return width, height, glyphs
+
+
+def pack(rows, left, width):
+    packed = []
+    for row in rows:
+        for byte in range(0, width, 8):
+            value = 0
+            for bit in range(8):
+                if byte + bit < width and row[left + byte + bit]:
+                    value |= 0x80 >> bit
+            packed.append(value)
+    return packed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("sfont", help="Waveshare font source, e.g. font24.cpp")
+    parser.add_argument("name", help="name of the PropFont to define")
+    parser.add_argument("--spacing", type=int, default=2, help="pixels between glyphs")
+    parser.add_argument("--space", type=int, help="advance of the space, default half the fixed width")
+    args = parser.parse_args()
+
+    fixed_width, height, glyphs = read_sfont(args.sfont)
+    space = args.space if args.space is not None else fixed_width // 2
+
+    bitmaps, entries = [], []
+    for index, rows in enumerate(glyphs):
+        columns = [x for x in range(fixed_width) if any(row[x] for row in rows)]
+        char = chr(ord(" ") + index)
+        if not columns:
+            entries.append((len(bitmaps), 0, space, 0, char))
+            continue
+        left, width = columns[0], columns[-1] - columns[0] + 1
+        entries.append((len(bitmaps), width, width + args.spacing, args.spacing // 2, char))
+        bitmaps.extend(pack(rows, left, width))
+
+    if len(bitmaps) > 0xFFFF:
+        sys.exit("bitmaps do not fit 16-bit offsets")
+    fallback = ord("?") - ord(" ")
+
+    out = sys.stdout
+    out.write(f"// Generated by scripts/prop_font.py from {args.sfont.split('/')[-1]}, do not edit.\n")
+    out.write("#include <prop_font.h>\n\n")
+    out.write(f"static const uint8_t {args.name}_Bitmaps[] = {{\n")
+    for offset, width, _, _, char in entries:
+        size = (width + 7) // 8 * height
+        if not size:
+            continue
+        chunk = ", ".join(f"0x{b:02X}" for b in bitmaps[offset : offset + size])
+        out.write(f"    // {char!r}\n    {chunk},\n")
+    out.write("};\n\n")
+    out.write(f"static const PropGlyph {args.name}_Glyphs[] = {{\n")
+    for offset, width, advance, x_offset, char in entries:
+        out.write(f"    {{{offset}, {width}, {advance}, {x_offset}}}, // {char!r}\n")
+    out.write("};\n\n")
+    out.write(f"static const PropFontRange {args.name}_Ranges[] = {{\n")
+    out.write(f"    {{0x20, {len(entries)}, 0}},\n")
+    out.write("};\n\n")
+    out.write(f"const PropFont {args.name} = {{\n")
+    out.write(f"    {args.name}_Bitmaps,\n    {args.name}_Glyphs,\n    {args.name}_Ranges,\n")
+    out.write(f"    1, /* ranges */\n    {height}, /* height */\n    {fallback}, /* fallback: '?' */\n}};\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,160 @@
+#pragma once
+
+/**
+ * Stand-in for the Arduino-ESP32 core, for the wake-cycle simulator (see
+ * wake_sim.h). Only what the firmware uses is here. Time is simulated:
+ * delay() and friends move the simulated clock instead of sleeping.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include <esp_err.h>
+#include <esp_system.h>
+#include <esp_sleep.h>
+#include <esp_heap_caps.h>
+#include <driver/gpio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+// the simulated chip
+#ifndef CONFIG_IDF_TARGET_ESP32C3
+#define CONFIG_IDF_TARGET_ESP32C3 1
+#endif
+
+#define ESP_ARDUINO_VERSION_MAJOR 2
+#define ESP_ARDUINO_VERSION_MINOR 0
+#define ESP_ARDUINO_VERSION_PATCH 17
+
+#define ESP_IDF_VERSION_MAJOR 4
+#define ESP_IDF_VERSION_MINOR 4
+#define ESP_IDF_VERSION_PATCH 7
+
+// RTC memory: the simulator carries these sections over to the next wake
+#define RTC_DATA_ATTR __attribute__((section("rtc_sim_data")))
+#define RTC_NOINIT_ATTR __attribute__((section("rtc_sim_noinit")))
+#define RTC_RODATA_ATTR
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const unsigned char *)(addr))
+#define pgm_read_word(addr) (*(const unsigned short *)(addr))
+#define pgm_read_dword(addr) (*(const unsigned long *)(addr))
+#define pgm_read_float(addr) (*(const float *)(addr))
+#define pgm_read_ptr(addr) (*(const void **)(addr))
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define memcmp_P memcmp
+#define memcpy_P memcpy
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define PI 3.1415926535897932384626433832795
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define _min(a, b) ((a) < (b) ? (a) : (b))
+#define _max(a, b) ((a) > (b) ? (a) : (b))
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef unsigned int word;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  void pinMode(uint8_t pin, uint8_t mode);
+  void digitalWrite(uint8_t pin, uint8_t val);
+  int digitalRead(uint8_t pin);
+  void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+  void detachInterrupt(uint8_t pin);
+  uint16_t analogRead(uint8_t pin);
+  uint32_t analogReadMilliVolts(uint8_t pin);
+
+  unsigned long millis(void);
+  unsigned long micros(void);
+  void delay(uint32_t ms);
+  void delayMicroseconds(uint32_t us);
+  void yield(void);
+
+  float temperatureRead(void);
+  char *dtostrf(double value, signed char width, unsigned char precision, char *out);
+
+  void configTime(long gmtOffset_sec, int daylightOffset_sec, const char *server1, const char *server2, const char *server3);
+  bool getLocalTime(struct tm *info, uint32_t ms);
+
+#ifdef __cplusplus
+}
+
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+#include <WString.h>
+#include <Print.h>
+#include <Stream.h>
+#include <IPAddress.h>
+
+inline bool getLocalTime(struct tm *info) { return getLocalTime(info, 5000); }
+
+class HardwareSerial : public Stream
+{
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  void end(void) {}
+  void setDebugOutput(bool enable) { (void)enable; }
+  operator bool() const { return true; }
+
+  int available(void) override { return 0; }
+  int read(void) override { return -1; }
+  int peek(void) override { return -1; }
+  void flush(void) override { fflush(stdout); }
+  size_t write(uint8_t c) override { return fwrite(&c, 1, 1, stdout); }
+  size_t write(const uint8_t *buffer, size_t size) override { return fwrite(buffer, 1, size, stdout); }
+  using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+class EspClass
+{
+public:
+  uint32_t getFreeHeap(void);
+  uint32_t getMinFreeHeap(void);
+  uint32_t getMaxAllocHeap(void);
+  uint32_t getHeapSize(void);
+  uint64_t getEfuseMac(void);
+  const char *getSdkVersion(void) { return "v4.4.7"; }
+  uint32_t getCpuFreqMHz(void) { return 80; }
+  void restart(void) __attribute__((noreturn));
+};
+
+extern EspClass ESP;
+
+#endif
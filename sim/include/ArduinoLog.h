@@ -0,0 +1,12 @@
+#pragma once
+
+// the simulator logs through the test logger, to the wake's log file
+#include <mock_log.h>
+
+#define LOG_LEVEL_SILENT 0
+#define LOG_LEVEL_FATAL 1
+#define LOG_LEVEL_ERROR 2
+#define LOG_LEVEL_WARNING 3
+#define LOG_LEVEL_INFO 4
+#define LOG_LEVEL_TRACE 5
+#define LOG_LEVEL_VERBOSE 6
@@ -0,0 +1,3 @@
+#pragma once
+
+// only the captive portal uses it, and the simulator replaces the portal (WifiCaptive.h)
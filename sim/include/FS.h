@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs
+{
+  enum SeekMode
+  {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+  };
+
+  class FileImpl;
+  typedef std::shared_ptr<FileImpl> FileImplPtr;
+
+  /** A file of the simulated filesystem, a host file underneath */
+  class File : public Stream
+  {
+  public:
+    File(FileImplPtr p = FileImplPtr()) : _p(p) {}
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) override;
+    using Print::write;
+    int available(void) override;
+    int read(void) override;
+    int peek(void) override;
+    void flush(void) override;
+    size_t read(uint8_t *buf, size_t size);
+    size_t readBytes(char *buffer, size_t length) override { return read((uint8_t *)buffer, length); }
+    using Stream::readBytes;
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position(void) const;
+    size_t size(void) const;
+    void close(void);
+    operator bool() const;
+    const char *path(void) const;
+    const char *name(void) const;
+    bool isDirectory(void);
+    File openNextFile(const char *mode = FILE_READ);
+    void rewindDirectory(void);
+
+  protected:
+    FileImplPtr _p;
+  };
+
+  /** The filesystem on the "spiffs" partition: files live in a directory of the simulated device */
+  class FS
+  {
+  public:
+    FS(const char *name) : name(name) {}
+
+    bool begin(bool formatOnFail = false, const char *basePath = nullptr, uint8_t maxOpenFiles = 10,
+               const char *partitionLabel = nullptr);
+    void end(void);
+    bool format(void);
+    size_t totalBytes(void);
+    size_t usedBytes(void);
+
+    File open(const char *path, const char *mode = FILE_READ, const bool create = false);
+    File open(const String &path, const char *mode = FILE_READ, const bool create = false)
+    {
+      return open(path.c_str(), mode, create);
+    }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *pathFrom, const char *pathTo);
+    bool rename(const String &pathFrom, const String &pathTo) { return rename(pathFrom.c_str(), pathTo.c_str()); }
+    bool mkdir(const char *path) { return false; }
+    bool rmdir(const char *path) { return false; }
+
+  private:
+    const char *name;
+    bool mounted = false;
+  };
+}
+
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekMode;
+using fs::SeekSet;
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM (-8)
+#define HTTPC_ERROR_ENCODING (-9)
+#define HTTPC_ERROR_STREAM_WRITE (-10)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+#define HTTPCLIENT_DEFAULT_TCP_TIMEOUT (5000)
+
+typedef enum
+{
+  HTTP_CODE_OK = 200,
+  HTTP_CODE_NO_CONTENT = 204,
+  HTTP_CODE_PARTIAL_CONTENT = 206,
+  HTTP_CODE_MOVED_PERMANENTLY = 301,
+  HTTP_CODE_FOUND = 302,
+  HTTP_CODE_NOT_MODIFIED = 304,
+  HTTP_CODE_BAD_REQUEST = 400,
+  HTTP_CODE_UNAUTHORIZED = 401,
+  HTTP_CODE_NOT_FOUND = 404,
+  HTTP_CODE_RANGE_NOT_SATISFIABLE = 416,
+  HTTP_CODE_TOO_MANY_REQUESTS = 429,
+  HTTP_CODE_INTERNAL_SERVER_ERROR = 500,
+  HTTP_CODE_SERVICE_UNAVAILABLE = 503,
+} t_http_codes;
+
+/** HTTPClient of the ESP32 core, talking to the fake server of wake_sim.h */
+class HTTPClient
+{
+public:
+  HTTPClient(void) {}
+  ~HTTPClient(void) { end(); }
+
+  bool begin(WiFiClient &client, const String &url);
+  void end(void);
+  bool connected(void);
+
+  void setTimeout(uint16_t timeout) { tcp_timeout = timeout; }
+  void setConnectTimeout(int32_t timeout) { connect_timeout = timeout; }
+  void setReuse(bool reuse) {}
+  void setUserAgent(const String &userAgent) {}
+  void addHeader(const String &name, const String &value, bool first = false, bool replace = true);
+  void collectHeaders(const char *headerKeys[], const size_t headerKeysCount);
+
+  int GET(void) { return sendRequest("GET", nullptr, 0); }
+  int POST(const String &payload) { return sendRequest("POST", (const uint8_t *)payload.c_str(), payload.length()); }
+  int POST(uint8_t *payload, size_t size) { return sendRequest("POST", payload, size); }
+  int sendRequest(const char *type, const uint8_t *payload, size_t size);
+
+  int getSize(void) { return size; }
+  String getString(void);
+  WiFiClient &getStream(void) { return *client; }
+  WiFiClient *getStreamPtr(void) { return connected() ? client : nullptr; }
+  String header(const char *name);
+  bool hasHeader(const char *name) { return header(name).length() > 0; }
+
+  static String errorToString(int error);
+
+private:
+  WiFiClient *client = nullptr;
+  String host;
+  String path;
+  String request_headers;
+  String content_type;
+  String content_range;
+  String collected; // names of the headers to keep, each followed by '\n'
+  uint16_t tcp_timeout = HTTPCLIENT_DEFAULT_TCP_TIMEOUT;
+  int32_t connect_timeout = HTTPCLIENT_DEFAULT_TCP_TIMEOUT;
+  int size = -1;
+};
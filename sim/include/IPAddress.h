@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <WString.h>
+
+class IPAddress
+{
+public:
+  IPAddress(void) : address(0) {}
+  IPAddress(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth)
+      : address(first | second << 8 | third << 16 | (uint32_t)fourth << 24) {}
+  IPAddress(uint32_t address) : address(address) {}
+
+  operator uint32_t() const { return address; }
+  uint8_t operator[](int index) const { return address >> (index * 8); }
+
+  String toString(void) const
+  {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(text);
+  }
+
+private:
+  uint32_t address;
+};
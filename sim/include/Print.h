@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <WString.h>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  virtual void flush(void) {}
+
+  size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+  size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+  size_t print(const String &s) { return write(s.c_str(), s.length()); }
+  size_t print(const char *str) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char value, int base = DEC) { return print(String(value, base)); }
+  size_t print(int value, int base = DEC) { return print(String(value, base)); }
+  size_t print(unsigned int value, int base = DEC) { return print(String(value, base)); }
+  size_t print(long value, int base = DEC) { return print(String(value, base)); }
+  size_t print(unsigned long value, int base = DEC) { return print(String(value, base)); }
+  size_t print(double value, int digits = 2) { return print(String(value, digits)); }
+
+  size_t println(void) { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T &value)
+  {
+    size_t n = print(value);
+    return n + println();
+  }
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Print.h>
+
+class Stream : public Print
+{
+public:
+  virtual int available(void) = 0;
+  virtual int read(void) = 0;
+  virtual int peek(void) = 0;
+
+  void setTimeout(unsigned long timeout) { _timeout = timeout; }
+  unsigned long getTimeout(void) const { return _timeout; }
+
+  virtual size_t readBytes(char *buffer, size_t length);
+  size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+  String readString(void);
+
+protected:
+  unsigned long _timeout = 1000;
+
+  int timedRead(void);
+};
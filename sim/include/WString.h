@@ -0,0 +1,152 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+class StringSumHelper;
+
+/** The Arduino String, with the interface of the ESP32 core; the buffer is always allocated and terminated */
+class String
+{
+public:
+  String(const char *cstr = "");
+  String(const char *cstr, unsigned int length);
+  String(const String &str);
+  String(String &&rval);
+  String(const __FlashStringHelper *str) : String(reinterpret_cast<const char *>(str)) {}
+  explicit String(char c);
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(long long value, unsigned char base = 10);
+  explicit String(unsigned long long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimalPlaces = 2);
+  explicit String(double value, unsigned int decimalPlaces = 2);
+  ~String(void);
+
+  bool reserve(unsigned int size);
+  unsigned int length(void) const { return len; }
+  bool isEmpty(void) const { return len == 0; }
+  const char *c_str(void) const { return buffer; }
+
+  String &operator=(const String &rhs);
+  String &operator=(const char *cstr);
+  String &operator=(String &&rval);
+  String &operator=(const __FlashStringHelper *str) { return *this = reinterpret_cast<const char *>(str); }
+
+  bool concat(const String &str) { return concat(str.buffer, str.len); }
+  bool concat(const char *cstr);
+  bool concat(const char *cstr, unsigned int length);
+  bool concat(char c) { return concat(&c, 1); }
+  bool concat(unsigned char value) { return concat(String(value)); }
+  bool concat(int value) { return concat(String(value)); }
+  bool concat(unsigned int value) { return concat(String(value)); }
+  bool concat(long value) { return concat(String(value)); }
+  bool concat(unsigned long value) { return concat(String(value)); }
+  bool concat(long long value) { return concat(String(value)); }
+  bool concat(unsigned long long value) { return concat(String(value)); }
+  bool concat(float value) { return concat(String(value)); }
+  bool concat(double value) { return concat(String(value)); }
+
+  template <typename T>
+  String &operator+=(const T &rhs)
+  {
+    concat(rhs);
+    return *this;
+  }
+
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, const String &rhs);
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, const char *cstr);
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, char c);
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, unsigned char value);
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, int value);
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, unsigned int value);
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, long value);
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, unsigned long value);
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, long long value);
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, unsigned long long value);
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, float value);
+  friend StringSumHelper &operator+(const StringSumHelper &lhs, double value);
+
+  int compareTo(const String &s) const;
+  bool equals(const String &s) const;
+  bool equals(const char *cstr) const;
+  bool equalsIgnoreCase(const String &s) const;
+  bool operator==(const String &rhs) const { return equals(rhs); }
+  bool operator==(const char *cstr) const { return equals(cstr); }
+  bool operator!=(const String &rhs) const { return !equals(rhs); }
+  bool operator!=(const char *cstr) const { return !equals(cstr); }
+  bool operator<(const String &rhs) const { return compareTo(rhs) < 0; }
+  bool operator>(const String &rhs) const { return compareTo(rhs) > 0; }
+  bool operator<=(const String &rhs) const { return compareTo(rhs) <= 0; }
+  bool operator>=(const String &rhs) const { return compareTo(rhs) >= 0; }
+  bool startsWith(const String &prefix) const;
+  bool startsWith(const String &prefix, unsigned int offset) const;
+  bool endsWith(const String &suffix) const;
+
+  char charAt(unsigned int index) const;
+  void setCharAt(unsigned int index, char c);
+  char operator[](unsigned int index) const { return charAt(index); }
+  char &operator[](unsigned int index);
+  void getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index = 0) const;
+  void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const
+  {
+    getBytes((unsigned char *)buf, bufsize, index);
+  }
+  const char *begin(void) const { return buffer; }
+  const char *end(void) const { return buffer + len; }
+
+  int indexOf(char ch) const { return indexOf(ch, 0); }
+  int indexOf(char ch, unsigned int fromIndex) const;
+  int indexOf(const String &str) const { return indexOf(str, 0); }
+  int indexOf(const String &str, unsigned int fromIndex) const;
+  int lastIndexOf(char ch) const;
+  int lastIndexOf(const String &str) const;
+  String substring(unsigned int beginIndex) const { return substring(beginIndex, len); }
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+  void replace(char find, char replace);
+  void replace(const String &find, const String &replace);
+  void remove(unsigned int index);
+  void remove(unsigned int index, unsigned int count);
+  void toLowerCase(void);
+  void toUpperCase(void);
+  void trim(void);
+
+  long toInt(void) const;
+  float toFloat(void) const;
+  double toDouble(void) const;
+
+private:
+  char *buffer;
+  unsigned int capacity;
+  unsigned int len;
+
+  void copy(const char *cstr, unsigned int length);
+  void move(String &rhs);
+};
+
+class StringSumHelper : public String
+{
+public:
+  StringSumHelper(const String &s) : String(s) {}
+  StringSumHelper(const char *p) : String(p) {}
+  StringSumHelper(char c) : String(c) {}
+  StringSumHelper(unsigned char num) : String(num) {}
+  StringSumHelper(int num) : String(num) {}
+  StringSumHelper(unsigned int num) : String(num) {}
+  StringSumHelper(long num) : String(num) {}
+  StringSumHelper(unsigned long num) : String(num) {}
+  StringSumHelper(long long num) : String(num) {}
+  StringSumHelper(unsigned long long num) : String(num) {}
+  StringSumHelper(float num) : String(num) {}
+  StringSumHelper(double num) : String(num) {}
+};
+
+inline bool operator==(const char *cstr, const String &rhs) { return rhs.equals(cstr); }
+inline bool operator!=(const char *cstr, const String &rhs) { return !rhs.equals(cstr); }
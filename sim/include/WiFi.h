@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+typedef enum
+{
+  WL_NO_SHIELD = 255,
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum
+{
+  WIFI_OFF,
+  WIFI_STA,
+  WIFI_AP,
+  WIFI_AP_STA,
+} wifi_mode_t;
+
+typedef enum
+{
+  WIFI_AUTH_OPEN,
+  WIFI_AUTH_WEP,
+  WIFI_AUTH_WPA_PSK,
+  WIFI_AUTH_WPA2_PSK,
+} wifi_auth_mode_t;
+
+/** The station interface; joining the network and DNS take the time set in SimConfig */
+class WiFiClass
+{
+public:
+  bool mode(wifi_mode_t mode);
+  wl_status_t begin(const char *ssid, const char *passphrase = nullptr);
+  wl_status_t status(void);
+  uint8_t waitForConnectResult(unsigned long timeout = 60000);
+  bool disconnect(bool wifioff = false, bool eraseap = false);
+  bool setSleep(bool enabled) { return true; }
+  void setMinSecurity(wifi_auth_mode_t mode) {}
+  int8_t RSSI(void);
+  String macAddress(void);
+  String SSID(void);
+  IPAddress localIP(void);
+  int hostByName(const char *host, IPAddress &result);
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Arduino.h>
+
+struct SimRequest;
+
+/**
+ * One connection to the fake server. HTTPClient fills in the response; its
+ * body arrives over simulated time at the configured bandwidth, so
+ * available() grows as the clock moves and readBytes() waits for data.
+ */
+class WiFiClient : public Stream
+{
+public:
+  virtual ~WiFiClient();
+
+  int available(void) override;
+  int read(void) override;
+  int peek(void) override;
+  int read(uint8_t *buffer, size_t size);
+  size_t readBytes(char *buffer, size_t length) override;
+  using Stream::readBytes;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+
+  uint8_t connected(void);
+  void stop(void);
+  operator bool() { return connected(); }
+
+protected:
+  friend class HTTPClient;
+
+  bool secure = false;
+  bool open = false;
+  const uint8_t *body = nullptr;
+  size_t body_size = 0; // bytes that will arrive before the connection closes
+  size_t consumed = 0;
+  uint64_t start_us = 0; // when the first byte of the body arrives
+  SimRequest *request = nullptr; // entry of the server's log, for the bytes received
+
+  size_t arrived(void);
+  uint64_t arrival_us(size_t bytes);
+  void received(size_t bytes);
+};
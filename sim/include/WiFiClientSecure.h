@@ -0,0 +1,12 @@
+#pragma once
+
+#include <WiFi.h>
+
+/** TLS costs two more round trips and SimConfig::tls_ms when connecting */
+class WiFiClientSecure : public WiFiClient
+{
+public:
+  WiFiClientSecure(void) { secure = true; }
+  void setInsecure(void) {}
+  void setCACert(const char *rootCA) {}
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <functional>
+
+/**
+ * The captive portal of lib/wificaptive, for the wake-cycle simulator. The
+ * credentials are kept in the same "wificaptive" NVS namespace; the portal
+ * itself saves SimConfig::portal_ssid if set, as if a user had typed it in;
+ * otherwise nobody comes and the wake ends with the device still awake.
+ */
+
+#define WIFI_MAX_SAVED_CREDS 5
+#define WIFI_CONNECTION_ATTEMPTS 3
+#define CONNECTION_TIMEOUT 15000
+
+class WifiCaptive
+{
+public:
+  bool startPortal();
+  bool isSaved();
+  void resetSettings();
+  void setResetSettingsCallback(std::function<void()> func) { _resetcallback = func; }
+  bool autoConnect();
+
+private:
+  std::function<void()> _resetcallback;
+};
+
+extern WifiCaptive WifiCaptivePortal;
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+typedef int gpio_num_t;
+
+typedef enum
+{
+  GPIO_INTR_DISABLE,
+  GPIO_INTR_POSEDGE,
+  GPIO_INTR_NEGEDGE,
+  GPIO_INTR_ANYEDGE,
+  GPIO_INTR_LOW_LEVEL,
+  GPIO_INTR_HIGH_LEVEL,
+} gpio_int_type_t;
+
+// the output registers the panel drivers write directly
+#define GPIO_OUT_W1TS_REG 1
+#define GPIO_OUT_W1TC_REG 0
+#define REG_WRITE(reg, mask) sim_gpio_write((reg) == GPIO_OUT_W1TS_REG, mask)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  void sim_gpio_write(bool high, uint32_t mask);
+  int gpio_get_level(gpio_num_t pin);
+  esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
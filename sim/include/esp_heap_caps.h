@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  size_t heap_caps_get_free_size(uint32_t caps);
+  size_t heap_caps_get_largest_free_block(uint32_t caps);
+  size_t heap_caps_get_minimum_free_size(uint32_t caps);
+  bool heap_caps_check_integrity_all(bool print_errors);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <esp_partition.h>
+
+/**
+ * OTA partitions of the simulated flash: the firmware runs from "app0" and
+ * updates go to "app1". An image is valid when it starts with the ESP image
+ * magic byte.
+ */
+
+#define ESP_ERR_OTA_BASE 0x1500
+#define ESP_ERR_OTA_PARTITION_CONFLICT (ESP_ERR_OTA_BASE + 0x01)
+#define ESP_ERR_OTA_SELECT_INFO_INVALID (ESP_ERR_OTA_BASE + 0x02)
+#define ESP_ERR_OTA_VALIDATE_FAILED (ESP_ERR_OTA_BASE + 0x03)
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  const esp_partition_t *esp_ota_get_running_partition(void);
+  const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start_from);
+  esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+/** Partitions of min_spiffs.csv, or frames_partition.csv, each backed by a file of the simulated device */
+
+typedef enum
+{
+  ESP_PARTITION_TYPE_APP = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01,
+  ESP_PARTITION_TYPE_ANY = 0xff,
+} esp_partition_type_t;
+
+typedef enum
+{
+  ESP_PARTITION_SUBTYPE_APP_OTA_0 = 0x10,
+  ESP_PARTITION_SUBTYPE_APP_OTA_1 = 0x11,
+  ESP_PARTITION_SUBTYPE_DATA_OTA = 0x00,
+  ESP_PARTITION_SUBTYPE_DATA_NVS = 0x02,
+  ESP_PARTITION_SUBTYPE_DATA_COREDUMP = 0x03,
+  ESP_PARTITION_SUBTYPE_DATA_SPIFFS = 0x82,
+  ESP_PARTITION_SUBTYPE_ANY = 0xff,
+} esp_partition_subtype_t;
+
+typedef struct
+{
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+  bool encrypted;
+} esp_partition_t;
+
+typedef enum
+{
+  SPI_FLASH_MMAP_DATA,
+  SPI_FLASH_MMAP_INST,
+} spi_flash_mmap_memory_t;
+
+typedef uint32_t spi_flash_mmap_handle_t;
+
+#define SPI_FLASH_SEC_SIZE 4096
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                   const char *label);
+  esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size);
+  esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size);
+  esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size);
+  esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                               spi_flash_mmap_memory_t memory, const void **out_ptr,
+                               spi_flash_mmap_handle_t *out_handle);
+  void spi_flash_munmap(spi_flash_mmap_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <esp_err.h>
+
+typedef enum
+{
+  ESP_SLEEP_WAKEUP_UNDEFINED,
+  ESP_SLEEP_WAKEUP_ALL,
+  ESP_SLEEP_WAKEUP_EXT0,
+  ESP_SLEEP_WAKEUP_EXT1,
+  ESP_SLEEP_WAKEUP_TIMER,
+  ESP_SLEEP_WAKEUP_TOUCHPAD,
+  ESP_SLEEP_WAKEUP_ULP,
+  ESP_SLEEP_WAKEUP_GPIO,
+  ESP_SLEEP_WAKEUP_UART,
+  ESP_SLEEP_WAKEUP_WIFI,
+  ESP_SLEEP_WAKEUP_COCPU,
+  ESP_SLEEP_WAKEUP_COCPU_TRAP_TRIG,
+  ESP_SLEEP_WAKEUP_BT,
+} esp_sleep_source_t;
+
+typedef esp_sleep_source_t esp_sleep_wakeup_cause_t;
+
+typedef enum
+{
+  ESP_GPIO_WAKEUP_GPIO_LOW = 0,
+  ESP_GPIO_WAKEUP_GPIO_HIGH = 1
+} esp_deepsleep_gpio_wake_up_mode_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void);
+  esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+  esp_err_t esp_sleep_enable_gpio_wakeup(void);
+  esp_err_t esp_deep_sleep_enable_gpio_wakeup(uint64_t gpio_pin_mask, esp_deepsleep_gpio_wake_up_mode_t mode);
+  esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source);
+  void esp_deep_sleep_start(void) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
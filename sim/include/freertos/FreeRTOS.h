@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * FreeRTOS for the wake-cycle simulator. The firmware only starts short
+ * tasks that run alongside the main one; here a task runs to completion
+ * inside xTaskCreate(), and the simulated time it took is taken back from
+ * the caller, so work done in parallel on the device does not add up.
+ * Whoever waits for its result with xSemaphoreTake() waits until it would
+ * have finished.
+ */
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t configSTACK_DEPTH_TYPE;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY (TickType_t)0xffffffffUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
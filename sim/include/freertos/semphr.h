@@ -0,0 +1,19 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+typedef struct SimSemaphore *SemaphoreHandle_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  SemaphoreHandle_t xSemaphoreCreateBinary(void);
+  BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+  BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+  void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+#ifdef __cplusplus
+}
+#endif
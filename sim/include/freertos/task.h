@@ -0,0 +1,21 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+
+typedef void (*TaskFunction_t)(void *);
+typedef void *TaskHandle_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  BaseType_t xTaskCreate(TaskFunction_t code, const char *name, configSTACK_DEPTH_TYPE stack_depth, void *parameters,
+                         UBaseType_t priority, TaskHandle_t *created_task);
+  void vTaskDelete(TaskHandle_t task);
+  void vTaskDelay(TickType_t ticks);
+  UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+
+#ifdef __cplusplus
+}
+#endif
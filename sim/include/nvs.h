@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+#include <esp_err.h>
+
+typedef struct
+{
+  size_t used_entries;
+  size_t free_entries;
+  size_t total_entries;
+  size_t namespace_count;
+} nvs_stats_t;
+
+#ifdef __cplusplus
+extern "C"
+#endif
+    esp_err_t
+    nvs_get_stats(const char *part_name, nvs_stats_t *nvs_stats);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Heap counters of the host builds in sim/: every malloc, calloc, realloc
+ * and aligned allocation (new included) is counted with glibc's usable size
+ * of the block, from sim_heap_begin() on. Linux only; elsewhere, and under
+ * a sanitizer, the counters stay at 0.
+ */
+
+/**
+ * @brief Function to start counting, from zero
+ * @param none
+ * @return none
+ */
+void sim_heap_begin(void);
+
+/**
+ * @brief Function to get how much is allocated
+ * @param none
+ * @return size_t bytes allocated now, since sim_heap_begin()
+ */
+size_t sim_heap_used(void);
+
+/**
+ * @brief Function to get the most that was allocated at once
+ * @param none
+ * @return size_t bytes, since sim_heap_begin()
+ */
+size_t sim_heap_peak(void);
+
+/**
+ * @brief Function to count the allocations
+ * @param none
+ * @return uint32_t allocations since sim_heap_begin(), a realloc counting as one
+ */
+uint32_t sim_heap_allocations(void);
+
+/**
+ * @brief Function to add up the size of the allocations
+ * @param none
+ * @return size_t bytes allocated since sim_heap_begin(), freed or not
+ */
+size_t sim_heap_allocated(void);
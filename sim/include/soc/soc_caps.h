@@ -0,0 +1,5 @@
+#pragma once
+
+// ESP32-C3
+#define SOC_TEMP_SENSOR_SUPPORTED 1
+#define SOC_GPIO_PIN_COUNT 22
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Wake-cycle simulator: the whole firmware (src/, bl_init() included) built
+ * for the host against the stand-ins in sim/include, talking to a fake TRMNL
+ * server, with the 7.5" panel modelled by lib/epd_sim.
+ *
+ * Every sim_wake() forks and runs setup() in the child until it deep
+ * sleeps, restarts, crashes or returns. What survives on the device
+ * survives from one wake to the next:
+ *   - RTC memory: RTC_DATA_ATTR across deep sleep, RTC_NOINIT_ATTR across
+ *     restarts and crashes too,
+ *   - NVS, the filesystem and the raw partitions, as files under
+ *     .pio/wake_sim/<name>/, where each wake also leaves its log and a PNG
+ *     of the panel,
+ *   - what the panel shows.
+ *
+ * Time is simulated and starts at 0 on every wake: delays, panel refreshes,
+ * WiFi, DNS, NTP and the transfers to and from the server move the clock by
+ * the amounts set in SimConfig, and millis() moves it by 1 us per call so
+ * busy-wait loops end. Work the firmware starts in a FreeRTOS task runs
+ * inline but does not add to the awake time (see freertos/FreeRTOS.h).
+ * The results are reproducible from run to run.
+ *
+ * Linux only: RTC memory is found through the linker's section symbols and
+ * the heap is measured by wrapping glibc's malloc.
+ *
+ * pio test -e native_wake_sim
+ */
+
+// free heap at the start of a wake, with WiFi up
+#define SIM_HEAP_SIZE (200 * 1024)
+
+// RTC slow memory of the ESP32-C3; RTC_DATA_ATTR and RTC_NOINIT_ATTR variables must fit
+#define SIM_RTC_SIZE (8 * 1024)
+
+struct SimConfig
+{
+  uint32_t latency_ms;      // round trip to the server
+  uint32_t bandwidth;       // bytes per second each way, 0 for no limit
+  uint32_t tls_ms;          // TLS handshake computation, on top of its two round trips
+  uint32_t wifi_connect_ms; // association and DHCP
+  bool wifi_available;      // the saved network is in range
+  const char *portal_ssid;  // what a user types into the captive portal, nullptr if nobody does
+  int8_t rssi;
+  bool ntp_available;
+  time_t epoch; // wall clock at the first wake
+  uint16_t battery_mv;
+  float temperature;
+};
+
+enum SimWakeCause
+{
+  SIM_WAKE_POWER_ON,     // battery connected: RTC memory and the clock are lost
+  SIM_WAKE_TIMER,        // end of deep sleep
+  SIM_WAKE_BUTTON,       // the button woke the device and was released at once
+  SIM_WAKE_BUTTON_HOLD,  // the button woke the device and is held down: a soft reset
+  SIM_WAKE_DOUBLE_CLICK, // the button woke the device and is pressed again: the special function
+  SIM_WAKE_REBOOT,       // the boot after a restart or a crash
+};
+
+enum SimEnd
+{
+  SIM_END_SLEEP,   // esp_deep_sleep_start()
+  SIM_END_RESTART, // ESP.restart()
+  SIM_END_AWAKE,   // setup() returned: the device would stay awake
+  SIM_END_CRASH,   // a signal, a panic on the device; also a wake still running after a minute of host time
+};
+
+struct SimWake
+{
+  SimEnd end;
+  uint64_t sleep_us; // timer armed before deep sleep, 0 if none
+  uint32_t awake_ms;
+  uint32_t requests;
+  uint32_t bytes_down; // response headers and bodies
+  uint32_t bytes_up;   // request headers and bodies
+  uint32_t nvs_write_bytes;       // NVS entries written, 32 bytes each
+  uint32_t fs_write_bytes;        // data written to files
+  uint32_t partition_write_bytes; // raw partitions: image slots, OTA
+  uint32_t erase_bytes;           // raw partitions
+  uint32_t peak_heap;             // most bytes allocated at once during the wake
+  uint32_t full_refreshes;
+  uint32_t fast_refreshes;
+  uint32_t partial_refreshes;
+  uint32_t panel_resets;
+  bool panel_asleep;     // the panel controller was left in deep sleep, or not woken up
+  bool firmware_updated; // esp_ota_set_boot_partition() accepted a new image
+};
+
+enum SimFailure
+{
+  SIM_FAIL_NONE,
+  SIM_FAIL_CONNECT,  // the connection is refused
+  SIM_FAIL_STATUS,   // HTTP 500
+  SIM_FAIL_TRUNCATE, // the connection closes halfway through the body
+  SIM_FAIL_STALL,    // no response until the client times out
+};
+
+struct SimRequest
+{
+  char method[8];
+  char path[96];
+  int status; // HTTPClient error if negative
+  uint32_t bytes_up;
+  uint32_t bytes_down;
+  char headers[512]; // request headers, "Name: value\r\n" each
+  char body[1024];   // start of the request body
+};
+
+/**
+ * @brief Function to start a run with a new device: blank flash, NVS and RTC memory, white panel, default config
+ * and an empty server
+ * @param name directory of the run under .pio/wake_sim, emptied
+ * @return none
+ */
+void sim_begin(const char *name);
+
+/**
+ * @brief Function to get the configuration used by the next wakes
+ * @param none
+ * @return SimConfig& configuration, to change in place
+ */
+SimConfig &sim_config(void);
+
+/**
+ * @brief Function to save WiFi credentials and the device's API key, as the captive portal and /api/setup do
+ * @param ssid network name
+ * @param api_key API key, nullptr to leave the device unregistered
+ * @param friendly_id friendly ID
+ * @return none
+ */
+void sim_provision(const char *ssid, const char *api_key, const char *friendly_id);
+
+/**
+ * @brief Function to put a file on a data partition formatted as SPIFFS, as the firmware before LittleFS left it
+ * @param path file name, starting with /
+ * @param data file contents
+ * @param size file size
+ * @return none
+ */
+void sim_spiffs_file(const char *path, const void *data, size_t size);
+
+/**
+ * @brief Function to put the image of the firmware the device runs into its app0 partition, which a firmware patch
+ * is applied against
+ * @param image application image
+ * @param size image size
+ * @return none
+ */
+void sim_flash_app(const void *image, size_t size);
+
+/**
+ * @brief Function to run one wake of the device
+ * @param cause why the device wakes up
+ * @return SimWake how the wake ended and what it cost
+ */
+SimWake sim_wake(SimWakeCause cause);
+
+/**
+ * @brief Function to run the wake that follows the previous one: timer after deep sleep, reboot after a restart or
+ * crash, power on after a wake that stayed awake
+ * @param none
+ * @return SimWake how the wake ended and what it cost
+ */
+SimWake sim_wake_next(void);
+
+/**
+ * @brief Function to get what the panel shows
+ * @param none
+ * @return const uint8_t* 800 / 8 * 480 bytes, 1 for white
+ */
+const uint8_t *sim_screen(void);
+
+/**
+ * @brief Function to set what the fake server answers for a path
+ * @param path path of the URL, without host and query
+ * @param status HTTP status
+ * @param content_type Content-Type header
+ * @param body response body, copied
+ * @param size body size
+ * @return none
+ */
+void sim_server_route(const char *path, int status, const char *content_type, const void *body, size_t size);
+
+/**
+ * @brief Function to make the fake server answer a path with JSON
+ * @param path path of the URL
+ * @param json response body, sent with status 200
+ * @return none
+ */
+void sim_server_json(const char *path, const char *json);
+
+/**
+ * @brief Function to make the next requests to a path fail
+ * @param path path of the URL
+ * @param failure how they fail
+ * @param count number of requests that fail, across wakes
+ * @return none
+ */
+void sim_server_fail(const char *path, SimFailure failure, uint32_t count);
+
+/**
+ * @brief Function to count the requests made to a path since sim_begin()
+ * @param path path of the URL
+ * @return uint32_t number of requests, failed ones included
+ */
+uint32_t sim_server_count(const char *path);
+
+/**
+ * @brief Function to get the last request made to a path
+ * @param path path of the URL
+ * @return const SimRequest* the request, nullptr if there was none
+ */
+const SimRequest *sim_server_last(const char *path);
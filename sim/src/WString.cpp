@@ -0,0 +1,403 @@
+#include <Arduino.h>
+#include <ctype.h>
+
+String::String(const char *cstr) : buffer(nullptr), capacity(0), len(0)
+{
+  copy(cstr ? cstr : "", cstr ? strlen(cstr) : 0);
+}
+
+String::String(const char *cstr, unsigned int length) : buffer(nullptr), capacity(0), len(0)
+{
+  copy(cstr ? cstr : "", cstr ? length : 0);
+}
+
+String::String(const String &str) : buffer(nullptr), capacity(0), len(0)
+{
+  copy(str.buffer, str.len);
+}
+
+String::String(String &&rval) : buffer(nullptr), capacity(0), len(0)
+{
+  move(rval);
+}
+
+String::String(char c) : buffer(nullptr), capacity(0), len(0)
+{
+  copy(&c, 1);
+}
+
+/** Formats value in base, like utoa() of the ESP32 core */
+static void formatUnsigned(char *out, unsigned long long value, unsigned char base, bool negative)
+{
+  char digits[66];
+  int n = 0;
+  if (base < 2 || base > 36)
+    base = 10;
+  do
+  {
+    int digit = value % base;
+    digits[n++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while (value);
+  if (negative)
+    *out++ = '-';
+  while (n)
+    *out++ = digits[--n];
+  *out = '\0';
+}
+
+static String fromSigned(long long value, unsigned char base)
+{
+  char text[68];
+  // like ltoa(), only base 10 shows the sign
+  if (base == 10 && value < 0)
+    formatUnsigned(text, 0ULL - (unsigned long long)value, base, true);
+  else
+    formatUnsigned(text, base == 10 ? (unsigned long long)value : (unsigned long)value, base, false);
+  return String(text);
+}
+
+static String fromUnsigned(unsigned long long value, unsigned char base)
+{
+  char text[68];
+  formatUnsigned(text, value, base, false);
+  return String(text);
+}
+
+static String fromDouble(double value, unsigned int decimalPlaces)
+{
+  char text[64];
+  snprintf(text, sizeof(text), "%.*f", decimalPlaces, value);
+  return String(text);
+}
+
+String::String(unsigned char value, unsigned char base) : String(fromUnsigned(value, base)) {}
+String::String(int value, unsigned char base) : String(fromSigned(value, base)) {}
+String::String(unsigned int value, unsigned char base) : String(fromUnsigned(value, base)) {}
+String::String(long value, unsigned char base) : String(fromSigned(value, base)) {}
+String::String(unsigned long value, unsigned char base) : String(fromUnsigned(value, base)) {}
+String::String(long long value, unsigned char base) : String(fromSigned(value, base)) {}
+String::String(unsigned long long value, unsigned char base) : String(fromUnsigned(value, base)) {}
+String::String(float value, unsigned int decimalPlaces) : String(fromDouble(value, decimalPlaces)) {}
+String::String(double value, unsigned int decimalPlaces) : String(fromDouble(value, decimalPlaces)) {}
+
+String::~String(void)
+{
+  free(buffer);
+}
+
+bool String::reserve(unsigned int size)
+{
+  if (buffer && capacity >= size)
+    return true;
+  char *grown = (char *)realloc(buffer, size + 1);
+  if (!grown)
+    return false;
+  if (!buffer)
+    grown[0] = '\0';
+  buffer = grown;
+  capacity = size;
+  return true;
+}
+
+void String::copy(const char *cstr, unsigned int length)
+{
+  if (!reserve(length))
+    abort();
+  memmove(buffer, cstr, length);
+  len = length;
+  buffer[len] = '\0';
+}
+
+void String::move(String &rhs)
+{
+  if (this == &rhs)
+    return;
+  free(buffer);
+  buffer = rhs.buffer;
+  capacity = rhs.capacity;
+  len = rhs.len;
+  rhs.buffer = nullptr;
+  rhs.capacity = 0;
+  rhs.len = 0;
+  // a moved-from String stays usable
+  rhs.copy("", 0);
+}
+
+String &String::operator=(const String &rhs)
+{
+  if (this != &rhs)
+    copy(rhs.buffer, rhs.len);
+  return *this;
+}
+
+String &String::operator=(const char *cstr)
+{
+  copy(cstr ? cstr : "", cstr ? strlen(cstr) : 0);
+  return *this;
+}
+
+String &String::operator=(String &&rval)
+{
+  move(rval);
+  return *this;
+}
+
+bool String::concat(const char *cstr)
+{
+  return cstr ? concat(cstr, strlen(cstr)) : false;
+}
+
+bool String::concat(const char *cstr, unsigned int length)
+{
+  if (!cstr)
+    return false;
+  if (length == 0)
+    return true;
+  // cstr may point into this string
+  size_t offset = cstr >= buffer && cstr < buffer + len ? cstr - buffer : (size_t)-1;
+  if (!reserve(len + length))
+    return false;
+  if (offset != (size_t)-1)
+    cstr = buffer + offset;
+  memmove(buffer + len, cstr, length);
+  len += length;
+  buffer[len] = '\0';
+  return true;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, const String &rhs)
+{
+  StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+  a.concat(rhs);
+  return a;
+}
+
+StringSumHelper &operator+(const StringSumHelper &lhs, const char *cstr)
+{
+  StringSumHelper &a = const_cast<StringSumHelper &>(lhs);
+  a.concat(cstr);
+  return a;
+}
+
+#define STRING_SUM(type)                                               \
+  StringSumHelper &operator+(const StringSumHelper &lhs, type value) \
+  {                                                                  \
+    StringSumHelper &a = const_cast<StringSumHelper &>(lhs);         \
+    a.concat(value);                                                 \
+    return a;                                                        \
+  }
+
+STRING_SUM(char)
+STRING_SUM(unsigned char)
+STRING_SUM(int)
+STRING_SUM(unsigned int)
+STRING_SUM(long)
+STRING_SUM(unsigned long)
+STRING_SUM(long long)
+STRING_SUM(unsigned long long)
+STRING_SUM(float)
+STRING_SUM(double)
+
+int String::compareTo(const String &s) const
+{
+  return strcmp(buffer, s.buffer);
+}
+
+bool String::equals(const String &s) const
+{
+  return len == s.len && memcmp(buffer, s.buffer, len) == 0;
+}
+
+bool String::equals(const char *cstr) const
+{
+  return strcmp(buffer, cstr ? cstr : "") == 0;
+}
+
+bool String::equalsIgnoreCase(const String &s) const
+{
+  return len == s.len && strcasecmp(buffer, s.buffer) == 0;
+}
+
+bool String::startsWith(const String &prefix) const
+{
+  return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String &prefix, unsigned int offset) const
+{
+  return offset <= len && prefix.len <= len - offset && memcmp(buffer + offset, prefix.buffer, prefix.len) == 0;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+  return suffix.len <= len && memcmp(buffer + len - suffix.len, suffix.buffer, suffix.len) == 0;
+}
+
+char String::charAt(unsigned int index) const
+{
+  return index < len ? buffer[index] : 0;
+}
+
+void String::setCharAt(unsigned int index, char c)
+{
+  if (index < len)
+    buffer[index] = c;
+}
+
+char &String::operator[](unsigned int index)
+{
+  static char dummy;
+  if (index >= len)
+  {
+    dummy = 0;
+    return dummy;
+  }
+  return buffer[index];
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+{
+  if (!bufsize || !buf)
+    return;
+  if (index >= len)
+  {
+    buf[0] = 0;
+    return;
+  }
+  unsigned int n = bufsize - 1;
+  if (n > len - index)
+    n = len - index;
+  memcpy(buf, buffer + index, n);
+  buf[n] = 0;
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const
+{
+  if (fromIndex >= len)
+    return -1;
+  const char *found = (const char *)memchr(buffer + fromIndex, ch, len - fromIndex);
+  return found ? found - buffer : -1;
+}
+
+int String::indexOf(const String &str, unsigned int fromIndex) const
+{
+  if (fromIndex > len)
+    return -1;
+  const char *found = strstr(buffer + fromIndex, str.buffer);
+  return found ? found - buffer : -1;
+}
+
+int String::lastIndexOf(char ch) const
+{
+  const char *found = strrchr(buffer, ch);
+  return found ? found - buffer : -1;
+}
+
+int String::lastIndexOf(const String &str) const
+{
+  if (str.len > len)
+    return -1;
+  for (int i = len - str.len; i >= 0; i--)
+  {
+    if (memcmp(buffer + i, str.buffer, str.len) == 0)
+      return i;
+  }
+  return -1;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const
+{
+  if (beginIndex > endIndex)
+  {
+    unsigned int temp = endIndex;
+    endIndex = beginIndex;
+    beginIndex = temp;
+  }
+  if (beginIndex >= len)
+    return String();
+  if (endIndex > len)
+    endIndex = len;
+  return String(buffer + beginIndex, endIndex - beginIndex);
+}
+
+void String::replace(char find, char replace)
+{
+  for (unsigned int i = 0; i < len; i++)
+  {
+    if (buffer[i] == find)
+      buffer[i] = replace;
+  }
+}
+
+void String::replace(const String &find, const String &replace)
+{
+  if (find.len == 0)
+    return;
+  String result;
+  unsigned int start = 0;
+  int found;
+  while ((found = indexOf(find, start)) >= 0)
+  {
+    result.concat(buffer + start, found - start);
+    result.concat(replace);
+    start = found + find.len;
+  }
+  result.concat(buffer + start, len - start);
+  *this = std::move(result);
+}
+
+void String::remove(unsigned int index)
+{
+  remove(index, (unsigned int)-1);
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+  if (index >= len)
+    return;
+  if (count > len - index)
+    count = len - index;
+  memmove(buffer + index, buffer + index + count, len - index - count + 1);
+  len -= count;
+}
+
+void String::toLowerCase(void)
+{
+  for (unsigned int i = 0; i < len; i++)
+    buffer[i] = tolower((unsigned char)buffer[i]);
+}
+
+void String::toUpperCase(void)
+{
+  for (unsigned int i = 0; i < len; i++)
+    buffer[i] = toupper((unsigned char)buffer[i]);
+}
+
+void String::trim(void)
+{
+  unsigned int begin = 0;
+  while (begin < len && isspace((unsigned char)buffer[begin]))
+    begin++;
+  unsigned int end = len;
+  while (end > begin && isspace((unsigned char)buffer[end - 1]))
+    end--;
+  memmove(buffer, buffer + begin, end - begin);
+  len = end - begin;
+  buffer[len] = '\0';
+}
+
+long String::toInt(void) const
+{
+  return atol(buffer);
+}
+
+float String::toFloat(void) const
+{
+  return atof(buffer);
+}
+
+double String::toDouble(void) const
+{
+  return atof(buffer);
+}
@@ -0,0 +1,230 @@
+#include <Arduino.h>
+#include <esp_mac.h>
+#include <config.h>
+#include <epd_sim.h>
+#include "sim_internal.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t n = 0;
+  while (size-- && write(*buffer++))
+    n++;
+  return n;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+  char text[256];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  if (len < 0)
+    return 0;
+  if ((size_t)len < sizeof(text))
+    return write((const uint8_t *)text, len);
+
+  char *large = (char *)malloc(len + 1);
+  if (!large)
+    return 0;
+  va_start(args, format);
+  vsnprintf(large, len + 1, format, args);
+  va_end(args);
+  size_t n = write((const uint8_t *)large, len);
+  free(large);
+  return n;
+}
+
+int Stream::timedRead(void)
+{
+  uint64_t start = sim_now_us();
+  do
+  {
+    int c = read();
+    if (c >= 0)
+      return c;
+    delay(1);
+  } while (sim_now_us() - start < _timeout * 1000ULL);
+  return -1;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+  size_t count = 0;
+  while (count < length)
+  {
+    int c = timedRead();
+    if (c < 0)
+      break;
+    buffer[count++] = (char)c;
+  }
+  return count;
+}
+
+String Stream::readString(void)
+{
+  String ret;
+  int c;
+  while ((c = timedRead()) >= 0)
+    ret += (char)c;
+  return ret;
+}
+
+uint32_t EspClass::getFreeHeap(void)
+{
+  size_t used = sim_heap_used();
+  return used < SIM_HEAP_SIZE ? SIM_HEAP_SIZE - used : 0;
+}
+
+uint32_t EspClass::getMinFreeHeap(void)
+{
+  size_t peak = sim_heap_peak();
+  return peak < SIM_HEAP_SIZE ? SIM_HEAP_SIZE - peak : 0;
+}
+
+uint32_t EspClass::getMaxAllocHeap(void)
+{
+  // no fragmentation in the model
+  return getFreeHeap();
+}
+
+uint32_t EspClass::getHeapSize(void)
+{
+  return SIM_HEAP_SIZE;
+}
+
+uint64_t EspClass::getEfuseMac(void)
+{
+  uint8_t mac[6];
+  esp_read_mac(mac, ESP_MAC_WIFI_STA);
+  uint64_t value = 0;
+  for (int i = 5; i >= 0; i--)
+    value = value << 8 | mac[i];
+  return value;
+}
+
+void EspClass::restart(void)
+{
+  sim_end_wake(SIM_END_RESTART);
+}
+
+extern "C"
+{
+  void pinMode(uint8_t pin, uint8_t mode)
+  {
+  }
+
+  void digitalWrite(uint8_t pin, uint8_t val)
+  {
+    epd_sim_gpio_write(val != LOW, 1UL << pin);
+  }
+
+  int digitalRead(uint8_t pin)
+  {
+    if (pin == PIN_INTERRUPT)
+      return sim_button_down() ? LOW : HIGH;
+    return epd_sim_gpio_level(pin);
+  }
+
+  void sim_gpio_write(bool high, uint32_t mask)
+  {
+    epd_sim_gpio_write(high, mask);
+  }
+
+  int gpio_get_level(gpio_num_t pin)
+  {
+    return digitalRead(pin);
+  }
+
+  void attachInterrupt(uint8_t pin, void (*handler)(void), int mode)
+  {
+  }
+
+  void detachInterrupt(uint8_t pin)
+  {
+  }
+
+  uint16_t analogRead(uint8_t pin)
+  {
+    return analogReadMilliVolts(pin) * 4095 / 3300;
+  }
+
+  uint32_t analogReadMilliVolts(uint8_t pin)
+  {
+    // the battery is read through a divider by two
+    if (pin == PIN_BATTERY)
+      return sim_cfg().battery_mv / 2;
+    return 0;
+  }
+
+  // millis() and micros() move the clock so that busy-wait loops end
+  unsigned long millis(void)
+  {
+    sim_advance_us(1);
+    return sim_now_us() / 1000;
+  }
+
+  unsigned long micros(void)
+  {
+    sim_advance_us(1);
+    return sim_now_us();
+  }
+
+  void delay(uint32_t ms)
+  {
+    sim_advance_us(ms * 1000ULL);
+  }
+
+  void delayMicroseconds(uint32_t us)
+  {
+    sim_advance_us(us);
+  }
+
+  void yield(void)
+  {
+  }
+
+  float temperatureRead(void)
+  {
+    return sim_cfg().temperature;
+  }
+
+  char *dtostrf(double value, signed char width, unsigned char precision, char *out)
+  {
+    sprintf(out, "%*.*f", width, precision, value);
+    return out;
+  }
+
+  void configTime(long gmtOffset_sec, int daylightOffset_sec, const char *server1, const char *server2,
+                  const char *server3)
+  {
+    sim_start_ntp();
+  }
+
+  bool getLocalTime(struct tm *info, uint32_t ms)
+  {
+    uint64_t start = sim_now_us();
+    while (true)
+    {
+      time_t now = sim_wall_time();
+      gmtime_r(&now, info);
+      if (info->tm_year > 2016 - 1900)
+        return true;
+      if (sim_now_us() - start >= ms * 1000ULL)
+        return false;
+      delay(10);
+    }
+  }
+
+  // the firmware reads the wall clock with time(); glibc's own calls are not affected
+  time_t time(time_t *out) noexcept
+  {
+    time_t now = sim_wall_time();
+    if (out)
+      *out = now;
+    return now;
+  }
+}
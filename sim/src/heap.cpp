@@ -0,0 +1,133 @@
+#include "sim_internal.h"
+
+/**
+ * Heap measurement: malloc and friends are wrapped to count the bytes in
+ * use, glibc's usable size of each block included, so the figures are an
+ * upper bound of what the device would use (pointers are twice as wide
+ * here). Allocations never fail. Without glibc, or under a sanitizer that
+ * brings its own malloc, nothing is counted and peak_heap stays 0.
+ */
+
+static bool counting = false;
+static size_t used = 0;
+static size_t peak = 0;
+static uint32_t allocations = 0;
+static size_t allocated = 0;
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#include <errno.h>
+#include <malloc.h>
+
+extern "C"
+{
+  void *__libc_malloc(size_t size);
+  void *__libc_calloc(size_t count, size_t size);
+  void *__libc_realloc(void *ptr, size_t size);
+  void *__libc_memalign(size_t alignment, size_t size);
+  void __libc_free(void *ptr);
+}
+
+static void *counted(void *ptr)
+{
+  if (ptr && counting)
+  {
+    size_t size = malloc_usable_size(ptr);
+    used += size;
+    if (used > peak)
+      peak = used;
+    allocations++;
+    allocated += size;
+  }
+  return ptr;
+}
+
+static void uncount(void *ptr)
+{
+  if (!ptr || !counting)
+    return;
+  size_t size = malloc_usable_size(ptr);
+  // blocks allocated before sim_heap_begin() were not counted
+  used = used > size ? used - size : 0;
+}
+
+extern "C"
+{
+  void *malloc(size_t size) noexcept
+  {
+    return counted(__libc_malloc(size));
+  }
+
+  void *calloc(size_t count, size_t size) noexcept
+  {
+    return counted(__libc_calloc(count, size));
+  }
+
+  void *realloc(void *ptr, size_t size) noexcept
+  {
+    uncount(ptr);
+    void *grown = __libc_realloc(ptr, size);
+    if (!grown && size != 0)
+    {
+      // the old block is still there
+      if (counting)
+        used += malloc_usable_size(ptr);
+      return nullptr;
+    }
+    return counted(grown);
+  }
+
+  void free(void *ptr) noexcept
+  {
+    uncount(ptr);
+    __libc_free(ptr);
+  }
+
+  void *memalign(size_t alignment, size_t size) noexcept
+  {
+    return counted(__libc_memalign(alignment, size));
+  }
+
+  void *aligned_alloc(size_t alignment, size_t size) noexcept
+  {
+    return memalign(alignment, size);
+  }
+
+  int posix_memalign(void **out, size_t alignment, size_t size) noexcept
+  {
+    void *ptr = memalign(alignment, size);
+    if (!ptr)
+      return ENOMEM;
+    *out = ptr;
+    return 0;
+  }
+}
+#endif
+
+void sim_heap_begin(void)
+{
+  used = 0;
+  peak = 0;
+  allocations = 0;
+  allocated = 0;
+  counting = true;
+}
+
+size_t sim_heap_used(void)
+{
+  return used;
+}
+
+size_t sim_heap_peak(void)
+{
+  return peak;
+}
+
+uint32_t sim_heap_allocations(void)
+{
+  return allocations;
+}
+
+size_t sim_heap_allocated(void)
+{
+  return allocated;
+}
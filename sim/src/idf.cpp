@@ -0,0 +1,195 @@
+#include <Arduino.h>
+#include <esp_mac.h>
+#include "sim_internal.h"
+
+/** Thrown by vTaskDelete(NULL) to leave a task that runs inline */
+struct SimTaskExit
+{
+};
+
+struct SimSemaphore
+{
+  bool given;
+  uint64_t given_us; // when it was given, in the time of the task that gave it
+};
+
+extern "C"
+{
+  const char *esp_err_to_name(esp_err_t code)
+  {
+    switch (code)
+    {
+    case ESP_OK:
+      return "ESP_OK";
+    case ESP_FAIL:
+      return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:
+      return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+      return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:
+      return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:
+      return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:
+      return "ESP_ERR_NOT_FOUND";
+    default:
+      return "UNKNOWN ERROR";
+    }
+  }
+
+  esp_reset_reason_t esp_reset_reason(void)
+  {
+    return sim_reset_reason();
+  }
+
+  void esp_restart(void)
+  {
+    sim_end_wake(SIM_END_RESTART);
+  }
+
+  esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void)
+  {
+    return sim_wakeup_cause();
+  }
+
+  esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us)
+  {
+    sim_set_sleep_timer(time_in_us);
+    return ESP_OK;
+  }
+
+  esp_err_t esp_sleep_enable_gpio_wakeup(void)
+  {
+    return ESP_OK;
+  }
+
+  esp_err_t esp_deep_sleep_enable_gpio_wakeup(uint64_t gpio_pin_mask, esp_deepsleep_gpio_wake_up_mode_t mode)
+  {
+    return ESP_OK;
+  }
+
+  esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source)
+  {
+    if (source == ESP_SLEEP_WAKEUP_TIMER || source == ESP_SLEEP_WAKEUP_ALL)
+      sim_set_sleep_timer(0);
+    return ESP_OK;
+  }
+
+  void esp_deep_sleep_start(void)
+  {
+    sim_end_wake(SIM_END_SLEEP);
+  }
+
+  esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type)
+  {
+    return ESP_OK;
+  }
+
+  esp_err_t esp_read_mac(uint8_t *mac, esp_mac_type_t type)
+  {
+    static const uint8_t sta[6] = {0xA0, 0xB7, 0x65, 0x12, 0x34, 0x56};
+    memcpy(mac, sta, sizeof(sta));
+    mac[5] += type;
+    return ESP_OK;
+  }
+
+  size_t heap_caps_get_free_size(uint32_t caps)
+  {
+    return ESP.getFreeHeap();
+  }
+
+  size_t heap_caps_get_largest_free_block(uint32_t caps)
+  {
+    return ESP.getMaxAllocHeap();
+  }
+
+  size_t heap_caps_get_minimum_free_size(uint32_t caps)
+  {
+    return ESP.getMinFreeHeap();
+  }
+
+  bool heap_caps_check_integrity_all(bool print_errors)
+  {
+    return true;
+  }
+
+  BaseType_t xTaskCreate(TaskFunction_t code, const char *name, configSTACK_DEPTH_TYPE stack_depth, void *parameters,
+                         UBaseType_t priority, TaskHandle_t *created_task)
+  {
+    uint64_t start = sim_now_us();
+    try
+    {
+      code(parameters);
+    }
+    catch (const SimTaskExit &)
+    {
+    }
+    sim_rewind_us(sim_now_us() - start);
+    if (created_task)
+      *created_task = nullptr;
+    return pdPASS;
+  }
+
+  void vTaskDelete(TaskHandle_t task)
+  {
+    if (!task)
+      throw SimTaskExit();
+  }
+
+  void vTaskDelay(TickType_t ticks)
+  {
+    delay(ticks * portTICK_PERIOD_MS);
+  }
+
+  UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+  {
+    return 1;
+  }
+
+  SemaphoreHandle_t xSemaphoreCreateBinary(void)
+  {
+    return new SimSemaphore{false, 0};
+  }
+
+  BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+  {
+    if (semaphore->given)
+      return pdFALSE;
+    semaphore->given = true;
+    semaphore->given_us = sim_now_us();
+    return pdTRUE;
+  }
+
+  BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks)
+  {
+    if (!semaphore->given)
+    {
+      // nothing else runs, so it would never be given
+      if (ticks == portMAX_DELAY)
+      {
+        fprintf(stderr, "xSemaphoreTake: waiting forever on a semaphore nobody gives\n");
+        abort();
+      }
+      delay(ticks * portTICK_PERIOD_MS);
+      return pdFALSE;
+    }
+    uint64_t now = sim_now_us();
+    if (semaphore->given_us > now)
+    {
+      if (ticks != portMAX_DELAY && semaphore->given_us - now > ticks * portTICK_PERIOD_MS * 1000ULL)
+      {
+        delay(ticks * portTICK_PERIOD_MS);
+        return pdFALSE;
+      }
+      sim_advance_us(semaphore->given_us - now);
+    }
+    semaphore->given = false;
+    return pdTRUE;
+  }
+
+  void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+  {
+    delete semaphore;
+  }
+}
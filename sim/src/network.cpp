@@ -0,0 +1,433 @@
+#include <Arduino.h>
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <esp_mac.h>
+#include "sim_internal.h"
+
+WiFiClass WiFi;
+
+static wifi_mode_t wifi_mode = WIFI_OFF;
+static bool joining = false;
+static uint64_t joined_us = 0; // when the join started by WiFi.begin() completes
+
+static uint64_t round_trip_us(void)
+{
+  return sim_cfg().latency_ms * 1000ULL;
+}
+
+/** Time to send bytes at the configured bandwidth */
+static uint64_t transfer_us(size_t bytes)
+{
+  uint32_t bandwidth = sim_cfg().bandwidth;
+  return bandwidth ? (bytes * 1000000ULL + bandwidth - 1) / bandwidth : 0;
+}
+
+bool sim_wifi_connected(void)
+{
+  return joining && sim_cfg().wifi_available && sim_now_us() >= joined_us;
+}
+
+bool WiFiClass::mode(wifi_mode_t mode)
+{
+  wifi_mode = mode;
+  return true;
+}
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *passphrase)
+{
+  if (wifi_mode == WIFI_OFF)
+    wifi_mode = WIFI_STA;
+  joining = true;
+  joined_us = sim_now_us() + sim_cfg().wifi_connect_ms * 1000ULL;
+  return WL_DISCONNECTED;
+}
+
+wl_status_t WiFiClass::status(void)
+{
+  if (sim_wifi_connected())
+    return WL_CONNECTED;
+  if (joining && sim_now_us() >= joined_us)
+    return WL_NO_SSID_AVAIL;
+  return WL_DISCONNECTED;
+}
+
+uint8_t WiFiClass::waitForConnectResult(unsigned long timeout)
+{
+  uint64_t start = sim_now_us();
+  while (status() == WL_DISCONNECTED && sim_now_us() - start < timeout * 1000ULL)
+    delay(100);
+  return status();
+}
+
+bool WiFiClass::disconnect(bool wifioff, bool eraseap)
+{
+  joining = false;
+  if (wifioff)
+    wifi_mode = WIFI_OFF;
+  return true;
+}
+
+int8_t WiFiClass::RSSI(void)
+{
+  return sim_wifi_connected() ? sim_cfg().rssi : 0;
+}
+
+String WiFiClass::macAddress(void)
+{
+  uint8_t mac[6];
+  char text[18];
+  esp_read_mac(mac, ESP_MAC_WIFI_STA);
+  snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  return String(text);
+}
+
+String WiFiClass::SSID(void)
+{
+  return sim_wifi_connected() ? String("trmnl-sim") : String();
+}
+
+IPAddress WiFiClass::localIP(void)
+{
+  return sim_wifi_connected() ? IPAddress(192, 168, 1, 100) : IPAddress();
+}
+
+int WiFiClass::hostByName(const char *host, IPAddress &result)
+{
+  if (!sim_wifi_connected())
+    return 0;
+  sim_advance_us(round_trip_us());
+  result = IPAddress(10, 0, 0, 2);
+  return 1;
+}
+
+WiFiClient::~WiFiClient()
+{
+  stop();
+}
+
+size_t WiFiClient::arrived(void)
+{
+  uint64_t now = sim_now_us();
+  if (!open || now < start_us)
+    return 0;
+  uint32_t bandwidth = sim_cfg().bandwidth;
+  if (!bandwidth)
+    return body_size;
+  uint64_t bytes = (now - start_us) * bandwidth / 1000000ULL;
+  return bytes < body_size ? bytes : body_size;
+}
+
+uint64_t WiFiClient::arrival_us(size_t bytes)
+{
+  return start_us + transfer_us(bytes);
+}
+
+void WiFiClient::received(size_t bytes)
+{
+  consumed += bytes;
+  sim_metrics().bytes_down += bytes;
+  if (request)
+    request->bytes_down += bytes;
+}
+
+int WiFiClient::available(void)
+{
+  return open ? arrived() - consumed : 0;
+}
+
+int WiFiClient::read(void)
+{
+  if (available() <= 0)
+    return -1;
+  uint8_t c = body[consumed];
+  received(1);
+  return c;
+}
+
+int WiFiClient::peek(void)
+{
+  return available() > 0 ? body[consumed] : -1;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size)
+{
+  int n = available();
+  if (n <= 0)
+    return -1;
+  if ((size_t)n > size)
+    n = size;
+  memcpy(buffer, body + consumed, n);
+  received(n);
+  return n;
+}
+
+size_t WiFiClient::readBytes(char *buffer, size_t length)
+{
+  size_t count = 0;
+  while (count < length)
+  {
+    int n = read((uint8_t *)buffer + count, length - count);
+    if (n > 0)
+    {
+      count += n;
+      continue;
+    }
+    // wait for the next byte, up to the timeout; a closed connection sends none
+    uint64_t now = sim_now_us();
+    uint64_t deadline = now + _timeout * 1000ULL;
+    uint64_t next = open && consumed < body_size ? arrival_us(consumed + 1) : UINT64_MAX;
+    if (next > deadline)
+    {
+      sim_advance_us(deadline - now);
+      break;
+    }
+    sim_advance_us(next - now);
+  }
+  return count;
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size)
+{
+  if (!open)
+    return 0;
+  sim_advance_us(transfer_us(size));
+  sim_metrics().bytes_up += size;
+  return size;
+}
+
+uint8_t WiFiClient::connected(void)
+{
+  return open && consumed < body_size;
+}
+
+void WiFiClient::stop(void)
+{
+  open = false;
+  request = nullptr;
+}
+
+bool HTTPClient::begin(WiFiClient &client, const String &url)
+{
+  int scheme = url.indexOf("://");
+  if (scheme < 0)
+    return false;
+  int slash = url.indexOf('/', scheme + 3);
+  host = slash < 0 ? url.substring(scheme + 3) : url.substring(scheme + 3, slash);
+  path = slash < 0 ? String("/") : url.substring(slash);
+  this->client = &client;
+  request_headers = "";
+  content_type = "";
+  content_range = "";
+  size = -1;
+  return host.length() > 0;
+}
+
+void HTTPClient::end(void)
+{
+  if (client)
+    client->stop();
+  client = nullptr;
+}
+
+bool HTTPClient::connected(void)
+{
+  return client && client->connected();
+}
+
+void HTTPClient::addHeader(const String &name, const String &value, bool first, bool replace)
+{
+  request_headers += name + ": " + value + "\r\n";
+}
+
+void HTTPClient::collectHeaders(const char *headerKeys[], const size_t headerKeysCount)
+{
+  collected = "";
+  for (size_t i = 0; i < headerKeysCount; i++)
+    collected += String(headerKeys[i]) + "\n";
+}
+
+/** Start of an open-ended "Range: bytes=N-" of the request, or -1 */
+static long range_start(const String &headers)
+{
+  int range = headers.indexOf("Range: bytes=");
+  if (range < 0)
+    return -1;
+  const char *start = headers.c_str() + range + strlen("Range: bytes=");
+  char *end;
+  long offset = strtol(start, &end, 10);
+  return end != start && *end == '-' ? offset : -1;
+}
+
+int HTTPClient::sendRequest(const char *type, const uint8_t *payload, size_t payload_size)
+{
+  if (!client)
+    return HTTPC_ERROR_NOT_CONNECTED;
+  client->stop();
+  size = -1;
+  content_type = "";
+  content_range = "";
+
+  // routes are keyed by the path without query
+  int query = path.indexOf('?');
+  String key = query < 0 ? path : path.substring(0, query);
+
+  SimRequest *request = sim_log_request();
+  snprintf(request->method, sizeof(request->method), "%s", type);
+  snprintf(request->path, sizeof(request->path), "%s", key.c_str());
+  snprintf(request->headers, sizeof(request->headers), "%s", request_headers.c_str());
+  if (payload)
+  {
+    size_t n = payload_size < sizeof(request->body) - 1 ? payload_size : sizeof(request->body) - 1;
+    memcpy(request->body, payload, n);
+    request->body[n] = '\0';
+  }
+  sim_metrics().requests++;
+
+  if (!sim_wifi_connected())
+    return request->status = HTTPC_ERROR_CONNECTION_REFUSED;
+
+  SimRoute *route = sim_route(key.c_str());
+  SimFailure failure = SIM_FAIL_NONE;
+  if (route)
+  {
+    route->count++;
+    if (route->failures)
+    {
+      route->failures--;
+      failure = route->failure;
+    }
+  }
+
+  // every request opens a new connection
+  const SimConfig &cfg = sim_cfg();
+  sim_advance_us(round_trip_us());
+  if (failure == SIM_FAIL_CONNECT)
+    return request->status = HTTPC_ERROR_CONNECTION_REFUSED;
+  if (client->secure)
+    sim_advance_us(2 * round_trip_us() + cfg.tls_ms * 1000ULL);
+
+  String head = String(type) + " " + path + " HTTP/1.1\r\nHost: " + host + "\r\n" + request_headers;
+  if (payload)
+    head += "Content-Length: " + String((unsigned int)payload_size) + "\r\n";
+  head += "\r\n";
+  size_t up = head.length() + (payload ? payload_size : 0);
+  sim_advance_us(transfer_us(up));
+  sim_metrics().bytes_up += up;
+  request->bytes_up = up;
+
+  if (failure == SIM_FAIL_STALL)
+  {
+    sim_advance_us(tcp_timeout * 1000ULL);
+    return request->status = HTTPC_ERROR_READ_TIMEOUT;
+  }
+
+  sim_advance_us(round_trip_us());
+  int status = route ? route->status : HTTP_CODE_NOT_FOUND;
+  const uint8_t *body = nullptr;
+  size_t body_size = 0;
+  if (failure == SIM_FAIL_STATUS)
+    status = HTTP_CODE_INTERNAL_SERVER_ERROR;
+  else if (route)
+  {
+    body = route->body;
+    body_size = route->size;
+    content_type = route->content_type;
+
+    // a body is served in part when asked to
+    long offset = range_start(request_headers);
+    if (offset >= 0 && status == HTTP_CODE_OK && body_size)
+    {
+      if ((size_t)offset >= body_size)
+      {
+        status = HTTP_CODE_RANGE_NOT_SATISFIABLE;
+        body = nullptr;
+        body_size = 0;
+      }
+      else
+      {
+        status = HTTP_CODE_PARTIAL_CONTENT;
+        content_range = "bytes " + String(offset) + "-" + String((unsigned long)(body_size - 1)) + "/" +
+                        String((unsigned long)body_size);
+        body += offset;
+        body_size -= offset;
+      }
+    }
+  }
+
+  String response = "HTTP/1.1 " + String(status) + "\r\nContent-Type: " + content_type +
+                    "\r\nContent-Length: " + String((unsigned int)body_size) + "\r\n";
+  if (content_range.length())
+    response += "Content-Range: " + content_range + "\r\n";
+  response += "\r\n";
+  sim_advance_us(transfer_us(response.length()));
+  sim_metrics().bytes_down += response.length();
+  request->bytes_down = response.length();
+  request->status = status;
+
+  client->open = true;
+  client->body = body;
+  // a truncated body still announces its full length
+  client->body_size = failure == SIM_FAIL_TRUNCATE ? body_size / 2 : body_size;
+  client->consumed = 0;
+  client->start_us = sim_now_us();
+  client->request = request;
+  client->setTimeout(tcp_timeout);
+  size = body_size;
+  return status;
+}
+
+String HTTPClient::getString(void)
+{
+  String payload;
+  if (!client || size <= 0)
+    return payload;
+  payload.reserve(size);
+  char chunk[256];
+  size_t n;
+  while ((n = client->readBytes(chunk, sizeof(chunk))) > 0)
+    payload.concat(chunk, n);
+  return payload;
+}
+
+String HTTPClient::header(const char *name)
+{
+  if (strcasecmp(name, "Content-Type") == 0)
+    return content_type;
+  if (strcasecmp(name, "Content-Length") == 0 && size >= 0)
+    return String(size);
+  // like the core, other headers are only kept when collected
+  if (strcasecmp(name, "Content-Range") == 0 && collected.indexOf("Content-Range\n") >= 0)
+    return content_range;
+  return String();
+}
+
+String HTTPClient::errorToString(int error)
+{
+  switch (error)
+  {
+  case HTTPC_ERROR_CONNECTION_REFUSED:
+    return F("connection refused");
+  case HTTPC_ERROR_SEND_HEADER_FAILED:
+    return F("send header failed");
+  case HTTPC_ERROR_SEND_PAYLOAD_FAILED:
+    return F("send payload failed");
+  case HTTPC_ERROR_NOT_CONNECTED:
+    return F("not connected");
+  case HTTPC_ERROR_CONNECTION_LOST:
+    return F("connection lost");
+  case HTTPC_ERROR_NO_STREAM:
+    return F("no stream");
+  case HTTPC_ERROR_NO_HTTP_SERVER:
+    return F("no HTTP server");
+  case HTTPC_ERROR_TOO_LESS_RAM:
+    return F("too less ram");
+  case HTTPC_ERROR_ENCODING:
+    return F("Transfer-Encoding not supported");
+  case HTTPC_ERROR_STREAM_WRITE:
+    return F("Stream write error");
+  case HTTPC_ERROR_READ_TIMEOUT:
+    return F("read Timeout");
+  default:
+    return String();
+  }
+}
@@ -0,0 +1,10 @@
+/**
+ * The 7.5" V2 driver and GUI_Paint, built against the panel model of
+ * lib/epd_sim like in the panel simulator test: epd_sim.h comes first so the
+ * driver's register writes and BUSY reads reach the model. The library
+ * itself is left out of this build, its DEV_Config.cpp drives the real SPI.
+ */
+#include <epd_sim.h>
+#include <utility/EPD_7in5_V2.cpp>
+#include <GUI_Paint.cpp>
+#include <font24.cpp>
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <wake_sim.h>
+#include <sim_heap.h>
+#include <esp_system.h>
+#include <esp_sleep.h>
+
+/** What the stand-ins in sim/src share with the runner in wake_sim.cpp */
+
+#define SIM_ROUTES 32
+#define SIM_REQUEST_LOG 64
+
+struct SimRoute
+{
+  char path[96];
+  int status;
+  char content_type[32];
+  const uint8_t *body; // in the runner's memory, which every wake inherits
+  size_t size;
+  SimFailure failure;
+  uint32_t failures; // requests left that fail
+  uint32_t count;
+};
+
+/**
+ * @brief Function to get the simulated time since the start of the wake
+ * @param none
+ * @return uint64_t microseconds, including the panel's SPI transfers
+ */
+uint64_t sim_now_us(void);
+
+/**
+ * @brief Function to let simulated time pass
+ * @param us microseconds
+ * @return none
+ */
+void sim_advance_us(uint64_t us);
+
+/**
+ * @brief Function to take back time spent by a task that ran inline, see freertos/FreeRTOS.h
+ * @param us microseconds
+ * @return none
+ */
+void sim_rewind_us(uint64_t us);
+
+/**
+ * @brief Function to get the wall clock of the device
+ * @param none
+ * @return time_t seconds since the epoch once NTP synced it, since power on before that
+ */
+time_t sim_wall_time(void);
+
+/**
+ * @brief Function to start an NTP sync, which completes one round trip later if SimConfig allows it
+ * @param none
+ * @return none
+ */
+void sim_start_ntp(void);
+
+/**
+ * @brief Function to get the configuration of the run
+ * @param none
+ * @return const SimConfig& configuration
+ */
+const SimConfig &sim_cfg(void);
+
+/**
+ * @brief Function to get the counters of the current wake, for the stand-ins to add to
+ * @param none
+ * @return SimWake& counters
+ */
+SimWake &sim_metrics(void);
+
+/**
+ * @brief Function to get why the device woke up
+ * @param none
+ * @return esp_sleep_wakeup_cause_t wakeup cause
+ */
+esp_sleep_wakeup_cause_t sim_wakeup_cause(void);
+
+/**
+ * @brief Function to check whether the button is down
+ * @param none
+ * @return bool true during a SIM_WAKE_BUTTON_HOLD wake, and during the second press of a SIM_WAKE_DOUBLE_CLICK
+ */
+bool sim_button_down(void);
+
+/**
+ * @brief Function to get why the device was reset
+ * @param none
+ * @return esp_reset_reason_t reset reason
+ */
+esp_reset_reason_t sim_reset_reason(void);
+
+/**
+ * @brief Function to arm the deep sleep timer
+ * @param us microseconds
+ * @return none
+ */
+void sim_set_sleep_timer(uint64_t us);
+
+/**
+ * @brief Function to end the wake: saves what survives it and leaves the wake's process
+ * @param end how the wake ended
+ * @return none
+ */
+void sim_end_wake(SimEnd end) __attribute__((noreturn));
+
+/**
+ * @brief Function to build a path in the storage of the simulated device
+ * @param out destination
+ * @param size size of out
+ * @param format path under the device directory, printf style
+ * @return none
+ */
+void sim_device_path(char *out, size_t size, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief Function to find the route of the fake server for a path
+ * @param path path of the URL, without query
+ * @return SimRoute* route, created as a 404 if there was none, nullptr if the table is full
+ */
+SimRoute *sim_route(const char *path);
+
+/**
+ * @brief Function to add a request to the server's log
+ * @param none
+ * @return SimRequest* cleared entry to fill in
+ */
+SimRequest *sim_log_request(void);
+
+/**
+ * @brief Function to tell if WiFi is connected
+ * @param none
+ * @return bool true when connected
+ */
+bool sim_wifi_connected(void);
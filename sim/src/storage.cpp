@@ -0,0 +1,851 @@
+#include <Arduino.h>
+#include <Preferences.h>
+#include <LittleFS.h>
+#include <SPIFFS.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#include <nvs.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "sim_internal.h"
+
+/**
+ * Storage of the simulated device, kept in files so it survives the wake's
+ * process. Host files are used through file descriptors only: a wake ends
+ * with _exit(), which would drop what a FILE* still buffers.
+ */
+
+// typical timings of the 4 MB SPI flash
+#define SIM_FLASH_SECTOR_ERASE_US 45000 // per 4 KB sector
+#define SIM_FLASH_PAGE_PROGRAM_US 600   // per 256-byte page
+
+#define SIM_NVS_ENTRY_SIZE 32
+#define SIM_NVS_PAGE_ENTRIES 126
+#define SIM_NVS_TOTAL_ENTRIES (0x5000 / SPI_FLASH_SEC_SIZE * SIM_NVS_PAGE_ENTRIES)
+
+#define SIM_FS_BLOCK_SIZE 4096
+#define SIM_FS_TOTAL_BYTES 0x20000 // "spiffs" of min_spiffs.csv
+#define SIM_FS_METADATA_BLOCKS 2 // superblock pair of LittleFS
+
+static uint64_t program_us(size_t bytes)
+{
+  return (bytes + 255) / 256 * (uint64_t)SIM_FLASH_PAGE_PROGRAM_US;
+}
+
+static bool write_all(int fd, const void *data, size_t size)
+{
+  const uint8_t *bytes = (const uint8_t *)data;
+  while (size)
+  {
+    ssize_t n = ::write(fd, bytes, size);
+    if (n <= 0)
+      return false;
+    bytes += n;
+    size -= n;
+  }
+  return true;
+}
+
+/* NVS: one file per namespace, a sequence of key length, key, type, value length, value */
+
+struct NvsEntry
+{
+  std::string key;
+  PreferenceType type;
+  std::vector<uint8_t> value;
+};
+
+static void nvs_path(char *out, size_t size, const char *ns)
+{
+  sim_device_path(out, size, "nvs/%s", ns);
+}
+
+static bool nvs_load(const char *ns, std::vector<NvsEntry> &entries)
+{
+  char path[256];
+  nvs_path(path, sizeof(path), ns);
+  entries.clear();
+  int fd = ::open(path, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  fstat(fd, &st);
+  std::vector<uint8_t> data(st.st_size);
+  size_t got = 0;
+  while (got < data.size())
+  {
+    ssize_t n = ::read(fd, data.data() + got, data.size() - got);
+    if (n <= 0)
+      break;
+    got += n;
+  }
+  ::close(fd);
+
+  size_t at = 0;
+  while (at + 1 <= got)
+  {
+    NvsEntry entry;
+    uint8_t key_len = data[at++];
+    if (at + key_len + 1 + 4 > got)
+      break;
+    entry.key.assign((const char *)&data[at], key_len);
+    at += key_len;
+    entry.type = (PreferenceType)data[at++];
+    uint32_t len;
+    memcpy(&len, &data[at], 4);
+    at += 4;
+    if (at + len > got)
+      break;
+    entry.value.assign(data.begin() + at, data.begin() + at + len);
+    at += len;
+    entries.push_back(entry);
+  }
+  return true;
+}
+
+static bool nvs_save(const char *ns, const std::vector<NvsEntry> &entries)
+{
+  char path[256];
+  nvs_path(path, sizeof(path), ns);
+  int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    return false;
+  bool ok = true;
+  for (const NvsEntry &entry : entries)
+  {
+    uint8_t key_len = entry.key.size();
+    uint8_t type = entry.type;
+    uint32_t len = entry.value.size();
+    ok = ok && write_all(fd, &key_len, 1) && write_all(fd, entry.key.data(), key_len) && write_all(fd, &type, 1) &&
+         write_all(fd, &len, 4) && write_all(fd, entry.value.data(), len);
+  }
+  ::close(fd);
+  return ok;
+}
+
+/** Entries an item takes: strings and blobs add their data in 32-byte entries */
+static size_t nvs_span(const NvsEntry &entry)
+{
+  if (entry.type != PT_STR && entry.type != PT_BLOB)
+    return 1;
+  return 1 + (entry.value.size() + SIM_NVS_ENTRY_SIZE - 1) / SIM_NVS_ENTRY_SIZE;
+}
+
+static std::vector<NvsEntry>::iterator nvs_find(std::vector<NvsEntry> &entries, const char *key)
+{
+  return std::find_if(entries.begin(), entries.end(), [key](const NvsEntry &entry)
+                      { return entry.key == key; });
+}
+
+extern "C" esp_err_t nvs_get_stats(const char *part_name, nvs_stats_t *nvs_stats)
+{
+  if (!nvs_stats)
+    return ESP_ERR_INVALID_ARG;
+  char dir_path[256];
+  sim_device_path(dir_path, sizeof(dir_path), "nvs");
+  size_t used = 0, namespaces = 0;
+  DIR *dir = opendir(dir_path);
+  if (dir)
+  {
+    struct dirent *item;
+    while ((item = readdir(dir)))
+    {
+      if (item->d_name[0] == '.')
+        continue;
+      std::vector<NvsEntry> entries;
+      nvs_load(item->d_name, entries);
+      namespaces++;
+      used++; // the namespace's own entry
+      for (const NvsEntry &entry : entries)
+        used += nvs_span(entry);
+    }
+    closedir(dir);
+  }
+  // NVS keeps one page free for garbage collection
+  size_t usable = SIM_NVS_TOTAL_ENTRIES - SIM_NVS_PAGE_ENTRIES;
+  nvs_stats->used_entries = used;
+  nvs_stats->free_entries = used < usable ? usable - used : 0;
+  nvs_stats->total_entries = SIM_NVS_TOTAL_ENTRIES;
+  nvs_stats->namespace_count = namespaces;
+  return ESP_OK;
+}
+
+bool Preferences::begin(const char *name, bool readOnly, const char *partition_label)
+{
+  if (started || !name || strlen(name) > 15)
+    return false;
+  std::vector<NvsEntry> entries;
+  if (!nvs_load(name, entries))
+  {
+    // opening read-only does not create the namespace
+    if (readOnly || !nvs_save(name, entries))
+      return false;
+    sim_metrics().nvs_write_bytes += SIM_NVS_ENTRY_SIZE;
+  }
+  strcpy(this->name, name);
+  this->readOnly = readOnly;
+  started = true;
+  return true;
+}
+
+void Preferences::end(void)
+{
+  started = false;
+}
+
+bool Preferences::clear(void)
+{
+  if (!started || readOnly)
+    return false;
+  return nvs_save(name, std::vector<NvsEntry>());
+}
+
+bool Preferences::remove(const char *key)
+{
+  if (!started || !key || readOnly)
+    return false;
+  std::vector<NvsEntry> entries;
+  nvs_load(name, entries);
+  auto found = nvs_find(entries, key);
+  if (found == entries.end())
+    return false;
+  entries.erase(found);
+  return nvs_save(name, entries);
+}
+
+size_t Preferences::put(const char *key, PreferenceType type, const void *value, size_t len)
+{
+  if (!started || !key || readOnly || strlen(key) > 15)
+    return 0;
+  std::vector<NvsEntry> entries;
+  nvs_load(name, entries);
+  auto found = nvs_find(entries, key);
+  const uint8_t *bytes = (const uint8_t *)value;
+  if (found != entries.end())
+  {
+    // like nvs_set_*, the same value is not written again
+    if (found->type == type && found->value.size() == len && memcmp(found->value.data(), bytes, len) == 0)
+      return len;
+    entries.erase(found);
+  }
+  NvsEntry entry{key, type, std::vector<uint8_t>(bytes, bytes + len)};
+  entries.push_back(entry);
+  if (!nvs_save(name, entries))
+    return 0;
+  sim_metrics().nvs_write_bytes += nvs_span(entry) * SIM_NVS_ENTRY_SIZE;
+  return len;
+}
+
+bool Preferences::get(const char *key, PreferenceType type, void *value, size_t len)
+{
+  if (!started || !key)
+    return false;
+  std::vector<NvsEntry> entries;
+  nvs_load(name, entries);
+  auto found = nvs_find(entries, key);
+  if (found == entries.end() || found->type != type || found->value.size() != len)
+    return false;
+  memcpy(value, found->value.data(), len);
+  return true;
+}
+
+size_t Preferences::putString(const char *key, const char *value)
+{
+  if (!value)
+    return 0;
+  size_t len = strlen(value);
+  return put(key, PT_STR, value, len + 1) ? len : 0;
+}
+
+bool Preferences::isKey(const char *key)
+{
+  return getType(key) != PT_INVALID;
+}
+
+PreferenceType Preferences::getType(const char *key)
+{
+  if (!started || !key)
+    return PT_INVALID;
+  std::vector<NvsEntry> entries;
+  nvs_load(name, entries);
+  auto found = nvs_find(entries, key);
+  return found == entries.end() ? PT_INVALID : found->type;
+}
+
+String Preferences::getString(const char *key, String defaultValue)
+{
+  if (!started || !key)
+    return defaultValue;
+  std::vector<NvsEntry> entries;
+  nvs_load(name, entries);
+  auto found = nvs_find(entries, key);
+  if (found == entries.end() || found->type != PT_STR)
+    return defaultValue;
+  return String((const char *)found->value.data());
+}
+
+size_t Preferences::getString(const char *key, char *value, size_t maxLen)
+{
+  if (!started || !key || !value)
+    return 0;
+  std::vector<NvsEntry> entries;
+  nvs_load(name, entries);
+  auto found = nvs_find(entries, key);
+  if (found == entries.end() || found->type != PT_STR || found->value.size() > maxLen)
+    return 0;
+  memcpy(value, found->value.data(), found->value.size());
+  return found->value.size();
+}
+
+size_t Preferences::getBytesLength(const char *key)
+{
+  if (!started || !key)
+    return 0;
+  std::vector<NvsEntry> entries;
+  nvs_load(name, entries);
+  auto found = nvs_find(entries, key);
+  return found == entries.end() || found->type != PT_BLOB ? 0 : found->value.size();
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen)
+{
+  if (!started || !key || !buf)
+    return 0;
+  std::vector<NvsEntry> entries;
+  nvs_load(name, entries);
+  auto found = nvs_find(entries, key);
+  if (found == entries.end() || found->type != PT_BLOB || found->value.size() > maxLen)
+    return 0;
+  memcpy(buf, found->value.data(), found->value.size());
+  return found->value.size();
+}
+
+size_t Preferences::freeEntries(void)
+{
+  nvs_stats_t stats;
+  nvs_get_stats(nullptr, &stats);
+  return stats.free_entries;
+}
+
+/* Filesystem: the files of the "spiffs" partition, in fs/ */
+
+namespace fs
+{
+  class FileImpl
+  {
+  public:
+    ~FileImpl()
+    {
+      if (fd >= 0)
+        ::close(fd);
+    }
+
+    FS *fs = nullptr;
+    int fd = -1;
+    bool writable = false;
+    bool directory = false;
+    std::string path;
+    std::vector<std::string> entries; // of a directory
+    size_t next = 0;
+  };
+}
+
+static size_t fs_blocks(size_t bytes)
+{
+  return (bytes + SIM_FS_BLOCK_SIZE - 1) / SIM_FS_BLOCK_SIZE;
+}
+
+static void fs_host_path(char *out, size_t size, const char *path)
+{
+  sim_device_path(out, size, "fs%s", path);
+}
+
+static std::vector<std::string> fs_list(void)
+{
+  std::vector<std::string> names;
+  char dir_path[256];
+  fs_host_path(dir_path, sizeof(dir_path), "");
+  DIR *dir = opendir(dir_path);
+  if (!dir)
+    return names;
+  struct dirent *item;
+  while ((item = readdir(dir)))
+  {
+    if (item->d_name[0] != '.')
+      names.push_back(item->d_name);
+  }
+  closedir(dir);
+  // the order of the host's directory is not reproducible
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+/** Blocks in use, metadata included */
+static size_t fs_used_blocks(void)
+{
+  size_t blocks = SIM_FS_METADATA_BLOCKS;
+  for (const std::string &name : fs_list())
+  {
+    char path[256];
+    struct stat st;
+    fs_host_path(path, sizeof(path), ("/" + name).c_str());
+    if (stat(path, &st) == 0)
+      blocks += fs_blocks(st.st_size);
+  }
+  return blocks;
+}
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+  if (!_p || _p->fd < 0 || !_p->writable)
+    return 0;
+  struct stat st;
+  fstat(_p->fd, &st);
+  off_t pos = lseek(_p->fd, 0, SEEK_CUR);
+  // the file may grow into the blocks nobody else uses
+  size_t others = fs_used_blocks() - fs_blocks(st.st_size);
+  size_t room = SIM_FS_TOTAL_BYTES / SIM_FS_BLOCK_SIZE > others
+                    ? (SIM_FS_TOTAL_BYTES / SIM_FS_BLOCK_SIZE - others) * SIM_FS_BLOCK_SIZE
+                    : 0;
+  if ((size_t)pos + size > room)
+    size = room > (size_t)pos ? room - pos : 0;
+  if (!size || !write_all(_p->fd, buf, size))
+    return 0;
+  sim_metrics().fs_write_bytes += size;
+  // programming, and erasing the blocks the data goes to
+  sim_advance_us(program_us(size) + size * (uint64_t)SIM_FLASH_SECTOR_ERASE_US / SIM_FS_BLOCK_SIZE);
+  return size;
+}
+
+int File::available(void)
+{
+  if (!_p || _p->fd < 0)
+    return 0;
+  return size() - position();
+}
+
+int File::read(void)
+{
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek(void)
+{
+  int c = read();
+  if (c >= 0)
+    lseek(_p->fd, -1, SEEK_CUR);
+  return c;
+}
+
+void File::flush(void)
+{
+}
+
+size_t File::read(uint8_t *buf, size_t size)
+{
+  if (!_p || _p->fd < 0)
+    return 0;
+  ssize_t n = ::read(_p->fd, buf, size);
+  return n > 0 ? n : 0;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+  if (!_p || _p->fd < 0)
+    return false;
+  int whence = mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END;
+  return lseek(_p->fd, pos, whence) >= 0;
+}
+
+size_t File::position(void) const
+{
+  if (!_p || _p->fd < 0)
+    return 0;
+  return lseek(_p->fd, 0, SEEK_CUR);
+}
+
+size_t File::size(void) const
+{
+  struct stat st;
+  if (!_p || _p->fd < 0 || fstat(_p->fd, &st) != 0)
+    return 0;
+  return st.st_size;
+}
+
+void File::close(void)
+{
+  _p.reset();
+}
+
+File::operator bool() const
+{
+  return _p && (_p->fd >= 0 || _p->directory);
+}
+
+const char *File::path(void) const
+{
+  return _p ? _p->path.c_str() : nullptr;
+}
+
+const char *File::name(void) const
+{
+  if (!_p)
+    return nullptr;
+  const char *slash = strrchr(_p->path.c_str(), '/');
+  return slash ? slash + 1 : _p->path.c_str();
+}
+
+bool File::isDirectory(void)
+{
+  return _p && _p->directory;
+}
+
+File File::openNextFile(const char *mode)
+{
+  if (!_p || !_p->directory || _p->next >= _p->entries.size())
+    return File();
+  return _p->fs->open(("/" + _p->entries[_p->next++]).c_str(), mode);
+}
+
+void File::rewindDirectory(void)
+{
+  if (_p)
+    _p->next = 0;
+}
+
+/* Which filesystem formatted the partition, kept next to its files: the other one cannot mount it */
+
+static void fs_format_path(char *out, size_t size)
+{
+  sim_device_path(out, size, "fs.format");
+}
+
+static bool fs_formatted_as(const char *name)
+{
+  char path[256], format[16] = "";
+  fs_format_path(path, sizeof(path));
+  FILE *file = fopen(path, "r");
+  if (!file)
+    return false;
+  bool same = fgets(format, sizeof(format), file) && strcmp(format, name) == 0;
+  fclose(file);
+  return same;
+}
+
+static bool fs_mark_formatted(const char *name)
+{
+  char path[256];
+  fs_format_path(path, sizeof(path));
+  FILE *file = fopen(path, "w");
+  if (!file)
+    return false;
+  bool ok = fputs(name, file) >= 0;
+  return fclose(file) == 0 && ok;
+}
+
+bool FS::begin(bool formatOnFail, const char *basePath, uint8_t maxOpenFiles, const char *partitionLabel)
+{
+  char dir_path[256];
+  fs_host_path(dir_path, sizeof(dir_path), "");
+  if (::mkdir(dir_path, 0755) != 0 && errno != EEXIST)
+    return false;
+  if (!fs_formatted_as(name))
+  {
+    // blank flash or the other filesystem
+    if (!formatOnFail)
+      return false;
+    for (const std::string &file : fs_list())
+    {
+      char path[256];
+      fs_host_path(path, sizeof(path), ("/" + file).c_str());
+      unlink(path);
+    }
+    if (!fs_mark_formatted(name))
+      return false;
+  }
+  mounted = true;
+  return true;
+}
+
+void FS::end(void)
+{
+  mounted = false;
+}
+
+bool FS::format(void)
+{
+  for (const std::string &name : fs_list())
+    remove(("/" + name).c_str());
+  return true;
+}
+
+size_t FS::totalBytes(void)
+{
+  return SIM_FS_TOTAL_BYTES;
+}
+
+size_t FS::usedBytes(void)
+{
+  return mounted ? fs_used_blocks() * SIM_FS_BLOCK_SIZE : 0;
+}
+
+File FS::open(const char *path, const char *mode, const bool create)
+{
+  if (!mounted || !path || path[0] != '/')
+    return File();
+  fs::FileImplPtr file = std::make_shared<fs::FileImpl>();
+  file->fs = this;
+  file->path = path;
+  if (strcmp(path, "/") == 0)
+  {
+    file->directory = true;
+    file->entries = fs_list();
+    return File(file);
+  }
+
+  int flags;
+  if (mode[0] == 'r')
+    flags = mode[1] == '+' ? O_RDWR : O_RDONLY;
+  else if (mode[0] == 'w')
+    flags = (mode[1] == '+' ? O_RDWR : O_WRONLY) | O_CREAT | O_TRUNC;
+  else if (mode[0] == 'a')
+    flags = (mode[1] == '+' ? O_RDWR : O_WRONLY) | O_CREAT | O_APPEND;
+  else
+    return File();
+  char host_path[256];
+  fs_host_path(host_path, sizeof(host_path), path);
+  file->fd = ::open(host_path, flags, 0644);
+  if (file->fd < 0)
+    return File();
+  file->writable = (flags & O_ACCMODE) != O_RDONLY;
+  return File(file);
+}
+
+bool FS::exists(const char *path)
+{
+  char host_path[256];
+  struct stat st;
+  fs_host_path(host_path, sizeof(host_path), path);
+  return mounted && stat(host_path, &st) == 0;
+}
+
+bool FS::remove(const char *path)
+{
+  char host_path[256];
+  fs_host_path(host_path, sizeof(host_path), path);
+  return mounted && unlink(host_path) == 0;
+}
+
+bool FS::rename(const char *pathFrom, const char *pathTo)
+{
+  char from[256], to[256];
+  fs_host_path(from, sizeof(from), pathFrom);
+  fs_host_path(to, sizeof(to), pathTo);
+  return mounted && ::rename(from, to) == 0;
+}
+
+fs::FS LittleFS("littlefs");
+fs::FS SPIFFS("spiffs");
+
+/*
+ * Raw partitions of min_spiffs.csv, the table of the shipping environments, or of frames_partition.csv for the
+ * framebuffer cache; each a file in flash/ mapped into memory
+ */
+
+static const esp_partition_t partitions[] = {
+    {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_NVS, 0x9000, 0x5000, "nvs", false},
+    {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_OTA, 0xe000, 0x2000, "otadata", false},
+#ifdef IMAGE_CACHE_FRAMEBUFFERS
+    {ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, 0x10000, 0x1B0000, "app0", false},
+    {ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, 0x1C0000, 0x1B0000, "app1", false},
+    {ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x370000, 0x60000, "frames", false},
+#else
+    {ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, 0x10000, 0x1E0000, "app0", false},
+    {ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, 0x1F0000, 0x1E0000, "app1", false},
+#endif
+    {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, 0x3D0000, 0x20000, "spiffs", false},
+    {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_COREDUMP, 0x3F0000, 0x10000, "coredump", false},
+};
+
+#define SIM_PARTITIONS (sizeof(partitions) / sizeof(partitions[0]))
+
+static uint8_t *partition_data[SIM_PARTITIONS];
+
+/** Contents of a partition, erased flash the first time */
+static uint8_t *partition_map(const esp_partition_t *partition)
+{
+  size_t index = partition - partitions;
+  if (index >= SIM_PARTITIONS)
+    return nullptr;
+  if (partition_data[index])
+    return partition_data[index];
+
+  char path[256];
+  sim_device_path(path, sizeof(path), "flash/%s.bin", partition->label);
+  int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0)
+    return nullptr;
+  struct stat st;
+  fstat(fd, &st);
+  size_t existing = (size_t)st.st_size < partition->size ? st.st_size : partition->size;
+  if (existing < partition->size && ftruncate(fd, partition->size) != 0)
+  {
+    ::close(fd);
+    return nullptr;
+  }
+  void *data = mmap(nullptr, partition->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+    return nullptr;
+  // erased flash, without a heap buffer that would count against the device
+  memset((uint8_t *)data + existing, 0xFF, partition->size - existing);
+  partition_data[index] = (uint8_t *)data;
+  return partition_data[index];
+}
+
+extern "C"
+{
+  const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                   const char *label)
+  {
+    for (const esp_partition_t &partition : partitions)
+    {
+      if ((type == ESP_PARTITION_TYPE_ANY || partition.type == type) &&
+          (subtype == ESP_PARTITION_SUBTYPE_ANY || partition.subtype == subtype) &&
+          (!label || strcmp(partition.label, label) == 0))
+        return &partition;
+    }
+    return nullptr;
+  }
+
+  esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+  {
+    if (!partition || !dst)
+      return ESP_ERR_INVALID_ARG;
+    if (src_offset > partition->size || size > partition->size - src_offset)
+      return ESP_ERR_INVALID_SIZE;
+    uint8_t *data = partition_map(partition);
+    if (!data)
+      return ESP_FAIL;
+    memcpy(dst, data + src_offset, size);
+    return ESP_OK;
+  }
+
+  esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size)
+  {
+    if (!partition || !src)
+      return ESP_ERR_INVALID_ARG;
+    if (dst_offset > partition->size || size > partition->size - dst_offset)
+      return ESP_ERR_INVALID_SIZE;
+    uint8_t *data = partition_map(partition);
+    if (!data)
+      return ESP_FAIL;
+    // programming only clears bits, erasing sets them again
+    const uint8_t *bytes = (const uint8_t *)src;
+    for (size_t i = 0; i < size; i++)
+      data[dst_offset + i] &= bytes[i];
+    sim_metrics().partition_write_bytes += size;
+    sim_advance_us(program_us(size));
+    return ESP_OK;
+  }
+
+  esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size)
+  {
+    if (!partition)
+      return ESP_ERR_INVALID_ARG;
+    if (offset > partition->size || size > partition->size - offset)
+      return ESP_ERR_INVALID_SIZE;
+    if (offset % SPI_FLASH_SEC_SIZE || size % SPI_FLASH_SEC_SIZE)
+      return ESP_ERR_INVALID_SIZE;
+    uint8_t *data = partition_map(partition);
+    if (!data)
+      return ESP_FAIL;
+    memset(data + offset, 0xFF, size);
+    sim_metrics().erase_bytes += size;
+    sim_advance_us(size / SPI_FLASH_SEC_SIZE * (uint64_t)SIM_FLASH_SECTOR_ERASE_US);
+    return ESP_OK;
+  }
+
+  esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                               spi_flash_mmap_memory_t memory, const void **out_ptr,
+                               spi_flash_mmap_handle_t *out_handle)
+  {
+    if (!partition || !out_ptr || !out_handle)
+      return ESP_ERR_INVALID_ARG;
+    if (offset > partition->size || size > partition->size - offset)
+      return ESP_ERR_INVALID_SIZE;
+    uint8_t *data = partition_map(partition);
+    if (!data)
+      return ESP_ERR_NO_MEM;
+    *out_ptr = data + offset;
+    *out_handle = 1;
+    return ESP_OK;
+  }
+
+  void spi_flash_munmap(spi_flash_mmap_handle_t handle)
+  {
+  }
+}
+
+/* OTA: the firmware runs from app0, updates go to app1 */
+
+void sim_spiffs_file(const char *path, const void *data, size_t size)
+{
+  char host_path[256];
+  fs_host_path(host_path, sizeof(host_path), path);
+  int fd = ::open(host_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0 || !write_all(fd, data, size) || !fs_mark_formatted("spiffs"))
+  {
+    perror(host_path);
+    abort();
+  }
+  ::close(fd);
+}
+
+void sim_flash_app(const void *image, size_t size)
+{
+  // written as a file: the runner does not map partitions, a wake maps it and pads it with erased flash
+  char path[256];
+  sim_device_path(path, sizeof(path), "flash/app0.bin");
+  int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0 || !write_all(fd, image, size))
+  {
+    perror(path);
+    abort();
+  }
+  ::close(fd);
+}
+
+#define SIM_APP_IMAGE_MAGIC 0xE9
+
+extern "C"
+{
+  const esp_partition_t *esp_ota_get_running_partition(void)
+  {
+    return esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, nullptr);
+  }
+
+  const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start_from)
+  {
+    return esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, nullptr);
+  }
+
+  esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition)
+  {
+    if (!partition || partition->type != ESP_PARTITION_TYPE_APP)
+      return ESP_ERR_INVALID_ARG;
+    uint8_t magic;
+    if (esp_partition_read(partition, 0, &magic, 1) != ESP_OK || magic != SIM_APP_IMAGE_MAGIC)
+      return ESP_ERR_OTA_VALIDATE_FAILED;
+    sim_metrics().firmware_updated = true;
+    return ESP_OK;
+  }
+}
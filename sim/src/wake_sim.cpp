@@ -0,0 +1,525 @@
+#include <wake_sim.h>
+#include <epd_sim.h>
+#include <Preferences.h>
+#include <config.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "sim_internal.h"
+
+// the firmware's entry point, src/main.cpp
+void setup(void);
+
+#define SIM_DIR ".pio/wake_sim"
+#define SIM_FRAME_SIZE (EPD_SIM_WIDTH / 8 * EPD_SIM_HEIGHT)
+#define SIM_RTC_BUFFER (16 * 1024) // room for a build over SIM_RTC_SIZE, which only gets a warning
+#define SIM_WAKE_TIMEOUT_S 60
+
+// the RTC memory sections of RTC_DATA_ATTR and RTC_NOINIT_ATTR, from the linker; weak as either may be empty
+extern "C" uint8_t __start_rtc_sim_data[] __attribute__((weak));
+extern "C" uint8_t __stop_rtc_sim_data[] __attribute__((weak));
+extern "C" uint8_t __start_rtc_sim_noinit[] __attribute__((weak));
+extern "C" uint8_t __stop_rtc_sim_noinit[] __attribute__((weak));
+
+// the executable's static constructors, from the linker
+typedef void (*SimConstructor)(int, char **, char **);
+extern "C" SimConstructor __init_array_start[] __attribute__((weak, visibility("hidden")));
+extern "C" SimConstructor __init_array_end[] __attribute__((weak, visibility("hidden")));
+
+/** What the wakes hand over to each other and to the runner, in memory shared with their processes */
+struct SimShared
+{
+  SimRoute routes[SIM_ROUTES];
+  uint32_t route_count;
+  SimRequest log[SIM_REQUEST_LOG];
+  uint32_t log_count; // requests since sim_begin(), the log keeps the last SIM_REQUEST_LOG
+
+  uint8_t screen[SIM_FRAME_SIZE];
+  bool panel_asleep;
+  uint8_t rtc_data[SIM_RTC_BUFFER];
+  uint8_t rtc_noinit[SIM_RTC_BUFFER];
+  bool rtc_saved;
+  bool ntp_synced;
+  uint64_t elapsed_us; // since power on, when the wake starts
+  esp_reset_reason_t reboot_reason;
+  uint32_t wakes;
+  SimEnd last_end;
+
+  SimWake metrics;
+  uint64_t awake_us;
+  bool finished; // the wake ended through sim_end_wake()
+};
+
+static SimShared *shared = nullptr;
+static SimConfig config;
+static char device_dir[128];
+
+// state of the wake, in its own process
+static bool in_wake = false;
+static SimWakeCause wake_cause;
+static int64_t clock_us;        // may go below 0 when a task's SPI time is taken back
+static int64_t button_read_us;  // when the firmware first read the button, -1 before
+static uint64_t sleep_timer_us; // armed timer
+static uint64_t ntp_ready_us;   // when the NTP answer arrives
+static uint8_t signal_stack[64 * 1024];
+
+static size_t section_size(const uint8_t *start, const uint8_t *stop)
+{
+  return start && stop ? stop - start : 0;
+}
+
+uint64_t sim_now_us(void)
+{
+  return clock_us + epd_sim_stats().spi_us;
+}
+
+void sim_advance_us(uint64_t us)
+{
+  clock_us += us;
+  while (us)
+  {
+    uint32_t chunk = us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+    epd_sim_delay_us(chunk);
+    us -= chunk;
+  }
+}
+
+void sim_rewind_us(uint64_t us)
+{
+  clock_us -= us;
+}
+
+time_t sim_wall_time(void)
+{
+  if (!in_wake)
+  {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return now.tv_sec;
+  }
+  uint64_t now = sim_now_us();
+  if (!shared->ntp_synced && now >= ntp_ready_us)
+    shared->ntp_synced = true;
+  uint64_t seconds = (shared->elapsed_us + now) / 1000000;
+  return shared->ntp_synced ? config.epoch + seconds : seconds;
+}
+
+void sim_start_ntp(void)
+{
+  if (config.ntp_available && sim_wifi_connected() && ntp_ready_us == UINT64_MAX)
+    ntp_ready_us = sim_now_us() + config.latency_ms * 1000ULL;
+}
+
+const SimConfig &sim_cfg(void)
+{
+  return config;
+}
+
+SimWake &sim_metrics(void)
+{
+  return shared->metrics;
+}
+
+esp_sleep_wakeup_cause_t sim_wakeup_cause(void)
+{
+  switch (wake_cause)
+  {
+  case SIM_WAKE_TIMER:
+    return ESP_SLEEP_WAKEUP_TIMER;
+  case SIM_WAKE_BUTTON:
+  case SIM_WAKE_BUTTON_HOLD:
+  case SIM_WAKE_DOUBLE_CLICK:
+    return ESP_SLEEP_WAKEUP_GPIO;
+  default:
+    return ESP_SLEEP_WAKEUP_UNDEFINED;
+  }
+}
+
+bool sim_button_down(void)
+{
+  // released right after the press that woke the device; a double click presses it again 200 ms after the firmware
+  // first reads it, for 100 ms
+  if (wake_cause == SIM_WAKE_DOUBLE_CLICK)
+  {
+    if (button_read_us < 0)
+      button_read_us = clock_us;
+    return clock_us - button_read_us >= 200000 && clock_us - button_read_us < 300000;
+  }
+  return wake_cause == SIM_WAKE_BUTTON_HOLD;
+}
+
+esp_reset_reason_t sim_reset_reason(void)
+{
+  switch (wake_cause)
+  {
+  case SIM_WAKE_POWER_ON:
+    return ESP_RST_POWERON;
+  case SIM_WAKE_REBOOT:
+    return shared->reboot_reason;
+  default:
+    return ESP_RST_DEEPSLEEP;
+  }
+}
+
+void sim_set_sleep_timer(uint64_t us)
+{
+  sleep_timer_us = us;
+}
+
+void sim_end_wake(SimEnd end)
+{
+  SimWake &metrics = shared->metrics;
+  const EpdSimStats &stats = epd_sim_stats();
+  shared->awake_us = sim_now_us();
+  metrics.end = end;
+  metrics.sleep_us = end == SIM_END_SLEEP ? sleep_timer_us : 0;
+  metrics.awake_ms = shared->awake_us / 1000;
+  metrics.full_refreshes = stats.full_refreshes;
+  metrics.fast_refreshes = stats.fast_refreshes;
+  metrics.partial_refreshes = stats.partial_refreshes;
+  metrics.panel_resets = stats.resets;
+  metrics.panel_asleep = epd_sim_asleep();
+  metrics.peak_heap = sim_heap_peak();
+
+  memcpy(shared->screen, epd_sim_screen(), SIM_FRAME_SIZE);
+  shared->panel_asleep = epd_sim_asleep();
+  size_t data_size = section_size(__start_rtc_sim_data, __stop_rtc_sim_data);
+  size_t noinit_size = section_size(__start_rtc_sim_noinit, __stop_rtc_sim_noinit);
+  memcpy(shared->rtc_data, __start_rtc_sim_data, data_size);
+  memcpy(shared->rtc_noinit, __start_rtc_sim_noinit, noinit_size);
+  shared->rtc_saved = true;
+  if (end != SIM_END_CRASH)
+    shared->reboot_reason = ESP_RST_SW;
+  shared->finished = true;
+
+  fflush(stdout);
+  fflush(stderr);
+  _exit(0);
+}
+
+/** A signal is a panic on the device; the one-minute alarm stands for the task watchdog */
+static void on_crash(int signal)
+{
+  shared->reboot_reason = signal == SIGALRM ? ESP_RST_TASK_WDT : ESP_RST_PANIC;
+  fprintf(stderr, "\nwake_sim: %s\n", signal == SIGALRM ? "still awake after a minute" : strsignal(signal));
+  sim_end_wake(SIM_END_CRASH);
+}
+
+void sim_device_path(char *out, size_t size, const char *format, ...)
+{
+  int len = snprintf(out, size, "%s/", device_dir);
+  va_list args;
+  va_start(args, format);
+  vsnprintf(out + len, size - len, format, args);
+  va_end(args);
+}
+
+static SimRoute *find_route(const char *path)
+{
+  for (uint32_t i = 0; i < shared->route_count; i++)
+  {
+    if (strcmp(shared->routes[i].path, path) == 0)
+      return &shared->routes[i];
+  }
+  return nullptr;
+}
+
+SimRoute *sim_route(const char *path)
+{
+  SimRoute *route = find_route(path);
+  if (route || shared->route_count == SIM_ROUTES)
+    return route;
+  // unknown paths answer 404, and are counted like the others
+  route = &shared->routes[shared->route_count++];
+  memset(route, 0, sizeof(*route));
+  snprintf(route->path, sizeof(route->path), "%s", path);
+  route->status = 404;
+  return route;
+}
+
+SimRequest *sim_log_request(void)
+{
+  SimRequest *request = &shared->log[shared->log_count++ % SIM_REQUEST_LOG];
+  memset(request, 0, sizeof(*request));
+  return request;
+}
+
+static int remove_entry(const char *path, const struct stat *st, int type, struct FTW *ftw)
+{
+  return remove(path);
+}
+
+void sim_begin(const char *name)
+{
+  if (!shared)
+  {
+    void *memory = mmap(nullptr, sizeof(SimShared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+      perror("wake_sim: mmap");
+      abort();
+    }
+    shared = (SimShared *)memory;
+
+    size_t rtc_size = section_size(__start_rtc_sim_data, __stop_rtc_sim_data) +
+                      section_size(__start_rtc_sim_noinit, __stop_rtc_sim_noinit);
+    if (rtc_size > SIM_RTC_BUFFER)
+    {
+      fprintf(stderr, "wake_sim: %u bytes of RTC variables, the simulator keeps %u\n", (unsigned)rtc_size,
+              SIM_RTC_BUFFER);
+      abort();
+    }
+    if (rtc_size > SIM_RTC_SIZE)
+      fprintf(stderr, "wake_sim: warning: %u bytes of RTC variables do not fit the %u of the device\n",
+              (unsigned)rtc_size, SIM_RTC_SIZE);
+  }
+  for (uint32_t i = 0; i < shared->route_count; i++)
+    free((void *)shared->routes[i].body);
+  memset(shared, 0, sizeof(*shared));
+  memset(shared->screen, 0xFF, sizeof(shared->screen));
+  shared->panel_asleep = true;
+  shared->last_end = SIM_END_AWAKE;
+
+  config = SimConfig();
+  config.latency_ms = 60;
+  config.bandwidth = 250000;
+  config.tls_ms = 800;
+  config.wifi_connect_ms = 2000;
+  config.wifi_available = true;
+  config.portal_ssid = nullptr;
+  config.rssi = -60;
+  config.ntp_available = true;
+  config.epoch = 1767225600; // 2026-01-01
+  config.battery_mv = 4000;
+  config.temperature = 22;
+
+  snprintf(device_dir, sizeof(device_dir), SIM_DIR "/%s", name);
+  nftw(device_dir, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+  mkdir(".pio", 0755);
+  mkdir(SIM_DIR, 0755);
+  const char *dirs[] = {"", "nvs", "fs", "flash"};
+  for (const char *dir : dirs)
+  {
+    char path[256];
+    sim_device_path(path, sizeof(path), "%s", dir);
+    if (mkdir(path, 0755) != 0 && errno != EEXIST)
+    {
+      perror(path);
+      abort();
+    }
+  }
+}
+
+SimConfig &sim_config(void)
+{
+  return config;
+}
+
+void sim_provision(const char *ssid, const char *api_key, const char *friendly_id)
+{
+  Preferences wifi;
+  wifi.begin("wificaptive", false);
+  wifi.putString("wifi_0_ssid", ssid);
+  wifi.putString("wifi_0_pswd", "");
+  wifi.putInt("wifi_last_index", 0);
+  wifi.end();
+
+  if (!api_key)
+    return;
+  Preferences data;
+  data.begin("data", false);
+  data.putString(PREFERENCES_API_KEY, api_key);
+  data.putString(PREFERENCES_FRIENDLY_ID, friendly_id);
+  data.end();
+}
+
+/**
+ * The runner constructed the globals before any RTC memory was there; a boot
+ * constructs them with it, and some read it (WakeStateStore), so run the
+ * constructors again over the parent's copies.
+ */
+static void run_constructors(void)
+{
+  if (!__init_array_start || !__init_array_end)
+    return;
+  for (SimConstructor *constructor = __init_array_start; constructor < __init_array_end; constructor++)
+    (*constructor)(0, nullptr, environ);
+}
+
+static void run_wake(SimWakeCause cause, uint32_t number) __attribute__((noreturn));
+
+static void run_wake(SimWakeCause cause, uint32_t number)
+{
+  in_wake = true;
+  wake_cause = cause;
+
+  stack_t stack = {};
+  stack.ss_sp = signal_stack;
+  stack.ss_size = sizeof(signal_stack);
+  sigaltstack(&stack, nullptr);
+  struct sigaction action = {};
+  action.sa_handler = on_crash;
+  action.sa_flags = SA_ONSTACK | SA_RESETHAND;
+  sigemptyset(&action.sa_mask);
+  const int signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGALRM};
+  for (int signal : signals)
+    sigaction(signal, &action, nullptr);
+  alarm(SIM_WAKE_TIMEOUT_S);
+
+  char path[256];
+  sim_device_path(path, sizeof(path), "wake-%u.log", (unsigned)number);
+  int log = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (log >= 0)
+  {
+    dup2(log, STDOUT_FILENO);
+    dup2(log, STDERR_FILENO);
+    close(log);
+  }
+
+  // RTC_DATA_ATTR survives deep sleep only, RTC_NOINIT_ATTR every reset but a power cycle
+  if (shared->rtc_saved && (cause == SIM_WAKE_TIMER || cause == SIM_WAKE_BUTTON || cause == SIM_WAKE_BUTTON_HOLD ||
+                           cause == SIM_WAKE_DOUBLE_CLICK))
+    memcpy(__start_rtc_sim_data, shared->rtc_data, section_size(__start_rtc_sim_data, __stop_rtc_sim_data));
+  if (shared->rtc_saved && cause != SIM_WAKE_POWER_ON)
+    memcpy(__start_rtc_sim_noinit, shared->rtc_noinit, section_size(__start_rtc_sim_noinit, __stop_rtc_sim_noinit));
+
+  clock_us = 0;
+  button_read_us = -1;
+  sleep_timer_us = 0;
+  ntp_ready_us = UINT64_MAX;
+  // the image stays on the panel without power, the controller does not
+  epd_sim_resume(shared->screen, shared->panel_asleep || cause == SIM_WAKE_POWER_ON);
+  sim_heap_begin();
+  run_constructors();
+
+  setup();
+  sim_end_wake(SIM_END_AWAKE);
+}
+
+SimWake sim_wake(SimWakeCause cause)
+{
+  if (!shared)
+  {
+    fprintf(stderr, "wake_sim: sim_begin() first\n");
+    abort();
+  }
+  uint32_t number = ++shared->wakes;
+  if (cause == SIM_WAKE_POWER_ON)
+  {
+    shared->elapsed_us = 0;
+    shared->ntp_synced = false;
+  }
+  memset(&shared->metrics, 0, sizeof(shared->metrics));
+  shared->awake_us = 0;
+  shared->finished = false;
+
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = fork();
+  if (pid < 0)
+  {
+    perror("wake_sim: fork");
+    abort();
+  }
+  if (pid == 0)
+    run_wake(cause, number);
+
+  int status;
+  while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+    ;
+  if (!shared->finished)
+  {
+    // killed before it could record anything
+    shared->metrics.end = SIM_END_CRASH;
+    shared->reboot_reason = ESP_RST_PANIC;
+  }
+  SimWake wake = shared->metrics;
+  shared->last_end = wake.end;
+  shared->elapsed_us += shared->awake_us + wake.sleep_us;
+
+  char path[256];
+  sim_device_path(path, sizeof(path), "wake-%u.png", (unsigned)number);
+  epd_sim_resume(shared->screen, shared->panel_asleep);
+  epd_sim_write_png(path);
+  return wake;
+}
+
+SimWake sim_wake_next(void)
+{
+  switch (shared ? shared->last_end : SIM_END_AWAKE)
+  {
+  case SIM_END_SLEEP:
+    return sim_wake(SIM_WAKE_TIMER);
+  case SIM_END_RESTART:
+  case SIM_END_CRASH:
+    return sim_wake(SIM_WAKE_REBOOT);
+  default:
+    return sim_wake(SIM_WAKE_POWER_ON);
+  }
+}
+
+const uint8_t *sim_screen(void)
+{
+  return shared->screen;
+}
+
+void sim_server_route(const char *path, int status, const char *content_type, const void *body, size_t size)
+{
+  SimRoute *route = sim_route(path);
+  if (!route)
+  {
+    fprintf(stderr, "wake_sim: more than %d routes\n", SIM_ROUTES);
+    abort();
+  }
+  free((void *)route->body);
+  uint8_t *copy = nullptr;
+  if (size)
+  {
+    copy = (uint8_t *)malloc(size);
+    memcpy(copy, body, size);
+  }
+  route->status = status;
+  snprintf(route->content_type, sizeof(route->content_type), "%s", content_type);
+  route->body = copy;
+  route->size = size;
+}
+
+void sim_server_json(const char *path, const char *json)
+{
+  sim_server_route(path, 200, "application/json", json, strlen(json));
+}
+
+void sim_server_fail(const char *path, SimFailure failure, uint32_t count)
+{
+  SimRoute *route = sim_route(path);
+  if (!route)
+  {
+    fprintf(stderr, "wake_sim: more than %d routes\n", SIM_ROUTES);
+    abort();
+  }
+  route->failure = failure;
+  route->failures = count;
+}
+
+uint32_t sim_server_count(const char *path)
+{
+  SimRoute *route = find_route(path);
+  return route ? route->count : 0;
+}
+
+const SimRequest *sim_server_last(const char *path)
+{
+  uint32_t kept = shared->log_count < SIM_REQUEST_LOG ? shared->log_count : SIM_REQUEST_LOG;
+  for (uint32_t i = 1; i <= kept; i++)
+  {
+    const SimRequest *request = &shared->log[(shared->log_count - i) % SIM_REQUEST_LOG];
+    if (strcmp(request->path, path) == 0)
+      return request;
+  }
+  return nullptr;
+}
@@ -0,0 +1,114 @@
+#include <WifiCaptive.h>
+#include <Preferences.h>
+#include "sim_internal.h"
+
+WifiCaptive WifiCaptivePortal;
+
+#define WIFI_SSID_KEY(i) ("wifi_" + String(i) + "_ssid").c_str()
+#define WIFI_PSWD_KEY(i) ("wifi_" + String(i) + "_pswd").c_str()
+#define WIFI_LAST_INDEX "wifi_last_index"
+
+/** Joins a network and waits for the result like lib/wificaptive: the full timeout unless connected */
+static bool connect(const String &ssid)
+{
+  if (ssid == "")
+    return false;
+  WiFi.begin(ssid.c_str());
+  unsigned long timeout = millis() + CONNECTION_TIMEOUT;
+  while (millis() < timeout)
+  {
+    if (WiFi.status() == WL_CONNECTED)
+      return true;
+    delay(100);
+  }
+  return WiFi.status() == WL_CONNECTED;
+}
+
+static bool connectWithRetries(const String &ssid)
+{
+  for (int attempt = 0; attempt < WIFI_CONNECTION_ATTEMPTS; attempt++)
+  {
+    if (connect(ssid))
+      return true;
+    WiFi.disconnect();
+    if (attempt < WIFI_CONNECTION_ATTEMPTS - 1)
+      delay(2000 * (1 << attempt));
+  }
+  return false;
+}
+
+bool WifiCaptive::startPortal()
+{
+  const char *ssid = sim_cfg().portal_ssid;
+  if (!ssid)
+    sim_end_wake(SIM_END_AWAKE);
+
+  Preferences preferences;
+  preferences.begin("wificaptive", false);
+  String saved[WIFI_MAX_SAVED_CREDS];
+  for (int i = 0; i < WIFI_MAX_SAVED_CREDS; i++)
+    saved[i] = preferences.getString(WIFI_SSID_KEY(i), "");
+  // the new network goes first
+  preferences.putString(WIFI_SSID_KEY(0), ssid);
+  preferences.putString(WIFI_PSWD_KEY(0), "");
+  for (int i = 1; i < WIFI_MAX_SAVED_CREDS; i++)
+    preferences.putString(WIFI_SSID_KEY(i), saved[i - 1]);
+  preferences.putInt(WIFI_LAST_INDEX, 0);
+  preferences.end();
+
+  return connect(ssid);
+}
+
+bool WifiCaptive::isSaved()
+{
+  Preferences preferences;
+  preferences.begin("wificaptive", true);
+  return preferences.getString(WIFI_SSID_KEY(0), "") != "";
+}
+
+void WifiCaptive::resetSettings()
+{
+  Preferences preferences;
+  preferences.begin("wificaptive", false);
+  preferences.remove("api_url");
+  preferences.remove(WIFI_LAST_INDEX);
+  for (int i = 0; i < WIFI_MAX_SAVED_CREDS; i++)
+  {
+    preferences.remove(WIFI_SSID_KEY(i));
+    preferences.remove(WIFI_PSWD_KEY(i));
+  }
+  preferences.end();
+  WiFi.disconnect(true, true);
+}
+
+bool WifiCaptive::autoConnect()
+{
+  Preferences preferences;
+  preferences.begin("wificaptive", true);
+  String saved[WIFI_MAX_SAVED_CREDS];
+  for (int i = 0; i < WIFI_MAX_SAVED_CREDS; i++)
+    saved[i] = preferences.getString(WIFI_SSID_KEY(i), "");
+  int last = preferences.getInt(WIFI_LAST_INDEX, 0);
+  preferences.end();
+  if (last < 0 || last >= WIFI_MAX_SAVED_CREDS || saved[last] == "")
+    last = 0;
+
+  WiFi.mode(WIFI_STA);
+  if (connectWithRetries(saved[last]))
+    return true;
+
+  // no scan: every saved network is tried in order
+  for (int i = 0; i < WIFI_MAX_SAVED_CREDS; i++)
+  {
+    if (i == last || saved[i] == "")
+      continue;
+    if (connectWithRetries(saved[i]))
+    {
+      Preferences update;
+      update.begin("wificaptive", false);
+      update.putInt(WIFI_LAST_INDEX, i);
+      return true;
+    }
+  }
+  return false;
+}
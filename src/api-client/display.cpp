@@ -22,7 +22,7 @@ void addHeaders(HTTPClient &https, ApiDisplayInputs &inputs)
            String(inputs.refreshRate).c_str(),
            String(inputs.batteryVoltage).c_str(),
            inputs.firmwareVersion.c_str(),
-           String(inputs.rssi));
+           String(inputs.rssi).c_str());
 
   https.addHeader("ID", inputs.macAddress);
   https.addHeader("Access-Token", inputs.apiKey);
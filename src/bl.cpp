@@ -16,7 +16,6 @@
 #include <cstdint>
 #include <png_file.h>
 #include <bmp.h>
-#include <Update.h>
 #include <math.h>
 #include <filesystem.h>
 #include "trmnl_log.h"
@@ -26,12 +25,18 @@
 #include <special_function.h>
 #include <api_response_parsing.h>
 #include "logging_parcers.h"
-#include <SPIFFS.h>
 #include "http_client.h"
 #include <api-client/display.h>
 #include "driver/gpio.h"
 #include <nvs.h>
 #include <serialize_log.h>
+#include <flight_recorder.h>
+#include <heap_trace.h>
+#include <settings.h>
+#include <image_store.h>
+#include <flash_store.h>
+#include <ota_update.h>
+#include <sleep_schedule.h>
 
 bool pref_clear = false;
 String new_filename = "";
@@ -40,6 +45,8 @@ uint8_t *buffer = nullptr;
 uint8_t *decodedPng = nullptr;
 char filename[1024];      // image URL
 char binUrl[1024];        // update URL
+String binSha256 = "";    // expected SHA-256 of the update, hex
+String binPatchUrl = "";  // patch from the running firmware to the update, if the server has one
 char message_buffer[128]; // message to show on the screen
 uint32_t time_since_sleep;
 image_err_e png_res = PNG_DECODE_ERR;
@@ -55,15 +62,37 @@ esp_sleep_wakeup_cause_t wakeup_reason = ESP_SLEEP_WAKEUP_UNDEFINED; // wake-up
 MSG current_msg = NONE;
 SPECIAL_FUNCTION special_function = SF_NONE;
 RTC_DATA_ATTR uint8_t need_to_refresh_display = 1;
+RTC_DATA_ATTR static ScheduleState schedule_state; // how often the image changes, see sleep_schedule.h
+bool schedule_sleep_time = false; // the image was polled: the sleep may be longer than the refresh rate
+uint16_t quiet_start = 0;         // quiet hours from the server, minutes after midnight UTC
+uint16_t quiet_end = 0;
+String framebufferName = ""; // image whose framebuffer goes to the image cache when it is shown
+String shownName = "";       // image on the panel when the wake began, which the logo replaces
+RTC_NOINIT_ATTR FlightRecord flight_record; // survives panics and watchdog resets, validated in bl_init
+
+#ifdef HEAP_TRACE
+static size_t heapTraceFreeSize(void) { return heap_caps_get_free_size(MALLOC_CAP_8BIT); }
+static size_t heapTraceLargestFreeBlock(void) { return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT); }
+static uint32_t heapTraceNow(void) { return millis(); }
+
+static const HeapTraceAllocator esp_heap_trace_allocator = {
+    malloc,
+    free,
+    heapTraceFreeSize,
+    heapTraceLargestFreeBlock,
+    heapTraceNow,
+};
+#endif
 
 Preferences preferences;
 
 static https_request_err_e downloadAndShow(); // download and show the image
 static uint32_t downloadStream(WiFiClient *stream, int content_size, uint8_t *buffer);
+static https_request_err_e showNewImage(uint32_t content_size, bool isPNG, const String &image_name, https_request_err_e &result, bool cached = false);
 static https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse);
 static void getDeviceCredentials();                  // receiveing API key and Friendly ID
 static void resetDeviceCredentials(void);            // reset device credentials API key, Friendly ID, Wi-Fi SSID and password
-static void checkAndPerformFirmwareUpdate(void);     // OTA update
+static bool checkAndPerformFirmwareUpdate(void);     // OTA update
 static void goToSleep(void);                         // sleep preparing
 static bool setClock(void);                          // clock synchronization
 static float readBatteryVoltage(void);               // battery voltage reading
@@ -79,7 +108,13 @@ static void wifiErrorDeepSleep();
 static uint8_t *storedLogoOrDefault(void);
 static bool saveCurrentFileName(String &name);
 static bool checkCurrentFileName(String &newName);
+static void cacheFramebuffer(const uint8_t *framebuffer, size_t size);
 static DeviceStatusStamp getDeviceStatusStamp();
+static void flightPhase(FlightPhase phase);
+static void flightRecorderLog(const LogRingRecord &record);
+#ifdef HEAP_TRACE
+static void heapTraceLine(const char *line);
+#endif
 void submitLog(const char *format, time_t time, int line, const char *file, ...);
 void log_nvs_usage();
 
@@ -105,8 +140,17 @@ void bl_init(void)
 {
 
   Serial.begin(115200);
-  Log.begin(LOG_LEVEL_VERBOSE, &Serial);
+  Log.begin(LOG_MIN_LEVEL, &Serial);
   Log_info("BL init success");
+
+  if (flight_recorder_boot(flight_record, esp_reset_reason(), ESP.getFreeHeap(), ESP.getMaxAllocHeap()))
+  {
+    Log_warning("Previous wake ended abnormally: %s", flight_record.report);
+  }
+  log_ring_set_observer(flightRecorderLog);
+#ifdef HEAP_TRACE
+  heap_trace_begin(&esp_heap_trace_allocator);
+#endif
   pins_init();
 
 #if defined(BOARD_SEEED_XIAO_ESP32C3) || defined(BOARD_SEEED_XIAO_ESP32S3)
@@ -167,47 +211,48 @@ void bl_init(void)
     Log_fatal("preferences init failed");
     ESP.restart();
   }
+  settings_init(preferences);
   Log_info("preferences end");
 
   if (double_click)
   { // special function reading
-    if (preferences.isKey(PREFERENCES_SF_KEY))
+    if (settings.isKey(PREFERENCES_SF_KEY))
     {
-      Log.info("%s [%d]: SF saved. Reading...\r\n", __FILE__, __LINE__);
-      special_function = (SPECIAL_FUNCTION)preferences.getUInt(PREFERENCES_SF_KEY, 0);
-      Log.info("%s [%d]: Read special function - %d\r\n", __FILE__, __LINE__, special_function);
+      Log_info("SF saved. Reading...");
+      special_function = (SPECIAL_FUNCTION)settings.getUInt(PREFERENCES_SF_KEY, 0);
+      Log_info("Read special function - %d", special_function);
       switch (special_function)
       {
       case SF_IDENTIFY:
       {
-        Log.info("%s [%d]: Identify special function...It will be handled while API ping...\r\n", __FILE__, __LINE__);
+        Log_info("Identify special function...It will be handled while API ping...");
       }
       break;
       case SF_SLEEP:
       {
-        Log.info("%s [%d]: Sleep special function...\r\n", __FILE__, __LINE__);
+        Log_info("Sleep special function...");
         // still in progress
       }
       break;
       case SF_ADD_WIFI:
       {
-        Log.info("%s [%d]: Add WiFi function...\r\n", __FILE__, __LINE__);
+        Log_info("Add WiFi function...");
         WifiCaptivePortal.startPortal();
       }
       break;
       case SF_RESTART_PLAYLIST:
       {
-        Log.info("%s [%d]: Identify special function...It will be handled while API ping...\r\n", __FILE__, __LINE__);
+        Log_info("Identify special function...It will be handled while API ping...");
       }
       break;
       case SF_REWIND:
       {
-        Log.info("%s [%d]: Rewind special function...\r\n", __FILE__, __LINE__);
+        Log_info("Rewind special function...");
       }
       break;
       case SF_SEND_TO_ME:
       {
-        Log.info("%s [%d]: Send to me special function...It will be handled while API ping...\r\n", __FILE__, __LINE__);
+        Log_info("Send to me special function...It will be handled while API ping...");
       }
       break;
       default:
@@ -219,54 +264,58 @@ void bl_init(void)
       Log_error("SF not saved");
     }
   }
-  // EPD init
-  // EPD clear
-  Log.info("%s [%d]: Display init\r\n", __FILE__, __LINE__);
+  // the panel itself is only initialized when something is drawn
+  Log_info("Display init");
   display_init();
+  flash_store_init();
 
   if (wakeup_reason != ESP_SLEEP_WAKEUP_TIMER)
   {
-    Log.info("%s [%d]: Display TRMNL logo start\r\n", __FILE__, __LINE__);
+    Log_info("Display TRMNL logo start");
 
-    buffer = (uint8_t *)malloc(DEFAULT_IMAGE_SIZE);
+    flightPhase(FLIGHT_PHASE_LOGO);
     display_show_image(storedLogoOrDefault(), false, false);
-    free(buffer);
+    heap_trace_free(buffer);
     buffer = nullptr;
 
     need_to_refresh_display = 1;
-    preferences.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
-    Log.info("%s [%d]: Display TRMNL logo end\r\n", __FILE__, __LINE__);
-    preferences.putString(PREFERENCES_FILENAME_KEY, "");
+    settings.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
+    Log_info("Display TRMNL logo end");
+    shownName = settings.getString(PREFERENCES_FILENAME_KEY, "");
+    settings.putString(PREFERENCES_FILENAME_KEY, "");
   }
 
-  // Mount SPIFFS
+  // Mount the filesystem
+  flightPhase(FLIGHT_PHASE_FILESYSTEM);
   filesystem_init();
+  image_store_init();
+  display_set_framebuffer_observer(cacheFramebuffer);
 
   Log_info("Firmware version %d.%d.%d", FW_MAJOR_VERSION, FW_MINOR_VERSION, FW_PATCH_VERSION);
   Log_info("Arduino version %d.%d.%d", ESP_ARDUINO_VERSION_MAJOR, ESP_ARDUINO_VERSION_MINOR, ESP_ARDUINO_VERSION_PATCH);
   Log_info("ESP-IDF version %d.%d.%d", ESP_IDF_VERSION_MAJOR, ESP_IDF_VERSION_MINOR, ESP_IDF_VERSION_PATCH);
-  list_files();
   log_nvs_usage();
 
+  flightPhase(FLIGHT_PHASE_WIFI);
   WiFi.mode(WIFI_STA); // explicitly set mode, esp defaults to STA+AP
   if (WifiCaptivePortal.isSaved())
   {
     // WiFi saved, connection
-    Log.info("%s [%d]: WiFi saved\r\n", __FILE__, __LINE__);
+    Log_info("WiFi saved");
     int connection_res = WifiCaptivePortal.autoConnect();
 
-    Log.info("%s [%d]: Connection result: %d, WiFI Status: %d\r\n", __FILE__, __LINE__, connection_res, WiFi.status());
+    Log_info("Connection result: %d, WiFI Status: %d", connection_res, WiFi.status());
 
     // Check if connected
     if (connection_res)
     {
       String ip = String(WiFi.localIP());
-      Log.info("%s [%d]:wifi_connection [DEBUG]: Connected: %s\r\n", __FILE__, __LINE__, ip.c_str());
-      preferences.putInt(PREFERENCES_CONNECT_WIFI_RETRY_COUNT, 1);
+      Log_info("wifi_connection [DEBUG]: Connected: %s", ip.c_str());
+      settings.putInt(PREFERENCES_CONNECT_WIFI_RETRY_COUNT, 1);
     }
     else
     {
-      Log.fatal("%s [%d]: Connection failed! WL Status: %d\r\n", __FILE__, __LINE__, WiFi.status());
+      Log_fatal("Connection failed! WL Status: %d", WiFi.status());
 
       if (current_msg != WIFI_FAILED)
       {
@@ -283,7 +332,7 @@ void bl_init(void)
   else
   {
     // WiFi credentials are not saved - start captive portal
-    Log.info("%s [%d]: WiFi NOT saved\r\n", __FILE__, __LINE__);
+    Log_info("WiFi NOT saved");
 
     char fw_version[20];
 
@@ -291,14 +340,14 @@ void bl_init(void)
 
     String fw = fw_version;
 
-    Log.info("%s [%d]: FW version %s\r\n", __FILE__, __LINE__, fw_version);
+    Log_info("FW version %s", fw_version);
 
     showMessageWithLogo(WIFI_CONNECT, "", false, fw.c_str(), "");
     WifiCaptivePortal.setResetSettingsCallback(resetDeviceCredentials);
     res = WifiCaptivePortal.startPortal();
     if (!res)
     {
-      Log.error("%s [%d]: Failed to connect or hit timeout\r\n", __FILE__, __LINE__);
+      Log_error("Failed to connect or hit timeout");
 
       WiFi.disconnect(true);
 
@@ -309,94 +358,99 @@ void bl_init(void)
       // Go to deep sleep
       wifiErrorDeepSleep();
     }
-    Log.info("%s [%d]: WiFi connected\r\n", __FILE__, __LINE__);
-    preferences.putInt(PREFERENCES_CONNECT_WIFI_RETRY_COUNT, 1);
+    Log_info("WiFi connected");
+    settings.putInt(PREFERENCES_CONNECT_WIFI_RETRY_COUNT, 1);
   }
 
   // clock synchronization
   if (setClock())
   {
-    time_since_sleep = preferences.getUInt(PREFERENCES_LAST_SLEEP_TIME, 0);
+    time_since_sleep = settings.getUInt(PREFERENCES_LAST_SLEEP_TIME, 0);
     time_since_sleep = time_since_sleep ? getTime() - time_since_sleep : 0; // may be can be used even if no sync
   }
   else
   {
     time_since_sleep = 0;
-    Log.info("%s [%d]: Time wasn't synced.\r\n", __FILE__, __LINE__);
+    Log_info("Time wasn't synced.");
   }
 
-  Log.info("%s [%d]: Time since last sleep: %d\r\n", __FILE__, __LINE__, time_since_sleep);
+  Log_info("Time since last sleep: %d", time_since_sleep);
 
-  if (!preferences.isKey(PREFERENCES_API_KEY) || !preferences.isKey(PREFERENCES_FRIENDLY_ID))
+  if (!settings.isKey(PREFERENCES_API_KEY) || !settings.isKey(PREFERENCES_FRIENDLY_ID))
   {
-    Log.info("%s [%d]: API key or friendly ID not saved\r\n", __FILE__, __LINE__);
+    Log_info("API key or friendly ID not saved");
     // lets get the api key and friendly ID
     getDeviceCredentials();
   }
   else
   {
-    Log.info("%s [%d]: API key and friendly ID saved\r\n", __FILE__, __LINE__);
+    Log_info("API key and friendly ID saved");
   }
 
+  // a wake that crashed or hung leaves a report; send it even if this wake goes well
+  if (flight_record.report_length > 0)
+    submit_log("previous wake ended abnormally");
+
   log_retry = true;
 
   // OTA checking, image checking and drawing
   https_request_err_e request_result = downloadAndShow();
-  Log.info("%s [%d]: request result - %d\r\n", __FILE__, __LINE__, request_result);
+  Log_info("request result - %d", request_result);
 
-  if (!preferences.isKey(PREFERENCES_CONNECT_API_RETRY_COUNT))
+  if (!settings.isKey(PREFERENCES_CONNECT_API_RETRY_COUNT))
   {
-    preferences.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, 1);
+    settings.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, 1);
   }
 
   if (request_result != HTTPS_SUCCESS && request_result != HTTPS_NO_ERR && request_result != HTTPS_NO_REGISTER && request_result != HTTPS_RESET && request_result != HTTPS_PLUGIN_NOT_ATTACHED)
   {
-    uint8_t retries = preferences.getInt(PREFERENCES_CONNECT_API_RETRY_COUNT);
+    schedule_sleep_time = false; // retry delays are kept as they are
+    uint8_t retries = settings.getInt(PREFERENCES_CONNECT_API_RETRY_COUNT);
 
     switch (retries)
     {
     case 1:
-      Log.info("%s [%d]: retry: %d - time to sleep: %d\r\n", __FILE__, __LINE__, retries, API_CONNECT_RETRY_TIME::API_FIRST_RETRY);
-      res = preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, API_CONNECT_RETRY_TIME::API_FIRST_RETRY);
-      preferences.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, ++retries);
+      Log_info("retry: %d - time to sleep: %d", retries, API_CONNECT_RETRY_TIME::API_FIRST_RETRY);
+      res = settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, API_CONNECT_RETRY_TIME::API_FIRST_RETRY);
+      settings.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, ++retries);
       display_sleep();
       goToSleep();
       break;
 
     case 2:
-      Log.info("%s [%d]: retry:%d - time to sleep: %d\r\n", __FILE__, __LINE__, retries, API_CONNECT_RETRY_TIME::API_SECOND_RETRY);
-      res = preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, API_CONNECT_RETRY_TIME::API_SECOND_RETRY);
-      preferences.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, ++retries);
+      Log_info("retry:%d - time to sleep: %d", retries, API_CONNECT_RETRY_TIME::API_SECOND_RETRY);
+      res = settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, API_CONNECT_RETRY_TIME::API_SECOND_RETRY);
+      settings.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, ++retries);
       display_sleep();
       goToSleep();
       break;
 
     case 3:
-      Log.info("%s [%d]: retry:%d - time to sleep: %d\r\n", __FILE__, __LINE__, retries, API_CONNECT_RETRY_TIME::API_THIRD_RETRY);
-      res = preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, API_CONNECT_RETRY_TIME::API_THIRD_RETRY);
-      preferences.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, ++retries);
+      Log_info("retry:%d - time to sleep: %d", retries, API_CONNECT_RETRY_TIME::API_THIRD_RETRY);
+      res = settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, API_CONNECT_RETRY_TIME::API_THIRD_RETRY);
+      settings.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, ++retries);
       display_sleep();
       goToSleep();
       break;
 
     default:
-      Log.info("%s [%d]: Max retries done. Time to sleep: %d\r\n", __FILE__, __LINE__, SLEEP_TIME_TO_SLEEP);
-      preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP);
-      preferences.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, ++retries);
+      Log_info("Max retries done. Time to sleep: %d", SLEEP_TIME_TO_SLEEP);
+      settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP);
+      settings.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, ++retries);
       break;
     }
   }
 
   else
   {
-    Log.info("%s [%d]: Connection done successfully. Retries counter reset.\r\n", __FILE__, __LINE__);
-    preferences.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, 1);
+    Log_info("Connection done successfully. Retries counter reset.");
+    settings.putInt(PREFERENCES_CONNECT_API_RETRY_COUNT, 1);
   }
 
   if (request_result == HTTPS_NO_REGISTER && need_to_refresh_display == 1)
   {
     // show the image
-    String friendly_id = preferences.getString(PREFERENCES_FRIENDLY_ID, PREFERENCES_FRIENDLY_ID_DEFAULT);
+    String friendly_id = settings.getString(PREFERENCES_FRIENDLY_ID, PREFERENCES_FRIENDLY_ID_DEFAULT);
     showMessageWithLogo(FRIENDLY_ID, friendly_id, true, "", String(message_buffer));
     need_to_refresh_display = 0;
   }
@@ -404,14 +458,15 @@ void bl_init(void)
   // reset checking
   if (request_result == HTTPS_RESET)
   {
-    Log.info("%s [%d]: Device reseting...\r\n", __FILE__, __LINE__);
+    Log_info("Device reseting...");
     resetDeviceCredentials();
   }
 
   // OTA update checking
   if (update_firmware)
   {
-    checkAndPerformFirmwareUpdate();
+    flightPhase(FLIGHT_PHASE_FIRMWARE_UPDATE);
+    update_firmware = checkAndPerformFirmwareUpdate(); // restart only into a complete image
   }
 
   // error handling
@@ -470,11 +525,11 @@ void bl_init(void)
   break;
   case HTTPS_PLUGIN_NOT_ATTACHED:
   {
-    if (preferences.getInt(PREFERENCES_SLEEP_TIME_KEY, 0) != SLEEP_TIME_WHILE_PLUGIN_NOT_ATTACHED)
+    if (settings.getInt(PREFERENCES_SLEEP_TIME_KEY, 0) != SLEEP_TIME_WHILE_PLUGIN_NOT_ATTACHED)
     {
-      Log.info("%s [%d]: write new refresh rate: %d\r\n", __FILE__, __LINE__, SLEEP_TIME_WHILE_PLUGIN_NOT_ATTACHED);
-      preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_WHILE_PLUGIN_NOT_ATTACHED);
-      Log.info("%s [%d]: written new refresh rate: %d\r\n", __FILE__, __LINE__, SLEEP_TIME_WHILE_PLUGIN_NOT_ATTACHED);
+      Log_info("write new refresh rate: %d", SLEEP_TIME_WHILE_PLUGIN_NOT_ATTACHED);
+      settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_WHILE_PLUGIN_NOT_ATTACHED);
+      Log_info("written new refresh rate: %d", SLEEP_TIME_WHILE_PLUGIN_NOT_ATTACHED);
     }
   }
   break;
@@ -484,6 +539,7 @@ void bl_init(void)
 
   if (request_result != HTTPS_NO_ERR && request_result != HTTPS_PLUGIN_NOT_ATTACHED)
   {
+    flightPhase(FLIGHT_PHASE_LOG_SUBMIT);
     submitStoredLogs();
   }
 
@@ -492,7 +548,11 @@ void bl_init(void)
   if (!update_firmware)
     goToSleep();
   else
+  {
+    settings_commit();
+    flightPhase(FLIGHT_PHASE_RESTART);
     ESP.restart();
+  }
 }
 
 /**
@@ -504,42 +564,42 @@ void bl_process(void)
 {
 }
 
-ApiDisplayInputs loadApiDisplayInputs(Preferences &preferences)
+ApiDisplayInputs loadApiDisplayInputs(SettingsCache &settings)
 {
   ApiDisplayInputs inputs;
 
-  inputs.baseUrl = preferences.getString(PREFERENCES_API_URL, API_BASE_URL);
+  inputs.baseUrl = settings.getString(PREFERENCES_API_URL, API_BASE_URL);
 
-  if (preferences.isKey(PREFERENCES_API_KEY))
+  if (settings.isKey(PREFERENCES_API_KEY))
   {
-    inputs.apiKey = preferences.getString(PREFERENCES_API_KEY, PREFERENCES_API_KEY_DEFAULT);
-    Log.info("%s [%d]: %s key exists. Value - %s\r\n", __FILE__, __LINE__, PREFERENCES_API_KEY, inputs.apiKey.c_str());
+    inputs.apiKey = settings.getString(PREFERENCES_API_KEY, PREFERENCES_API_KEY_DEFAULT);
+    Log_info("%s key exists. Value - %s", PREFERENCES_API_KEY, inputs.apiKey.c_str());
   }
   else
   {
-    Log.error("%s [%d]: %s key not exists.\r\n", __FILE__, __LINE__, PREFERENCES_API_KEY);
+    Log_error("%s key not exists.", PREFERENCES_API_KEY);
   }
 
-  if (preferences.isKey(PREFERENCES_FRIENDLY_ID))
+  if (settings.isKey(PREFERENCES_FRIENDLY_ID))
   {
-    inputs.friendlyId = preferences.getString(PREFERENCES_FRIENDLY_ID, PREFERENCES_FRIENDLY_ID_DEFAULT);
-    Log.info("%s [%d]: %s key exists. Value - %s\r\n", __FILE__, __LINE__, PREFERENCES_FRIENDLY_ID, inputs.friendlyId);
+    inputs.friendlyId = settings.getString(PREFERENCES_FRIENDLY_ID, PREFERENCES_FRIENDLY_ID_DEFAULT);
+    Log_info("%s key exists. Value - %s", PREFERENCES_FRIENDLY_ID, inputs.friendlyId.c_str());
   }
   else
   {
-    Log.error("%s [%d]: %s key not exists.\r\n", __FILE__, __LINE__, PREFERENCES_FRIENDLY_ID);
+    Log_error("%s key not exists.", PREFERENCES_FRIENDLY_ID);
   }
 
   inputs.refreshRate = SLEEP_TIME_TO_SLEEP;
 
-  if (preferences.isKey(PREFERENCES_SLEEP_TIME_KEY))
+  if (settings.isKey(PREFERENCES_SLEEP_TIME_KEY))
   {
-    inputs.refreshRate = preferences.getUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP);
-    Log.info("%s [%d]: %s key exists. Value - %d\r\n", __FILE__, __LINE__, PREFERENCES_SLEEP_TIME_KEY, inputs.refreshRate);
+    inputs.refreshRate = settings.getUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP);
+    Log_info("%s key exists. Value - %d", PREFERENCES_SLEEP_TIME_KEY, inputs.refreshRate);
   }
   else
   {
-    Log.error("%s [%d]: %s key not exists.\r\n", __FILE__, __LINE__, PREFERENCES_SLEEP_TIME_KEY);
+    Log_error("%s key not exists.", PREFERENCES_SLEEP_TIME_KEY);
   }
 
   inputs.macAddress = WiFi.macAddress();
@@ -566,7 +626,7 @@ ApiDisplayInputs loadApiDisplayInputs(Preferences &preferences)
 static https_request_err_e downloadAndShow()
 {
   IPAddress serverIP;
-  String apiHostname = preferences.getString(PREFERENCES_API_URL, API_BASE_URL);
+  String apiHostname = settings.getString(PREFERENCES_API_URL, API_BASE_URL);
   apiHostname.replace("https://", "");
   apiHostname.replace("http://", "");
   apiHostname.replace("/", "");
@@ -574,12 +634,12 @@ static https_request_err_e downloadAndShow()
   {
     if (WiFi.hostByName(apiHostname.c_str(), serverIP) == 1)
     {
-      Log.info("%s [%d]: Hostname resolved to %s on attempt %d\r\n", __FILE__, __LINE__, serverIP.toString().c_str(), attempt);
+      Log_info("Hostname resolved to %s on attempt %d", serverIP.toString().c_str(), attempt);
       break;
     }
     else
     {
-      Log.error("%s [%d]: Failed to resolve hostname on attempt %d\r\n", __FILE__, __LINE__, attempt);
+      Log_error("Failed to resolve hostname on attempt %d", attempt);
       if (attempt == 5)
       {
         submit_log("Failed to resolve hostname after 5 attempts, continuing...");
@@ -588,19 +648,48 @@ static https_request_err_e downloadAndShow()
     }
   }
 
-  auto apiDisplayInputs = loadApiDisplayInputs(preferences);
+  flightPhase(FLIGHT_PHASE_API);
+  auto apiDisplayInputs = loadApiDisplayInputs(settings);
 
   auto apiDisplayResult = fetchApiDisplay(apiDisplayInputs);
 
   if (apiDisplayResult.error != HTTPS_NO_ERR)
   {
-    Log.error("%s [%d]: Error fetching API display: %d, detail: %s\r\n", __FILE__, __LINE__, apiDisplayResult.error, apiDisplayResult.error_detail.c_str());
+    Log_error("Error fetching API display: %d, detail: %s", apiDisplayResult.error, apiDisplayResult.error_detail.c_str());
     submit_log("Error fetching API display: %d, detail: %s", apiDisplayResult.error, apiDisplayResult.error_detail.c_str());
     return apiDisplayResult.error;
   }
 
   https_request_err_e result = handleApiDisplayResponse(apiDisplayResult.response);
 
+  if (status && !update_firmware && !reset_firmware)
+  {
+    // a new image will be drawn: reset and power on the panel while it is fetched
+    display_prepare();
+
+    size_t cached_size = 0;
+    bool cached_png = false;
+    if (image_store_show_framebuffer(apiDisplayResult.response.filename.c_str()))
+    {
+      Log_info("Image shown from cache, skipping the download");
+      status = false;
+      image_store_set_current_cached(apiDisplayResult.response.filename.c_str());
+      new_filename = apiDisplayResult.response.filename;
+      saveCurrentFileName(new_filename);
+      if (result != HTTPS_PLUGIN_NOT_ATTACHED)
+        result = HTTPS_SUCCESS;
+    }
+    else if ((buffer = image_store_load(apiDisplayResult.response.filename.c_str(), cached_size, cached_png)))
+    {
+      Log_info("Image found in cache, skipping the download");
+      result = showNewImage(cached_size, cached_png, apiDisplayResult.response.filename, result, true);
+      if (result == HTTPS_WRONG_IMAGE_FORMAT)
+        Log_error("Cached image unusable, downloading it"); // status stays set: the download below fetches it again
+      else
+        status = false;
+    }
+  }
+
   auto withHttpResult = withHttp(
       filename,
       [&](HTTPClient *httpsp, HttpError error) -> https_request_err_e
@@ -652,7 +741,7 @@ static https_request_err_e downloadAndShow()
           // httpCode will be negative on error
           if (httpCode < 0)
           {
-            Log.error("%s [%d]: [HTTPS] GET... failed, error: %d (%s)\r\n", __FILE__, __LINE__, httpCode, https.errorToString(httpCode).c_str());
+            Log_error("[HTTPS] GET... failed, error: %d (%s)", httpCode, https.errorToString(httpCode).c_str());
 
             submit_log("HTTP Client failed with error: %s", https.errorToString(httpCode).c_str());
 
@@ -660,57 +749,58 @@ static https_request_err_e downloadAndShow()
           }
 
           // HTTP header has been send and Server response header has been handled
-          Log.error("%s [%d]: [HTTPS] GET... code: %d\r\n", __FILE__, __LINE__, httpCode);
-          Log.info("%s [%d]: RSSI: %d\r\n", __FILE__, __LINE__, WiFi.RSSI());
+          Log_error("[HTTPS] GET... code: %d", httpCode);
+          Log_info("RSSI: %d", WiFi.RSSI());
           // file found at server
           if (httpCode != HTTP_CODE_OK && httpCode != HTTP_CODE_MOVED_PERMANENTLY)
           {
-            Log.error("%s [%d]: [HTTPS] GET... failed, code: %d (%s)\r\n", __FILE__, __LINE__, httpCode, https.errorToString(httpCode).c_str());
+            Log_error("[HTTPS] GET... failed, code: %d (%s)", httpCode, https.errorToString(httpCode).c_str());
 
             submit_log("HTTPS returned code is not OK. Code: %d", httpCode);
             return HTTPS_REQUEST_FAILED;
           }
-          Log.info("%s [%d]: Content size: %d\r\n", __FILE__, __LINE__, https.getSize());
+          Log_info("Content size: %d", https.getSize());
 
           uint32_t counter = 0;
           if (content_size > DISPLAY_BMP_IMAGE_SIZE)
           {
-            Log.error("%s [%d]: Receiving failed. Bad file size\r\n", __FILE__, __LINE__);
+            Log_error("Receiving failed. Bad file size");
 
             submit_log("HTTPS request error. Returned code - %d, available bytes - %d, received bytes - %d", httpCode, https.getSize(), counter);
 
             return HTTPS_REQUEST_FAILED;
           }
           WiFiClient *stream = https.getStreamPtr();
-          Log.info("%s [%d]: RSSI: %d\r\n", __FILE__, __LINE__, WiFi.RSSI());
-          Log.info("%s [%d]: Stream timeout: %d\r\n", __FILE__, __LINE__, stream->getTimeout());
+          Log_info("RSSI: %d", WiFi.RSSI());
+          Log_info("Stream timeout: %d", stream->getTimeout());
 
-          Log.info("%s [%d]: Stream available: %d\r\n", __FILE__, __LINE__, stream->available());
+          Log_info("Stream available: %d", stream->available());
 
           uint32_t timer = millis();
           while (stream->available() < 4000 && millis() - timer < 1000)
             ;
 
-          Log.info("%s [%d]: Stream available: %d\r\n", __FILE__, __LINE__, stream->available());
+          Log_info("Stream available: %d", stream->available());
 
           bool isPNG = https.header("Content-Type") == "image/png";
 
-          Log.info("%s [%d]: Starting a download at: %d\r\n", __FILE__, __LINE__, getTime());
+          Log_info("Starting a download at: %d", getTime());
+          flightPhase(FLIGHT_PHASE_DOWNLOAD);
           heap_caps_check_integrity_all(true);
-          buffer = (uint8_t *)malloc(content_size);
+          buffer = (uint8_t *)heap_trace_malloc(content_size, "download_buffer");
 
           counter = downloadStream(stream, content_size, buffer);
 
           if (counter >= 2 && buffer[0] == 'B' && buffer[1] == 'M')
           {
             isPNG = false;
-            Log.info("BMP file detected");
+            Log_info("BMP file detected");
           }
 
           if (counter != content_size)
           {
 
-            Log.error("%s [%d]: Receiving failed. Read: %d\r\n", __FILE__, __LINE__, counter);
+            Log_error("Receiving failed. Read: %d", counter);
 
             // display_show_msg(const_cast<uint8_t *>(default_icon), API_SIZE_ERROR);
             submit_log("HTTPS request error. Returned code - %d, available bytes - %d, received bytes - %d", httpCode, https.getSize(), counter);
@@ -718,162 +808,181 @@ static https_request_err_e downloadAndShow()
             return HTTPS_WRONG_IMAGE_SIZE;
           }
 
-          Log.info("%s [%d]: Received successfully\r\n", __FILE__, __LINE__);
+          Log_info("Received successfully");
 
-          bool bmp_rename = false;
+          return showNewImage(content_size, isPNG, apiDisplayResult.response.filename, result);
+        }
 
-          if (filesystem_file_exists("/current.bmp") || filesystem_file_exists("/current.png"))
-          {
-            filesystem_file_delete("/last.bmp");
-            filesystem_file_delete("/last.png");
-            filesystem_file_rename("/current.png", "/last.png");
-            filesystem_file_rename("/current.bmp", "/last.bmp");
-          }
+        return result;
+      });
 
-          bool image_reverse = false;
+  if (result == HTTPS_UNABLE_TO_CONNECT)
+  {
+    Log_error("unable to connect");
+    submit_log("unable to connect to the API");
+  }
 
-          if (isPNG)
-          {
-            writeImageToFile("/current.png", buffer, content_size);
-            delay(100);
-            free(buffer);
-            buffer = nullptr;
-            Log.info("%s [%d]: Decoding png\r\n", __FILE__, __LINE__);
-            png_res = decodePNG("/current.png", decodedPng);
-          }
-          else
-          {
-            bmp_res = parseBMPHeader(buffer, image_reverse);
-            Log.info("%s [%d]: BMP Parsing result: %d\r\n", __FILE__, __LINE__, bmp_res);
-          }
-          Serial.println();
-          String error = "";
-          uint8_t *imagePointer = (decodedPng == nullptr) ? buffer : decodedPng;
-          bool lastImageExists = filesystem_file_exists("/last.bmp") || filesystem_file_exists("/last.png");
+  if (send_log)
+  {
+    send_log = false;
+  }
 
-          switch (png_res)
-          {
-          case PNG_NO_ERR:
-          {
+  Log_info("Returned result - %d", result);
 
-            Log.info("Free heap at before display - %d", ESP.getMaxAllocHeap());
-            display_show_image(imagePointer, image_reverse, isPNG);
+  return result;
+}
 
-            // Using filename from API response
-            new_filename = apiDisplayResult.response.filename;
+/**
+ * @brief Function to store, decode and show an image that is in the download buffer
+ * @param content_size image size in bytes
+ * @param isPNG image format
+ * @param image_name filename from the API response
+ * @param result result of the API response, set to HTTPS_SUCCESS once the image is shown
+ * @param cached true if the buffer was read from the image cache, which then keeps it: nothing is written
+ * @return https_request_err_e HTTPS_WRONG_IMAGE_FORMAT if the PNG could not be decoded, result otherwise
+ */
+static https_request_err_e showNewImage(uint32_t content_size, bool isPNG, const String &image_name, https_request_err_e &result, bool cached)
+{
+  bool image_reverse = false;
 
-            // Print the extracted string
-            Log.info("%s [%d]: New filename - %s\r\n", __FILE__, __LINE__, new_filename.c_str());
+  flightPhase(FLIGHT_PHASE_DECODE);
+  if (isPNG)
+  {
+    bool stored = cached ? image_store_set_current_cached(image_name.c_str())
+                         : image_store_set_current(image_name.c_str(), buffer, content_size, true);
+    if (!stored)
+      submit_log("error writing file - %s. Size - %d bytes", image_name.c_str(), content_size);
+    heap_trace_free(buffer);
+    buffer = nullptr;
 
-            bool res = saveCurrentFileName(new_filename);
-            if (res)
-              Log.info("%s [%d]: New filename saved\r\n", __FILE__, __LINE__);
-            else
-              Log.error("%s [%d]: New image name saving error!", __FILE__, __LINE__);
+    // PNGs are decoded from the file
+    char png_path[IMAGE_CACHE_PATH_SIZE] = "";
+    bool png_stored = true;
+    if (stored)
+      image_store_find(false, image_name.c_str(), png_path, png_stored);
+    Log_info("Decoding png %s", png_path);
+    png_res = decodePNG(png_path, decodedPng);
+  }
+  else
+  {
+    bmp_res = parseBMPHeader(buffer, image_reverse);
+    Log_info("BMP Parsing result: %d", bmp_res);
+  }
+  Serial.println();
+  String error = "";
+  uint8_t *imagePointer = (decodedPng == nullptr) ? buffer : decodedPng;
 
-            if (result != HTTPS_PLUGIN_NOT_ATTACHED)
-              result = HTTPS_SUCCESS;
-          }
-          break;
-          case PNG_WRONG_FORMAT:
-          {
-            error = "Wrong image format. Did not pass signature check";
-          }
-          break;
-          case PNG_BAD_SIZE:
-          {
-            error = "IMAGE width, height or size are invalid";
-          }
-          break;
-          case PNG_DECODE_ERR:
-          {
-            error = "could not decode png image";
-          }
-          break;
-          case PNG_MALLOC_FAILED:
-          {
-            error = "could not allocate memory for png image decoder";
-          }
-          break;
-          default:
-            break;
-          }
+  switch (png_res)
+  {
+  case PNG_NO_ERR:
+  {
 
-          switch (bmp_res)
-          {
-          case BMP_NO_ERR:
-          {
-            if (!filesystem_file_exists("/current.png"))
-            {
-              writeImageToFile("/current.bmp", buffer, content_size);
-            }
-            Log.info("Free heap at before display - %d", ESP.getMaxAllocHeap());
-            display_show_image(imagePointer, image_reverse, isPNG);
+    Log_info("Free heap at before display - %d", ESP.getMaxAllocHeap());
+    flightPhase(FLIGHT_PHASE_DISPLAY);
+    framebufferName = image_name;
+    display_show_image(imagePointer, image_reverse, isPNG);
 
-            // Using filename from API response
-            new_filename = apiDisplayResult.response.filename;
+    // Using filename from API response
+    new_filename = image_name;
 
-            // Print the extracted string
-            Log.info("%s [%d]: New filename - %s\r\n", __FILE__, __LINE__, new_filename.c_str());
+    // Print the extracted string
+    Log_info("New filename - %s", new_filename.c_str());
 
-            bool res = saveCurrentFileName(new_filename);
-            if (res)
-              Log.info("%s [%d]: New filename saved\r\n", __FILE__, __LINE__);
-            else
-              Log.error("%s [%d]: New image name saving error!", __FILE__, __LINE__);
+    bool res = saveCurrentFileName(new_filename);
+    if (res)
+      Log_info("New filename saved");
+    else
+      Log_error("New image name saving error!");
 
-            if (result != HTTPS_PLUGIN_NOT_ATTACHED)
-              result = HTTPS_SUCCESS;
-          }
-          break;
-          case BMP_FORMAT_ERROR:
-          {
-            error = "First two header bytes are invalid!";
-          }
-          break;
-          case BMP_BAD_SIZE:
-          {
-            error = "BMP width, height or size are invalid";
-          }
-          break;
-          case BMP_COLOR_SCHEME_FAILED:
-          {
-            error = "BMP color scheme is invalid";
-          }
-          break;
-          case BMP_INVALID_OFFSET:
-          {
-            error = "BMP header offset is invalid";
-          }
-          break;
-          default:
-            break;
-          }
+    if (result != HTTPS_PLUGIN_NOT_ATTACHED)
+      result = HTTPS_SUCCESS;
+  }
+  break;
+  case PNG_WRONG_FORMAT:
+  {
+    error = "Wrong image format. Did not pass signature check";
+  }
+  break;
+  case PNG_BAD_SIZE:
+  {
+    error = "IMAGE width, height or size are invalid";
+  }
+  break;
+  case PNG_DECODE_ERR:
+  {
+    error = "could not decode png image";
+  }
+  break;
+  case PNG_MALLOC_FAILED:
+  {
+    error = "could not allocate memory for png image decoder";
+  }
+  break;
+  default:
+    break;
+  }
 
-          if (isPNG && png_res != PNG_NO_ERR)
-          {
-            filesystem_file_delete("/current.png");
-            submit_log("error parsing image file - %s", error.c_str());
+  switch (bmp_res)
+  {
+  case BMP_NO_ERR:
+  {
+    if (cached)
+      image_store_set_current_cached(image_name.c_str());
+    else if (!image_store_set_current(image_name.c_str(), buffer, content_size, false))
+      submit_log("error writing file - %s. Size - %d bytes", image_name.c_str(), content_size);
+    Log_info("Free heap at before display - %d", ESP.getMaxAllocHeap());
+    flightPhase(FLIGHT_PHASE_DISPLAY);
+    framebufferName = image_name;
+    display_show_image(imagePointer, image_reverse, isPNG);
 
-            return HTTPS_WRONG_IMAGE_FORMAT;
-          }
-        }
+    // Using filename from API response
+    new_filename = image_name;
 
-        return result;
-      });
+    // Print the extracted string
+    Log_info("New filename - %s", new_filename.c_str());
 
-  if (result == HTTPS_UNABLE_TO_CONNECT)
+    bool res = saveCurrentFileName(new_filename);
+    if (res)
+      Log_info("New filename saved");
+    else
+      Log_error("New image name saving error!");
+
+    if (result != HTTPS_PLUGIN_NOT_ATTACHED)
+      result = HTTPS_SUCCESS;
+  }
+  break;
+  case BMP_FORMAT_ERROR:
   {
-    Log_error("unable to connect");
-    submit_log("unable to connect to the API");
+    error = "First two header bytes are invalid!";
   }
-
-  if (send_log)
+  break;
+  case BMP_BAD_SIZE:
   {
-    send_log = false;
+    error = "BMP width, height or size are invalid";
+  }
+  break;
+  case BMP_COLOR_SCHEME_FAILED:
+  {
+    error = "BMP color scheme is invalid";
+  }
+  break;
+  case BMP_INVALID_OFFSET:
+  {
+    error = "BMP header offset is invalid";
+  }
+  break;
+  default:
+    break;
   }
 
-  Log_info("Returned result - %d", result);
+  if (isPNG && png_res != PNG_NO_ERR)
+  {
+    filesystem_file_delete("/current.png");
+    image_store_forget(image_name.c_str());
+    submit_log("error parsing image file - %s", error.c_str());
+
+    return HTTPS_WRONG_IMAGE_FORMAT;
+  }
 
   return result;
 }
@@ -881,15 +990,14 @@ static https_request_err_e downloadAndShow()
 uint32_t downloadStream(WiFiClient *stream, int content_size, uint8_t *buffer)
 {
   int iteration_counter = 0;
-  int counter2 = content_size;
   unsigned long download_start = millis();
   int counter = 0;
   while (counter != content_size && millis() - download_start < 10000)
   {
     if (stream->available())
     {
-      Log.info("%s [%d]: Downloading... Available bytes: %d\r\n", __FILE__, __LINE__, stream->available());
-      counter += stream->readBytes(buffer + counter, counter2 -= counter);
+      Log_verbose("Downloading... Available bytes: %d", stream->available());
+      counter += stream->readBytes(buffer + counter, content_size - counter);
       iteration_counter++;
     }
     delay(10);
@@ -906,7 +1014,7 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
   if (special_function == SF_NONE)
   {
     uint64_t request_status = apiResponse.status;
-    Log.info("%s [%d]: status: %d\r\n", __FILE__, __LINE__, request_status);
+    Log_info("status: %d", request_status);
     switch (request_status)
     {
     case 0:
@@ -923,38 +1031,38 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
 
       if (update_firmware)
       {
-        Log.info("%s [%d]: update firmware. Check URL\r\n", __FILE__, __LINE__);
+        Log_info("update firmware. Check URL");
         if (firmware_url.length() == 0)
         {
-          Log.error("%s [%d]: Empty URL\r\n", __FILE__, __LINE__);
+          Log_error("Empty URL");
           update_firmware = false;
         }
       }
       if (image_url.length() > 0)
       {
-        Log.info("%s [%d]: image_url: %s\r\n", __FILE__, __LINE__, image_url.c_str());
-        Log.info("%s [%d]: image url end with: %d\r\n", __FILE__, __LINE__, image_url.endsWith("/setup-logo.bmp"));
+        Log_info("image_url: %s", image_url.c_str());
+        Log_info("image url end with: %d", image_url.endsWith("/setup-logo.bmp"));
 
         image_url.toCharArray(filename, image_url.length() + 1);
         // check if plugin is applied
-        bool flag = preferences.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
-        Log.info("%s [%d]: flag: %d\r\n", __FILE__, __LINE__, flag);
+        bool flag = settings.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
+        Log_info("flag: %d", flag);
 
         if (apiResponse.filename == "empty_state")
         {
-          Log.info("%s [%d]: End with empty_state\r\n", __FILE__, __LINE__);
+          Log_info("End with empty_state");
           if (!flag)
           {
             // draw received logo
             status = true;
             // set flag to true
-            if (preferences.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != true) // check the flag to avoid the re-writing
+            if (settings.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != true) // check the flag to avoid the re-writing
             {
-              bool res = preferences.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, true);
+              bool res = settings.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, true);
               if (res)
-                Log.info("%s [%d]: Flag written true successfully\r\n", __FILE__, __LINE__);
+                Log_info("Flag written true successfully");
               else
-                Log.error("%s [%d]: FLag writing failed\r\n", __FILE__, __LINE__);
+                Log_error("FLag writing failed");
             }
           }
           else
@@ -967,53 +1075,62 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
         }
         else
         {
-          Log.info("%s [%d]: End with NO empty_state\r\n", __FILE__, __LINE__);
+          Log_info("End with NO empty_state");
           if (flag)
           {
-            if (preferences.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != false) // check the flag to avoid the re-writing
+            if (settings.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != false) // check the flag to avoid the re-writing
             {
-              bool res = preferences.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
+              bool res = settings.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
               if (res)
-                Log.info("%s [%d]: Flag written false successfully\r\n", __FILE__, __LINE__);
+                Log_info("Flag written false successfully");
               else
-                Log.error("%s [%d]: FLag writing failed\r\n", __FILE__, __LINE__);
+                Log_error("FLag writing failed");
             }
           }
           // Using filename from API response
           new_filename = apiResponse.filename;
 
           // Print the extracted string
-          Log.info("%s [%d]: New filename - %s\r\n", __FILE__, __LINE__, new_filename.c_str());
+          Log_info("New filename - %s", new_filename.c_str());
           if (!checkCurrentFileName(new_filename))
           {
-            Log.info("%s [%d]: New image. Show it.\r\n", __FILE__, __LINE__);
+            Log_info("New image. Show it.");
             status = true;
           }
           else
           {
-            Log.info("%s [%d]: Old image. No needed to show it.\r\n", __FILE__, __LINE__);
+            Log_info("Old image. No needed to show it.");
             status = false;
             result = HTTPS_SUCCESS;
           }
+          schedule_observe(schedule_state, status, time_since_sleep);
+          schedule_sleep_time = true;
+          quiet_start = apiResponse.quiet_start;
+          quiet_end = apiResponse.quiet_end;
         }
       }
-      Log.info("%s [%d]: update_firmware: %d\r\n", __FILE__, __LINE__, update_firmware);
+      Log_info("update_firmware: %d", update_firmware);
       if (firmware_url.length() > 0)
       {
-        Log.info("%s [%d]: firmware_url: %s\r\n", __FILE__, __LINE__, firmware_url.c_str());
+        Log_info("firmware_url: %s", firmware_url.c_str());
         firmware_url.toCharArray(binUrl, firmware_url.length() + 1);
+        binSha256 = apiResponse.firmware_sha256;
+        binPatchUrl = apiResponse.firmware_patch_url;
+        Log_info("firmware_sha256: %s", binSha256.c_str());
+        if (binPatchUrl.length() > 0)
+          Log_info("firmware_patch_url: %s", binPatchUrl.c_str());
       }
-      Log.info("%s [%d]: refresh_rate: %d\r\n", __FILE__, __LINE__, rate);
-      if (rate != preferences.getUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP))
+      Log_info("refresh_rate: %d", rate);
+      if (rate != settings.getUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP))
       {
-        Log.info("%s [%d]: write new refresh rate: %d\r\n", __FILE__, __LINE__, rate);
-        preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, rate);
-        Log.info("%s [%d]: written new refresh rate: %d\r\n", __FILE__, __LINE__, result);
+        Log_info("write new refresh rate: %d", rate);
+        settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, rate);
+        Log_info("written new refresh rate: %d", result);
       }
 
       if (reset_firmware)
       {
-        Log.info("%s [%d]: Reset status is true\r\n", __FILE__, __LINE__);
+        Log_info("Reset status is true");
       }
 
       if (update_firmware)
@@ -1022,24 +1139,24 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
         result = HTTPS_RESET;
       if (sleep_5_seconds)
         result = HTTPS_PLUGIN_NOT_ATTACHED;
-      Log.info("%s [%d]: result - %d\r\n", __FILE__, __LINE__, result);
+      Log_info("result - %d", result);
     }
     break;
     case 202:
     {
       result = HTTPS_NO_REGISTER;
-      Log.info("%s [%d]: write new refresh rate: %d\r\n", __FILE__, __LINE__, SLEEP_TIME_WHILE_NOT_CONNECTED);
-      size_t result = preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_WHILE_NOT_CONNECTED);
-      Log.info("%s [%d]: written new refresh rate: %d\r\n", __FILE__, __LINE__, result);
+      Log_info("write new refresh rate: %d", SLEEP_TIME_WHILE_NOT_CONNECTED);
+      size_t result = settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_WHILE_NOT_CONNECTED);
+      Log_info("written new refresh rate: %d", result);
       status = false;
     }
     break;
     case 500:
     {
       result = HTTPS_RESET;
-      Log.info("%s [%d]: write new refresh rate: %d\r\n", __FILE__, __LINE__, SLEEP_TIME_WHILE_NOT_CONNECTED);
-      preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_WHILE_NOT_CONNECTED);
-      Log.info("%s [%d]: written new refresh rate: %d\r\n", __FILE__, __LINE__, result);
+      Log_info("write new refresh rate: %d", SLEEP_TIME_WHILE_NOT_CONNECTED);
+      settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_WHILE_NOT_CONNECTED);
+      Log_info("written new refresh rate: %d", result);
       status = false;
     }
     break;
@@ -1051,7 +1168,7 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
   else if (special_function != SF_NONE)
   {
     uint64_t request_status = apiResponse.status;
-    Log.info("%s [%d]: status: %d\r\n", __FILE__, __LINE__, request_status);
+    Log_info("status: %d", request_status);
     switch (request_status)
     {
     case 0:
@@ -1063,33 +1180,33 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
         String action = apiResponse.action;
         if (action.equals("identify"))
         {
-          Log.info("%s [%d]:Identify success\r\n", __FILE__, __LINE__);
+          Log_info("Identify success");
           String image_url = apiResponse.image_url;
           if (image_url.length() > 0)
           {
-            Log.info("%s [%d]: image_url: %s\r\n", __FILE__, __LINE__, image_url.c_str());
-            Log.info("%s [%d]: image url end with: %d\r\n", __FILE__, __LINE__, image_url.endsWith("/setup-logo.bmp"));
+            Log_info("image_url: %s", image_url.c_str());
+            Log_info("image url end with: %d", image_url.endsWith("/setup-logo.bmp"));
 
             image_url.toCharArray(filename, image_url.length() + 1);
             // check if plugin is applied
-            bool flag = preferences.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
-            Log.info("%s [%d]: flag: %d\r\n", __FILE__, __LINE__, flag);
+            bool flag = settings.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
+            Log_info("flag: %d", flag);
 
             if (apiResponse.filename == "empty_state")
             {
-              Log.info("%s [%d]: End with empty_state\r\n", __FILE__, __LINE__);
+              Log_info("End with empty_state");
               if (!flag)
               {
                 // draw received logo
                 status = true;
                 // set flag to true
-                if (preferences.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != true) // check the flag to avoid the re-writing
+                if (settings.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != true) // check the flag to avoid the re-writing
                 {
-                  bool res = preferences.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, true);
+                  bool res = settings.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, true);
                   if (res)
-                    Log.info("%s [%d]: Flag written true successfully\r\n", __FILE__, __LINE__);
+                    Log_info("Flag written true successfully");
                   else
-                    Log.error("%s [%d]: FLag writing failed\r\n", __FILE__, __LINE__);
+                    Log_error("FLag writing failed");
                 }
               }
               else
@@ -1099,16 +1216,16 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
             }
             else
             {
-              Log.info("%s [%d]: End with NO empty_state\r\n", __FILE__, __LINE__);
+              Log_info("End with NO empty_state");
               if (flag)
               {
-                if (preferences.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != false) // check the flag to avoid the re-writing
+                if (settings.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != false) // check the flag to avoid the re-writing
                 {
-                  bool res = preferences.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
+                  bool res = settings.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
                   if (res)
-                    Log.info("%s [%d]: Flag written false successfully\r\n", __FILE__, __LINE__);
+                    Log_info("Flag written false successfully");
                   else
-                    Log.error("%s [%d]: FLag writing failed\r\n", __FILE__, __LINE__);
+                    Log_error("FLag writing failed");
                 }
               }
               status = true;
@@ -1117,7 +1234,7 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
         }
         else
         {
-          Log.error("%s [%d]: identify failed\r\n", __FILE__, __LINE__);
+          Log_error("identify failed");
         }
       }
       break;
@@ -1127,20 +1244,20 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
         if (action.equals("sleep"))
         {
           uint64_t rate = apiResponse.refresh_rate;
-          Log.info("%s [%d]: refresh_rate: %d\r\n", __FILE__, __LINE__, rate);
-          if (rate != preferences.getUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP))
+          Log_info("refresh_rate: %d", rate);
+          if (rate != settings.getUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP))
           {
-            Log.info("%s [%d]: write new refresh rate: %d\r\n", __FILE__, __LINE__, rate);
-            preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, rate);
-            Log.info("%s [%d]: written new refresh rate: %d\r\n", __FILE__, __LINE__, result);
+            Log_info("write new refresh rate: %d", rate);
+            settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, rate);
+            Log_info("written new refresh rate: %d", result);
           }
           status = false;
           result = HTTPS_SUCCESS;
-          Log.info("%s [%d]: sleep success\r\n", __FILE__, __LINE__);
+          Log_info("sleep success");
         }
         else
         {
-          Log.error("%s [%d]: sleep failed\r\n", __FILE__, __LINE__);
+          Log_error("sleep failed");
           // need to add error
         }
       }
@@ -1152,11 +1269,11 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
         {
           status = false;
           result = HTTPS_SUCCESS;
-          Log.info("%s [%d]: Add wifi success\r\n", __FILE__, __LINE__);
+          Log_info("Add wifi success");
         }
         else
         {
-          Log.error("%s [%d]: Add wifi failed\r\n", __FILE__, __LINE__);
+          Log_error("Add wifi failed");
         }
       }
       break;
@@ -1165,33 +1282,33 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
         String action = apiResponse.action;
         if (action.equals("restart_playlist"))
         {
-          Log.info("%s [%d]:Restart playlist success\r\n", __FILE__, __LINE__);
+          Log_info("Restart playlist success");
           String image_url = apiResponse.image_url;
           if (image_url.length() > 0)
           {
-            Log.info("%s [%d]: image_url: %s\r\n", __FILE__, __LINE__, image_url.c_str());
-            Log.info("%s [%d]: image url end with: %d\r\n", __FILE__, __LINE__, image_url.endsWith("/setup-logo.bmp"));
+            Log_info("image_url: %s", image_url.c_str());
+            Log_info("image url end with: %d", image_url.endsWith("/setup-logo.bmp"));
 
             image_url.toCharArray(filename, image_url.length() + 1);
             // check if plugin is applied
-            bool flag = preferences.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
-            Log.info("%s [%d]: flag: %d\r\n", __FILE__, __LINE__, flag);
+            bool flag = settings.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
+            Log_info("flag: %d", flag);
 
             if (apiResponse.filename == "empty_state")
             {
-              Log.info("%s [%d]: End with empty_state\r\n", __FILE__, __LINE__);
+              Log_info("End with empty_state");
               if (!flag)
               {
                 // draw received logo
                 status = true;
                 // set flag to true
-                if (preferences.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != true) // check the flag to avoid the re-writing
+                if (settings.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != true) // check the flag to avoid the re-writing
                 {
-                  bool res = preferences.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, true);
+                  bool res = settings.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, true);
                   if (res)
-                    Log.info("%s [%d]: Flag written true successfully\r\n", __FILE__, __LINE__);
+                    Log_info("Flag written true successfully");
                   else
-                    Log.error("%s [%d]: FLag writing failed\r\n", __FILE__, __LINE__);
+                    Log_error("FLag writing failed");
                 }
               }
               else
@@ -1202,16 +1319,16 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
             }
             else
             {
-              Log.info("%s [%d]: End with NO empty_state\r\n", __FILE__, __LINE__);
+              Log_info("End with NO empty_state");
               if (flag)
               {
-                if (preferences.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != false) // check the flag to avoid the re-writing
+                if (settings.getBool(PREFERENCES_DEVICE_REGISTERED_KEY, false) != false) // check the flag to avoid the re-writing
                 {
-                  bool res = preferences.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
+                  bool res = settings.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
                   if (res)
-                    Log.info("%s [%d]: Flag written false successfully\r\n", __FILE__, __LINE__);
+                    Log_info("Flag written false successfully");
                   else
-                    Log.error("%s [%d]: FLag writing failed\r\n", __FILE__, __LINE__);
+                    Log_error("FLag writing failed");
                 }
               }
               status = true;
@@ -1220,7 +1337,7 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
         }
         else
         {
-          Log.error("%s [%d]: identify failed\r\n", __FILE__, __LINE__);
+          Log_error("identify failed");
         }
       }
       break;
@@ -1232,27 +1349,34 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
           bool isPNG = false;
           status = false;
           result = HTTPS_SUCCESS;
-          Log.info("%s [%d]: rewind success\r\n", __FILE__, __LINE__);
+          Log_info("rewind success");
 
           bool image_reverse = false;
           bool file_check_bmp = true;
           image_err_e image_proccess_response = PNG_WRONG_FORMAT;
           bmp_err_e bmp_proccess_response = BMP_NOT_BMP;
 
+          if (image_store_show_framebuffer(settings.getString(PREFERENCES_LAST_FILENAME_KEY, "").c_str()))
+          {
+            need_to_refresh_display = 1;
+            break;
+          }
+
           // showMessageWithLogo(BMP_FORMAT_ERROR);
-          String last_dot_file = filesystem_file_exists("/last.bmp") ? "/last.bmp" : "/last.png";
-          if (last_dot_file == "/last.bmp")
+          char last_dot_file[IMAGE_CACHE_PATH_SIZE] = "/last.png";
+          isPNG = true;
+          image_store_find(true, settings.getString(PREFERENCES_LAST_FILENAME_KEY, "").c_str(), last_dot_file, isPNG);
+          if (!isPNG)
           {
-            Log.info("Rewind BMP\n\r");
-            buffer = (uint8_t *)malloc(DISPLAY_BMP_IMAGE_SIZE);
-            file_check_bmp = filesystem_read_from_file(last_dot_file.c_str(), buffer, DISPLAY_BMP_IMAGE_SIZE);
+            Log_info("Rewind BMP %s", last_dot_file);
+            buffer = (uint8_t *)heap_trace_malloc(DISPLAY_BMP_IMAGE_SIZE, "stored_image_buffer");
+            file_check_bmp = filesystem_read_from_file(last_dot_file, buffer, DISPLAY_BMP_IMAGE_SIZE);
             bmp_proccess_response = parseBMPHeader(buffer, image_reverse);
           }
-          else if (last_dot_file == "/last.png")
+          else
           {
-            isPNG = true;
-            Log.info("Rewind PNG\n\r");
-            image_proccess_response = decodePNG(last_dot_file.c_str(), buffer);
+            Log_info("Rewind PNG %s", last_dot_file);
+            image_proccess_response = decodePNG(last_dot_file, buffer);
           }
 
           if (file_check_bmp)
@@ -1261,7 +1385,7 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
             {
             case PNG_NO_ERR:
             {
-              Log.info("Showing image\n\r");
+              Log_info("Showing image");
               display_show_image(buffer, image_reverse, isPNG);
               need_to_refresh_display = 1;
             }
@@ -1275,7 +1399,7 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
             {
             case BMP_NO_ERR:
             {
-              Log.info("Showing image\n\r");
+              Log_info("Showing image");
               display_show_image(buffer, image_reverse, isPNG);
               need_to_refresh_display = 1;
             }
@@ -1288,14 +1412,14 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
           }
           else
           {
-            free(buffer);
+            heap_trace_free(buffer);
             buffer = nullptr;
             showMessageWithLogo(BMP_FORMAT_ERROR);
           }
         }
         else
         {
-          Log.error("%s [%d]: rewind failed\r\n", __FILE__, __LINE__);
+          Log_error("rewind failed");
         }
       }
       break;
@@ -1308,28 +1432,36 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
           bool isPNG = false;
           status = false;
           result = HTTPS_SUCCESS;
-          Log.info("%s [%d]: send_to_me success\r\n", __FILE__, __LINE__);
+          Log_info("send_to_me success");
 
           bool image_reverse = false;
           image_err_e image_proccess_response = PNG_WRONG_FORMAT;
 
-          if (!filesystem_file_exists("/current.bmp") && !filesystem_file_exists("/current.png"))
+          // a double click wakes the device with the button, so the logo has replaced the image already
+          if (image_store_show_framebuffer(shownName.c_str()))
           {
-            Log.info("%s [%d]: No current image!\r\n", __FILE__, __LINE__);
-            free(buffer);
+            need_to_refresh_display = 1;
+            break;
+          }
+
+          char current_file[IMAGE_CACHE_PATH_SIZE];
+          if (!image_store_find(false, shownName.c_str(), current_file, isPNG))
+          {
+            Log_info("No current image!");
+            heap_trace_free(buffer);
             buffer = nullptr;
             return HTTPS_WRONG_IMAGE_FORMAT;
           }
 
-          if (filesystem_file_exists("/current.bmp"))
+          if (!isPNG)
           {
-            Log.info("%s [%d]: send_to_me BMP\r\n", __FILE__, __LINE__);
-            buffer = (uint8_t *)malloc(DISPLAY_BMP_IMAGE_SIZE);
+            Log_info("send_to_me BMP %s", current_file);
+            buffer = (uint8_t *)heap_trace_malloc(DISPLAY_BMP_IMAGE_SIZE, "stored_image_buffer");
 
-            if (!filesystem_read_from_file("/current.bmp", buffer, DISPLAY_BMP_IMAGE_SIZE))
+            if (!filesystem_read_from_file(current_file, buffer, DISPLAY_BMP_IMAGE_SIZE))
             {
-              Log.info("%s [%d]: Error reading image!\r\n", __FILE__, __LINE__);
-              free(buffer);
+              Log_info("Error reading image!");
+              heap_trace_free(buffer);
               buffer = nullptr;
               submit_log("Error reading image!");
               return HTTPS_WRONG_IMAGE_FORMAT;
@@ -1338,39 +1470,38 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
             bmp_err_e bmp_parse_result = parseBMPHeader(buffer, image_reverse);
             if (bmp_parse_result != BMP_NO_ERR)
             {
-              Log.info("%s [%d]: Error parsing BMP header, code: %d\r\n", __FILE__, __LINE__, bmp_parse_result);
-              free(buffer);
+              Log_info("Error parsing BMP header, code: %d", bmp_parse_result);
+              heap_trace_free(buffer);
               buffer = nullptr;
               submit_log("Error parsing BMP header, code: %d", bmp_parse_result);
               return HTTPS_WRONG_IMAGE_FORMAT;
             }
           }
-          else if (filesystem_file_exists("/current.png"))
+          else
           {
-            Log.info("%s [%d]: send_to_me PNG\r\n", __FILE__, __LINE__);
-            isPNG = true;
-            image_err_e png_parse_result = decodePNG("/current.png", buffer);
+            Log_info("send_to_me PNG %s", current_file);
+            image_err_e png_parse_result = decodePNG(current_file, buffer);
 
             if (png_parse_result != PNG_NO_ERR)
             {
-              Log.info("%s [%d]: Error parsing PNG header, code: %d\r\n", __FILE__, __LINE__, png_parse_result);
-              free(buffer);
+              Log_info("Error parsing PNG header, code: %d", png_parse_result);
+              heap_trace_free(buffer);
               buffer = nullptr;
               submit_log("Error parsing PNG header, code: %d", png_parse_result);
               return HTTPS_WRONG_IMAGE_FORMAT;
             }
           }
 
-          Log.info("Showing image\n\r");
+          Log_info("Showing image");
           display_show_image(buffer, image_reverse, isPNG);
           need_to_refresh_display = 1;
 
-          free(buffer);
+          heap_trace_free(buffer);
           buffer = nullptr;
         }
         else
         {
-          Log.error("%s [%d]: send_to_me failed\r\n", __FILE__, __LINE__);
+          Log_error("send_to_me failed");
         }
       }
       break;
@@ -1382,18 +1513,18 @@ https_request_err_e handleApiDisplayResponse(ApiDisplayResponse &apiResponse)
     case 202:
     {
       result = HTTPS_NO_REGISTER;
-      Log.info("%s [%d]: write new refresh rate: %d\r\n", __FILE__, __LINE__, SLEEP_TIME_WHILE_NOT_CONNECTED);
-      preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_WHILE_NOT_CONNECTED);
-      Log.info("%s [%d]: written new refresh rate: %d\r\n", __FILE__, __LINE__, result);
+      Log_info("write new refresh rate: %d", SLEEP_TIME_WHILE_NOT_CONNECTED);
+      settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_WHILE_NOT_CONNECTED);
+      Log_info("written new refresh rate: %d", result);
       status = false;
     }
     break;
     case 500:
     {
       result = HTTPS_RESET;
-      Log.info("%s [%d]: write new refresh rate: %d\r\n", __FILE__, __LINE__, SLEEP_TIME_WHILE_NOT_CONNECTED);
-      preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_WHILE_NOT_CONNECTED);
-      Log.info("%s [%d]: written new refresh rate: %d\r\n", __FILE__, __LINE__, result);
+      Log_info("write new refresh rate: %d", SLEEP_TIME_WHILE_NOT_CONNECTED);
+      settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_WHILE_NOT_CONNECTED);
+      Log_info("written new refresh rate: %d", result);
       status = false;
     }
     break;
@@ -1417,7 +1548,7 @@ static void getDeviceCredentials()
   secureClient->setInsecure();
 
   bool isHttps = true;
-  if (preferences.getString(PREFERENCES_API_URL, API_BASE_URL).indexOf("https://") == -1)
+  if (settings.getString(PREFERENCES_API_URL, API_BASE_URL).indexOf("https://") == -1)
   {
     isHttps = false;
   }
@@ -1433,9 +1564,9 @@ static void getDeviceCredentials()
       https.setTimeout(15000);
       https.setConnectTimeout(15000);
 
-      Log.info("%s [%d]: [HTTPS] begin /api/setup/ ...\r\n", __FILE__, __LINE__);
+      Log_info("[HTTPS] begin /api/setup/ ...");
       char new_url[200];
-      strcpy(new_url, preferences.getString(PREFERENCES_API_URL, API_BASE_URL).c_str());
+      strcpy(new_url, settings.getString(PREFERENCES_API_URL, API_BASE_URL).c_str());
       strcat(new_url, "/api/setup/");
 
       char fw_version[30];
@@ -1443,13 +1574,13 @@ static void getDeviceCredentials()
 
       if (https.begin(*client, new_url))
       { // HTTPS
-        Log.info("%s [%d]: RSSI: %d\r\n", __FILE__, __LINE__, WiFi.RSSI());
-        Log.info("%s [%d]: [HTTPS] GET...\r\n", __FILE__, __LINE__);
+        Log_info("RSSI: %d", WiFi.RSSI());
+        Log_info("[HTTPS] GET...");
         // start connection and send HTTP header
 
         https.addHeader("ID", WiFi.macAddress());
         https.addHeader("FW-Version", fw_version);
-        Log.info("%s [%d]: Device MAC address: %s\r\n", __FILE__, __LINE__, WiFi.macAddress().c_str());
+        Log_info("Device MAC address: %s", WiFi.macAddress().c_str());
 
         int httpCode = https.GET();
 
@@ -1457,20 +1588,20 @@ static void getDeviceCredentials()
         if (httpCode > 0)
         {
           // HTTP header has been send and Server response header has been handled
-          Log.info("%s [%d]: GET... code: %d\r\n", __FILE__, __LINE__, httpCode);
+          Log_info("GET... code: %d", httpCode);
           // file found at server
-          Log.info("%s [%d]: RSSI: %d\r\n", __FILE__, __LINE__, WiFi.RSSI());
+          Log_info("RSSI: %d", WiFi.RSSI());
           if (httpCode == HTTP_CODE_OK)
           {
-            Log.info("%s [%d]: Content size: %d\r\n", __FILE__, __LINE__, https.getSize());
+            Log_info("Content size: %d", https.getSize());
             String payload = https.getString();
-            Log.info("%s [%d]: Payload: %s\r\n", __FILE__, __LINE__, payload.c_str());
+            Log_info("Payload: %s", payload.c_str());
 
             auto apiResponse = parseResponse_apiSetup(payload);
 
             if (apiResponse.outcome == ApiSetupOutcome::DeserializationError)
             {
-              Log.error("%s [%d]: JSON deserialization error.\r\n", __FILE__, __LINE__);
+              Log_error("JSON deserialization error.");
               https.end();
               client->stop();
               return;
@@ -1479,27 +1610,28 @@ static void getDeviceCredentials()
             if (url_status == 200)
             {
               status = true;
-              Log.info("%s [%d]: status OK.\r\n", __FILE__, __LINE__);
+              Log_info("status OK.");
 
               String api_key = apiResponse.api_key;
-              Log.info("%s [%d]: API key - %s\r\n", __FILE__, __LINE__, api_key.c_str());
-              size_t res = preferences.putString(PREFERENCES_API_KEY, api_key);
-              Log.info("%s [%d]: api key saved in the preferences - %d\r\n", __FILE__, __LINE__, res);
+              Log_info("API key - %s", api_key.c_str());
+              size_t res = settings.putString(PREFERENCES_API_KEY, api_key);
+              Log_info("api key saved in the preferences - %d", res);
 
               String friendly_id = apiResponse.friendly_id;
-              Log.info("%s [%d]: friendly ID - %s\r\n", __FILE__, __LINE__, friendly_id.c_str());
-              res = preferences.putString(PREFERENCES_FRIENDLY_ID, friendly_id);
-              Log.info("%s [%d]: friendly ID saved in the preferences - %d\r\n", __FILE__, __LINE__, res);
+              Log_info("friendly ID - %s", friendly_id.c_str());
+              res = settings.putString(PREFERENCES_FRIENDLY_ID, friendly_id);
+              Log_info("friendly ID saved in the preferences - %d", res);
+              settings_commit(); // credentials must survive a crash before the next sleep
 
               String image_url = apiResponse.image_url;
-              Log.info("%s [%d]: image_url - %s\r\n", __FILE__, __LINE__, image_url.c_str());
+              Log_info("image_url - %s", image_url.c_str());
               image_url.toCharArray(filename, image_url.length() + 1);
 
               String message_str = apiResponse.message;
-              Log.info("%s [%d]: message - %s\r\n", __FILE__, __LINE__, message_str.c_str());
+              Log_info("message - %s", message_str.c_str());
               message_str.toCharArray(message_buffer, message_str.length() + 1);
 
-              Log.info("%s [%d]: status - %d\r\n", __FILE__, __LINE__, status);
+              Log_info("status - %d", status);
             }
             else if (url_status == 404)
             {
@@ -1507,20 +1639,20 @@ static void getDeviceCredentials()
 
               showMessageWithLogo(MAC_NOT_REGISTERED, apiResponse);
 
-              preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP);
+              settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP);
 
               display_sleep();
               goToSleep();
             }
             else
             {
-              Log.info("%s [%d]: status FAIL.\r\n", __FILE__, __LINE__);
+              Log_info("status FAIL.");
               status = false;
             }
           }
           else
           {
-            Log.info("%s [%d]: [HTTPS] Unable to connect\r\n", __FILE__, __LINE__);
+            Log_info("[HTTPS] Unable to connect");
 
             if (WiFi.RSSI() > WIFI_CONNECTION_RSSI)
             {
@@ -1535,7 +1667,7 @@ static void getDeviceCredentials()
         }
         else
         {
-          Log.error("%s [%d]: [HTTPS] GET... failed, error: %s\r\n", __FILE__, __LINE__, https.errorToString(httpCode).c_str());
+          Log_error("[HTTPS] GET... failed, error: %s", https.errorToString(httpCode).c_str());
           if (WiFi.RSSI() > WIFI_CONNECTION_RSSI)
           {
             showMessageWithLogo(API_ERROR);
@@ -1551,20 +1683,20 @@ static void getDeviceCredentials()
       }
       else
       {
-        Log.error("%s [%d]: [HTTPS] Unable to connect\r\n", __FILE__, __LINE__);
+        Log_error("[HTTPS] Unable to connect");
         showMessageWithLogo(WIFI_INTERNAL_ERROR);
         submit_log("unable to connect to the API");
       }
-      Log.info("%s [%d]: status - %d\r\n", __FILE__, __LINE__, status);
+      Log_info("status - %d", status);
       if (status)
       {
         status = false;
-        Log.info("%s [%d]: filename - %s\r\n", __FILE__, __LINE__, filename);
+        Log_info("filename - %s", filename);
 
-        Log.info("%s [%d]: [HTTPS] Request to %s\r\n", __FILE__, __LINE__, filename);
+        Log_info("[HTTPS] Request to %s", filename);
         if (https.begin(*client, filename))
         { // HTTPS
-          Log.info("%s [%d]: [HTTPS] GET..\r\n", __FILE__, __LINE__);
+          Log_info("[HTTPS] GET..");
           // start connection and send HTTP header
           int httpCode = https.GET();
 
@@ -1572,17 +1704,17 @@ static void getDeviceCredentials()
           if (httpCode > 0)
           {
             // HTTP header has been send and Server response header has been handled
-            Log.error("%s [%d]: [HTTPS] GET... code: %d\r\n", __FILE__, __LINE__, httpCode);
+            Log_error("[HTTPS] GET... code: %d", httpCode);
             // file found at server
             if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_MOVED_PERMANENTLY)
             {
-              Log.info("%s [%d]: Content size: %d\r\n", __FILE__, __LINE__, https.getSize());
+              Log_info("Content size: %d", https.getSize());
 
               WiFiClient *stream = https.getStreamPtr();
 
               uint32_t counter = 0;
               // Read and save BMP data to buffer
-              buffer = (uint8_t *)malloc(https.getSize());
+              buffer = (uint8_t *)heap_trace_malloc(https.getSize(), "setup_logo_buffer");
               if (stream->available() && https.getSize() == DISPLAY_BMP_IMAGE_SIZE)
               {
                 counter = downloadStream(stream, DISPLAY_BMP_IMAGE_SIZE, buffer);
@@ -1590,22 +1722,25 @@ static void getDeviceCredentials()
               https.end();
               if (counter == DISPLAY_BMP_IMAGE_SIZE)
               {
-                Log.info("%s [%d]: Received successfully\r\n", __FILE__, __LINE__);
+                Log_info("Received successfully");
 
-                writeImageToFile("/logo.bmp", buffer, DEFAULT_IMAGE_SIZE);
+                if (flash_store_write(FLASH_STORE_LOGO, buffer, DEFAULT_IMAGE_SIZE))
+                  filesystem_file_delete("/logo.bmp");
+                else
+                  writeImageToFile("/logo.bmp", buffer, DEFAULT_IMAGE_SIZE);
 
                 // show the image
-                String friendly_id = preferences.getString(PREFERENCES_FRIENDLY_ID, PREFERENCES_FRIENDLY_ID_DEFAULT);
+                String friendly_id = settings.getString(PREFERENCES_FRIENDLY_ID, PREFERENCES_FRIENDLY_ID_DEFAULT);
                 display_show_msg(buffer, FRIENDLY_ID, friendly_id, true, "", String(message_buffer));
-                free(buffer);
+                heap_trace_free(buffer);
                 buffer = nullptr;
                 need_to_refresh_display = 0;
               }
               else
               {
-                free(buffer);
+                heap_trace_free(buffer);
                 buffer = nullptr;
-                Log.error("%s [%d]: Receiving failed. Read: %d\r\n", __FILE__, __LINE__, counter);
+                Log_error("Receiving failed. Read: %d", counter);
                 if (WiFi.RSSI() > WIFI_CONNECTION_RSSI)
                 {
                   showMessageWithLogo(API_SIZE_ERROR);
@@ -1619,7 +1754,7 @@ static void getDeviceCredentials()
             }
             else
             {
-              Log.error("%s [%d]: [HTTPS] GET... failed, error: %s\r\n", __FILE__, __LINE__, https.errorToString(httpCode).c_str());
+              Log_error("[HTTPS] GET... failed, error: %s", https.errorToString(httpCode).c_str());
               https.end();
               if (WiFi.RSSI() > WIFI_CONNECTION_RSSI)
               {
@@ -1634,7 +1769,7 @@ static void getDeviceCredentials()
           }
           else
           {
-            Log.error("%s [%d]: [HTTPS] GET... failed, error: %s\r\n", __FILE__, __LINE__, https.errorToString(httpCode).c_str());
+            Log_error("[HTTPS] GET... failed, error: %s", https.errorToString(httpCode).c_str());
             if (WiFi.RSSI() > WIFI_CONNECTION_RSSI)
             {
               showMessageWithLogo(API_ERROR);
@@ -1648,7 +1783,7 @@ static void getDeviceCredentials()
         }
         else
         {
-          Log.error("%s [%d]: unable to connect\r\n", __FILE__, __LINE__);
+          Log_error("unable to connect");
           if (WiFi.RSSI() > WIFI_CONNECTION_RSSI)
           {
             showMessageWithLogo(API_ERROR);
@@ -1667,7 +1802,7 @@ static void getDeviceCredentials()
   }
   else
   {
-    Log.error("%s [%d]: Unable to create client\r\n", __FILE__, __LINE__);
+    Log_error("Unable to create client");
     showMessageWithLogo(WIFI_INTERNAL_ERROR);
     submit_log("unable to create the client");
   }
@@ -1680,80 +1815,45 @@ static void getDeviceCredentials()
  */
 static void resetDeviceCredentials(void)
 {
-  Log.info("%s [%d]: The device will be reset now...\r\n", __FILE__, __LINE__);
-  Log.info("%s [%d]: WiFi reseting...\r\n", __FILE__, __LINE__);
+  Log_info("The device will be reset now...");
+  Log_info("WiFi reseting...");
   WifiCaptivePortal.resetSettings();
   need_to_refresh_display = 1;
   bool res = preferences.clear();
+  settings_reset(); // drop cached and RTC values so nothing is written back
   if (res)
-    Log.info("%s [%d]: The device reset success. Restarting...\r\n", __FILE__, __LINE__);
+    Log_info("The device reset success. Restarting...");
   else
-    Log.error("%s [%d]: The device reseting error. The device will be reset now...\r\n", __FILE__, __LINE__);
+    Log_error("The device reseting error. The device will be reset now...");
   preferences.end();
+  flightPhase(FLIGHT_PHASE_RESTART);
   ESP.restart();
 }
 
 /**
  * @brief Function to check and performing OTA update
+ * An interrupted download continues on the next wake, see ota_update.h.
  * @param none
- * @return none
+ * @return bool true if the new firmware boots on restart
  */
-static void checkAndPerformFirmwareUpdate(void)
+static bool checkAndPerformFirmwareUpdate(void)
 {
-
-  withHttp(binUrl, [&](HTTPClient *https, HttpError errorCode) -> bool
-           {
-             if (errorCode != HttpError::HTTPCLIENT_SUCCESS || !https)
-             {
-               Log.fatal("%s [%d]: Unable to connect for firmware update\r\n", __FILE__, __LINE__);
-               if (WiFi.RSSI() > WIFI_CONNECTION_RSSI)
-               {
-                 showMessageWithLogo(API_ERROR);
-               }
-               else
-               {
-                 showMessageWithLogo(WIFI_WEAK);
-               }
-             }
-
-             int httpCode = https->GET();
-             if (httpCode == HTTP_CODE_OK)
-             {
-               Log.info("%s [%d]: Downloading .bin file...\r\n", __FILE__, __LINE__);
-
-               size_t contentLength = https->getSize();
-               // Perform firmware update
-               if (Update.begin(contentLength))
-               {
-                 Log.info("%s [%d]: Firmware update start\r\n", __FILE__, __LINE__);
-                 showMessageWithLogo(FW_UPDATE);
-
-                 if (Update.writeStream(https->getStream()))
-                 {
-                   if (Update.end(true))
-                   {
-                     Log.info("%s [%d]: Firmware update successful. Rebooting...\r\n", __FILE__, __LINE__);
-                     showMessageWithLogo(FW_UPDATE_SUCCESS);
-                   }
-                   else
-                   {
-                     Log.fatal("%s [%d]: Firmware update failed!\r\n", __FILE__, __LINE__);
-                     showMessageWithLogo(FW_UPDATE_FAILED);
-                   }
-                 }
-                 else
-                 {
-                   Log.fatal("%s [%d]: Write to firmware update stream failed!\r\n", __FILE__, __LINE__);
-                   showMessageWithLogo(FW_UPDATE_FAILED);
-                 }
-               }
-               else
-               {
-                 Log.fatal("%s [%d]: Begin firmware update failed!\r\n", __FILE__, __LINE__);
-                 showMessageWithLogo(FW_UPDATE_FAILED);
-               }
-             }
-             return true; });
+  OtaResult result = ota_update(binUrl, binPatchUrl.c_str(), binSha256.c_str(), preferences, []
+                                { showMessageWithLogo(FW_UPDATE); });
+  switch (result)
+  {
+  case OTA_DONE:
+    Log_info("Firmware update successful. Rebooting...");
+    showMessageWithLogo(FW_UPDATE_SUCCESS);
+    return true;
+  case OTA_FAILED:
+    Log_fatal("Firmware update failed!");
+    showMessageWithLogo(FW_UPDATE_FAILED);
+    return false;
+  default:
+    Log_error("Firmware download interrupted, RSSI %d", WiFi.RSSI());
+    return false;
+  }
 }
 
 /**
@@ -1764,12 +1864,29 @@ static void checkAndPerformFirmwareUpdate(void)
 static void goToSleep(void)
 {
   WiFi.disconnect(true);
+  image_store_commit();
   filesystem_deinit();
   uint32_t time_to_sleep = SLEEP_TIME_TO_SLEEP;
-  if (preferences.isKey(PREFERENCES_SLEEP_TIME_KEY))
-    time_to_sleep = preferences.getUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP);
-  Log.info("%s [%d]: time to sleep - %d\r\n", __FILE__, __LINE__, time_to_sleep);
-  preferences.putUInt(PREFERENCES_LAST_SLEEP_TIME, getTime());
+  if (settings.isKey(PREFERENCES_SLEEP_TIME_KEY))
+    time_to_sleep = settings.getUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP);
+  if (schedule_sleep_time)
+  {
+    // the refresh rate stays in the settings: it is reported to the server
+    uint32_t now = getTime();
+    ScheduleInputs inputs = {
+        .refresh_rate = time_to_sleep,
+        .battery_mv = (uint32_t)(readBatteryVoltage() * 1000),
+        .time_of_day = now ? (int32_t)(now % SCHEDULE_DAY_S) : SCHEDULE_NO_TIME,
+        .quiet_start = quiet_start,
+        .quiet_end = quiet_end,
+    };
+    ScheduleReason reason;
+    time_to_sleep = schedule_sleep(schedule_state, inputs, reason);
+    Log_info("sleep scheduled by %s", schedule_reason_name(reason));
+  }
+  Log_info("time to sleep - %d", time_to_sleep);
+  settings.putUInt(PREFERENCES_LAST_SLEEP_TIME, getTime());
+  settings_commit();
   preferences.end();
   esp_sleep_enable_timer_wakeup((uint64_t)time_to_sleep * SLEEP_uS_TO_S_FACTOR);
   // Configure GPIO pin for wakeup
@@ -1781,6 +1898,10 @@ static void goToSleep(void)
 #elif CONFIG_IDF_TARGET_ESP32S3
 #else
 #error "Unsupported ESP32 target for GPIO wakeup configuration"
+#endif
+  flightPhase(FLIGHT_PHASE_SLEEP);
+#ifdef HEAP_TRACE
+  heap_trace_dump(heapTraceLine);
 #endif
   esp_deep_sleep_start();
 }
@@ -1798,20 +1919,20 @@ static bool setClock()
   struct tm timeinfo;
 
   configTime(0, 0, "pool.ntp.org", "time.google.com", "time.windows.com");
-  Log.info("%s [%d]: Time synchronization...\r\n", __FILE__, __LINE__);
+  Log_info("Time synchronization...");
 
   // Wait for time to be set
   if (getLocalTime(&timeinfo))
   {
     sync_status = true;
-    Log.info("%s [%d]: Time synchronization succeed!\r\n", __FILE__, __LINE__);
+    Log_info("Time synchronization succeed!");
   }
   else
   {
-    Log.info("%s [%d]: Time synchronization failed...\r\n", __FILE__, __LINE__);
+    Log_info("Time synchronization failed...");
   }
 
-  Log.info("%s [%d]: Current time - %s\r\n", __FILE__, __LINE__, asctime(&timeinfo));
+  Log_info("Current time - %s", asctime(&timeinfo));
 
   return sync_status;
 }
@@ -1824,10 +1945,10 @@ static bool setClock()
 static float readBatteryVoltage(void)
 {
 #ifdef FAKE_BATTERY_VOLTAGE
-  Log.warning("%s [%d]: FAKE_BATTERY_VOLTAGE is defined. Returning 4.2V.\r\n", __FILE__, __LINE__);
+  Log_warning("FAKE_BATTERY_VOLTAGE is defined. Returning 4.2V.");
   return 4.2f;
 #else
-  Log.info("%s [%d]: Battery voltage reading...\r\n", __FILE__, __LINE__);
+  Log_info("Battery voltage reading...");
   int32_t adc = 0;
   for (uint8_t i = 0; i < 128; i++)
   {
@@ -1850,18 +1971,18 @@ static float readBatteryVoltage(void)
 static void submitOrSaveLogString(const char *log_buffer, size_t size)
 {
   String api_key = "";
-  if (preferences.isKey(PREFERENCES_API_KEY))
+  if (settings.isKey(PREFERENCES_API_KEY))
   {
-    api_key = preferences.getString(PREFERENCES_API_KEY, PREFERENCES_API_KEY_DEFAULT);
-    Log.info("%s [%d]: %s key exists. Value - %s\r\n", __FILE__, __LINE__, PREFERENCES_API_KEY, api_key.c_str());
+    api_key = settings.getString(PREFERENCES_API_KEY, PREFERENCES_API_KEY_DEFAULT);
+    Log_info("%s key exists. Value - %s", PREFERENCES_API_KEY, api_key.c_str());
   }
   else
   {
-    Log.error("%s [%d]: %s key not exists.\r\n", __FILE__, __LINE__, PREFERENCES_API_KEY);
+    Log_error("%s key not exists.", PREFERENCES_API_KEY);
   }
 
   LogApiInput input{api_key, log_buffer};
-  auto submitLogToApiResult = submitLogToApi(input, preferences.getString(PREFERENCES_API_URL, API_BASE_URL).c_str());
+  auto submitLogToApiResult = submitLogToApi(input, settings.getString(PREFERENCES_API_URL, API_BASE_URL).c_str());
   if (!submitLogToApiResult)
   {
     Log_info("Was unable to send log to API; saving locally for later.");
@@ -1876,7 +1997,7 @@ static uint32_t getTime(void)
   struct tm timeinfo;
   if (!getLocalTime(&timeinfo, 200))
   {
-    Log.info("%s [%d]: Failed to obtain time. \r\n", __FILE__, __LINE__);
+    Log_info("Failed to obtain time. ");
     return (0);
   }
   time(&now);
@@ -1889,28 +2010,28 @@ static void submitStoredLogs(void)
   gather_stored_logs(log, preferences);
 
   String api_key = "";
-  if (preferences.isKey(PREFERENCES_API_KEY))
+  if (settings.isKey(PREFERENCES_API_KEY))
   {
-    api_key = preferences.getString(PREFERENCES_API_KEY, PREFERENCES_API_KEY_DEFAULT);
-    Log.info("%s [%d]: %s key exists. Value - %s\r\n", __FILE__, __LINE__, PREFERENCES_API_KEY, api_key.c_str());
+    api_key = settings.getString(PREFERENCES_API_KEY, PREFERENCES_API_KEY_DEFAULT);
+    Log_info("%s key exists. Value - %s", PREFERENCES_API_KEY, api_key.c_str());
   }
   else
   {
-    Log.error("%s [%d]: %s key not exists.\r\n", __FILE__, __LINE__, PREFERENCES_API_KEY);
+    Log_error("%s key not exists.", PREFERENCES_API_KEY);
   }
 
   bool submitLogToApiResult = false;
   if (log.length() > 0)
   {
-    Log.info("%s [%d]: log string - %s\r\n", __FILE__, __LINE__, log.c_str());
-    Log.info("%s [%d]: need to send the log\r\n", __FILE__, __LINE__);
+    Log_info("log string - %s", log.c_str());
+    Log_info("need to send the log");
 
     LogApiInput input{api_key, log.c_str()};
-    submitLogToApiResult = submitLogToApi(input, preferences.getString(PREFERENCES_API_URL, API_BASE_URL).c_str());
+    submitLogToApiResult = submitLogToApi(input, settings.getString(PREFERENCES_API_URL, API_BASE_URL).c_str());
   }
   else
   {
-    Log.info("%s [%d]: no needed to send the log\r\n", __FILE__, __LINE__);
+    Log_info("no needed to send the log");
   }
   if (submitLogToApiResult == true)
   {
@@ -1920,68 +2041,66 @@ static void submitStoredLogs(void)
 
 static void writeImageToFile(const char *name, uint8_t *in_buffer, size_t size)
 {
-  size_t res = filesystem_write_to_file(name, in_buffer, size);
+  size_t res = filesystem_write_atomic(name, in_buffer, size);
   if (res != size)
   {
-    Log.error("%s [%d]: File writing ERROR. Result - %d\r\n", __FILE__, __LINE__, res);
+    Log_error("File writing ERROR. Result - %d", res);
     submit_log("error writing file - %s. Written - %d bytes", name, res);
   }
   else
   {
-    Log.info("%s [%d]: file %s writing success - %d bytes\r\n", __FILE__, __LINE__, name, res);
+    Log_info("file %s writing success - %d bytes", name, res);
   }
 }
 
 static void writeSpecialFunction(SPECIAL_FUNCTION function)
 {
-  if (preferences.isKey(PREFERENCES_SF_KEY))
+  if (settings.isKey(PREFERENCES_SF_KEY))
   {
-    Log.info("%s [%d]: SF saved. Reading...\r\n", __FILE__, __LINE__);
-    if ((SPECIAL_FUNCTION)preferences.getUInt(PREFERENCES_SF_KEY, 0) == function)
+    Log_info("SF saved. Reading...");
+    if ((SPECIAL_FUNCTION)settings.getUInt(PREFERENCES_SF_KEY, 0) == function)
     {
-      Log.info("%s [%d]: No needed to re-write\r\n", __FILE__, __LINE__);
+      Log_info("No needed to re-write");
     }
     else
     {
-      Log.info("%s [%d]: Writing new special function\r\n", __FILE__, __LINE__);
-      bool res = preferences.putUInt(PREFERENCES_SF_KEY, function);
+      Log_info("Writing new special function");
+      bool res = settings.putUInt(PREFERENCES_SF_KEY, function);
       if (res)
-        Log.info("%s [%d]: Written new special function successfully\r\n", __FILE__, __LINE__);
+        Log_info("Written new special function successfully");
       else
-        Log.error("%s [%d]: Writing new special function failed\r\n", __FILE__, __LINE__);
+        Log_error("Writing new special function failed");
     }
   }
   else
   {
-    Log.error("%s [%d]: SF not saved\r\n", __FILE__, __LINE__);
-    bool res = preferences.putUInt(PREFERENCES_SF_KEY, function);
+    Log_error("SF not saved");
+    bool res = settings.putUInt(PREFERENCES_SF_KEY, function);
     if (res)
-      Log.info("%s [%d]: Written new special function successfully\r\n", __FILE__, __LINE__);
+      Log_info("Written new special function successfully");
     else
-      Log.error("%s [%d]: Writing new special function failed\r\n", __FILE__, __LINE__);
+      Log_error("Writing new special function failed");
   }
 }
 
 static void showMessageWithLogo(MSG message_type)
 {
-  buffer = (uint8_t *)malloc(DEFAULT_IMAGE_SIZE);
   display_show_msg(storedLogoOrDefault(), message_type);
-  free(buffer);
+  heap_trace_free(buffer);
   buffer = nullptr;
 
   need_to_refresh_display = 1;
-  preferences.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
+  settings.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
 }
 
 static void showMessageWithLogo(MSG message_type, String friendly_id, bool id, const char *fw_version, String message)
 {
-  buffer = (uint8_t *)malloc(DEFAULT_IMAGE_SIZE);
   display_show_msg(storedLogoOrDefault(), message_type, friendly_id, id, fw_version, message);
-  free(buffer);
+  heap_trace_free(buffer);
   buffer = nullptr;
 
   need_to_refresh_display = 1;
-  preferences.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
+  settings.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
 }
 
 /**
@@ -1992,97 +2111,113 @@ static void showMessageWithLogo(MSG message_type, String friendly_id, bool id, c
  */
 static void showMessageWithLogo(MSG message_type, const ApiSetupResponse &apiResponse)
 {
-  buffer = (uint8_t *)malloc(DEFAULT_IMAGE_SIZE);
   display_show_msg(storedLogoOrDefault(), message_type, "", false, "", apiResponse.message);
-  free(buffer);
+  heap_trace_free(buffer);
   buffer = nullptr;
 
   need_to_refresh_display = 1;
-  preferences.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
+  settings.putBool(PREFERENCES_DEVICE_REGISTERED_KEY, false);
 }
 
+/**
+ * @brief Function to find the logo to show with messages
+ * @param none
+ * @return uint8_t* logo mapped from flash, else read from /logo.bmp into buffer, else nullptr for the
+ * built-in logo; the caller frees buffer
+ */
 static uint8_t *storedLogoOrDefault(void)
 {
-  if (filesystem_read_from_file("/logo.bmp", buffer, DEFAULT_IMAGE_SIZE))
+  size_t size = 0;
+  const uint8_t *mapped = flash_store_map(FLASH_STORE_LOGO, size);
+  if (mapped && size == DEFAULT_IMAGE_SIZE)
+    return const_cast<uint8_t *>(mapped);
+
+  if (!filesystem_file_exists("/logo.bmp"))
+    return nullptr;
+
+  buffer = (uint8_t *)heap_trace_malloc(DEFAULT_IMAGE_SIZE, "logo_buffer");
+  if (buffer && filesystem_read_from_file("/logo.bmp", buffer, DEFAULT_IMAGE_SIZE))
   {
     return buffer;
   }
-  return const_cast<uint8_t *>(default_icon);
+  return nullptr;
 }
 
 static bool saveCurrentFileName(String &name)
 {
-  if (!preferences.getString(PREFERENCES_FILENAME_KEY, "").equals(name))
+  String current_name = settings.getString(PREFERENCES_FILENAME_KEY, "");
+  if (!current_name.equals(name))
   {
-    Log.info("%s [%d]: New filename:  - %s\r\n", __FILE__, __LINE__, name.c_str());
-    size_t res = preferences.putString(PREFERENCES_FILENAME_KEY, name);
+    Log_info("New filename:  - %s", name.c_str());
+    settings.putString(PREFERENCES_LAST_FILENAME_KEY, current_name); // what rewind shows
+    size_t res = settings.putString(PREFERENCES_FILENAME_KEY, name);
     if (res > 0)
     {
-      Log.info("%s [%d]: New filename saved in the preferences - %d\r\n", __FILE__, __LINE__, res);
+      Log_info("New filename saved in the preferences - %d", res);
       return true;
     }
     else
     {
-      Log.error("%s [%d]: New filename saving error!\r\n", __FILE__, __LINE__);
+      Log_error("New filename saving error!");
       return false;
     }
   }
   else
   {
-    Log.info("%s [%d]: No needed to re-write\r\n", __FILE__, __LINE__);
+    Log_info("No needed to re-write");
     return true;
   }
 }
 
 static bool checkCurrentFileName(String &newName)
 {
-  String currentFilename = preferences.getString(PREFERENCES_FILENAME_KEY, "");
+  String currentFilename = settings.getString(PREFERENCES_FILENAME_KEY, "");
 
-  Log.error("%s [%d]: Current filename: %s\r\n", __FILE__, __LINE__, currentFilename);
+  Log_info("Current filename: %s", currentFilename.c_str());
 
   if (currentFilename.equals(newName))
   {
-    Log.info("%s [%d]: Current filename equals to the new filename\r\n", __FILE__, __LINE__);
+    Log_info("Current filename equals to the new filename");
     return true;
   }
   else
   {
-    Log.error("%s [%d]: Current filename doesn't equal to the new filename\r\n", __FILE__, __LINE__);
+    Log_error("Current filename doesn't equal to the new filename");
     return false;
   }
 }
 
 static void wifiErrorDeepSleep()
 {
-  if (!preferences.isKey(PREFERENCES_CONNECT_WIFI_RETRY_COUNT))
+  if (!settings.isKey(PREFERENCES_CONNECT_WIFI_RETRY_COUNT))
   {
-    preferences.putInt(PREFERENCES_CONNECT_WIFI_RETRY_COUNT, 1);
+    settings.putInt(PREFERENCES_CONNECT_WIFI_RETRY_COUNT, 1);
   }
 
-  uint8_t retry_count = preferences.getInt(PREFERENCES_CONNECT_WIFI_RETRY_COUNT);
+  uint8_t retry_count = settings.getInt(PREFERENCES_CONNECT_WIFI_RETRY_COUNT);
 
   Log_info("WIFI connection failed! Retry count: %d \n", retry_count);
 
   switch (retry_count)
   {
   case 1:
-    preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, WIFI_CONNECT_RETRY_TIME::WIFI_FIRST_RETRY);
+    settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, WIFI_CONNECT_RETRY_TIME::WIFI_FIRST_RETRY);
     break;
 
   case 2:
-    preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, WIFI_CONNECT_RETRY_TIME::WIFI_SECOND_RETRY);
+    settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, WIFI_CONNECT_RETRY_TIME::WIFI_SECOND_RETRY);
     break;
 
   case 3:
-    preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, WIFI_CONNECT_RETRY_TIME::WIFI_THIRD_RETRY);
+    settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, WIFI_CONNECT_RETRY_TIME::WIFI_THIRD_RETRY);
     break;
 
   default:
-    preferences.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP);
+    settings.putUInt(PREFERENCES_SLEEP_TIME_KEY, SLEEP_TIME_TO_SLEEP);
     break;
   }
   retry_count++;
-  preferences.putInt(PREFERENCES_CONNECT_WIFI_RETRY_COUNT, retry_count);
+  settings.putInt(PREFERENCES_CONNECT_WIFI_RETRY_COUNT, retry_count);
 
   display_sleep();
   goToSleep();
@@ -2097,7 +2232,7 @@ DeviceStatusStamp getDeviceStatusStamp()
 
   deviceStatus.wifi_rssi_level = WiFi.RSSI();
   parseWifiStatusToStr(deviceStatus.wifi_status, sizeof(deviceStatus.wifi_status), WiFi.status());
-  deviceStatus.refresh_rate = preferences.getUInt(PREFERENCES_SLEEP_TIME_KEY);
+  deviceStatus.refresh_rate = settings.getUInt(PREFERENCES_SLEEP_TIME_KEY);
   deviceStatus.time_since_last_sleep = time_since_sleep;
   snprintf(deviceStatus.current_fw_version, sizeof(deviceStatus.current_fw_version), "%d.%d.%d", FW_MAJOR_VERSION, FW_MINOR_VERSION, FW_PATCH_VERSION);
   parseSpecialFunctionToStr(deviceStatus.special_function, sizeof(deviceStatus.special_function), special_function);
@@ -2111,7 +2246,7 @@ DeviceStatusStamp getDeviceStatusStamp()
 
 void submitLog(const char *format, time_t time, int line, const char *file, ...)
 {
-  uint32_t log_id = preferences.getUInt(PREFERENCES_LOG_ID_KEY, 1);
+  uint32_t log_id = settings.getUInt(PREFERENCES_LOG_ID_KEY, 1);
 
   char log_message[1024];
 
@@ -2129,16 +2264,23 @@ void submitLog(const char *format, time_t time, int line, const char *file, ...)
       .sourceFile = file,
       .logMessage = log_message,
       .logId = log_id,
-      .filenameCurrent = preferences.getString(PREFERENCES_FILENAME_KEY, ""),
+      .filenameCurrent = settings.getString(PREFERENCES_FILENAME_KEY, ""),
       .filenameNew = new_filename,
       .logRetry = log_retry,
-      .retryAttempt = log_retry ? preferences.getInt(PREFERENCES_CONNECT_API_RETRY_COUNT) : 0};
+      .retryAttempt = log_retry ? settings.getInt(PREFERENCES_CONNECT_API_RETRY_COUNT) : 0};
+
+  char flight_report[FLIGHT_RECORDER_REPORT_SIZE];
+  if (flight_recorder_take_report(flight_record, flight_report, sizeof(flight_report)) > 0)
+    input.flightRecord = flight_report;
 
   String json_string = serialize_log(input);
 
+  // something went wrong: print the deferred context that led up to it
+  Log_flush();
+
   submitOrSaveLogString(json_string.c_str(), json_string.length());
 
-  preferences.putUInt(PREFERENCES_LOG_ID_KEY, ++log_id);
+  settings.putUInt(PREFERENCES_LOG_ID_KEY, ++log_id);
 }
 
 void log_nvs_usage()
@@ -2156,4 +2298,55 @@ void log_nvs_usage()
   {
     Log_error("Failed to get NVS stats: %s", esp_err_to_name(ret));
   }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Function to cache the panel-ready framebuffer of the image just shown, observer of the display
+ * @param framebuffer framebuffer sent to the panel
+ * @param size size of the framebuffer
+ * @return none
+ */
+static void cacheFramebuffer(const uint8_t *framebuffer, size_t size)
+{
+  if (framebufferName.length() == 0)
+    return;
+  image_store_save_framebuffer(framebufferName.c_str(), framebuffer, size);
+  framebufferName = "";
+}
+
+/**
+ * @brief Function to record the phase of the wake in RTC memory, sampling the heap
+ * The deferred log is printed before the device sleeps or restarts.
+ * @param phase phase being entered
+ * @return none
+ */
+static void flightPhase(FlightPhase phase)
+{
+  flight_recorder_phase(flight_record, phase, ESP.getMinFreeHeap(), ESP.getMaxAllocHeap());
+  heap_trace_phase(flight_phase_name(phase));
+  // the deferred log ring does not survive deep sleep or a restart
+  if (phase == FLIGHT_PHASE_SLEEP || phase == FLIGHT_PHASE_RESTART)
+    Log_flush();
+}
+
+/**
+ * @brief Function to keep the id of every log call in RTC memory
+ * @param record record of the call, pushed to the log ring in deferred builds
+ * @return none
+ */
+static void flightRecorderLog(const LogRingRecord &record)
+{
+  flight_recorder_log(flight_record, (uint32_t)(uintptr_t)record.format, ESP.getMinFreeHeap());
+}
+
+#ifdef HEAP_TRACE
+/**
+ * @brief Function to print one line of the heap trace summary
+ * @param line summary line
+ * @return none
+ */
+static void heapTraceLine(const char *line)
+{
+  Log.info("heap trace: %s\r\n", line);
+}
+#endif
@@ -41,4 +41,5 @@ ButtonPressResult read_button_presses()
 const char *ButtonPressResultNames[] = {
     "LongPress",
     "DoubleClick",
-    "NoAction"};
\ No newline at end of file
+    "NoAction",
+    "SoftReset"};
\ No newline at end of file
@@ -2,15 +2,87 @@
 #include "png_flip.h"
 #include <display.h>
 #include "DEV_Config.h"
-#include "EPD.h"
+#include <panel.h>
 #include "GUI_Paint.h"
 #include <config.h>
 #include <ImageData.h>
 #include <ctype.h> //iscntrl()
 #include <trmnl_log.h>
+#include <heap_trace.h>
+#include <lzss.h>
+#include <refresh_policy.h>
+#include <esp_sleep.h>
+#include <soc/soc_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+static const Panel *panel = nullptr;
+static uint8_t panel_mode = 0;                  // PanelMode the panel was initialized with, 0 while it sleeps
+static SemaphoreHandle_t panel_init_done = nullptr; // given by the task started by display_prepare()
+
+RTC_DATA_ATTR static RefreshState refresh_state;
+
+// band CRCs of a framebuffer sent with display_stream_write()
+static uint32_t stream_bands[REFRESH_BANDS];
+static size_t stream_offset = 0;
+static bool stream_full = true;
+
+/**
+ * @brief Function to get the panel being driven
+ * @param none
+ * @return const Panel& the panel, found in the registry on first use
+ */
+static const Panel &display_panel(void)
+{
+    if (!panel)
+        panel = &panel_default();
+    return *panel;
+}
+
+/**
+ * @brief Function to wait for the panel init started by display_prepare()
+ * @param none
+ * @return none
+ */
+static void display_panel_wait(void)
+{
+    if (!panel_init_done)
+        return;
+    xSemaphoreTake(panel_init_done, portMAX_DELAY);
+    vSemaphoreDelete(panel_init_done);
+    panel_init_done = nullptr;
+}
+
+/**
+ * @brief Function to make sure the panel is initialized for a waveform before it is sent anything
+ * @param mode waveform
+ * @return none
+ */
+static void display_panel_init(PanelMode mode)
+{
+    display_panel_wait();
+    if (panel_mode != mode)
+    {
+        display_panel().init(mode);
+        panel_mode = mode;
+    }
+}
+
+/**
+ * @brief Function of the task that initializes the panel in the background
+ * @param arg PanelMode to init with
+ * @return none
+ */
+static void display_panel_init_task(void *arg)
+{
+    display_panel().init((PanelMode)(uintptr_t)arg);
+    xSemaphoreGive(panel_init_done);
+    vTaskDelete(NULL);
+}
 
 /**
  * @brief Function to init the display
+ * The panel itself is initialized on the first draw, or by display_prepare().
  * @param none
  * @return none
  */
@@ -19,10 +91,7 @@ void display_init(void)
     Log_info("dev module start");
     DEV_Module_Init();
     Log_info("dev module end");
-
-    Log_info("screen hw start");
-    EPD_7IN5_V2_Init_New();
-    Log_info("screen hw end");
+    Log_info("panel %s", display_panel().name);
 }
 
 /**
@@ -33,7 +102,8 @@ void display_init(void)
 void display_reset(void)
 {
     Log_info("e-Paper Clear start");
-    EPD_7IN5_V2_Clear();
+    display_panel_init(PANEL_MODE_FULL);
+    display_panel().refresh();
     Log_info("e-Paper Clear end");
     // DEV_Delay_ms(500);
 }
@@ -44,7 +114,7 @@ void display_reset(void)
  */
 uint16_t display_height()
 {
-    return EPD_7IN5_V2_HEIGHT;
+    return display_panel().height;
 }
 
 /**
@@ -53,16 +123,56 @@ uint16_t display_height()
  */
 uint16_t display_width()
 {
-    return EPD_7IN5_V2_WIDTH;
+    return display_panel().width;
+}
+
+/**
+ * @brief Function to draw UTF-8 text in a proportional font
+ * @param x_start X coordinate of the pen
+ * @param y_start Y coordinate of the top of the text
+ * @param text UTF-8 text
+ * @param length number of bytes to draw
+ * @param font Font to use
+ * @param color_fg Foreground color
+ * @param color_bg Background color, FONT_BACKGROUND to leave it
+ * @return none
+ */
+void Paint_DrawPropText(UWORD x_start, UWORD y_start, const char *text, size_t length,
+                        const PropFont &font, UWORD color_fg, UWORD color_bg)
+{
+    const char *end = text + length;
+    UWORD x = x_start;
+    while (text < end && *text && x < display_width())
+    {
+        const PropGlyph &glyph = prop_font_glyph(font, utf8_next(text));
+        if (glyph.width)
+        {
+            Paint_DrawGlyph(x + glyph.x_offset, y_start, font.bitmaps + glyph.offset, glyph.width, font.height,
+                            color_fg, color_bg);
+        }
+        x += glyph.advance;
+    }
+}
+
+/**
+ * @brief Function to draw a line of text centered on the display
+ * @param y_start Y coordinate of the top of the text
+ * @param text UTF-8 text
+ * @return none
+ */
+static void Paint_DrawCenteredText(UWORD y_start, const char *text)
+{
+    uint16_t text_width = prop_font_text_width(PropFont24, text, strlen(text));
+    UWORD x_start = text_width < display_width() ? (display_width() - text_width) / 2 : 0;
+    Paint_DrawPropText(x_start, y_start, text, strlen(text), PropFont24, BLACK, WHITE);
 }
 
 /**
  * @brief Function to draw multi-line text onto the display
  * @param x_start X coordinate to start drawing
  * @param y_start Y coordinate to start drawing
- * @param message Text message to draw
+ * @param message UTF-8 text message to draw
  * @param max_width Maximum width in pixels for each line
- * @param font_width Width of a single character in pixels
  * @param color_fg Foreground color
  * @param color_bg Background color
  * @param font Font to use
@@ -70,148 +180,176 @@ uint16_t display_width()
  * @return none
  */
 void Paint_DrawMultilineText(UWORD x_start, UWORD y_start, const char *message,
-                             uint16_t max_width, uint16_t font_width,
-                             UWORD color_fg, UWORD color_bg, sFONT *font,
-                             bool is_center_aligned)
+                             uint16_t max_width, UWORD color_fg, UWORD color_bg,
+                             const PropFont &font, bool is_center_aligned)
 {
-    uint16_t display_width_pixels = max_width;
-    int max_chars_per_line = display_width_pixels / font_width;
+    const uint8_t MAX_LINES = 4;
+    PropFontLine lines[MAX_LINES];
+    size_t line_count = prop_font_wrap(font, message, max_width, lines, MAX_LINES);
 
-    uint8_t MAX_LINES = 4;
-
-    char lines[MAX_LINES][max_chars_per_line + 1] = {0};
-    uint16_t line_count = 0;
-
-    int text_len = strlen(message);
-    int current_width = 0;
-    int line_index = 0;
-    int line_pos = 0;
-    int word_start = 0;
-    int i = 0;
-    char word_buffer[max_chars_per_line + 1] = {0};
-    int word_length = 0;
-
-    while (i <= text_len && line_index < MAX_LINES)
+    for (size_t j = 0; j < line_count; j++)
     {
-        word_length = 0;
-        word_start = i;
-
-        // Skip leading spaces
-        while (i < text_len && message[i] == ' ')
+        uint16_t draw_x = x_start;
+        if (is_center_aligned && lines[j].width < max_width)
         {
-            i++;
+            draw_x = x_start + (max_width - lines[j].width) / 2;
         }
-        word_start = i;
 
-        // Find end of word or end of text
-        while (i < text_len && message[i] != ' ')
-        {
-            i++;
-        }
+        Paint_DrawPropText(draw_x, y_start + j * (font.height + 5), lines[j].start, lines[j].length, font,
+                           color_fg, color_bg);
+    }
+}
 
-        word_length = i - word_start;
-        if (word_length > max_chars_per_line)
-        {
-            word_length = max_chars_per_line; // Truncate if word is too long
-        }
+/**
+ * @brief Function to decompress a built-in image into the framebuffer, a row at a time
+ * @param image compressed image
+ * @param x_start X coordinate, a multiple of 8
+ * @param y_start Y coordinate
+ * @return none
+ */
+static void Paint_DrawCompressedImage(const CompressedImage &image, UWORD x_start, UWORD y_start)
+{
+    UWORD row_bytes = (image.width + 7) / 8;
+    if (x_start / 8 + row_bytes > Paint.WidthByte || y_start + image.height > Paint.HeightByte)
+    {
+        Log_error("image does not fit at %d,%d", x_start, y_start);
+        return;
+    }
 
-        if (word_length > 0)
-        {
-            strncpy(word_buffer, message + word_start, word_length);
-            word_buffer[word_length] = '\0';
-        }
-        else
+    LzssDecoder decoder;
+    lzss_decoder_init(decoder, image.data, image.size);
+    for (UWORD y = 0; y < image.height; y++)
+    {
+        UBYTE *row = Paint.Image + (UDOUBLE)(y_start + y) * Paint.WidthByte + x_start / 8;
+        if (lzss_decode(decoder, row, row_bytes) != row_bytes)
         {
-            i++;
-            continue;
+            Log_error("built-in image is corrupt");
+            return;
         }
+    }
+}
 
-        int word_width = word_length * font_width;
+/**
+ * @brief Function to draw a full screen BMP, or the built-in logo without one
+ * @param image_buffer BMP file, or nullptr
+ * @return none
+ */
+static void Paint_DrawBitMapOrLogo(const uint8_t *image_buffer)
+{
+    if (image_buffer)
+        Paint_DrawBitMap(image_buffer + 62);
+    else
+        Paint_DrawCompressedImage(default_icon, 0, 0);
+}
 
-        // Check if adding the word exceeds max_width
-        if (current_width + word_width + (current_width > 0 ? font_width : 0) <= display_width_pixels)
-        {
-            // Add space before word if not the first word in the line
-            if (current_width > 0 && line_pos < max_chars_per_line - 1)
-            {
-                lines[line_index][line_pos++] = ' ';
-                current_width += font_width;
-            }
-
-            // Add word to current line
-            if (line_pos + word_length <= max_chars_per_line)
-            {
-                strcpy(&lines[line_index][line_pos], word_buffer);
-                line_pos += word_length;
-                current_width += word_width;
-            }
-        }
-        else
-        {
-            // Current line is full, draw it
-            if (line_pos > 0)
-            {
-                lines[line_index][line_pos] = '\0'; // Null-terminate the current line
-                line_index++;
-                line_count++;
-
-                if (line_index >= MAX_LINES)
-                {
-                    break;
-                }
-
-                // Start new line with this word
-                strncpy(lines[line_index], word_buffer, word_length);
-                line_pos = word_length;
-                current_width = word_width;
-            }
-            else
-            {
-                // Single long word case
-                strncpy(lines[line_index], word_buffer, max_chars_per_line);
-                lines[line_index][max_chars_per_line] = '\0';
-                line_index++;
-                line_count++;
-                line_pos = 0;
-                current_width = 0;
-            }
-        }
+/**
+ * @brief Function to read the temperature for the refresh policy
+ * @param none
+ * @return int16_t degrees C of the chip, which is close to ambient after deep sleep
+ */
+static int16_t display_temperature(void)
+{
+#if SOC_TEMP_SENSOR_SUPPORTED
+    return (int16_t)lroundf(temperatureRead());
+#else
+    return REFRESH_NO_TEMPERATURE;
+#endif
+}
 
-        // Move to next word
-        if (message[i] == ' ')
-        {
-            i++;
-        }
-    }
+/**
+ * @brief Function to choose the waveform of the next refresh
+ * @param dirty_percent share of the image that changes, 0 if unknown
+ * @param temperature from display_temperature()
+ * @param choice set to the reason for the waveform
+ * @return PanelMode PANEL_MODE_FAST or PANEL_MODE_FULL
+ */
+static PanelMode display_refresh_mode(uint8_t dirty_percent, int16_t temperature, RefreshChoice &choice)
+{
+    bool timer_wake = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+    choice = refresh_choose(refresh_state, timer_wake, temperature, dirty_percent);
+    if (choice == REFRESH_FAST && (display_panel().modes & PANEL_MODE_FAST))
+        return PANEL_MODE_FAST;
+    return PANEL_MODE_FULL;
+}
+
+/**
+ * @brief Function to choose the waveform of the next refresh and init the panel for it
+ * @param dirty_percent share of the image that changes, 0 if unknown
+ * @param temperature from display_temperature()
+ * @return bool true for a full refresh
+ */
+static bool display_prepare_refresh(uint8_t dirty_percent, int16_t temperature)
+{
+    RefreshChoice choice;
+    PanelMode mode = display_refresh_mode(dirty_percent, temperature, choice);
+    Log_info("refresh: %s, %d%% changed", refresh_choice_name(choice), dirty_percent);
 
-    // Store the last line if any
-    if (line_pos > 0 && line_index < MAX_LINES)
+    display_panel_init(mode);
+    return mode == PANEL_MODE_FULL;
+}
+
+/**
+ * @brief Function to start initializing the panel in the background
+ * @param none
+ * @return none
+ */
+void display_prepare(void)
+{
+    if (panel_mode || panel_init_done)
+        return;
+    panel_init_done = xSemaphoreCreateBinary();
+    if (!panel_init_done)
+        return;
+
+    // the image is not known yet: expect it to change as much as the last one did, so a
+    // playlist that replaces the whole screen is prepared for the full waveform it will need
+    RefreshChoice choice;
+    PanelMode mode = display_refresh_mode(refresh_state.dirty_percent, display_temperature(), choice);
+    // the task owns the panel until it gives panel_init_done, every other user waits for it first
+    panel_mode = mode;
+    if (xTaskCreate(display_panel_init_task, "panel_init", 2048, (void *)(uintptr_t)mode, uxTaskPriorityGet(NULL), NULL) != pdPASS)
     {
-        lines[line_index][line_pos] = '\0';
-        line_count++;
+        Log_error("panel init task not started");
+        vSemaphoreDelete(panel_init_done);
+        panel_init_done = nullptr;
+        panel_mode = 0;
+        return;
     }
+    Log_info("panel init started for the %s waveform", mode == PANEL_MODE_FAST ? "fast" : "full");
+}
 
-    // Draw the lines
-    for (int j = 0; j < line_count; j++)
-    {
-        uint16_t line_width = strlen(lines[j]) * font_width;
-        uint16_t draw_x = x_start;
+/**
+ * @brief Function to send a framebuffer to the panel and refresh it with the waveform the policy picks
+ * @param framebuffer panel-ready framebuffer
+ * @param size size of the framebuffer
+ * @return none
+ */
+static void display_refresh(const uint8_t *framebuffer, size_t size)
+{
+    uint32_t bands[REFRESH_BANDS] = {0};
+    refresh_bands_update(bands, size, 0, framebuffer, size);
+    int16_t temperature = display_temperature();
 
-        if (is_center_aligned)
-        {
-            if (line_width < max_width)
-            {
-                draw_x = x_start + (max_width - line_width) / 2;
-            }
-        }
+    bool full = display_prepare_refresh(refresh_dirty_percent(refresh_state, bands), temperature);
+    panel_show(display_panel(), framebuffer);
+    refresh_record(refresh_state, full, temperature, bands);
+}
 
-        Paint_DrawString_EN(draw_x, y_start + j * (font->Height + 5), lines[j], font, color_fg, color_bg);
-    }
+static DisplayFramebufferObserver framebuffer_observer = nullptr;
+
+/**
+ * @brief Function to set the function that receives every framebuffer shown by display_show_image()
+ * @param observer function to call, or nullptr
+ * @return none
+ */
+void display_set_framebuffer_observer(DisplayFramebufferObserver observer)
+{
+    framebuffer_observer = observer;
 }
 
 /**
  * @brief Function to show the image on the display
- * @param image_buffer pointer to the uint8_t image buffer
+ * @param image_buffer pointer to the uint8_t image buffer, nullptr for the built-in logo
  * @param reverse shows if the color scheme is reverse
  * @return none
  */
@@ -224,9 +362,9 @@ void display_show_image(uint8_t *image_buffer, bool reverse, bool isPNG)
     /* you have to edit the startup_stm32fxxx.s file and set a big enough heap size */
     UWORD Imagesize = ((width % 8 == 0) ? (width / 8) : (width / 8 + 1)) * height;
     
-    Log_error("free heap - %d", ESP.getFreeHeap());
-    Log_error("free alloc heap - %d", ESP.getMaxAllocHeap());
-    if ((BlackImage = (UBYTE *)malloc(Imagesize)) == NULL)
+    Log_verbose("free heap - %d", ESP.getFreeHeap());
+    Log_verbose("free alloc heap - %d", ESP.getMaxAllocHeap());
+    if ((BlackImage = (UBYTE *)heap_trace_malloc(Imagesize, "framebuffer")) == NULL)
     {
         Log_fatal("Failed to apply for black memory...");
         ESP.restart();
@@ -238,7 +376,7 @@ void display_show_image(uint8_t *image_buffer, bool reverse, bool isPNG)
     Log_info("show image for array");
     Paint_SelectImage(BlackImage);
     Paint_Clear(WHITE);
-    if (reverse)
+    if (reverse && image_buffer)
     {
         Log_info("inverse the image");
         for (size_t i = 0; i < DISPLAY_BMP_IMAGE_SIZE; i++)
@@ -255,18 +393,72 @@ void display_show_image(uint8_t *image_buffer, bool reverse, bool isPNG)
     }
     else
     {
-        Paint_DrawBitMap(image_buffer + 62);
+        Paint_DrawBitMapOrLogo(image_buffer);
     }
-    EPD_7IN5_V2_Display(BlackImage);
+    display_refresh(BlackImage, Imagesize);
     Log_info("display");
 
-    free(BlackImage);
+    if (framebuffer_observer)
+        framebuffer_observer(BlackImage, Imagesize);
+
+    heap_trace_free(BlackImage);
     BlackImage = NULL;
 }
 
+/**
+ * @brief Function to start sending a framebuffer to the display piece by piece
+ * @param none
+ * @return none
+ */
+void display_stream_begin(void)
+{
+    // the panel has to be initialized for the waveform before the data is sent, so
+    // the changed area is not known yet: guess it as display_prepare() did
+    stream_full = display_prepare_refresh(refresh_state.dirty_percent, display_temperature());
+    memset(stream_bands, 0, sizeof(stream_bands));
+    stream_offset = 0;
+    display_panel().write_begin();
+}
+
+/**
+ * @brief Function to send the next piece of a framebuffer
+ * @param data framebuffer bytes, as passed to the framebuffer observer
+ * @param size number of bytes
+ * @return none
+ */
+void display_stream_write(const uint8_t *data, size_t size)
+{
+    refresh_bands_update(stream_bands, (size_t)display_width() / 8 * display_height(), stream_offset, data, size);
+    stream_offset += size;
+    display_panel().write(data, size);
+}
+
+/**
+ * @brief Function to refresh the display with the framebuffer sent since display_stream_begin()
+ * @param none
+ * @return none
+ */
+void display_stream_end(void)
+{
+    display_panel().write_end();
+    refresh_record(refresh_state, stream_full, display_temperature(), stream_bands);
+    Log_info("display");
+}
+
+/**
+ * @brief Function to drop the framebuffer sent since display_stream_begin() without refreshing
+ * @param none
+ * @return none
+ */
+void display_stream_abort(void)
+{
+    Log_info("framebuffer stream dropped");
+    display_sleep();
+}
+
 /**
  * @brief Function to show the image with message on the display
- * @param image_buffer pointer to the uint8_t image buffer
+ * @param image_buffer pointer to the uint8_t image buffer, nullptr for the built-in logo
  * @param message_type type of message that will show on the screen
  * @return none
  */
@@ -277,9 +469,9 @@ void display_show_msg(uint8_t *image_buffer, MSG message_type)
     UBYTE *BlackImage;
     /* you have to edit the startup_stm32fxxx.s file and set a big enough heap size */
     UWORD Imagesize = ((width % 8 == 0) ? (width / 8) : (width / 8 + 1)) * height;
-    Log_error("free heap - %d", ESP.getFreeHeap());
-    Log_error("free alloc heap - %d", ESP.getMaxAllocHeap());
-    if ((BlackImage = (UBYTE *)malloc(Imagesize)) == NULL)
+    Log_verbose("free heap - %d", ESP.getFreeHeap());
+    Log_verbose("free alloc heap - %d", ESP.getMaxAllocHeap());
+    if ((BlackImage = (UBYTE *)heap_trace_malloc(Imagesize, "framebuffer")) == NULL)
     {
         Log_fatal("Failed to apply for black memory...");
         ESP.restart();
@@ -291,91 +483,91 @@ void display_show_msg(uint8_t *image_buffer, MSG message_type)
     Log_info("show image for array");
     Paint_SelectImage(BlackImage);
     Paint_Clear(WHITE);
-    Paint_DrawBitMap(image_buffer + 62);
+    Paint_DrawBitMapOrLogo(image_buffer);
     switch (message_type)
     {
     case WIFI_CONNECT:
     {
         char string1[] = "Connect to TRMNL WiFi";
-        Paint_DrawString_EN((800 - sizeof(string1) * 17 > 9) ? (800 - sizeof(string1) * 17) / 2 + 9 : 0, 400, string1, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string1);
         char string2[] = "on your phone or computer";
-        Paint_DrawString_EN((800 - sizeof(string2) * 17 > 9) ? (800 - sizeof(string2) * 17) / 2 + 9 : 0, 430, string2, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(430, string2);
     }
     break;
     case WIFI_FAILED:
     {
         char string1[] = "Can't establish WiFi";
-        Paint_DrawString_EN((800 - sizeof(string1) * 17 > 9) ? (800 - sizeof(string1) * 17) / 2 + 9 : 0, 340, string1, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(340, string1);
         char string2[] = "connection. Hold button on";
-        Paint_DrawString_EN((800 - sizeof(string2) * 17 > 9) ? (800 - sizeof(string2) * 17) / 2 + 9 : 0, 370, string2, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(370, string2);
         char string3[] = "the back to reset WiFi";
-        Paint_DrawString_EN((800 - sizeof(string3) * 17 > 9) ? (800 - sizeof(string3) * 17) / 2 + 9 : 0, 400, string3, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string3);
         char string4[] = "or scan QR Code for help.";
-        Paint_DrawString_EN((800 - sizeof(string4) * 17 > 9) ? (800 - sizeof(string4) * 17) / 2 + 9 : 0, 430, string4, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(430, string4);
 
-        Paint_DrawImage(wifi_failed_qr, 640, 337, 130, 130);
+        Paint_DrawCompressedImage(wifi_failed_qr, 640, 337);
     }
     break;
     case WIFI_INTERNAL_ERROR:
     {
         char string1[] = "WiFi connected, but";
-        Paint_DrawString_EN((800 - sizeof(string1) > 9) * 17 ? (800 - sizeof(string1) * 17) / 2 + 9 : 0, 340, string1, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(340, string1);
         char string2[] = "API connection cannot be";
-        Paint_DrawString_EN((800 - sizeof(string2) > 9) * 17 ? (800 - sizeof(string2) * 17) / 2 + 9 : 0, 370, string2, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(370, string2);
         char string3[] = "established. Try to refresh,";
-        Paint_DrawString_EN((800 - sizeof(string3) > 9) * 17 ? (800 - sizeof(string3) * 17) / 2 + 9 : 0, 400, string3, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string3);
         char string4[] = "or scan QR Code for help.";
-        Paint_DrawString_EN((800 - sizeof(string4) > 9) * 17 ? (800 - sizeof(string4) * 17) / 2 + 9 : 0, 430, string4, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(430, string4);
 
-        Paint_DrawImage(wifi_failed_qr, 640, 337, 130, 130);
+        Paint_DrawCompressedImage(wifi_failed_qr, 640, 337);
     }
     break;
     case WIFI_WEAK:
     {
         char string1[] = "WiFi connected but signal is weak";
-        Paint_DrawString_EN((800 - sizeof(string1) > 9) * 17 ? (800 - sizeof(string1) * 17) / 2 + 9 : 0, 400, string1, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string1);
     }
     break;
     case API_ERROR:
     {
         char string1[] = "WiFi connected, TRMNL not responding.";
-        Paint_DrawString_EN((800 - sizeof(string1) > 9) * 17 ? (800 - sizeof(string1) * 17) / 2 + 9 : 0, 340, string1, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(340, string1);
         char string2[] = "Short click the button on back,";
-        Paint_DrawString_EN((800 - sizeof(string2) > 9) * 17 ? (800 - sizeof(string2) * 17) / 2 + 9 : 0, 400, string2, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string2);
         char string3[] = "otherwise check your internet.";
-        Paint_DrawString_EN((800 - sizeof(string3) > 9) * 17 ? (800 - sizeof(string3) * 17) / 2 + 9 : 0, 430, string3, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(430, string3);
     }
     break;
     case API_SIZE_ERROR:
     {
         char string1[] = "WiFi connected, TRMNL content malformed.";
-        Paint_DrawString_EN((800 - sizeof(string1) > 9) * 17 ? (800 - sizeof(string1) * 17) / 2 + 9 : 0, 400, string1, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string1);
         char string2[] = "Wait or reset by holding button on back.";
-        Paint_DrawString_EN((800 - sizeof(string2) > 9) * 17 ? (800 - sizeof(string2) * 17) / 2 + 9 : 0, 430, string2, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(430, string2);
     }
     break;
     case FW_UPDATE:
     {
         char string1[] = "Firmware update available! Starting now...";
-        Paint_DrawString_EN((800 - sizeof(string1) > 9) * 17 ? (800 - sizeof(string1) * 17) / 2 + 9 : 0, 400, string1, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string1);
     }
     break;
     case FW_UPDATE_FAILED:
     {
         char string1[] = "Firmware update failed. Device will restart...";
-        Paint_DrawString_EN((800 - sizeof(string1) > 9) * 17 ? (800 - sizeof(string1) * 17) / 2 + 9 : 0, 400, string1, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string1);
     }
     break;
     case FW_UPDATE_SUCCESS:
     {
         char string1[] = "Firmware update success. Device will restart..";
-        Paint_DrawString_EN((800 - sizeof(string1) > 9) * 17 ? (800 - sizeof(string1) * 17) / 2 + 9 : 0, 400, string1, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string1);
     }
     break;
     case BMP_FORMAT_ERROR:
     {
         char string1[] = "The image format is incorrect";
-        Paint_DrawString_EN((800 - sizeof(string1) > 9) * 17 ? (800 - sizeof(string1) * 17) / 2 + 9 : 0, 400, string1, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string1);
     }
     break;
     case TEST:
@@ -390,15 +582,15 @@ void display_show_msg(uint8_t *image_buffer, MSG message_type)
         break;
     }
 
-    EPD_7IN5_V2_Display(BlackImage);
+    display_refresh(BlackImage, Imagesize);
     Log_info("display");
-    free(BlackImage);
+    heap_trace_free(BlackImage);
     BlackImage = NULL;
 }
 
 /**
  * @brief Function to show the image with message on the display
- * @param image_buffer pointer to the uint8_t image buffer
+ * @param image_buffer pointer to the uint8_t image buffer, nullptr for the built-in logo
  * @param message_type type of message that will show on the screen
  * @param friendly_id device friendly ID
  * @param id shows if ID exists
@@ -411,7 +603,8 @@ void display_show_msg(uint8_t *image_buffer, MSG message_type, String friendly_i
     if (message_type == WIFI_CONNECT)
     {
         Log_info("Display set to white");
-        EPD_7IN5_V2_ClearWhite();
+        display_panel_init(PANEL_MODE_FULL);
+        display_panel().clear();
         delay(1000);
     }
 
@@ -420,9 +613,9 @@ void display_show_msg(uint8_t *image_buffer, MSG message_type, String friendly_i
     UBYTE *BlackImage;
     /* you have to edit the startup_stm32fxxx.s file and set a big enough heap size */
     UWORD Imagesize = ((width % 8 == 0) ? (width / 8) : (width / 8 + 1)) * height;
-    Log_error("free heap - %d", ESP.getFreeHeap());
-    Log_error("free alloc heap - %d", ESP.getMaxAllocHeap());
-    if ((BlackImage = (UBYTE *)malloc(Imagesize)) == NULL)
+    Log_verbose("free heap - %d", ESP.getFreeHeap());
+    Log_verbose("free alloc heap - %d", ESP.getMaxAllocHeap());
+    if ((BlackImage = (UBYTE *)heap_trace_malloc(Imagesize, "framebuffer")) == NULL)
     {
         Log_fatal("Failed to apply for black memory...");
         ESP.restart();
@@ -434,14 +627,14 @@ void display_show_msg(uint8_t *image_buffer, MSG message_type, String friendly_i
     Log_info("show image for array");
     Paint_SelectImage(BlackImage);
     Paint_Clear(WHITE);
-    Paint_DrawBitMap(image_buffer + 62);
+    Paint_DrawBitMapOrLogo(image_buffer);
     switch (message_type)
     {
     case FRIENDLY_ID:
     {
         Log_info("friendly id case");
         char string1[] = "Please sign up at usetrmnl.com/signup";
-        Paint_DrawString_EN((800 - sizeof(string1) * 17 > 9) ? (800 - sizeof(string1) * 17) / 2 + 9 : 0, 400, string1, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string1);
 
         String string2 = "with Friendly ID ";
         if (id)
@@ -449,7 +642,7 @@ void display_show_msg(uint8_t *image_buffer, MSG message_type, String friendly_i
             string2 += friendly_id;
         }
         string2 += " to finish setup";
-        Paint_DrawString_EN((800 - string2.length() * 17 > 9) ? (800 - string2.length() * 17) / 2 + 9 : 0, 430, string2.c_str(), &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(430, string2.c_str());
     }
     break;
     case WIFI_CONNECT:
@@ -458,30 +651,30 @@ void display_show_msg(uint8_t *image_buffer, MSG message_type, String friendly_i
 
         String string1 = "FW: ";
         string1 += fw_version;
-        Paint_DrawString_EN((800 - string1.length() * 17 > 9) ? (800 - string1.length() * 17) / 2 + 9 : 0, 340, string1.c_str(), &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(340, string1.c_str());
         char string2[] = "Connect phone or computer";
-        Paint_DrawString_EN((800 - sizeof(string2) * 17 > 9) ? (800 - sizeof(string2) * 17) / 2 + 9 : 0, 370, string2, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(370, string2);
         char string3[] = "to \"TRMNL\" WiFi network";
-        Paint_DrawString_EN((800 - sizeof(string3) * 17 > 9) ? (800 - sizeof(string3) * 17) / 2 + 9 : 0, 400, string3, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(400, string3);
         char string4[] = "or scan QR code for help.";
-        Paint_DrawString_EN((800 - sizeof(string4) * 17 > 9) ? (800 - sizeof(string4) * 17) / 2 + 9 : 0, 430, string4, &Font24, WHITE, BLACK);
+        Paint_DrawCenteredText(430, string4);
 
-        Paint_DrawImage(wifi_connect_qr, 640, 337, 130, 130);
+        Paint_DrawCompressedImage(wifi_connect_qr, 640, 337);
     }
     break;
     case MAC_NOT_REGISTERED:
     {
         UWORD y_start = 340;
-        Paint_DrawMultilineText(0, y_start, message.c_str(), width, Font24.Width, WHITE, BLACK, &Font24, true);
+        Paint_DrawMultilineText(0, y_start, message.c_str(), width, BLACK, WHITE, PropFont24, true);
     }
     break;
     default:
         break;
     }
     Log_info("Start drawing...");
-    EPD_7IN5_V2_Display(BlackImage);
+    display_refresh(BlackImage, Imagesize);
     Log_info("display");
-    free(BlackImage);
+    heap_trace_free(BlackImage);
     BlackImage = NULL;
 }
 
@@ -492,6 +685,13 @@ void display_show_msg(uint8_t *image_buffer, MSG message_type, String friendly_i
  */
 void display_sleep(void)
 {
+    display_panel_wait();
+    if (!panel_mode)
+    {
+        Log_info("panel not initialized, nothing to put to sleep");
+        return;
+    }
     Log_info("Goto Sleep...");
-    EPD_7IN5B_V2_Sleep();
+    display_panel().sleep();
+    panel_mode = 0;
 }
@@ -1,7 +1,103 @@
 #include <filesystem.h>
 #include <Arduino.h>
-#include <SPIFFS.h>
 #include <trmnl_log.h>
+#include <file_index.h>
+#include <heap_trace.h>
+
+// LittleFS unless built with FILESYSTEM_SPIFFS; both use the "spiffs" data partition
+#ifdef FILESYSTEM_SPIFFS
+#include <SPIFFS.h>
+#define FILESYSTEM SPIFFS
+#define FILESYSTEM_NAME "SPIFFS"
+#else
+#include <LittleFS.h>
+#include <SPIFFS.h>
+#define FILESYSTEM LittleFS
+#define FILESYSTEM_NAME "LittleFS"
+#endif
+
+#define FILESYSTEM_TEMP_FILE "/tmp.img"
+
+// which files exist, so most exists() calls never reach the flash
+static FileIndex fileIndex;
+
+static bool fileExists(const char *name)
+{
+    switch (file_index_lookup(fileIndex, name))
+    {
+    case FILE_INDEX_PRESENT:
+        return true;
+    case FILE_INDEX_ABSENT:
+        return false;
+    default:
+        return FILESYSTEM.exists(name);
+    }
+}
+
+/** Logs the files and fills the index: the only directory walk of a wake */
+static void scanFiles(void)
+{
+    Log_info("Filesystem Usage: %d/%d", FILESYSTEM.usedBytes(), FILESYSTEM.totalBytes());
+    file_index_reset(fileIndex, true);
+    File rootDir = FILESYSTEM.open("/");
+
+    while (File file = rootDir.openNextFile())
+    {
+        Log_info("  %d  %s", file.size(), file.name());
+        if (file.isDirectory())
+            continue;
+        file_index_add(fileIndex, file.name());
+    }
+    rootDir.close();
+}
+
+#ifndef FILESYSTEM_SPIFFS
+#define FILESYSTEM_LEGACY_LOGO "/logo.bmp"
+
+/**
+ * @brief Function to format the partition the firmware before LittleFS left as SPIFFS, keeping the setup logo:
+ * it is only fetched during setup, so a registered device would never get it back
+ * @param none
+ * @return bool true if LittleFS is mounted
+ */
+static bool formatKeepingLogo(void)
+{
+    uint8_t *logo = nullptr;
+    size_t size = 0;
+    if (SPIFFS.begin(false))
+    {
+        File file = SPIFFS.open(FILESYSTEM_LEGACY_LOGO, FILE_READ);
+        if (file)
+        {
+            size = file.size();
+            logo = (uint8_t *)heap_trace_malloc(size, "legacy_logo");
+            if (logo && file.read(logo, size) != size)
+            {
+                heap_trace_free(logo);
+                logo = nullptr;
+            }
+            file.close();
+        }
+        SPIFFS.end();
+        Log_info("SPIFFS found, logo %s", logo ? "kept" : "not found");
+    }
+
+    if (!LittleFS.begin(true))
+    {
+        heap_trace_free(logo);
+        return false;
+    }
+    if (logo)
+    {
+        File file = LittleFS.open(FILESYSTEM_LEGACY_LOGO, FILE_WRITE);
+        if (!file || file.write(logo, size) != size)
+            Log_error("file %s not carried over", FILESYSTEM_LEGACY_LOGO);
+        file.close();
+        heap_trace_free(logo);
+    }
+    return true;
+}
+#endif
 
 /**
  * @brief Function to init the filesystem
@@ -10,15 +106,28 @@
  */
 bool filesystem_init(void)
 {
-    if (!SPIFFS.begin(true))
+#ifdef FILESYSTEM_SPIFFS
+    bool mounted = FILESYSTEM.begin(true);
+#else
+    // only the first boot after moving from SPIFFS, or a blank partition, formats
+    bool mounted = FILESYSTEM.begin(false) || formatKeepingLogo();
+#endif
+    if (!mounted)
     {
-        Log_fatal("Failed to mount SPIFFS");
+        Log_fatal("Failed to mount " FILESYSTEM_NAME);
         ESP.restart();
         return false;
     }
     else
     {
-        Log_info("SPIFFS mounted");
+        Log_info(FILESYSTEM_NAME " mounted");
+        scanFiles();
+        // left over by a write that was interrupted before its rename
+        if (fileExists(FILESYSTEM_TEMP_FILE))
+        {
+            FILESYSTEM.remove(FILESYSTEM_TEMP_FILE);
+            file_index_remove(fileIndex, FILESYSTEM_TEMP_FILE);
+        }
         return true;
     }
 }
@@ -30,7 +139,8 @@ bool filesystem_init(void)
  */
 void filesystem_deinit(void)
 {
-    SPIFFS.end();
+    FILESYSTEM.end();
+    file_index_reset(fileIndex, false);
 }
 
 /**
@@ -41,10 +151,10 @@ void filesystem_deinit(void)
  */
 bool filesystem_read_from_file(const char *name, uint8_t *out_buffer, size_t size)
 {
-    if (SPIFFS.exists(name))
+    if (fileExists(name))
     {
         Log_info("file %s exists", name);
-        File file = SPIFFS.open(name, FILE_READ);
+        File file = FILESYSTEM.open(name, FILE_READ);
         if (file)
         {
             file.readBytes((char *)out_buffer, size);
@@ -63,6 +173,34 @@ bool filesystem_read_from_file(const char *name, uint8_t *out_buffer, size_t siz
     }
 }
 
+/**
+ * @brief Function to read a file piece by piece without buffering all of it
+ * @param name filename
+ * @param chunk buffer for one piece
+ * @param chunk_size size of the buffer
+ * @param reader function called with each piece
+ * @return size_t number of bytes read
+ */
+size_t filesystem_read_chunks(const char *name, uint8_t *chunk, size_t chunk_size, FilesystemChunkReader reader)
+{
+    File file = FILESYSTEM.open(name, FILE_READ);
+    if (!file)
+    {
+        Log_error("File %s open error", name);
+        return 0;
+    }
+
+    size_t total = 0;
+    size_t read;
+    while ((read = file.read(chunk, chunk_size)) > 0)
+    {
+        reader(chunk, read);
+        total += read;
+    }
+    file.close();
+    return total;
+}
+
 /**
  * @brief Function to write data to file
  * @param name filename
@@ -72,24 +210,12 @@ bool filesystem_read_from_file(const char *name, uint8_t *out_buffer, size_t siz
  */
 size_t filesystem_write_to_file(const char *name, uint8_t *in_buffer, size_t size)
 {
-    uint32_t SPIFFS_freeBytes = (SPIFFS.totalBytes() - SPIFFS.usedBytes());
-    Log_info("SPIFFS free space - %d, total -%d", SPIFFS_freeBytes, SPIFFS.totalBytes());
-    if (SPIFFS.exists(name))
-    {
-        Log_info("file %s exists. Deleting...", name);
-        if (SPIFFS.remove(name))
-            Log_info("file %s deleted", name);
-        else
-            Log_info("file %s deleting failed", name);
-    }
-    else
-    {
-        Log_info("file %s not exists.", name);
-    }
-    delay(100);
-    File file = SPIFFS.open(name, FILE_WRITE);
+    Log_info(FILESYSTEM_NAME " free space - %d, total -%d", filesystem_free_space(), FILESYSTEM.totalBytes());
+    // FILE_WRITE truncates an existing file, no need to delete it first
+    File file = FILESYSTEM.open(name, FILE_WRITE);
     if (file)
     {
+        file_index_add(fileIndex, name);
         // Write the buffer in chunks
         size_t bytesWritten = 0;
         while (bytesWritten < size)
@@ -101,21 +227,29 @@ size_t filesystem_write_to_file(const char *name, uint8_t *in_buffer, size_t siz
             if (res != chunkSize)
             {
                 file.close();
-
+#ifdef FILESYSTEM_SPIFFS
+                // a short write on SPIFFS usually means it is fragmented beyond repair
                 Log_info("Erasing SPIFFS...");
                 if (SPIFFS.format())
                 {
+                    file_index_reset(fileIndex, true);
                     Log_info("SPIFFS erased successfully.");
                 }
                 else
                 {
                     Log_error("Error erasing SPIFFS.");
                 }
-
+#else
+                // LittleFS only fails a write when it is full: drop the partial file, keep the rest
+                Log_error("file %s short write, filesystem full", name);
+                FILESYSTEM.remove(name);
+                file_index_remove(fileIndex, name);
+#endif
                 return bytesWritten;
             }
             bytesWritten += chunkSize;
         }
+        file.flush(); // fsync: the data is on flash once this returns
         Log_info("file %s writing success - %d bytes", name, bytesWritten);
         file.close();
         return bytesWritten;
@@ -127,6 +261,25 @@ size_t filesystem_write_to_file(const char *name, uint8_t *in_buffer, size_t siz
     }
 }
 
+/**
+ * @brief Function to write a file so that it holds either its old or its new content, even on power loss
+ * @param name filename
+ * @param in_buffer pointer to input buffer
+ * @param size size of the input buffer
+ * @return size of written bytes, 0 if the file was left unchanged
+ */
+size_t filesystem_write_atomic(const char *name, uint8_t *in_buffer, size_t size)
+{
+    size_t written = filesystem_write_to_file(FILESYSTEM_TEMP_FILE, in_buffer, size);
+    if (written != size)
+    {
+        FILESYSTEM.remove(FILESYSTEM_TEMP_FILE);
+        file_index_remove(fileIndex, FILESYSTEM_TEMP_FILE);
+        return 0;
+    }
+    return filesystem_file_replace(FILESYSTEM_TEMP_FILE, name) ? written : 0;
+}
+
 /**
  * @brief Function to check if file exists
  * @param name filename
@@ -134,7 +287,7 @@ size_t filesystem_write_to_file(const char *name, uint8_t *in_buffer, size_t siz
  */
 bool filesystem_file_exists(const char *name)
 {
-    if (SPIFFS.exists(name))
+    if (fileExists(name))
     {
         Log_info("file %s exists.", name);
         return true;
@@ -153,10 +306,11 @@ bool filesystem_file_exists(const char *name)
  */
 bool filesystem_file_delete(const char *name)
 {
-    if (SPIFFS.exists(name))
+    if (fileExists(name))
     {
-        if (SPIFFS.remove(name))
+        if (FILESYSTEM.remove(name))
         {
+            file_index_remove(fileIndex, name);
             Log_info("file %s deleted", name);
             return true;
         }
@@ -181,12 +335,13 @@ bool filesystem_file_delete(const char *name)
  */
 bool filesystem_file_rename(const char *old_name, const char *new_name)
 {
-    if (SPIFFS.exists(old_name))
+    if (fileExists(old_name))
     {
         Log_info("file %s exists.", old_name);
-        bool res = SPIFFS.rename(old_name, new_name);
+        bool res = FILESYSTEM.rename(old_name, new_name);
         if (res)
         {
+            file_index_rename(fileIndex, old_name, new_name);
             Log_info("file %s renamed to %s.", old_name, new_name);
             return true;
         }
@@ -201,14 +356,51 @@ bool filesystem_file_rename(const char *old_name, const char *new_name)
     }
 }
 
-void list_files()
+/**
+ * @brief Function to rename a file over another one
+ * @param old_name old filename
+ * @param new_name new filename, replaced if it exists
+ * @return result - true if success; false - if failed
+ */
+bool filesystem_file_replace(const char *old_name, const char *new_name)
 {
-    Log_info("Filesystem Usage: %d/%d", SPIFFS.usedBytes(), SPIFFS.totalBytes());
-    File rootDir = SPIFFS.open("/");
-
-    while (File file = rootDir.openNextFile())
+#ifdef FILESYSTEM_SPIFFS
+    // SPIFFS refuses to rename onto an existing file, so this is not atomic there
+    if (fileExists(new_name))
+        FILESYSTEM.remove(new_name);
+#endif
+    // LittleFS swaps the directory entry in a single metadata commit
+    if (FILESYSTEM.rename(old_name, new_name))
     {
-        Log_info("  %d  %s", file.size(), file.name());
+        file_index_rename(fileIndex, old_name, new_name);
+        Log_info("file %s renamed to %s.", old_name, new_name);
+        return true;
     }
-    rootDir.close();
+    Log_error("file %s wasn't renamed to %s.", old_name, new_name);
+    return false;
+}
+
+/**
+ * @brief Function to read the free space of the filesystem
+ * @param none
+ * @return size_t free bytes
+ */
+size_t filesystem_free_space(void)
+{
+    return FILESYSTEM.totalBytes() - FILESYSTEM.usedBytes();
+}
+
+/**
+ * @brief Function to get the mounted filesystem, for code that streams files itself
+ * @param none
+ * @return fs::FS& filesystem
+ */
+fs::FS &filesystem_fs(void)
+{
+    return FILESYSTEM;
+}
+
+void list_files()
+{
+    scanFiles();
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <flash_store.h>
+#include <wake_state.h>
+#include <esp_partition.h>
+#include <trmnl_log.h>
+
+#define FLASH_STORE_MAGIC 0x54524653 // "TRFS"
+#define FLASH_STORE_MAX_SLOTS 8
+
+static const esp_partition_t *partition = nullptr;
+
+struct MappedSlot
+{
+  spi_flash_mmap_handle_t handle;
+  const uint8_t *data; // points past the header; nullptr while unmapped
+  size_t size;
+};
+
+static MappedSlot mapped[FLASH_STORE_MAX_SLOTS];
+
+static void unmap(size_t slot)
+{
+  if (!mapped[slot].data)
+    return;
+  spi_flash_munmap(mapped[slot].handle);
+  mapped[slot].data = nullptr;
+}
+
+bool flash_store_init(void)
+{
+  partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, FLASH_STORE_PARTITION);
+  if (!partition)
+  {
+    Log_info("no " FLASH_STORE_PARTITION " partition, images stay on the filesystem");
+    return false;
+  }
+  Log_info(FLASH_STORE_PARTITION " partition: %d slots", flash_store_slot_count());
+  return true;
+}
+
+size_t flash_store_slot_count(void)
+{
+  if (!partition)
+    return 0;
+  size_t count = partition->size / FLASH_STORE_SLOT_SIZE;
+  return count < FLASH_STORE_MAX_SLOTS ? count : FLASH_STORE_MAX_SLOTS;
+}
+
+bool flash_store_header(size_t slot, FlashStoreHeader &header)
+{
+  if (slot >= flash_store_slot_count() ||
+      esp_partition_read(partition, slot * FLASH_STORE_SLOT_SIZE, &header, sizeof(header)) != ESP_OK)
+    return false;
+  return header.magic == FLASH_STORE_MAGIC && header.size <= FLASH_STORE_SLOT_SIZE - sizeof(header);
+}
+
+const uint8_t *flash_store_map(size_t slot, size_t &size)
+{
+  FlashStoreHeader header;
+  if (!flash_store_header(slot, header))
+    return nullptr;
+  if (mapped[slot].data)
+  {
+    size = mapped[slot].size;
+    return mapped[slot].data;
+  }
+
+  const void *address;
+  spi_flash_mmap_handle_t handle;
+  if (esp_partition_mmap(partition, slot * FLASH_STORE_SLOT_SIZE, sizeof(header) + header.size, SPI_FLASH_MMAP_DATA,
+                         &address, &handle) != ESP_OK)
+  {
+    Log_error("slot %d could not be mapped", slot);
+    return nullptr;
+  }
+
+  const uint8_t *data = (const uint8_t *)address + sizeof(header);
+  if (wake_state_crc32(data, header.size) != header.hash)
+  {
+    Log_error("slot %d is corrupt", slot);
+    spi_flash_munmap(handle);
+    return nullptr;
+  }
+
+  mapped[slot].handle = handle;
+  mapped[slot].data = data;
+  mapped[slot].size = header.size;
+  size = header.size;
+  return data;
+}
+
+bool flash_store_write(size_t slot, const uint8_t *data, size_t size)
+{
+  if (slot >= flash_store_slot_count() || size > FLASH_STORE_SLOT_SIZE - sizeof(FlashStoreHeader))
+    return false;
+  unmap(slot);
+
+  size_t offset = slot * FLASH_STORE_SLOT_SIZE;
+  FlashStoreHeader header = {FLASH_STORE_MAGIC, (uint32_t)size, wake_state_crc32(data, size)};
+  // the header goes last: until it is written the erased slot reads as empty
+  if (esp_partition_erase_range(partition, offset, FLASH_STORE_SLOT_SIZE) != ESP_OK ||
+      esp_partition_write(partition, offset + sizeof(header), data, size) != ESP_OK ||
+      esp_partition_write(partition, offset, &header, sizeof(header)) != ESP_OK)
+  {
+    Log_error("slot %d write failed", slot);
+    return false;
+  }
+  Log_info("slot %d written - %d bytes", slot, size);
+  return true;
+}
@@ -0,0 +1,371 @@
+#include <image_store.h>
+#include <image_cache.h>
+#include <wake_state.h>
+#include <filesystem.h>
+#include <heap_trace.h>
+#include <display.h>
+#include <flash_store.h>
+#include <config.h>
+#include <trmnl_log.h>
+
+#define IMAGE_CACHE_INDEX_FILE "/img_index"
+
+#ifndef IMAGE_CACHE_MAX_BYTES
+#define IMAGE_CACHE_MAX_BYTES (256 * 1024)
+#endif
+
+// filesystem overhead of a file on top of its data
+#define IMAGE_FILE_SLACK (8 * 1024)
+
+// a framebuffer always leaves room for the next image, or storing it would fail
+#define IMAGE_CACHE_RESERVE (DISPLAY_BMP_IMAGE_SIZE + IMAGE_FILE_SLACK)
+
+// a complete new image waiting to become /current.*, when it could not be cached: the commit record of
+// image_store_set_current()
+#define PENDING_PNG "/pending.png"
+#define PENDING_BMP "/pending.bmp"
+
+static ImageCacheIndex cacheIndex;
+static bool cacheDirty = false;
+
+static void deleteCachedFile(const ImageCacheEntry &entry)
+{
+  char path[IMAGE_CACHE_PATH_SIZE];
+  image_cache_path(entry, path);
+  filesystem_file_delete(path);
+}
+
+static uint32_t cacheBudget(size_t reserve)
+{
+  size_t free_space = filesystem_free_space();
+  size_t available = image_cache_bytes(cacheIndex);
+  if (free_space > reserve)
+    available += free_space - reserve;
+  return available < IMAGE_CACHE_MAX_BYTES ? available : IMAGE_CACHE_MAX_BYTES;
+}
+
+static bool currentExists(void)
+{
+  return filesystem_file_exists("/current.png") || filesystem_file_exists("/current.bmp");
+}
+
+/** Moves /current.* to /last.*, a rename only */
+static void moveCurrentToLast(void)
+{
+  if (filesystem_file_exists("/current.png"))
+  {
+    filesystem_file_delete("/last.bmp");
+    filesystem_file_replace("/current.png", "/last.png");
+  }
+  else if (filesystem_file_exists("/current.bmp"))
+  {
+    filesystem_file_delete("/last.png");
+    filesystem_file_replace("/current.bmp", "/last.bmp");
+  }
+}
+
+/** Moves /current.* to /last.* and the pending image to /current.*; safe to run again after an interruption */
+static bool installPending(bool isPNG)
+{
+  moveCurrentToLast();
+  return isPNG ? filesystem_file_replace(PENDING_PNG, "/current.png") : filesystem_file_replace(PENDING_BMP, "/current.bmp");
+}
+
+static void dropLast(void)
+{
+  filesystem_file_delete("/last.bmp");
+  filesystem_file_delete("/last.png");
+}
+
+/** Makes the cached image the current one: /current.* becomes /last.*, or, if the cache already holds the
+ * image on screen, /last.* is older still and goes */
+static void makeCachedCurrent(void)
+{
+  if (currentExists())
+    moveCurrentToLast();
+  else
+    dropLast();
+}
+
+/** Writes a new image to the cache, where it is kept once; the least recently used images make room for it,
+ * the last one before the current one */
+static bool cacheCurrent(const char *name, uint8_t *data, size_t size, bool isPNG)
+{
+  bool write_file = false;
+  ImageCacheEntry *entry = image_cache_insert(cacheIndex, name, isPNG ? IMAGE_CACHE_PNG : IMAGE_CACHE_BMP, size,
+                                              wake_state_crc32(data, size), cacheBudget(IMAGE_FILE_SLACK),
+                                              deleteCachedFile, write_file);
+  if (!entry)
+    return false;
+  cacheDirty = true;
+
+  char path[IMAGE_CACHE_PATH_SIZE];
+  image_cache_path(*entry, path);
+  if (write_file && filesystem_write_atomic(path, data, size) != size)
+  {
+    Log_error("image cache write of %s failed", path);
+    image_cache_remove(cacheIndex, name, deleteCachedFile);
+    return false;
+  }
+
+  // written now, so a reset before sleep does not leave the file behind unindexed
+  image_store_commit();
+  makeCachedCurrent();
+  Log_info("image %s stored as %s", name, path);
+  return true;
+}
+
+bool image_store_set_current(const char *name, uint8_t *data, size_t size, bool isPNG)
+{
+  if (cacheCurrent(name, data, size, isPNG))
+    return true;
+
+  // the image on screen came from the cache and becomes the last one there: /last.* is older still
+  if (!currentExists())
+    dropLast();
+
+  // three full-size BMPs do not fit: give up the rewind image before writing, the current one stays
+  if (filesystem_free_space() < size + IMAGE_FILE_SLACK)
+  {
+    Log_info("no room for the new image, dropping the last one");
+    dropLast();
+  }
+
+  // until the pending file exists the old images are untouched; once it does, the new one is complete
+  const char *pending = isPNG ? PENDING_PNG : PENDING_BMP;
+  size_t written = filesystem_write_atomic(pending, data, size);
+  if (written != size)
+  {
+    // the estimate of the free space was short
+    Log_info("new image did not fit, dropping the last one");
+    dropLast();
+    written = filesystem_write_atomic(pending, data, size);
+  }
+  if (written != size)
+  {
+    Log_error("new image not stored, keeping the current one");
+    return false;
+  }
+  return installPending(isPNG);
+}
+
+bool image_store_set_current_cached(const char *name)
+{
+  if (!image_cache_lookup(cacheIndex, name))
+    return false;
+  cacheDirty = true;
+  makeCachedCurrent();
+  return true;
+}
+
+bool image_store_find(bool last, const char *name, char *path, bool &isPNG)
+{
+  const char *bmp = last ? "/last.bmp" : "/current.bmp";
+  const char *png = last ? "/last.png" : "/current.png";
+  if (filesystem_file_exists(bmp) || filesystem_file_exists(png))
+  {
+    isPNG = !filesystem_file_exists(bmp);
+    strcpy(path, isPNG ? png : bmp);
+    return true;
+  }
+
+  ImageCacheEntry *entry = image_cache_lookup(cacheIndex, name);
+  if (!entry || entry->format == IMAGE_CACHE_FRAMEBUFFER)
+    return false;
+  cacheDirty = true;
+  image_cache_path(*entry, path);
+  isPNG = entry->format == IMAGE_CACHE_PNG;
+  return true;
+}
+
+void image_store_init(void)
+{
+  cacheDirty = false;
+  if (filesystem_file_exists(PENDING_PNG) || filesystem_file_exists(PENDING_BMP))
+  {
+    Log_info("finishing an interrupted image update");
+    installPending(filesystem_file_exists(PENDING_PNG));
+  }
+
+  if (filesystem_file_exists(IMAGE_CACHE_INDEX_FILE) &&
+      filesystem_read_from_file(IMAGE_CACHE_INDEX_FILE, (uint8_t *)&cacheIndex, sizeof(cacheIndex)) &&
+      image_cache_valid(cacheIndex))
+  {
+    Log_info("image cache: %d bytes cached", image_cache_bytes(cacheIndex));
+    return;
+  }
+
+  Log_info("image cache index not found, starting empty");
+  image_cache_reset(cacheIndex);
+}
+
+uint8_t *image_store_load(const char *name, size_t &size, bool &isPNG)
+{
+  ImageCacheEntry *entry = image_cache_lookup(cacheIndex, name);
+  if (!entry || entry->format == IMAGE_CACHE_FRAMEBUFFER)
+    return nullptr;
+  cacheDirty = true;
+
+  char path[IMAGE_CACHE_PATH_SIZE];
+  image_cache_path(*entry, path);
+  uint8_t *data = (uint8_t *)heap_trace_malloc(entry->size, "cached_image");
+  if (!data)
+  {
+    Log_error("no memory for cached image %s", path);
+    return nullptr;
+  }
+
+  if (!filesystem_read_from_file(path, data, entry->size) || wake_state_crc32(data, entry->size) != entry->hash)
+  {
+    Log_error("cached image %s is unreadable, dropping it", path);
+    heap_trace_free(data);
+    image_cache_remove(cacheIndex, name, deleteCachedFile);
+    return nullptr;
+  }
+
+  Log_info("image %s read from cache %s", name, path);
+  size = entry->size;
+  isPNG = entry->format == IMAGE_CACHE_PNG;
+  return data;
+}
+
+/** Finds the flash_store slot holding a framebuffer, or FLASH_STORE_LOGO if it is a file */
+static size_t framebufferSlot(uint32_t hash, uint32_t size)
+{
+  FlashStoreHeader header;
+  for (size_t slot = FLASH_STORE_LOGO + 1; slot < flash_store_slot_count(); slot++)
+  {
+    if (flash_store_header(slot, header) && header.hash == hash && header.size == size)
+      return slot;
+  }
+  return FLASH_STORE_LOGO;
+}
+
+/** Finds a slot no cached framebuffer uses any more, or FLASH_STORE_LOGO if all are taken */
+static size_t freeFramebufferSlot(void)
+{
+  FlashStoreHeader header;
+  for (size_t slot = FLASH_STORE_LOGO + 1; slot < flash_store_slot_count(); slot++)
+  {
+    if (!flash_store_header(slot, header))
+      return slot;
+
+    bool used = false;
+    for (const ImageCacheEntry &entry : cacheIndex.entries)
+      used |= entry.key[0] && entry.format == IMAGE_CACHE_FRAMEBUFFER && entry.hash == header.hash;
+    if (!used)
+      return slot;
+  }
+  return FLASH_STORE_LOGO;
+}
+
+void image_store_save_framebuffer(const char *name, const uint8_t *framebuffer, size_t size)
+{
+#ifdef IMAGE_CACHE_FRAMEBUFFERS
+  uint32_t hash = wake_state_crc32(framebuffer, size);
+  bool write_file = false;
+  ImageCacheEntry *entry = image_cache_insert(cacheIndex, name, IMAGE_CACHE_FRAMEBUFFER, size, hash, cacheBudget(IMAGE_CACHE_RESERVE),
+                                              deleteCachedFile, write_file);
+  if (!entry)
+    return;
+  cacheDirty = true;
+  if (!write_file)
+    return;
+
+  // a mapped slot is shown without reading the file through a buffer
+  size_t slot = freeFramebufferSlot();
+  if (slot != FLASH_STORE_LOGO && flash_store_write(slot, framebuffer, size))
+    return;
+
+  char path[IMAGE_CACHE_PATH_SIZE];
+  image_cache_path(*entry, path);
+  if (filesystem_write_to_file(path, const_cast<uint8_t *>(framebuffer), size) != size)
+  {
+    Log_error("image cache write of %s failed", path);
+    image_cache_remove(cacheIndex, name, deleteCachedFile);
+  }
+#endif
+}
+
+static uint32_t streamCrc;
+
+static void streamCheck(const uint8_t *data, size_t size)
+{
+  streamCrc = wake_state_crc32_update(streamCrc, data, size);
+}
+
+static void streamToDisplay(const uint8_t *data, size_t size)
+{
+  streamCheck(data, size);
+  display_stream_write(data, size);
+}
+
+bool image_store_show_framebuffer(const char *name)
+{
+  ImageCacheEntry *entry = image_cache_lookup(cacheIndex, name);
+  if (!entry || entry->format != IMAGE_CACHE_FRAMEBUFFER)
+    return false;
+  cacheDirty = true;
+
+  size_t slot = framebufferSlot(entry->hash, entry->size);
+  if (slot != FLASH_STORE_LOGO)
+  {
+    size_t size = 0;
+    const uint8_t *framebuffer = flash_store_map(slot, size);
+    if (framebuffer)
+    {
+      display_stream_begin();
+      display_stream_write(framebuffer, size);
+      display_stream_end();
+      Log_info("image %s shown from flash slot %d", name, slot);
+      return true;
+    }
+    // a corrupt slot has no file behind it either: the entry is dropped below and the slot reused
+  }
+
+  char path[IMAGE_CACHE_PATH_SIZE];
+  image_cache_path(*entry, path);
+  uint8_t chunk[1000]; // 10 rows of the 800 px panel
+
+  // checked before the panel is touched, so a bad file leaves it ready for the download
+  streamCrc = 0;
+  size_t read = filesystem_read_chunks(path, chunk, sizeof(chunk), streamCheck);
+  if (read != entry->size || streamCrc != entry->hash)
+  {
+    Log_error("cached framebuffer %s is unreadable, dropping it", path);
+    image_cache_remove(cacheIndex, name, deleteCachedFile);
+    return false;
+  }
+
+  streamCrc = 0;
+  display_stream_begin();
+  read = filesystem_read_chunks(path, chunk, sizeof(chunk), streamToDisplay);
+  if (read != entry->size || streamCrc != entry->hash)
+  {
+    // a read error on the second pass: the panel holds part of a frame and is reset by the next draw
+    Log_error("cached framebuffer %s failed while it was shown, dropping it", path);
+    display_stream_abort();
+    image_cache_remove(cacheIndex, name, deleteCachedFile);
+    return false;
+  }
+
+  display_stream_end();
+  Log_info("image %s shown from cached framebuffer %s", name, path);
+  return true;
+}
+
+void image_store_forget(const char *name)
+{
+  if (image_cache_remove(cacheIndex, name, deleteCachedFile))
+    cacheDirty = true;
+}
+
+void image_store_commit(void)
+{
+  if (!cacheDirty)
+    return;
+
+  image_cache_seal(cacheIndex);
+  if (filesystem_write_atomic(IMAGE_CACHE_INDEX_FILE, (uint8_t *)&cacheIndex, sizeof(cacheIndex)) == sizeof(cacheIndex))
+    cacheDirty = false;
+}
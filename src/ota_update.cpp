@@ -0,0 +1,428 @@
+#include <ota_update.h>
+#include <config.h>
+#include <trmnl_log.h>
+#include <http_client.h>
+#include <heap_trace.h>
+#include <ota_progress.h>
+#include <ota_delta.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#include <string.h>
+
+#if OTA_CHECKPOINT_SIZE % OTA_DELTA_BLOCK_SIZE || OTA_DELTA_BLOCK_SIZE % SPI_FLASH_SEC_SIZE
+#error "patch blocks must fill flash sectors and end at every checkpoint"
+#endif
+
+static void saveProgress(Preferences &preferences, const OtaProgress &progress)
+{
+  if (preferences.putBytes(PREFERENCES_OTA_PROGRESS_KEY, &progress, sizeof(progress)) != sizeof(progress))
+    Log_error("OTA progress not saved");
+}
+
+static void clearProgress(Preferences &preferences)
+{
+  if (preferences.isKey(PREFERENCES_OTA_PROGRESS_KEY))
+    preferences.remove(PREFERENCES_OTA_PROGRESS_KEY);
+}
+
+/** Same image from the first byte, keeping the count of attempts */
+static void startOver(OtaProgress &progress)
+{
+  uint32_t attempts = progress.attempts;
+  ota_progress_start(progress, progress.image);
+  progress.attempts = attempts;
+}
+
+/**
+ * @brief Function to check the response and the size of the download
+ * @param https client after GET()
+ * @param code HTTP status
+ * @param progress progress, started over if the server sends the whole file
+ * @param partition partition the image goes to
+ * @param patch true if the download is a patch
+ * @return OtaResult OTA_DONE if the body continues the download at progress.received
+ */
+static OtaResult checkResponse(HTTPClient *https, int code, OtaProgress &progress, const esp_partition_t *partition,
+                               bool patch)
+{
+  uint32_t total = 0;
+  if (code == HTTP_CODE_PARTIAL_CONTENT)
+  {
+    uint32_t start = 0;
+    String range = https->header("Content-Range");
+    if (!ota_parse_content_range(range.c_str(), start, total) || start != progress.received ||
+        (progress.length && total != progress.length))
+    {
+      Log_error("unexpected Content-Range \"%s\" at %u bytes, starting over", range.c_str(), progress.received);
+      startOver(progress);
+      return OTA_RETRY;
+    }
+  }
+  else if (code == HTTP_CODE_OK)
+  {
+    if (progress.received)
+      Log_info("the server sent the whole file, starting over");
+    startOver(progress);
+    if (https->getSize() <= 0)
+    {
+      Log_fatal("firmware download without Content-Length");
+      return OTA_FAILED;
+    }
+    total = https->getSize();
+  }
+  else if (code == HTTP_CODE_RANGE_NOT_SATISFIABLE)
+  {
+    Log_error("range from %u bytes refused, starting over", progress.received);
+    startOver(progress);
+    return OTA_RETRY;
+  }
+  else
+  {
+    Log_error("firmware download failed: %d %s", code, HTTPClient::errorToString(code).c_str());
+    return OTA_RETRY;
+  }
+
+  if (!patch)
+  {
+    if (total > partition->size)
+    {
+      Log_fatal("firmware image of %u bytes does not fit in %u", total, partition->size);
+      return OTA_FAILED;
+    }
+    progress.size = total;
+  }
+  progress.length = total;
+  return OTA_DONE;
+}
+
+/**
+ * @brief Function to copy the image into the partition up to its end or a stall
+ * @param stream response body
+ * @param partition partition the image goes to
+ * @param progress progress, saved at every checkpoint
+ * @param sha hash of the image so far
+ * @param received bytes of the image received so far, updated
+ * @param preferences opened Preferences instance
+ * @return OtaResult OTA_DONE once the whole image is written, OTA_RETRY if it stopped before
+ */
+static OtaResult receiveImage(WiFiClient &stream, const esp_partition_t *partition, OtaProgress &progress,
+                              Sha256 &sha, uint32_t &received, Preferences &preferences)
+{
+  uint8_t buffer[OTA_BUFFER_SIZE];
+  uint32_t erased = received; // checkpoints fall on sector boundaries
+  while (received < progress.size)
+  {
+    // never read across a checkpoint, so every one of them is saved
+    uint32_t checkpoint = (received / OTA_CHECKPOINT_SIZE + 1) * OTA_CHECKPOINT_SIZE;
+    size_t want = sizeof(buffer);
+    if (want > checkpoint - received)
+      want = checkpoint - received;
+    if (want > progress.size - received)
+      want = progress.size - received;
+
+    size_t n = stream.readBytes((char *)buffer, want);
+    if (n == 0)
+      return OTA_RETRY;
+    while (erased < received + n)
+    {
+      if (esp_partition_erase_range(partition, erased, SPI_FLASH_SEC_SIZE) != ESP_OK)
+      {
+        Log_error("erase at %u failed", erased);
+        return OTA_RETRY;
+      }
+      erased += SPI_FLASH_SEC_SIZE;
+    }
+    if (esp_partition_write(partition, received, buffer, n) != ESP_OK)
+    {
+      Log_error("write at %u failed", received);
+      return OTA_RETRY;
+    }
+    sha256_update(sha, buffer, n);
+    received += n;
+
+    if (ota_progress_checkpoint(progress, sha, received))
+      saveProgress(preferences, progress);
+  }
+  return OTA_DONE;
+}
+
+/**
+ * @brief Function to check that a patch applies to the running image
+ * @param running partition the firmware runs from
+ * @param header header of the patch
+ * @return bool true if the running image has the size and SHA-256 the patch was made against
+ */
+static bool sourceMatches(const esp_partition_t *running, const OtaDeltaHeader &header)
+{
+  if (header.source_size > running->size)
+    return false;
+  uint8_t buffer[OTA_BUFFER_SIZE];
+  Sha256 sha;
+  sha256_init(sha);
+  for (uint32_t offset = 0; offset < header.source_size; offset += sizeof(buffer))
+  {
+    size_t n = header.source_size - offset < sizeof(buffer) ? header.source_size - offset : sizeof(buffer);
+    if (esp_partition_read(running, offset, buffer, n) != ESP_OK)
+      return false;
+    sha256_update(sha, buffer, n);
+  }
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  sha256_finish(sha, digest);
+  return memcmp(digest, header.source_sha256, SHA256_DIGEST_SIZE) == 0;
+}
+
+/**
+ * @brief Function to write one block of a patch: the next sector of the image
+ * @param partition partition the image goes to
+ * @param running partition the firmware runs from
+ * @param block block header
+ * @param packed packed bytes of the block
+ * @param offset offset of the block in the image
+ * @param length bytes the block produces
+ * @param sha hash of the image so far
+ * @return OtaResult OTA_DONE if written, OTA_FAILED if the block is corrupt, OTA_RETRY if the flash failed
+ */
+static OtaResult applyBlock(const esp_partition_t *partition, const esp_partition_t *running,
+                            const OtaDeltaBlock &block, const uint8_t *packed, uint32_t offset, uint32_t length,
+                            Sha256 &sha)
+{
+  if (esp_partition_erase_range(partition, offset, OTA_DELTA_BLOCK_SIZE) != ESP_OK)
+  {
+    Log_error("erase at %u failed", offset);
+    return OTA_RETRY;
+  }
+  uint8_t source[OTA_BUFFER_SIZE];
+  uint8_t out[OTA_BUFFER_SIZE];
+  LzssDecoder decoder;
+  lzss_decoder_init(decoder, packed, block.packed);
+  for (uint32_t done = 0; done < length; done += sizeof(out))
+  {
+    size_t n = length - done < sizeof(out) ? length - done : sizeof(out);
+    bool from_source = block.source != OTA_DELTA_NO_SOURCE;
+    if (from_source && esp_partition_read(running, block.source + done, source, n) != ESP_OK)
+      return OTA_RETRY;
+    if (ota_delta_decode(decoder, from_source ? source : nullptr, out, n) != n)
+    {
+      Log_fatal("corrupt patch block at %u", offset);
+      return OTA_FAILED;
+    }
+    if (esp_partition_write(partition, offset + done, out, n) != ESP_OK)
+    {
+      Log_error("write at %u failed", offset + done);
+      return OTA_RETRY;
+    }
+    sha256_update(sha, out, n);
+  }
+  return OTA_DONE;
+}
+
+/**
+ * @brief Function to apply a patch as it is received, up to its end or a stall
+ * @param stream response body
+ * @param partition partition the image goes to
+ * @param progress progress, saved at every checkpoint
+ * @param sha hash of the image so far
+ * @param received bytes of the patch received so far, updated
+ * @param preferences opened Preferences instance
+ * @return OtaResult OTA_DONE once the whole image is written, OTA_RETRY if it stopped before, OTA_FAILED if the
+ * patch does not apply
+ */
+static OtaResult receivePatch(WiFiClient &stream, const esp_partition_t *partition, OtaProgress &progress,
+                              Sha256 &sha, uint32_t &received, Preferences &preferences)
+{
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  if (!running)
+    return OTA_FAILED;
+  if (received == 0)
+  {
+    uint8_t data[OTA_DELTA_HEADER_SIZE];
+    if (stream.readBytes((char *)data, sizeof(data)) != sizeof(data))
+      return OTA_RETRY;
+    received += sizeof(data);
+    OtaDeltaHeader header;
+    if (!ota_delta_header(data, header) || header.target_size > partition->size)
+    {
+      Log_fatal("not a firmware patch");
+      return OTA_FAILED;
+    }
+    if (!sourceMatches(running, header))
+    {
+      Log_error("the patch was made for another firmware");
+      return OTA_FAILED;
+    }
+    progress.size = header.target_size;
+  }
+
+  uint8_t *packed = (uint8_t *)heap_trace_malloc(OTA_DELTA_MAX_PACKED, "ota_patch_block");
+  if (!packed)
+    return OTA_RETRY;
+  OtaResult result = OTA_DONE;
+  uint32_t offset = progress.written;
+  while (offset < progress.size && result == OTA_DONE)
+  {
+    uint8_t data[OTA_DELTA_BLOCK_HEADER_SIZE];
+    OtaDeltaBlock block;
+    uint32_t length = ota_delta_block_length(progress.size, offset);
+    if (stream.readBytes((char *)data, sizeof(data)) != sizeof(data))
+    {
+      result = OTA_RETRY;
+      break;
+    }
+    if (!ota_delta_block(data, length, running->size, block))
+    {
+      Log_fatal("corrupt patch block at %u", offset);
+      result = OTA_FAILED;
+      break;
+    }
+    if (stream.readBytes((char *)packed, block.packed) != block.packed)
+    {
+      result = OTA_RETRY;
+      break;
+    }
+    received += sizeof(data) + block.packed;
+
+    result = applyBlock(partition, running, block, packed, offset, length, sha);
+    offset += length;
+    if (result == OTA_DONE && ota_progress_checkpoint(progress, sha, received))
+      saveProgress(preferences, progress);
+  }
+  heap_trace_free(packed);
+  return result;
+}
+
+/**
+ * @brief Function to make one connection of the download
+ * @param url URL of the image or the patch
+ * @param patch true if the download is a patch
+ * @param sha256_hex expected SHA-256 of the image, may be empty
+ * @param partition partition the image goes to
+ * @param progress progress of the download
+ * @param preferences opened Preferences instance
+ * @return OtaResult OTA_DONE once the image is complete and checked
+ */
+static OtaResult downloadAttempt(const char *url, bool patch, const char *sha256_hex,
+                                 const esp_partition_t *partition, OtaProgress &progress, Preferences &preferences)
+{
+  return withHttp(url, [&](HTTPClient *https, HttpError errorCode) -> OtaResult
+                  {
+    if (errorCode != HttpError::HTTPCLIENT_SUCCESS || !https)
+    {
+      Log_error("unable to connect for firmware update");
+      return OTA_RETRY;
+    }
+
+    const char *headers[] = {"Content-Range"};
+    https->collectHeaders(headers, 1);
+    if (progress.received)
+      https->addHeader("Range", "bytes=" + String(progress.received) + "-");
+
+    progress.attempts++;
+    uint32_t resumed = progress.received;
+    int code = https->GET();
+    OtaResult result = checkResponse(https, code, progress, partition, patch);
+    if (progress.received != resumed)
+      saveProgress(preferences, progress); // started over, the old checkpoint is about to be overwritten
+    if (result != OTA_DONE)
+      return result;
+
+    Log_info("downloading firmware %s from %u of %u bytes, attempt %u", patch ? "patch" : "image", progress.received,
+             progress.length, progress.attempts);
+    uint32_t received = progress.received;
+    uint32_t from = received;
+    uint32_t start = millis();
+    Sha256 sha;
+    ota_progress_hash(progress, sha);
+    result = patch ? receivePatch(https->getStream(), partition, progress, sha, received, preferences)
+                   : receiveImage(https->getStream(), partition, progress, sha, received, preferences);
+
+    uint32_t ms = millis() - start;
+    uint32_t bytes = received - from;
+    Log_info("firmware download: %u bytes in %u ms, %u B/s, %u of %u bytes", bytes, ms,
+             ms ? (uint32_t)((uint64_t)bytes * 1000 / ms) : 0, received, progress.length);
+    if (patch)
+      Log_info("firmware patch applied up to %u of %u bytes", (uint32_t)sha.length, progress.size);
+    if (result == OTA_RETRY)
+      saveProgress(preferences, progress); // the attempt count, the bytes since the last checkpoint are lost
+    if (result != OTA_DONE)
+      return result;
+
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256_finish(sha, digest);
+    if (sha256_hex[0] && !sha256_matches_hex(digest, sha256_hex))
+    {
+      Log_fatal("firmware SHA-256 does not match");
+      return OTA_FAILED;
+    }
+    esp_err_t err = esp_ota_set_boot_partition(partition);
+    if (err != ESP_OK)
+    {
+      Log_fatal("firmware image rejected: %d", err);
+      return OTA_FAILED;
+    }
+    return OTA_DONE; });
+}
+
+/**
+ * @brief Function to download an image or a patch, resuming saved progress
+ * @param url URL of the image or the patch
+ * @param patch true if the download is a patch
+ * @param sha256_hex expected SHA-256 of the image, may be empty
+ * @param partition partition the image goes to
+ * @param saved progress read from NVS, nullptr if there was none
+ * @param preferences opened Preferences instance
+ * @param starting called when the download starts from the first byte, may be nullptr
+ * @return OtaResult outcome
+ */
+static OtaResult download(const char *url, bool patch, const char *sha256_hex, const esp_partition_t *partition,
+                          const OtaProgress *saved, Preferences &preferences, void (*starting)(void))
+{
+  uint32_t image = ota_image_id(url, sha256_hex);
+  OtaProgress progress;
+  if (saved && ota_progress_resumes(*saved, image))
+  {
+    progress = *saved;
+    Log_info("resuming firmware %s at %u of %u bytes", patch ? "patch" : "image", progress.received, progress.length);
+  }
+  else
+  {
+    // saved at once, so a patch given up for the whole image stays given up
+    ota_progress_start(progress, image);
+    saveProgress(preferences, progress);
+    if (starting)
+      starting();
+  }
+
+  OtaResult result = OTA_RETRY;
+  for (int i = 0; i < OTA_CONNECT_ATTEMPTS && result == OTA_RETRY; i++)
+    result = downloadAttempt(url, patch, sha256_hex, partition, progress, preferences);
+
+  if (result == OTA_RETRY)
+    Log_info("firmware download continues on the next wake");
+  else
+    clearProgress(preferences);
+  return result;
+}
+
+OtaResult ota_update(const char *url, const char *patch_url, const char *sha256_hex, Preferences &preferences,
+                     void (*starting)(void))
+{
+  const esp_partition_t *partition = esp_ota_get_next_update_partition(nullptr);
+  if (!partition)
+  {
+    Log_fatal("no OTA partition");
+    return OTA_FAILED;
+  }
+
+  OtaProgress saved;
+  bool have_saved = preferences.getBytes(PREFERENCES_OTA_PROGRESS_KEY, &saved, sizeof(saved)) == sizeof(saved);
+  // the whole image already in progress means the patch was given up
+  bool patch = patch_url[0] && !(have_saved && ota_progress_resumes(saved, ota_image_id(url, sha256_hex)));
+  OtaResult result = download(patch ? patch_url : url, patch, sha256_hex, partition, have_saved ? &saved : nullptr,
+                              preferences, starting);
+  if (patch && result == OTA_FAILED)
+  {
+    Log_error("firmware patch unusable, downloading the whole image");
+    result = download(url, false, sha256_hex, partition, nullptr, preferences, nullptr);
+  }
+  return result;
+}
@@ -0,0 +1,57 @@
+#include <panel.h>
+#include "EPD.h"
+#include <trmnl_log.h>
+
+static void init_7in5_v2(PanelMode mode)
+{
+  if (mode == PANEL_MODE_FAST)
+    EPD_7IN5_V2_Init_Fast();
+  else
+    EPD_7IN5_V2_Init_New();
+}
+
+static const Panel panel_7in5_v2 = {
+    "7in5_v2",
+    EPD_7IN5_V2_WIDTH,
+    EPD_7IN5_V2_HEIGHT,
+    PANEL_MODE_FULL | PANEL_MODE_FAST,
+    init_7in5_v2,
+    EPD_7IN5_V2_Display_Begin,
+    EPD_7IN5_V2_Display_Write,
+    EPD_7IN5_V2_Display_End,
+    EPD_7IN5_V2_ClearWhite,
+    EPD_7IN5_V2_Clear,
+    EPD_7IN5_V2_Sleep,
+};
+
+static const Panel *const panels[] = {
+    &panel_7in5_v2,
+};
+
+const Panel *panel_find(const char *name)
+{
+  for (const Panel *panel : panels)
+  {
+    if (strcmp(panel->name, name) == 0)
+      return panel;
+  }
+  return nullptr;
+}
+
+const Panel &panel_default(void)
+{
+  const Panel *panel = panel_find(DISPLAY_PANEL);
+  if (!panel)
+  {
+    Log_error("unknown panel %s, using %s", DISPLAY_PANEL, panels[0]->name);
+    panel = panels[0];
+  }
+  return *panel;
+}
+
+void panel_show(const Panel &panel, const uint8_t *framebuffer)
+{
+  panel.write_begin();
+  panel.write(framebuffer, (uint32_t)panel.width / 8 * panel.height);
+  panel.write_end();
+}
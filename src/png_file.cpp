@@ -2,15 +2,15 @@
 #include <trmnl_log.h>
 #include <PNGdec.h>
 #include <esp_mac.h>
-#include <SPIFFS.h>
+#include <filesystem.h>
 #include "png.h"
 
 File pngfile; // Global file handle
 
 void *pngOpen(const char *filename, int32_t *size)
 {
-  Serial.printf("Attempting to open %s from SPIFFS\n", filename);
-  pngfile = SPIFFS.open(filename, "r");
+  Serial.printf("Attempting to open %s\n", filename);
+  pngfile = filesystem_fs().open(filename, "r");
 
   if (!pngfile)
   {
@@ -0,0 +1,73 @@
+#include <settings.h>
+#include <wake_state.h>
+#include <config.h>
+#include <trmnl_log.h>
+
+/** SettingsStore that reads and writes NVS through Preferences */
+class PreferencesStore : public SettingsStore
+{
+public:
+  Preferences *preferences = nullptr;
+
+  bool isKey(const char *key) override { return preferences->isKey(key); }
+  bool getBool(const char *key) override { return preferences->getBool(key); }
+  int32_t getInt(const char *key) override { return preferences->getInt(key); }
+  uint32_t getUInt(const char *key) override { return preferences->getUInt(key); }
+  String getString(const char *key) override { return preferences->getString(key); }
+  size_t putBool(const char *key, bool value) override { return preferences->putBool(key, value); }
+  size_t putInt(const char *key, int32_t value) override { return preferences->putInt(key, value); }
+  size_t putUInt(const char *key, uint32_t value) override { return preferences->putUInt(key, value); }
+  size_t putString(const char *key, const String &value) override { return preferences->putString(key, value); }
+  bool remove(const char *key) override { return preferences->remove(key); }
+};
+
+// every key of the "data" namespace except the stored log ring (see stored_logs.h);
+// per-cycle state is kept in RTC memory and only read from NVS after a power loss
+static const SettingDef settingDefs[] = {
+    {PREFERENCES_API_KEY, SettingType::String, false},
+    {PREFERENCES_API_URL, SettingType::String, false},
+    {PREFERENCES_FRIENDLY_ID, SettingType::String, false},
+    {PREFERENCES_SLEEP_TIME_KEY, SettingType::UInt, false},
+    {PREFERENCES_LOG_ID_KEY, SettingType::UInt, false},
+    {PREFERENCES_DEVICE_REGISTERED_KEY, SettingType::Bool, false},
+    {PREFERENCES_SF_KEY, SettingType::UInt, true},
+    {PREFERENCES_FILENAME_KEY, SettingType::String, true},
+    {PREFERENCES_LAST_FILENAME_KEY, SettingType::String, true},
+    {PREFERENCES_LAST_SLEEP_TIME, SettingType::UInt, true},
+    {PREFERENCES_CONNECT_API_RETRY_COUNT, SettingType::Int, true},
+    {PREFERENCES_CONNECT_WIFI_RETRY_COUNT, SettingType::Int, true},
+};
+
+RTC_DATA_ATTR WakeState wake_state;
+
+static PreferencesStore preferencesStore;
+static WakeStateStore wakeStateStore(wake_state);
+
+SettingsCache settings(preferencesStore, settingDefs, sizeof(settingDefs) / sizeof(settingDefs[0]), &wakeStateStore);
+
+void settings_init(Preferences &preferences)
+{
+  preferencesStore.preferences = &preferences;
+  settings.load();
+  if (!wakeStateStore.restored())
+    Log_info("wake state not restored, per-cycle settings read from NVS");
+}
+
+void settings_reset(void)
+{
+  wake_state_reset(wake_state);
+  // a soft reset from the button runs before settings_init()
+  if (!preferencesStore.preferences)
+    return;
+  settings.load();
+}
+
+size_t settings_commit(void)
+{
+  if (!preferencesStore.preferences)
+    return 0;
+
+  size_t written = settings.commit();
+  Log_info("settings commit: %d NVS entries written", written);
+  return written;
+}
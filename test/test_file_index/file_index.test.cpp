@@ -0,0 +1,89 @@
+#include <unity.h>
+#include <file_index.h>
+#include <stdio.h>
+
+static FileIndex index_;
+
+void test_unwalked_index_knows_nothing(void)
+{
+  file_index_reset(index_, false);
+  TEST_ASSERT_EQUAL(FILE_INDEX_UNKNOWN, file_index_lookup(index_, "/current.png"));
+}
+
+void test_walked_index_answers_misses(void)
+{
+  file_index_add(index_, "logo.bmp"); // File::name() has no leading slash
+  TEST_ASSERT_EQUAL(FILE_INDEX_PRESENT, file_index_lookup(index_, "/logo.bmp"));
+  TEST_ASSERT_EQUAL(FILE_INDEX_ABSENT, file_index_lookup(index_, "/current.png"));
+}
+
+void test_image_rotation(void)
+{
+  file_index_add(index_, "/current.png");
+  file_index_add(index_, "/last.png");
+  file_index_add(index_, "/pending.bmp");
+
+  file_index_remove(index_, "/last.bmp");
+  file_index_rename(index_, "/current.png", "/last.png");
+  file_index_rename(index_, "/pending.bmp", "/current.bmp");
+
+  TEST_ASSERT_EQUAL(FILE_INDEX_PRESENT, file_index_lookup(index_, "/current.bmp"));
+  TEST_ASSERT_EQUAL(FILE_INDEX_PRESENT, file_index_lookup(index_, "/last.png"));
+  TEST_ASSERT_EQUAL(FILE_INDEX_ABSENT, file_index_lookup(index_, "/current.png"));
+  TEST_ASSERT_EQUAL(FILE_INDEX_ABSENT, file_index_lookup(index_, "/pending.bmp"));
+  TEST_ASSERT_EQUAL(2, index_.count);
+}
+
+void test_overflow_makes_misses_unknown(void)
+{
+  char name[FILE_INDEX_NAME_SIZE];
+  for (int i = 0; i < FILE_INDEX_MAX_FILES; i++)
+  {
+    snprintf(name, sizeof(name), "/img_%08x.png", i);
+    file_index_add(index_, name);
+  }
+  TEST_ASSERT_TRUE(index_.complete);
+
+  file_index_add(index_, "/one_too_many");
+  TEST_ASSERT_FALSE(index_.complete);
+  TEST_ASSERT_EQUAL(FILE_INDEX_PRESENT, file_index_lookup(index_, "/img_00000000.png"));
+  TEST_ASSERT_EQUAL(FILE_INDEX_UNKNOWN, file_index_lookup(index_, "/one_too_many"));
+}
+
+void test_long_names_and_subdirectories_are_not_indexed(void)
+{
+  file_index_add(index_, "/a_file_name_that_does_not_fit_the_index.bmp");
+  TEST_ASSERT_FALSE(index_.complete);
+
+  file_index_reset(index_, true);
+  file_index_add(index_, "/dir/file");
+  TEST_ASSERT_TRUE(index_.complete);
+  TEST_ASSERT_EQUAL(0, index_.count);
+  TEST_ASSERT_EQUAL(FILE_INDEX_UNKNOWN, file_index_lookup(index_, "/dir/file"));
+}
+
+void setUp(void)
+{
+  file_index_reset(index_, true);
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_unwalked_index_knows_nothing);
+  RUN_TEST(test_walked_index_answers_misses);
+  RUN_TEST(test_image_rotation);
+  RUN_TEST(test_overflow_makes_misses_unknown);
+  RUN_TEST(test_long_names_and_subdirectories_are_not_indexed);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include <unity.h>
+#include <flight_recorder.h>
+#include <string.h>
+
+static const int RESET_POWERON = 1;
+static const int RESET_PANIC = 4;
+static const int RESET_DEEPSLEEP = 8;
+static const int RESET_BROWNOUT = 9;
+
+static FlightRecord record;
+static char report[FLIGHT_RECORDER_REPORT_SIZE];
+
+void test_garbage_record_starts_clean(void)
+{
+  memset(&record, 0xA5, sizeof(record));
+
+  TEST_ASSERT_FALSE(flight_recorder_boot(record, RESET_POWERON, 200000, 110000));
+  TEST_ASSERT_TRUE(flight_recorder_valid(record));
+  TEST_ASSERT_EQUAL(0, record.wake_count);
+  TEST_ASSERT_EQUAL(FLIGHT_PHASE_BOOT, record.phase);
+  TEST_ASSERT_EQUAL(200000, record.heap_low_water);
+  TEST_ASSERT_EQUAL(0, flight_recorder_take_report(record, report, sizeof(report)));
+}
+
+void test_planned_sleep_is_not_reported(void)
+{
+  flight_recorder_boot(record, RESET_POWERON, 200000, 110000);
+  flight_recorder_phase(record, FLIGHT_PHASE_DOWNLOAD, 150000, 60000);
+  flight_recorder_phase(record, FLIGHT_PHASE_SLEEP, 150000, 100000);
+
+  TEST_ASSERT_FALSE(flight_recorder_boot(record, RESET_DEEPSLEEP, 200000, 110000));
+  TEST_ASSERT_EQUAL(1, record.wake_count);
+}
+
+void test_crash_is_reported_with_phase_heap_and_logs(void)
+{
+  flight_recorder_boot(record, RESET_POWERON, 200000, 110000);
+  flight_recorder_phase(record, FLIGHT_PHASE_DOWNLOAD, 150000, 60000);
+  flight_recorder_log(record, 0x3c0a0010, 140000);
+  flight_recorder_phase(record, FLIGHT_PHASE_DECODE, 145000, 70000);
+  flight_recorder_log(record, 0x3c0a0020, 21000);
+
+  TEST_ASSERT_TRUE(flight_recorder_boot(record, RESET_PANIC, 200000, 110000));
+  TEST_ASSERT_EQUAL(FLIGHT_PHASE_BOOT, record.phase);
+
+  size_t length = flight_recorder_take_report(record, report, sizeof(report));
+  TEST_ASSERT_EQUAL(strlen(report), length);
+  TEST_ASSERT_EQUAL_STRING("reset=panic phase=decode wake=0 heap_low=21000 max_alloc_low=60000@download logs=3c0a0010,3c0a0020", report);
+
+  // taken once only
+  TEST_ASSERT_EQUAL(0, flight_recorder_take_report(record, report, sizeof(report)));
+}
+
+void test_log_ids_keep_most_recent(void)
+{
+  flight_recorder_boot(record, RESET_POWERON, 200000, 110000);
+  for (uint32_t id = 1; id <= FLIGHT_RECORDER_LOG_IDS + 2; id++)
+  {
+    flight_recorder_log(record, id, 200000);
+  }
+  flight_recorder_boot(record, RESET_BROWNOUT, 200000, 110000);
+  flight_recorder_take_report(record, report, sizeof(report));
+
+  TEST_ASSERT_NOT_NULL(strstr(report, "reset=brownout phase=boot"));
+  TEST_ASSERT_NOT_NULL(strstr(report, "logs=00000003,"));
+  TEST_ASSERT_NOT_NULL(strstr(report, ",0000000a"));
+}
+
+void test_pending_report_survives_until_taken(void)
+{
+  flight_recorder_boot(record, RESET_POWERON, 200000, 110000);
+  flight_recorder_phase(record, FLIGHT_PHASE_DISPLAY, 90000, 30000);
+  flight_recorder_boot(record, RESET_PANIC, 200000, 110000);
+
+  // next wake fails to submit any log and sleeps normally; a later panic must not replace the first report
+  flight_recorder_phase(record, FLIGHT_PHASE_WIFI, 200000, 110000);
+  flight_recorder_boot(record, RESET_PANIC, 200000, 110000);
+
+  flight_recorder_take_report(record, report, sizeof(report));
+  TEST_ASSERT_NOT_NULL(strstr(report, "phase=display"));
+}
+
+void test_take_report_truncates(void)
+{
+  flight_recorder_boot(record, RESET_POWERON, 200000, 110000);
+  flight_recorder_boot(record, RESET_PANIC, 200000, 110000);
+
+  char small[12];
+  TEST_ASSERT_EQUAL(sizeof(small) - 1, flight_recorder_take_report(record, small, sizeof(small)));
+  TEST_ASSERT_EQUAL_STRING("reset=panic", small);
+}
+
+void test_names(void)
+{
+  TEST_ASSERT_EQUAL_STRING("firmware_update", flight_phase_name(FLIGHT_PHASE_FIRMWARE_UPDATE));
+  TEST_ASSERT_EQUAL_STRING("unknown", flight_phase_name(FLIGHT_PHASE_COUNT));
+  TEST_ASSERT_EQUAL_STRING("task_wdt", reset_reason_name(6));
+  TEST_ASSERT_EQUAL_STRING("unknown", reset_reason_name(42));
+}
+
+void setUp(void)
+{
+  memset(&record, 0, sizeof(record));
+  memset(report, 0, sizeof(report));
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_garbage_record_starts_clean);
+  RUN_TEST(test_planned_sleep_is_not_reported);
+  RUN_TEST(test_crash_is_reported_with_phase_heap_and_logs);
+  RUN_TEST(test_log_ids_keep_most_recent);
+  RUN_TEST(test_pending_report_survives_until_taken);
+  RUN_TEST(test_take_report_truncates);
+  RUN_TEST(test_names);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
@@ -0,0 +1,236 @@
+#include <unity.h>
+#include <heap_trace.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/**
+ * Simulated heap: first-fit over a fixed arena with coalescing on free, sized
+ * like the free heap the firmware has once WiFi and TLS are up.
+ */
+static const size_t SIM_HEAP_SIZE = 128 * 1024;
+static const size_t SIM_ALIGN = 8;
+
+struct SimBlock
+{
+  size_t offset;
+  size_t size;
+  bool used;
+};
+
+static uint8_t sim_arena[SIM_HEAP_SIZE];
+static std::vector<SimBlock> sim_blocks;
+static uint32_t sim_now = 0;
+
+static void sim_reset(void)
+{
+  sim_blocks.clear();
+  sim_blocks.push_back({0, SIM_HEAP_SIZE, false});
+  sim_now = 0;
+}
+
+static void *sim_alloc(size_t size)
+{
+  size = (size + SIM_ALIGN - 1) & ~(SIM_ALIGN - 1);
+  for (size_t i = 0; i < sim_blocks.size(); i++)
+  {
+    SimBlock &block = sim_blocks[i];
+    if (block.used || block.size < size)
+      continue;
+    if (block.size > size)
+    {
+      SimBlock rest = {block.offset + size, block.size - size, false};
+      block.size = size;
+      sim_blocks.insert(sim_blocks.begin() + i + 1, rest);
+    }
+    sim_blocks[i].used = true;
+    return sim_arena + sim_blocks[i].offset;
+  }
+  return nullptr;
+}
+
+static void sim_free(void *ptr)
+{
+  size_t offset = (uint8_t *)ptr - sim_arena;
+  for (size_t i = 0; i < sim_blocks.size(); i++)
+  {
+    if (sim_blocks[i].offset != offset)
+      continue;
+    sim_blocks[i].used = false;
+    if (i + 1 < sim_blocks.size() && !sim_blocks[i + 1].used)
+    {
+      sim_blocks[i].size += sim_blocks[i + 1].size;
+      sim_blocks.erase(sim_blocks.begin() + i + 1);
+    }
+    if (i > 0 && !sim_blocks[i - 1].used)
+    {
+      sim_blocks[i - 1].size += sim_blocks[i].size;
+      sim_blocks.erase(sim_blocks.begin() + i);
+    }
+    return;
+  }
+}
+
+static size_t sim_free_size(void)
+{
+  size_t total = 0;
+  for (const SimBlock &block : sim_blocks)
+    if (!block.used)
+      total += block.size;
+  return total;
+}
+
+static size_t sim_largest_free_block(void)
+{
+  size_t largest = 0;
+  for (const SimBlock &block : sim_blocks)
+    if (!block.used && block.size > largest)
+      largest = block.size;
+  return largest;
+}
+
+static uint32_t sim_now_ms(void)
+{
+  return sim_now;
+}
+
+static const HeapTraceAllocator sim_allocator = {
+    sim_alloc,
+    sim_free,
+    sim_free_size,
+    sim_largest_free_block,
+    sim_now_ms,
+};
+
+static std::vector<std::string> dumped;
+
+static void capture_sink(const char *line)
+{
+  dumped.push_back(line);
+}
+
+void test_untraced_calls_fall_back_to_malloc(void)
+{
+  heap_trace_begin(nullptr);
+  void *ptr = heap_trace_malloc(4096, "plain");
+  TEST_ASSERT_NOT_NULL(ptr);
+  heap_trace_free(ptr);
+  TEST_ASSERT_NULL(heap_trace_alloc_at(0));
+}
+
+void test_small_allocations_are_not_recorded(void)
+{
+  void *small = heap_trace_malloc(64, "small");
+  void *large = heap_trace_malloc(2048, "large");
+
+  TEST_ASSERT_NOT_NULL(small);
+  TEST_ASSERT_NOT_NULL(heap_trace_alloc_at(0));
+  TEST_ASSERT_EQUAL_STRING("large", heap_trace_alloc_at(0)->tag);
+  TEST_ASSERT_NULL(heap_trace_alloc_at(1));
+
+  heap_trace_free(small);
+  heap_trace_free(large);
+  TEST_ASSERT_EQUAL(SIM_HEAP_SIZE, sim_free_size());
+}
+
+void test_lifetime_is_recorded(void)
+{
+  sim_now = 100;
+  void *ptr = heap_trace_malloc(48000, "download_buffer");
+  sim_now = 350;
+  heap_trace_free(ptr);
+
+  const HeapTraceAlloc *record = heap_trace_alloc_at(0);
+  TEST_ASSERT_NULL(record->ptr);
+  TEST_ASSERT_EQUAL(48000, record->size);
+  TEST_ASSERT_EQUAL(100, record->alloc_ms);
+  TEST_ASSERT_EQUAL(350, record->free_ms);
+  TEST_ASSERT_EQUAL(SIM_HEAP_SIZE, record->largest_free_block);
+  TEST_ASSERT_FALSE(record->failed);
+}
+
+/**
+ * Mirrors the PNG path of downloadAndShow(): the download buffer is freed while a
+ * long-lived allocation made after it sits behind it, so the framebuffer no
+ * longer fits even though the total free heap would be enough.
+ */
+void test_image_path_fragmentation_is_visible(void)
+{
+  heap_trace_phase("download");
+  void *download = heap_trace_malloc(40000, "download_buffer");
+  void *tls = heap_trace_malloc(30000, "tls_session");
+  heap_trace_phase("decode");
+  heap_trace_free(download);
+  void *decoded = heap_trace_malloc(48000, "png_decoded");
+  heap_trace_phase("display");
+  void *framebuffer = heap_trace_malloc(48000, "framebuffer");
+  heap_trace_phase(nullptr);
+
+  TEST_ASSERT_NULL(framebuffer);
+  TEST_ASSERT_TRUE(sim_free_size() >= 48000);
+
+  const HeapTraceAlloc *failed = heap_trace_alloc_at(3);
+  TEST_ASSERT_EQUAL_STRING("framebuffer", failed->tag);
+  TEST_ASSERT_TRUE(failed->failed);
+  TEST_ASSERT_EQUAL(40000, failed->largest_free_block);
+
+  const HeapTracePhase *decode = heap_trace_phase_at(1);
+  TEST_ASSERT_EQUAL_STRING("decode", decode->name);
+  TEST_ASSERT_TRUE(decode->ended);
+  TEST_ASSERT_TRUE(decode->largest_after < decode->largest_before);
+
+  dumped.clear();
+  heap_trace_dump(capture_sink);
+  TEST_ASSERT_EQUAL(3 + 4, dumped.size());
+  TEST_ASSERT_EQUAL_STRING("phase decode: free 61072 -> 53072, largest block 61072 -> 40000", dumped[1].c_str());
+  TEST_ASSERT_EQUAL_STRING("alloc tls_session: 30000 bytes at 0 ms, still live", dumped[4].c_str());
+  TEST_ASSERT_EQUAL_STRING("alloc framebuffer: 48000 bytes FAILED at 0 ms, largest block 40000", dumped[6].c_str());
+
+  heap_trace_free(tls);
+  heap_trace_free(decoded);
+  TEST_ASSERT_EQUAL(SIM_HEAP_SIZE, sim_free_size());
+}
+
+void test_full_table_counts_dropped(void)
+{
+  std::vector<void *> ptrs;
+  for (int i = 0; i < HEAP_TRACE_MAX_ALLOCS + 2; i++)
+    ptrs.push_back(heap_trace_malloc(1024, "chunk"));
+
+  TEST_ASSERT_EQUAL(2, heap_trace_dropped());
+  for (void *ptr : ptrs)
+    heap_trace_free(ptr);
+  TEST_ASSERT_EQUAL(SIM_HEAP_SIZE, sim_free_size());
+
+  dumped.clear();
+  heap_trace_dump(capture_sink);
+  TEST_ASSERT_EQUAL_STRING("2 allocations not recorded", dumped.back().c_str());
+}
+
+void setUp(void)
+{
+  sim_reset();
+  heap_trace_begin(&sim_allocator, 1024);
+}
+
+void tearDown(void)
+{
+  heap_trace_begin(nullptr);
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_untraced_calls_fall_back_to_malloc);
+  RUN_TEST(test_small_allocations_are_not_recorded);
+  RUN_TEST(test_lifetime_is_recorded);
+  RUN_TEST(test_image_path_fragmentation_is_visible);
+  RUN_TEST(test_full_table_counts_dropped);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
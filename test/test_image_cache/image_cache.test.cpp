@@ -0,0 +1,202 @@
+#include <unity.h>
+#include <image_cache.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static ImageCacheIndex index_;
+static std::vector<std::string> evicted;
+
+static void record_evict(const ImageCacheEntry &entry)
+{
+  char path[IMAGE_CACHE_PATH_SIZE];
+  image_cache_path(entry, path);
+  evicted.push_back(path);
+}
+
+static ImageCacheEntry *insert(const char *key, uint32_t size, uint32_t hash, uint32_t budget, bool &write_file)
+{
+  return image_cache_insert(index_, key, IMAGE_CACHE_PNG, size, hash, budget, record_evict, write_file);
+}
+
+void test_zeroed_index_is_invalid(void)
+{
+  memset(&index_, 0, sizeof(index_));
+  TEST_ASSERT_FALSE(image_cache_valid(index_));
+  image_cache_reset(index_);
+  TEST_ASSERT_TRUE(image_cache_valid(index_));
+}
+
+void test_hit_after_insert(void)
+{
+  bool write_file;
+  TEST_ASSERT_NOT_NULL(insert("plugin-a", 12000, 0xA, 100000, write_file));
+  TEST_ASSERT_TRUE(write_file);
+  image_cache_seal(index_);
+  TEST_ASSERT_TRUE(image_cache_valid(index_));
+
+  ImageCacheEntry *entry = image_cache_lookup(index_, "plugin-a");
+  TEST_ASSERT_NOT_NULL(entry);
+  TEST_ASSERT_EQUAL(12000, entry->size);
+  TEST_ASSERT_EQUAL(IMAGE_CACHE_PNG, entry->format);
+  TEST_ASSERT_NULL(image_cache_lookup(index_, "plugin-b"));
+
+  char path[IMAGE_CACHE_PATH_SIZE];
+  image_cache_path(*entry, path);
+  TEST_ASSERT_EQUAL_STRING("/img_0000000a.png", path);
+}
+
+void test_playlist_rotation_is_served_from_cache(void)
+{
+  const char *playlist[] = {"p1", "p2", "p3", "p4", "p5", "p6", "p7", "p8"};
+  bool write_file;
+  int downloads = 0;
+
+  for (int round = 0; round < 3; round++)
+  {
+    for (uint32_t i = 0; i < 8; i++)
+    {
+      if (image_cache_lookup(index_, playlist[i]))
+        continue;
+      downloads++;
+      insert(playlist[i], 10000, i + 1, 100000, write_file);
+    }
+  }
+
+  TEST_ASSERT_EQUAL(8, downloads);
+  TEST_ASSERT_EQUAL(0, evicted.size());
+  TEST_ASSERT_EQUAL(80000, image_cache_bytes(index_));
+}
+
+void test_least_recently_used_is_evicted_for_space(void)
+{
+  bool write_file;
+  insert("a", 40000, 1, 100000, write_file);
+  insert("b", 40000, 2, 100000, write_file);
+  image_cache_lookup(index_, "a");
+  insert("c", 40000, 3, 100000, write_file);
+
+  TEST_ASSERT_EQUAL(1, evicted.size());
+  TEST_ASSERT_EQUAL_STRING("/img_00000002.png", evicted[0].c_str());
+  TEST_ASSERT_NOT_NULL(image_cache_lookup(index_, "a"));
+  TEST_ASSERT_NULL(image_cache_lookup(index_, "b"));
+  TEST_ASSERT_EQUAL(80000, image_cache_bytes(index_));
+}
+
+void test_entry_limit_evicts(void)
+{
+  bool write_file;
+  for (uint32_t i = 0; i < IMAGE_CACHE_MAX_ENTRIES + 1; i++)
+  {
+    char key[8];
+    snprintf(key, sizeof(key), "k%u", (unsigned)i);
+    insert(key, 100, i + 1, 100000, write_file);
+  }
+  TEST_ASSERT_EQUAL(1, evicted.size());
+  TEST_ASSERT_NULL(image_cache_lookup(index_, "k0"));
+}
+
+void test_identical_content_shares_one_file(void)
+{
+  bool write_file;
+  insert("morning", 20000, 0x77, 100000, write_file);
+  TEST_ASSERT_TRUE(write_file);
+  insert("evening", 20000, 0x77, 100000, write_file);
+  TEST_ASSERT_FALSE(write_file);
+  TEST_ASSERT_EQUAL(20000, image_cache_bytes(index_));
+
+  image_cache_remove(index_, "morning", record_evict);
+  TEST_ASSERT_EQUAL(0, evicted.size());
+  image_cache_remove(index_, "evening", record_evict);
+  TEST_ASSERT_EQUAL(1, evicted.size());
+}
+
+void test_reinsert_of_evicted_content_keeps_file(void)
+{
+  bool write_file;
+  for (uint32_t i = 0; i < IMAGE_CACHE_MAX_ENTRIES; i++)
+  {
+    char key[8];
+    snprintf(key, sizeof(key), "k%u", (unsigned)i);
+    insert(key, 100, i + 1, 100000, write_file);
+  }
+
+  // the entry limit evicts k0, whose file holds the same image
+  TEST_ASSERT_NOT_NULL(insert("renamed", 100, 1, 100000, write_file));
+  TEST_ASSERT_FALSE(write_file);
+  TEST_ASSERT_EQUAL(0, evicted.size());
+  TEST_ASSERT_NULL(image_cache_lookup(index_, "k0"));
+}
+
+void test_oversized_and_long_keys_are_rejected(void)
+{
+  bool write_file = true;
+  TEST_ASSERT_NULL(insert("big", 200000, 1, 100000, write_file));
+  TEST_ASSERT_FALSE(write_file);
+
+  std::string long_key(IMAGE_CACHE_KEY_SIZE, 'x');
+  TEST_ASSERT_NULL(insert(long_key.c_str(), 100, 2, 100000, write_file));
+  TEST_ASSERT_NULL(insert("", 100, 3, 100000, write_file));
+}
+
+void test_changed_content_replaces_file(void)
+{
+  bool write_file;
+  insert("weather", 30000, 0x10, 100000, write_file);
+  insert("weather", 31000, 0x11, 100000, write_file);
+
+  TEST_ASSERT_TRUE(write_file);
+  TEST_ASSERT_EQUAL(1, evicted.size());
+  TEST_ASSERT_EQUAL_STRING("/img_00000010.png", evicted[0].c_str());
+  TEST_ASSERT_EQUAL(0x11, image_cache_lookup(index_, "weather")->hash);
+}
+
+void test_framebuffer_replaces_source(void)
+{
+  bool write_file;
+  insert("plugin-a", 12000, 0xA, 100000, write_file);
+  ImageCacheEntry *entry = image_cache_insert(index_, "plugin-a", IMAGE_CACHE_FRAMEBUFFER, 48000, 0xB, 100000,
+                                              record_evict, write_file);
+
+  TEST_ASSERT_TRUE(write_file);
+  TEST_ASSERT_EQUAL(1, evicted.size());
+  TEST_ASSERT_EQUAL_STRING("/img_0000000a.png", evicted[0].c_str());
+
+  char path[IMAGE_CACHE_PATH_SIZE];
+  image_cache_path(*entry, path);
+  TEST_ASSERT_EQUAL_STRING("/img_0000000b.fb", path);
+  TEST_ASSERT_EQUAL(IMAGE_CACHE_FRAMEBUFFER, image_cache_lookup(index_, "plugin-a")->format);
+}
+
+void setUp(void)
+{
+  image_cache_reset(index_);
+  evicted.clear();
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_zeroed_index_is_invalid);
+  RUN_TEST(test_hit_after_insert);
+  RUN_TEST(test_playlist_rotation_is_served_from_cache);
+  RUN_TEST(test_least_recently_used_is_evicted_for_space);
+  RUN_TEST(test_entry_limit_evicts);
+  RUN_TEST(test_identical_content_shares_one_file);
+  RUN_TEST(test_reinsert_of_evicted_content_keeps_file);
+  RUN_TEST(test_oversized_and_long_keys_are_rejected);
+  RUN_TEST(test_changed_content_replaces_file);
+  RUN_TEST(test_framebuffer_replaces_source);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
@@ -0,0 +1,261 @@
+#include <unity.h>
+#include <sim_heap.h>
+#include <bmp.h>
+#include <png_flip.h>
+#include <display.h>
+#include <prop_font.h>
+#include "GUI_Paint.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <functional>
+
+/**
+ * Benchmark of the work a wake does on the CPU: checking the image,
+ * flipping it and drawing into the framebuffer. The PNG decoder and the JSON
+ * of the API are left out until their baseline is written against PNGdec and
+ * ArduinoJson rather than the stand-ins of a host without them.
+ * Each kernel reports its time per call, and the bytes and the number of
+ * allocations it makes, against baseline.txt next to this file:
+ *   - more allocations or more bytes than the baseline fail,
+ *   - so does a time over the baseline by more than BENCH_TOLERANCE_PERCENT,
+ *   - and a kernel missing from the baseline.
+ * Times depend on the machine: before measuring an optimization, write the
+ * baseline on the machine you compare on and commit the new numbers with it.
+ *
+ * Built with the host stand-ins of the wake-cycle simulator, which count the
+ * heap and reach the drawing code in src/.
+ *
+ * pio test -e native_kernel_bench
+ * BENCH_UPDATE=1 pio test -e native_kernel_bench   (rewrites baseline.txt)
+ */
+
+#ifndef BENCH_TOLERANCE_PERCENT
+#define BENCH_TOLERANCE_PERCENT 25
+#endif
+
+#define BASELINE_PATH "./test/test_kernel_bench/baseline.txt"
+
+static const double BATCH_NS = 20e6; // long enough for the clock
+static const int BATCHES = 5;        // the fastest counts
+static const size_t MAX_KERNELS = 16;
+
+struct KernelResult
+{
+  char name[32];
+  double ns;
+  uint32_t bytes;
+  uint32_t allocations;
+};
+
+static KernelResult baseline[MAX_KERNELS];
+static size_t baseline_count = 0;
+static KernelResult results[MAX_KERNELS];
+static size_t result_count = 0;
+
+static uint8_t bmp[62 + 800 / 8 * 480];
+static uint8_t framebuffer[800 / 8 * 480];
+
+static void loadBaseline(void)
+{
+  FILE *file = fopen(BASELINE_PATH, "r");
+  if (!file)
+    return;
+  char line[128];
+  while (fgets(line, sizeof(line), file) && baseline_count < MAX_KERNELS)
+  {
+    KernelResult &entry = baseline[baseline_count];
+    if (line[0] != '#' && sscanf(line, "%31s %lf %u %u", entry.name, &entry.ns, &entry.bytes, &entry.allocations) == 4)
+      baseline_count++;
+  }
+  fclose(file);
+}
+
+static void writeBaseline(void)
+{
+  FILE *file = fopen(BASELINE_PATH, "w");
+  if (!file)
+  {
+    perror(BASELINE_PATH);
+    return;
+  }
+  fprintf(file, "# kernel ns/op bytes/op allocations/op, written by BENCH_UPDATE=1 pio test -e native_kernel_bench\n");
+  for (size_t i = 0; i < result_count; i++)
+    fprintf(file, "%s %.0f %u %u\n", results[i].name, results[i].ns, results[i].bytes, results[i].allocations);
+  fclose(file);
+  printf("baseline written to %s\n", BASELINE_PATH);
+}
+
+static const KernelResult *findBaseline(const char *name)
+{
+  for (size_t i = 0; i < baseline_count; i++)
+  {
+    if (strcmp(baseline[i].name, name) == 0)
+      return &baseline[i];
+  }
+  return nullptr;
+}
+
+/** The kernels log as they go; that goes nowhere while they are timed */
+static int muteStdout(void)
+{
+  fflush(stdout);
+  int saved = dup(STDOUT_FILENO);
+  int null = open("/dev/null", O_WRONLY);
+  dup2(null, STDOUT_FILENO);
+  close(null);
+  return saved;
+}
+
+static void restoreStdout(int saved)
+{
+  fflush(stdout);
+  dup2(saved, STDOUT_FILENO);
+  close(saved);
+}
+
+static double timeBatch(const std::function<void(void)> &kernel, long calls)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < calls; i++)
+    kernel();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+static void bench(const char *name, const std::function<void(void)> &kernel)
+{
+  int saved = muteStdout();
+  kernel(); // warm up
+
+  sim_heap_begin();
+  kernel();
+  uint32_t bytes = sim_heap_allocated();
+  uint32_t allocations = sim_heap_allocations();
+
+  long calls = 1;
+  while (calls < (1L << 24) && timeBatch(kernel, calls) < BATCH_NS)
+    calls *= 2;
+  double best = 0;
+  for (int i = 0; i < BATCHES; i++)
+  {
+    double ns = timeBatch(kernel, calls) / calls;
+    if (i == 0 || ns < best)
+      best = ns;
+  }
+  restoreStdout(saved);
+
+  KernelResult &result = results[result_count++];
+  snprintf(result.name, sizeof(result.name), "%s", name);
+  result.ns = best;
+  result.bytes = bytes;
+  result.allocations = allocations;
+
+  const KernelResult *base = findBaseline(name);
+  if (!base)
+  {
+    printf("%-24s %12.0f ns/op %8u B/op %4u allocs/op   no baseline\n", name, best, bytes, allocations);
+    // a kernel the baseline does not know about is not guarded
+    if (!getenv("BENCH_UPDATE"))
+      TEST_FAIL_MESSAGE("not in baseline.txt, rewrite it with BENCH_UPDATE=1");
+    return;
+  }
+  printf("%-24s %12.0f ns/op %8u B/op %4u allocs/op   baseline %12.0f ns/op %8u B/op %4u allocs/op, %+6.1f%%\n",
+         name, best, bytes, allocations, base->ns, base->bytes, base->allocations,
+         (best - base->ns) * 100 / base->ns);
+  if (getenv("BENCH_UPDATE"))
+    return;
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(base->allocations, allocations);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(base->bytes, bytes);
+  TEST_ASSERT_TRUE_MESSAGE(best <= base->ns * (100 + BENCH_TOLERANCE_PERCENT) / 100, "slower than the baseline");
+}
+
+/** An 800x480 1 bit BMP as the server sends it, with stripes */
+static void makeBMP(void)
+{
+  const uint32_t header[] = {sizeof(bmp), 0, 62, 40, 800, 480, 0x10001, 0, 48000, 0, 0, 2, 0};
+  memset(bmp, 0, sizeof(bmp));
+  bmp[0] = 'B';
+  bmp[1] = 'M';
+  memcpy(bmp + 2, header, sizeof(header));
+  memset(bmp + 58, 255, 3);
+  for (size_t i = 62; i < sizeof(bmp); i++)
+    bmp[i] = (i / 100) % 7 ? 0xFF : 0x0F;
+}
+
+void test_parseBMPHeader(void)
+{
+  bench("parseBMPHeader", [] {
+    bool reversed = false;
+    parseBMPHeader(bmp, reversed);
+  });
+}
+
+void test_flip_image(void)
+{
+  bench("flip_image", [] { flip_image(framebuffer, 800, 480); });
+}
+
+void test_horizontal_mirror(void)
+{
+  bench("horizontal_mirror", [] { horizontal_mirror(framebuffer, 800, 480); });
+}
+
+void test_Paint_DrawBitMap(void)
+{
+  bench("Paint_DrawBitMap", [] { Paint_DrawBitMap(bmp + 62); });
+}
+
+void test_Paint_DrawString_EN(void)
+{
+  bench("Paint_DrawString_EN", [] {
+    Paint_DrawString_EN(128, 340, "Can't establish WiFi connection.", &Font24, WHITE, BLACK);
+  });
+}
+
+void test_Paint_DrawMultilineText(void)
+{
+  bench("Paint_DrawMultilineText", [] {
+    Paint_DrawMultilineText(0, 300,
+                            "The device could not reach the server. Check the WiFi network, "
+                            "then hold the button on the back for five seconds to try again.",
+                            800, BLACK, WHITE, PropFont24, true);
+  });
+}
+
+void setUp(void)
+{
+  Paint_NewImage(framebuffer, 800, 480, ROTATE_0, WHITE);
+  Paint_Clear(WHITE);
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  makeBMP();
+  loadBaseline();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_parseBMPHeader);
+  RUN_TEST(test_flip_image);
+  RUN_TEST(test_horizontal_mirror);
+  RUN_TEST(test_Paint_DrawBitMap);
+  RUN_TEST(test_Paint_DrawString_EN);
+  RUN_TEST(test_Paint_DrawMultilineText);
+  UNITY_END();
+
+  if (getenv("BENCH_UPDATE"))
+    writeBaseline();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
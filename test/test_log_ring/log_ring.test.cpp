@@ -0,0 +1,150 @@
+#include <unity.h>
+#include <log_ring.h>
+#include <trmnl_log.h>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> dumped;
+
+static void capture_sink(uint8_t level, const char *line)
+{
+  dumped.push_back(line);
+}
+
+static std::string format_last(void)
+{
+  dumped.clear();
+  log_ring_dump(capture_sink);
+  return dumped.empty() ? "" : dumped.back();
+}
+
+void test_log_ring_formats_integers(void)
+{
+  log_ring_push(LOG_LEVEL_INFO, nullptr, 0, "retry: %d - time to sleep: %u", 2, 900u);
+  TEST_ASSERT_EQUAL_STRING("retry: 2 - time to sleep: 900", format_last().c_str());
+
+  log_ring_push(LOG_LEVEL_INFO, nullptr, 0, "%d %x %05d %lld", -1, -1, 42, (long long)-5000000000LL);
+  TEST_ASSERT_EQUAL_STRING("-1 ffffffff 00042 -5000000000", format_last().c_str());
+}
+
+void test_log_ring_formats_float_and_char(void)
+{
+  log_ring_push(LOG_LEVEL_INFO, nullptr, 0, "%.2f V %c", 4.2f, 'x');
+  TEST_ASSERT_EQUAL_STRING("4.20 V x", format_last().c_str());
+}
+
+void test_log_ring_copies_strings(void)
+{
+  char name[16];
+  strcpy(name, "/current.bmp");
+  log_ring_push(LOG_LEVEL_INFO, nullptr, 0, "file %s writing success - %d bytes", name, 48062);
+  strcpy(name, "overwritten");
+
+  TEST_ASSERT_EQUAL_STRING("file /current.bmp writing success - 48062 bytes", format_last().c_str());
+}
+
+void test_log_ring_truncates_long_strings(void)
+{
+  std::string long_value(200, 'a');
+  log_ring_push(LOG_LEVEL_INFO, nullptr, 0, "%s|%s", long_value.c_str(), "b");
+
+  // the first argument is cut and marked, the second has no room left
+  std::string expected = std::string(LOG_RING_TEXT_SIZE - 1 - 3, 'a') + "...|...";
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), format_last().c_str());
+}
+
+void test_log_ring_keeps_empty_strings_without_room(void)
+{
+  std::string long_value(200, 'a');
+  log_ring_push(LOG_LEVEL_INFO, nullptr, 0, "%s|%s|", long_value.c_str(), "");
+
+  std::string line = format_last();
+  TEST_ASSERT_EQUAL_STRING("...||", line.substr(line.size() - 5).c_str());
+}
+
+void test_log_ring_prints_percent_and_missing_args(void)
+{
+  log_ring_push(LOG_LEVEL_INFO, nullptr, 0, "NVS Usage: 50%% %d %s", 7);
+  TEST_ASSERT_EQUAL_STRING("NVS Usage: 50% 7 %s", format_last().c_str());
+}
+
+void test_log_ring_prefixes_file_and_line(void)
+{
+  log_ring_push(LOG_LEVEL_ERROR, "src/bl.cpp", 123, "unable to connect");
+  TEST_ASSERT_EQUAL_STRING("src/bl.cpp [123]: unable to connect", format_last().c_str());
+}
+
+void test_log_ring_overwrites_oldest(void)
+{
+  for (int i = 0; i < LOG_RING_CAPACITY + 3; i++)
+  {
+    log_ring_push(LOG_LEVEL_INFO, nullptr, 0, "entry %d", i);
+  }
+  TEST_ASSERT_EQUAL(LOG_RING_CAPACITY, log_ring_count());
+
+  dumped.clear();
+  TEST_ASSERT_EQUAL(LOG_RING_CAPACITY, log_ring_dump(capture_sink));
+  TEST_ASSERT_EQUAL_STRING("entry 3", dumped.front().c_str());
+  TEST_ASSERT_EQUAL_STRING(("entry " + std::to_string(LOG_RING_CAPACITY + 2)).c_str(), dumped.back().c_str());
+  TEST_ASSERT_EQUAL(0, log_ring_count());
+}
+
+void test_log_deferred_macro_records_call_site(void)
+{
+  Log_deferred(LOG_LEVEL_INFO, "Download end: %d/%d bytes", 100, 48062);
+
+  std::string line = format_last();
+  TEST_ASSERT_TRUE(line.find("log_ring.test.cpp [") != std::string::npos);
+  TEST_ASSERT_TRUE(line.find("Download end: 100/48062 bytes") != std::string::npos);
+}
+
+static std::vector<std::string> observed;
+
+static void capture_observer(const LogRingRecord &record)
+{
+  observed.push_back(record.format);
+}
+
+void test_log_immediate_macro_notifies_observer(void)
+{
+  observed.clear();
+  log_ring_set_observer(capture_observer);
+  Log_info("Download end: %d/%d bytes", 100, 48062);
+  log_ring_set_observer(nullptr);
+
+  // formatted right away, but the observer still sees the call
+  TEST_ASSERT_EQUAL(0, log_ring_count());
+  TEST_ASSERT_EQUAL(1, observed.size());
+  TEST_ASSERT_EQUAL_STRING("Download end: %d/%d bytes", observed[0].c_str());
+}
+
+void setUp(void)
+{
+  log_ring_clear();
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_log_ring_formats_integers);
+  RUN_TEST(test_log_ring_formats_float_and_char);
+  RUN_TEST(test_log_ring_copies_strings);
+  RUN_TEST(test_log_ring_truncates_long_strings);
+  RUN_TEST(test_log_ring_keeps_empty_strings_without_room);
+  RUN_TEST(test_log_ring_prints_percent_and_missing_args);
+  RUN_TEST(test_log_ring_prefixes_file_and_line);
+  RUN_TEST(test_log_ring_overwrites_oldest);
+  RUN_TEST(test_log_deferred_macro_records_call_site);
+  RUN_TEST(test_log_immediate_macro_notifies_observer);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
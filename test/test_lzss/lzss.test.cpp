@@ -0,0 +1,88 @@
+#include <unity.h>
+#include <lzss.h>
+#include <string.h>
+
+// 1, 2, 3, 4 then two 130 byte copies from 4 back, past the end of the window,
+// then 3 bytes from 256 back
+static const uint8_t stream[] = {0x03, 1, 2, 3, 4, 0xFF, 3, 0xFF, 3, 0x80, 0xFF};
+static const size_t STREAM_SIZE = 4 + 130 + 130 + 3;
+
+static uint8_t expected[STREAM_SIZE];
+static uint8_t out[STREAM_SIZE + 16];
+static LzssDecoder decoder;
+
+void test_decodes_literals_and_overlapping_copies(void)
+{
+  lzss_decoder_init(decoder, stream, sizeof(stream));
+  TEST_ASSERT_EQUAL(STREAM_SIZE, lzss_decode(decoder, out, sizeof(out)));
+  TEST_ASSERT_FALSE(decoder.error);
+  TEST_ASSERT_EQUAL_MEMORY(expected, out, STREAM_SIZE);
+}
+
+void test_decodes_in_pieces(void)
+{
+  // row sized pieces that end in the middle of literals and copies
+  lzss_decoder_init(decoder, stream, sizeof(stream));
+  size_t done = 0;
+  while (done < STREAM_SIZE)
+  {
+    size_t piece = lzss_decode(decoder, out + done, 3);
+    if (!piece)
+      break;
+    done += piece;
+  }
+  TEST_ASSERT_EQUAL(STREAM_SIZE, done);
+  TEST_ASSERT_FALSE(decoder.error);
+  TEST_ASSERT_EQUAL_MEMORY(expected, out, STREAM_SIZE);
+  TEST_ASSERT_EQUAL(0, lzss_decode(decoder, out, 1));
+}
+
+void test_copy_before_the_start_is_an_error(void)
+{
+  static const uint8_t bad[] = {0x01, 7, 8, 0x80, 0x02};
+  lzss_decoder_init(decoder, bad, sizeof(bad));
+  TEST_ASSERT_EQUAL(2, lzss_decode(decoder, out, sizeof(out)));
+  TEST_ASSERT_TRUE(decoder.error);
+}
+
+void test_truncated_stream_is_an_error(void)
+{
+  static const uint8_t bad[] = {0x05, 7, 8};
+  lzss_decoder_init(decoder, bad, sizeof(bad));
+  TEST_ASSERT_EQUAL(2, lzss_decode(decoder, out, sizeof(out)));
+  TEST_ASSERT_TRUE(decoder.error);
+
+  static const uint8_t no_distance[] = {0x00, 7, 0x80};
+  lzss_decoder_init(decoder, no_distance, sizeof(no_distance));
+  TEST_ASSERT_EQUAL(1, lzss_decode(decoder, out, sizeof(out)));
+  TEST_ASSERT_TRUE(decoder.error);
+}
+
+void setUp(void)
+{
+  for (size_t i = 0; i < 4 + 130 + 130; i++)
+    expected[i] = i % 4 + 1;
+  for (size_t i = 264; i < STREAM_SIZE; i++)
+    expected[i] = expected[i - 256];
+  memset(out, 0, sizeof(out));
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_decodes_literals_and_overlapping_copies);
+  RUN_TEST(test_decodes_in_pieces);
+  RUN_TEST(test_copy_before_the_start_is_an_error);
+  RUN_TEST(test_truncated_stream_is_an_error);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include <unity.h>
+#include <ota_delta.h>
+#include <string.h>
+
+static void put32(uint8_t *out, uint32_t value)
+{
+  out[0] = value;
+  out[1] = value >> 8;
+  out[2] = value >> 16;
+  out[3] = value >> 24;
+}
+
+void test_header(void)
+{
+  uint8_t data[OTA_DELTA_HEADER_SIZE];
+  put32(data, OTA_DELTA_MAGIC);
+  put32(data + 4, 1200000);
+  for (size_t i = 0; i < SHA256_DIGEST_SIZE; i++)
+    data[8 + i] = i;
+  put32(data + 8 + SHA256_DIGEST_SIZE, 1210000);
+
+  OtaDeltaHeader header;
+  TEST_ASSERT_TRUE(ota_delta_header(data, header));
+  TEST_ASSERT_EQUAL(1200000, header.source_size);
+  TEST_ASSERT_EQUAL(1210000, header.target_size);
+  TEST_ASSERT_EQUAL_MEMORY(data + 8, header.source_sha256, SHA256_DIGEST_SIZE);
+
+  // a whole image starts with 0xE9, not the magic
+  data[0] = 0xE9;
+  TEST_ASSERT_FALSE(ota_delta_header(data, header));
+}
+
+void test_block_length(void)
+{
+  TEST_ASSERT_EQUAL(OTA_DELTA_BLOCK_SIZE, ota_delta_block_length(10000, 0));
+  TEST_ASSERT_EQUAL(10000 - 2 * OTA_DELTA_BLOCK_SIZE, ota_delta_block_length(10000, 2 * OTA_DELTA_BLOCK_SIZE));
+  TEST_ASSERT_EQUAL(0, ota_delta_block_length(10000, 3 * OTA_DELTA_BLOCK_SIZE));
+}
+
+void test_block(void)
+{
+  uint8_t data[OTA_DELTA_BLOCK_HEADER_SIZE];
+  OtaDeltaBlock block;
+
+  put32(data, 8192);
+  put32(data + 4, 300);
+  TEST_ASSERT_TRUE(ota_delta_block(data, OTA_DELTA_BLOCK_SIZE, 8192 + OTA_DELTA_BLOCK_SIZE, block));
+  TEST_ASSERT_EQUAL(8192, block.source);
+  TEST_ASSERT_EQUAL(300, block.packed);
+
+  // reads past the end of the running image
+  TEST_ASSERT_FALSE(ota_delta_block(data, OTA_DELTA_BLOCK_SIZE, 8192 + 100, block));
+  TEST_ASSERT_TRUE(ota_delta_block(data, 100, 8192 + 100, block));
+
+  put32(data, OTA_DELTA_NO_SOURCE);
+  TEST_ASSERT_TRUE(ota_delta_block(data, OTA_DELTA_BLOCK_SIZE, 100, block));
+  put32(data + 4, 0);
+  TEST_ASSERT_FALSE(ota_delta_block(data, OTA_DELTA_BLOCK_SIZE, 100, block));
+  put32(data + 4, OTA_DELTA_MAX_PACKED + 1);
+  TEST_ASSERT_FALSE(ota_delta_block(data, OTA_DELTA_BLOCK_SIZE, 100, block));
+}
+
+void test_decode_adds_the_source(void)
+{
+  static const uint8_t source[] = {10, 20, 30, 40, 50, 60, 70, 250};
+  // 1, 2, 3 then five zeroes: the last five bytes are unchanged, the last one wraps
+  static const uint8_t packed[] = {0x03, 1, 2, 3, 0, 0x81, 0};
+  static const uint8_t expected[] = {11, 22, 33, 40, 50, 60, 70, 250};
+  uint8_t out[sizeof(expected)];
+
+  LzssDecoder decoder;
+  lzss_decoder_init(decoder, packed, sizeof(packed));
+  TEST_ASSERT_EQUAL(5, ota_delta_decode(decoder, source, out, 5));
+  TEST_ASSERT_EQUAL(3, ota_delta_decode(decoder, source + 5, out + 5, 3));
+  TEST_ASSERT_FALSE(decoder.error);
+  TEST_ASSERT_EQUAL_MEMORY(expected, out, sizeof(expected));
+}
+
+void test_decode_without_source(void)
+{
+  static const uint8_t packed[] = {0x02, 0xE9, 7, 8};
+  static const uint8_t expected[] = {0xE9, 7, 8};
+  uint8_t out[sizeof(expected)];
+
+  LzssDecoder decoder;
+  lzss_decoder_init(decoder, packed, sizeof(packed));
+  TEST_ASSERT_EQUAL(3, ota_delta_decode(decoder, nullptr, out, sizeof(out)));
+  TEST_ASSERT_EQUAL_MEMORY(expected, out, sizeof(expected));
+
+  // cut short: fewer bytes than the block needs
+  lzss_decoder_init(decoder, packed, 2);
+  TEST_ASSERT_EQUAL(1, ota_delta_decode(decoder, nullptr, out, sizeof(out)));
+  TEST_ASSERT_TRUE(decoder.error);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_header);
+  RUN_TEST(test_block_length);
+  RUN_TEST(test_block);
+  RUN_TEST(test_decode_adds_the_source);
+  RUN_TEST(test_decode_without_source);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
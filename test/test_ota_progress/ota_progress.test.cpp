@@ -0,0 +1,113 @@
+#include <unity.h>
+#include <ota_progress.h>
+#include <string.h>
+
+static const char *const URL = "https://trmnl.app/firmware/1.5.8.bin";
+static const char *const HASH = "9f86d081884c7d659a2feaa0c55ad015a3bf4f1b2b0b822cd15d6c15b0f00a08";
+
+void test_image_id(void)
+{
+  uint32_t image = ota_image_id(URL, HASH);
+  TEST_ASSERT_EQUAL_HEX32(image, ota_image_id(URL, HASH));
+  TEST_ASSERT_NOT_EQUAL(image, ota_image_id(URL, ""));
+  TEST_ASSERT_NOT_EQUAL(image, ota_image_id("https://trmnl.app/firmware/1.5.9.bin", HASH));
+}
+
+void test_start_and_resume(void)
+{
+  uint32_t image = ota_image_id(URL, HASH);
+  OtaProgress progress;
+  memset(&progress, 0, sizeof(progress));
+  // NVS had nothing: zeroes never resume
+  TEST_ASSERT_FALSE(ota_progress_resumes(progress, image));
+
+  ota_progress_start(progress, image);
+  TEST_ASSERT_TRUE(ota_progress_resumes(progress, image));
+  TEST_ASSERT_EQUAL(0, progress.written);
+  TEST_ASSERT_FALSE(ota_progress_resumes(progress, ota_image_id(URL, "")));
+
+  progress.size = OTA_CHECKPOINT_SIZE;
+  progress.written = 2 * OTA_CHECKPOINT_SIZE;
+  TEST_ASSERT_FALSE(ota_progress_resumes(progress, image));
+
+  // a patch: fewer bytes received than written, but not more than its length
+  progress.size = 4 * OTA_CHECKPOINT_SIZE;
+  progress.received = 5000;
+  progress.length = 4000;
+  TEST_ASSERT_FALSE(ota_progress_resumes(progress, image));
+  progress.length = 9000;
+  TEST_ASSERT_TRUE(ota_progress_resumes(progress, image));
+}
+
+void test_checkpoint(void)
+{
+  static uint8_t image[3 * OTA_CHECKPOINT_SIZE];
+  for (size_t i = 0; i < sizeof(image); i++)
+    image[i] = i * 7;
+
+  OtaProgress progress;
+  ota_progress_start(progress, 1);
+  Sha256 sha;
+  ota_progress_hash(progress, sha);
+  sha256_update(sha, image, OTA_CHECKPOINT_SIZE + 100);
+  TEST_ASSERT_FALSE(ota_progress_checkpoint(progress, sha, OTA_CHECKPOINT_SIZE + 100));
+  TEST_ASSERT_EQUAL(0, progress.written);
+
+  ota_progress_hash(progress, sha);
+  sha256_update(sha, image, 2 * OTA_CHECKPOINT_SIZE);
+  TEST_ASSERT_TRUE(ota_progress_checkpoint(progress, sha, 2 * OTA_CHECKPOINT_SIZE));
+  TEST_ASSERT_EQUAL(2 * OTA_CHECKPOINT_SIZE, progress.written);
+  TEST_ASSERT_EQUAL(2 * OTA_CHECKPOINT_SIZE, progress.received);
+
+  // the rest hashed after a restart gives the hash of the whole image
+  Sha256 resumed;
+  ota_progress_hash(progress, resumed);
+  sha256_update(resumed, image + progress.written, sizeof(image) - progress.written);
+  uint8_t expected[SHA256_DIGEST_SIZE], actual[SHA256_DIGEST_SIZE];
+  sha256_init(sha);
+  sha256_update(sha, image, sizeof(image));
+  sha256_finish(sha, expected);
+  sha256_finish(resumed, actual);
+  TEST_ASSERT_EQUAL_MEMORY(expected, actual, SHA256_DIGEST_SIZE);
+}
+
+void test_content_range(void)
+{
+  uint32_t start = 0, total = 0;
+  TEST_ASSERT_TRUE(ota_parse_content_range("bytes 65536-1310719/1310720", start, total));
+  TEST_ASSERT_EQUAL(65536, start);
+  TEST_ASSERT_EQUAL(1310720, total);
+
+  TEST_ASSERT_FALSE(ota_parse_content_range("bytes 65536-1310719/*", start, total));
+  TEST_ASSERT_FALSE(ota_parse_content_range("bytes */1310720", start, total));
+  TEST_ASSERT_FALSE(ota_parse_content_range("bytes 100-50/1310720", start, total));
+  TEST_ASSERT_FALSE(ota_parse_content_range("bytes 0-1310720/1310720", start, total));
+  TEST_ASSERT_FALSE(ota_parse_content_range("items 0-9/10", start, total));
+  TEST_ASSERT_FALSE(ota_parse_content_range("", start, total));
+  TEST_ASSERT_FALSE(ota_parse_content_range(nullptr, start, total));
+  TEST_ASSERT_EQUAL(65536, start);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_image_id);
+  RUN_TEST(test_start_and_resume);
+  RUN_TEST(test_checkpoint);
+  RUN_TEST(test_content_range);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
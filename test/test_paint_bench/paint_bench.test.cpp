@@ -0,0 +1,218 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+
+/**
+ * Benchmark of the GUI_Paint drawing the device does before each refresh:
+ * the message screens of display_show_msg() and the pixel-by-pixel shapes.
+ * Every workload runs with the Paint_SetPixel() picked for the image and
+ * again with the generic one, and both must leave the same framebuffer.
+ * The clear and window fills are checked against pixel-by-pixel versions.
+ *
+ * The library sources are compiled into this test (the panel drivers in the
+ * same library need the real SPI), so the static functions are reachable.
+ *
+ * pio test -e native_paint_bench
+ */
+#include <GUI_Paint.cpp>
+#include <font24.cpp>
+
+static const UWORD WIDTH = 800;
+static const UWORD HEIGHT = 480;
+static const int RUNS = 50;
+
+static UBYTE framebuffer[WIDTH / 8 * HEIGHT];
+static UBYTE reference[WIDTH / 8 * HEIGHT];
+static unsigned char logo[62 + WIDTH / 8 * HEIGHT];
+static unsigned char qr[130 / 8 * 130 + 130];
+
+/** Centered like display_show_msg() does it */
+static void drawCentered(UWORD y, const char *text)
+{
+  size_t size = strlen(text) + 1;
+  Paint_DrawString_EN((800 - size * 17 > 9) ? (800 - size * 17) / 2 + 9 : 0, y, text, &Font24, WHITE, BLACK);
+}
+
+static void wifiFailedScreen(void)
+{
+  Paint_Clear(WHITE);
+  Paint_DrawBitMap(logo + 62);
+  drawCentered(340, "Can't establish WiFi");
+  drawCentered(370, "connection. Hold button on");
+  drawCentered(400, "the back to reset WiFi");
+  drawCentered(430, "or scan QR Code for help.");
+  Paint_DrawImage(qr, 640, 337, 130, 130);
+}
+
+static void friendlyIdScreen(void)
+{
+  Paint_Clear(WHITE);
+  Paint_DrawBitMap(logo + 62);
+  drawCentered(400, "Please sign up at usetrmnl.com/signup");
+  drawCentered(430, "with Friendly ID 8F3A2C to finish setup");
+}
+
+static void shapes(void)
+{
+  Paint_Clear(WHITE);
+  for (UWORD i = 0; i < 20; i++)
+  {
+    Paint_DrawLine(0, i * 24, WIDTH - 1, HEIGHT - 1 - i * 24, BLACK, DOT_PIXEL_1X1, LINE_STYLE_SOLID);
+    Paint_DrawRectangle(10 + i * 20, 10 + i * 10, 200 + i * 20, 100 + i * 10, BLACK, DOT_PIXEL_2X2, DRAW_FILL_EMPTY);
+    Paint_DrawCircle(400, 240, 10 + i * 11, BLACK, DOT_PIXEL_1X1, DRAW_FILL_EMPTY);
+  }
+  Paint_DrawRectangle(600, 300, 780, 460, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+}
+
+static void pixels(void)
+{
+  for (UWORD y = 0; y < HEIGHT; y++)
+    for (UWORD x = 0; x < WIDTH; x++)
+      Paint_SetPixel(x, y, (x ^ y) & 1 ? BLACK : WHITE);
+}
+
+/** Returns microseconds per run; leaves the framebuffer of the last run */
+static double timeRuns(UBYTE *image, UWORD rotate, bool generic, std::function<void(void)> draw)
+{
+  Paint_NewImage(image, WIDTH, HEIGHT, rotate, WHITE);
+  if (generic)
+    Paint_Pixel = Paint_SetPixel_Generic;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < RUNS; i++)
+    draw();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() / RUNS;
+}
+
+static void compare(const char *name, UWORD rotate, std::function<void(void)> draw)
+{
+  double generic = timeRuns(reference, rotate, true, draw);
+  double selected = timeRuns(framebuffer, rotate, false, draw);
+  printf("%-22s rotate %3u: generic %9.1f us, selected %9.1f us, %5.2fx\n", name, rotate, generic, selected,
+         generic / selected);
+  TEST_ASSERT_EQUAL_MEMORY(reference, framebuffer, sizeof(framebuffer));
+}
+
+void test_message_screens(void)
+{
+  compare("wifi failed screen", ROTATE_0, wifiFailedScreen);
+  compare("friendly id screen", ROTATE_0, friendlyIdScreen);
+}
+
+void test_shapes(void)
+{
+  compare("lines, boxes, circles", ROTATE_0, shapes);
+  compare("lines, boxes, circles", ROTATE_90, shapes);
+}
+
+/** The fills Paint_ClearWindows() and Paint_Clear() replaced, pixel by pixel and byte by byte */
+static void windowsByPixel(UWORD Xstart, UWORD Ystart, UWORD Xend, UWORD Yend, UWORD Color)
+{
+  for (UWORD y = Ystart; y < Yend; y++)
+    for (UWORD x = Xstart; x < Xend; x++)
+      Paint_SetPixel_Generic(x, y, Color);
+}
+
+static void clear7ByByte(UWORD Color)
+{
+  UWORD Width = (Paint.WidthMemory * 3 % 8 == 0) ? (Paint.WidthMemory * 3 / 8) : (Paint.WidthMemory * 3 / 8 + 1);
+  for (UWORD y = 0; y < Paint.HeightByte; y++)
+  {
+    for (UWORD x = 0; x < Width; x++)
+    {
+      UDOUBLE Addr = x + y * Width;
+      if (Addr % 3 == 0)
+        Paint.Image[Addr] = ((Color << 5) | (Color << 2) | (Color >> 1));
+      else if (Addr % 3 == 1)
+        Paint.Image[Addr] = ((Color << 7) | (Color << 4) | (Color << 1) | (Color >> 2));
+      else
+        Paint.Image[Addr] = ((Color << 6) | (Color << 3) | Color);
+    }
+  }
+}
+
+static void windows(void)
+{
+  Paint_ClearWindows(0, 0, WIDTH, HEIGHT, WHITE);
+  for (UWORD i = 0; i < 40; i++)
+    Paint_ClearWindows(i * 17 % 700, i * 11 % 400, i * 17 % 700 + 1 + i * 3, i * 11 % 400 + 1 + i * 2, i & 1 ? BLACK : WHITE);
+  Paint_ClearWindows(795, 470, 900, 500, BLACK); // clipped at the corner
+}
+
+static void windowsReference(void)
+{
+  windowsByPixel(0, 0, WIDTH, HEIGHT, WHITE);
+  for (UWORD i = 0; i < 40; i++)
+    windowsByPixel(i * 17 % 700, i * 11 % 400, i * 17 % 700 + 1 + i * 3, i * 11 % 400 + 1 + i * 2, i & 1 ? BLACK : WHITE);
+  windowsByPixel(795, 470, WIDTH, HEIGHT, BLACK);
+}
+
+static void compareFills(const char *name, UBYTE scale, UWORD height, std::function<void(void)> slow,
+                         std::function<void(void)> fast)
+{
+  memset(reference, 0, sizeof(reference));
+  memset(framebuffer, 0, sizeof(framebuffer));
+  Paint_NewImage(reference, WIDTH, height, ROTATE_0, WHITE);
+  Paint_SetScale(scale);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < RUNS; i++)
+    slow();
+  auto middle = std::chrono::steady_clock::now();
+  Paint_NewImage(framebuffer, WIDTH, height, ROTATE_0, WHITE);
+  Paint_SetScale(scale);
+  for (int i = 0; i < RUNS; i++)
+    fast();
+  auto end = std::chrono::steady_clock::now();
+
+  double before = std::chrono::duration<double, std::micro>(middle - start).count() / RUNS;
+  double after = std::chrono::duration<double, std::micro>(end - middle).count() / RUNS;
+  printf("%-22s scale %4u: per pixel %8.1f us, fill %11.1f us, %5.2fx\n", name, scale, before, after, before / after);
+  TEST_ASSERT_EQUAL_MEMORY(reference, framebuffer, sizeof(framebuffer));
+}
+
+void test_fills(void)
+{
+  compareFills("windows", 2, HEIGHT, windowsReference, windows);
+  // 3 bits per pixel: a third of the panel fits in the 1bpp framebuffer
+  compareFills("7-colour clear", 7, HEIGHT / 3, []()
+               { clear7ByByte(0x5); },
+               []()
+               { Paint_Clear(0x5); });
+}
+
+void test_every_pixel(void)
+{
+  compare("every pixel", ROTATE_0, pixels);
+  compare("every pixel", ROTATE_270, pixels);
+}
+
+void setUp(void)
+{
+  for (size_t i = 0; i < sizeof(logo); i++)
+    logo[i] = (i * 131) >> 3;
+  for (size_t i = 0; i < sizeof(qr); i++)
+    qr[i] = i * 37;
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_message_screens);
+  RUN_TEST(test_shapes);
+  RUN_TEST(test_every_pixel);
+  RUN_TEST(test_fills);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
@@ -0,0 +1,231 @@
+#include <ArduinoFake.h>
+#include <unity.h>
+#include <epd_sim.h>
+#include <wake_state.h>
+#include <PNGdec.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/**
+ * The 7.5" V2 driver and GUI_Paint running against the panel simulator.
+ * The golden images are kept as CRCs of the screen; every screen is also
+ * saved under SNAPSHOTS as a PNG, to look at when a CRC changes.
+ *
+ * The library sources are compiled into this test, like in the paint
+ * bench, with epd_sim.h first so the driver's register access reaches the
+ * simulator. The driver's Debug() would print through Serial, which
+ * ArduinoFake would need stubs for, so it is compiled out.
+ *
+ * pio test -e native_panel_sim
+ */
+#define __DEBUG_H
+#define Debug(__info)
+#include <utility/EPD_7in5_V2.cpp>
+#include <GUI_Paint.cpp>
+#include <font24.cpp>
+
+#define SNAPSHOTS ".pio/panel_sim"
+
+using namespace fakeit;
+
+static const size_t FRAME_SIZE = EPD_SIM_WIDTH / 8 * EPD_SIM_HEIGHT;
+
+static UBYTE framebuffer[FRAME_SIZE];
+
+static void snapshot(const char *name)
+{
+  char path[64];
+  snprintf(path, sizeof(path), SNAPSHOTS "/%s.png", name);
+  TEST_ASSERT_TRUE(epd_sim_write_png(path));
+}
+
+static uint32_t screenCrc(void)
+{
+  return wake_state_crc32(epd_sim_screen(), FRAME_SIZE);
+}
+
+/** Text and shapes over most of the panel, drawn the way display.cpp does */
+static void drawScreen(void)
+{
+  Paint_NewImage(framebuffer, EPD_SIM_WIDTH, EPD_SIM_HEIGHT, 0, WHITE);
+  Paint_SelectImage(framebuffer);
+  Paint_Clear(WHITE);
+  Paint_DrawRectangle(10, 10, 790, 470, BLACK, DOT_PIXEL_2X2, DRAW_FILL_EMPTY);
+  Paint_DrawCircle(200, 240, 120, BLACK, DOT_PIXEL_1X1, DRAW_FILL_FULL);
+  Paint_DrawLine(400, 40, 760, 440, BLACK, DOT_PIXEL_3X3, LINE_STYLE_SOLID);
+  Paint_DrawString_EN(360, 200, "Panel simulator", &Font24, WHITE, BLACK);
+  Paint_DrawString_EN(360, 240, "0x13 0x12", &Font24, BLACK, WHITE);
+}
+
+void test_clear_white(void)
+{
+  EPD_7IN5_V2_Init_New();
+  EPD_7IN5_V2_ClearBlack();
+  EPD_7IN5_V2_ClearWhite();
+
+  const EpdSimStats &stats = epd_sim_stats();
+  for (size_t i = 0; i < FRAME_SIZE; i++)
+    TEST_ASSERT_EQUAL_HEX8(0xFF, epd_sim_screen()[i]);
+  TEST_ASSERT_EQUAL(1, stats.resets);
+  TEST_ASSERT_EQUAL(2, stats.full_refreshes);
+  TEST_ASSERT_EQUAL(0, stats.busy_writes);
+  TEST_ASSERT_EQUAL(0, stats.ignored_bytes);
+  TEST_ASSERT_GREATER_OR_EQUAL(2 * FRAME_SIZE, stats.data_bytes);
+  // the second clear waited for the first refresh
+  TEST_ASSERT_GREATER_OR_EQUAL(EPD_SIM_FULL_REFRESH_MS * 1000ULL, stats.time_us);
+}
+
+void test_display_golden(void)
+{
+  drawScreen();
+  EPD_7IN5_V2_Init_New();
+  EPD_7IN5_V2_Display(framebuffer);
+  snapshot("display");
+
+  TEST_ASSERT_EQUAL_MEMORY(framebuffer, epd_sim_screen(), FRAME_SIZE);
+  TEST_ASSERT_EQUAL_HEX32(0x561C6C67, screenCrc());
+  TEST_ASSERT_EQUAL(1, epd_sim_stats().full_refreshes);
+  TEST_ASSERT_EQUAL(0, epd_sim_stats().busy_writes);
+}
+
+void test_stream_matches_display(void)
+{
+  drawScreen();
+  EPD_7IN5_V2_Init_New();
+  EPD_7IN5_V2_Display(framebuffer);
+  uint32_t data_bytes = epd_sim_stats().data_bytes;
+  uint32_t whole = screenCrc();
+
+  epd_sim_begin();
+  EPD_7IN5_V2_Init_New();
+  EPD_7IN5_V2_Display_Begin();
+  for (size_t offset = 0; offset < FRAME_SIZE; offset += 1000)
+    EPD_7IN5_V2_Display_Write(framebuffer + offset, FRAME_SIZE - offset < 1000 ? FRAME_SIZE - offset : 1000);
+  EPD_7IN5_V2_Display_End();
+
+  TEST_ASSERT_EQUAL_HEX32(whole, screenCrc());
+  TEST_ASSERT_EQUAL(data_bytes, epd_sim_stats().data_bytes);
+}
+
+void test_fast_waveform(void)
+{
+  drawScreen();
+  EPD_7IN5_V2_Init_Fast();
+  EPD_7IN5_V2_Display(framebuffer);
+  EPD_7IN5_V2_Sleep();
+
+  const EpdSimStats &stats = epd_sim_stats();
+  TEST_ASSERT_EQUAL_MEMORY(framebuffer, epd_sim_screen(), FRAME_SIZE);
+  TEST_ASSERT_EQUAL(0, stats.full_refreshes);
+  TEST_ASSERT_EQUAL(1, stats.fast_refreshes);
+  TEST_ASSERT_EQUAL(EPD_SIM_FAST_REFRESH_MS * 1000ULL, stats.refresh_us);
+  // 200 + 2 + 200 ms reset, power on, refresh, power off
+  TEST_ASSERT_GREATER_OR_EQUAL((402 + EPD_SIM_FAST_REFRESH_MS) * 1000ULL, stats.time_us);
+}
+
+void test_asleep_until_reset(void)
+{
+  EPD_7IN5_V2_Init_New();
+  EPD_7IN5_V2_Sleep();
+  TEST_ASSERT_TRUE(epd_sim_asleep());
+
+  drawScreen();
+  EPD_7IN5_V2_Display(framebuffer);
+  TEST_ASSERT_EQUAL(FRAME_SIZE, epd_sim_stats().ignored_bytes);
+  TEST_ASSERT_EQUAL(0, epd_sim_stats().full_refreshes);
+
+  EPD_7IN5_V2_Init_New();
+  TEST_ASSERT_FALSE(epd_sim_asleep());
+  EPD_7IN5_V2_Display(framebuffer);
+  TEST_ASSERT_EQUAL_MEMORY(framebuffer, epd_sim_screen(), FRAME_SIZE);
+}
+
+void test_partial_window(void)
+{
+  drawScreen();
+  EPD_7IN5_V2_Init_New();
+  EPD_7IN5_V2_ClearWhite();
+
+  // x 160..319, y 100..199
+  const UBYTE window[] = {0x00, 160, 0x01, 319 - 256, 0x00, 100, 0x00, 199, 0x01};
+  EPD_WaitUntilIdle();
+  EPD_SendCommand(0x91);
+  EPD_SendCommand(0x90);
+  for (UBYTE value : window)
+    EPD_SendData(value);
+  EPD_SendCommand(0x13);
+  for (UWORD y = 100; y < 200; y++)
+    EPD_SendDataBuffer(framebuffer + y * 100 + 20, 20, 0xFF);
+  EPD_SendCommand(0x12);
+  EPD_SendCommand(0x92);
+
+  TEST_ASSERT_EQUAL(1, epd_sim_stats().partial_refreshes);
+  for (UWORD y = 0; y < EPD_SIM_HEIGHT; y++)
+  {
+    for (UWORD x = 0; x < 100; x++)
+    {
+      bool inside = y >= 100 && y < 200 && x >= 20 && x < 40;
+      TEST_ASSERT_EQUAL_HEX8(inside ? framebuffer[y * 100 + x] : 0xFF, epd_sim_screen()[y * 100 + x]);
+    }
+  }
+}
+
+static UBYTE decoded[FRAME_SIZE];
+
+void test_png_decodes_to_screen(void)
+{
+  drawScreen();
+  EPD_7IN5_V2_Init_New();
+  EPD_7IN5_V2_Display(framebuffer);
+
+  size_t size = epd_sim_png(nullptr, 0);
+  uint8_t *data = new uint8_t[size];
+  TEST_ASSERT_EQUAL(size, epd_sim_png(data, size));
+  TEST_ASSERT_EQUAL(0, epd_sim_png(data, size - 1));
+
+  PNG *png = new PNG();
+  TEST_ASSERT_EQUAL(PNG_SUCCESS, png->openRAM(data, size, nullptr));
+  TEST_ASSERT_EQUAL(EPD_SIM_WIDTH, png->getWidth());
+  TEST_ASSERT_EQUAL(EPD_SIM_HEIGHT, png->getHeight());
+  TEST_ASSERT_EQUAL(1, png->getBpp());
+  png->setBuffer(decoded);
+  TEST_ASSERT_EQUAL(PNG_SUCCESS, png->decode(nullptr, 0));
+  TEST_ASSERT_EQUAL_MEMORY(epd_sim_screen(), decoded, FRAME_SIZE);
+  delete png;
+  delete[] data;
+}
+
+void setUp(void)
+{
+  ArduinoFakeReset();
+  When(Method(ArduinoFake(), delay)).AlwaysDo([](unsigned long ms) { epd_sim_delay_us(ms * 1000); });
+  When(Method(ArduinoFake(), delayMicroseconds)).AlwaysDo([](unsigned int us) { epd_sim_delay_us(us); });
+  When(Method(ArduinoFake(), digitalWrite)).AlwaysDo([](uint8_t pin, uint8_t value) { epd_sim_gpio_write(value, 1UL << pin); });
+  epd_sim_begin();
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  mkdir(".pio", 0755);
+  mkdir(SNAPSHOTS, 0755);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_clear_white);
+  RUN_TEST(test_display_golden);
+  RUN_TEST(test_stream_matches_display);
+  RUN_TEST(test_fast_waveform);
+  RUN_TEST(test_asleep_until_reset);
+  RUN_TEST(test_partial_window);
+  RUN_TEST(test_png_decodes_to_screen);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
@@ -8,7 +8,11 @@ void assert_response_equal(ApiDisplayResponse expected, ApiDisplayResponse actua
   TEST_ASSERT_EQUAL_STRING(expected.image_url.c_str(), actual.image_url.c_str());
   TEST_ASSERT_EQUAL(expected.update_firmware, actual.update_firmware);
   TEST_ASSERT_EQUAL_STRING(expected.firmware_url.c_str(), actual.firmware_url.c_str());
+  TEST_ASSERT_EQUAL_STRING(expected.firmware_sha256.c_str(), actual.firmware_sha256.c_str());
+  TEST_ASSERT_EQUAL_STRING(expected.firmware_patch_url.c_str(), actual.firmware_patch_url.c_str());
   TEST_ASSERT_EQUAL_UINT64(expected.refresh_rate, actual.refresh_rate);
+  TEST_ASSERT_EQUAL(expected.quiet_start, actual.quiet_start);
+  TEST_ASSERT_EQUAL(expected.quiet_end, actual.quiet_end);
   TEST_ASSERT_EQUAL(expected.reset_firmware, actual.reset_firmware);
   TEST_ASSERT_EQUAL(expected.special_function, actual.special_function);
   TEST_ASSERT_EQUAL_STRING(expected.action.c_str(), actual.action.c_str());
@@ -16,7 +20,7 @@ void assert_response_equal(ApiDisplayResponse expected, ApiDisplayResponse actua
 
 void test_parseResponse_apiDisplay_success(void)
 {
-  String input = "{\"status\":200,\"image_url\":\"http://example.com/foo.bmp\",\"filename\":\"empty_state\",\"update_firmware\":true,\"firmware_url\":\"https://example.com/firmware.bin\",\"refresh_rate\":123456,\"reset_firmware\":true,\"special_function\":\"identify\",\"action\":\"special_action\"}";
+  String input = "{\"status\":200,\"image_url\":\"http://example.com/foo.bmp\",\"filename\":\"empty_state\",\"update_firmware\":true,\"firmware_url\":\"https://example.com/firmware.bin\",\"firmware_sha256\":\"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad\",\"firmware_patch_url\":\"https://example.com/firmware-1.5.7-1.5.8.patch\",\"refresh_rate\":123456,\"quiet_start\":1320,\"quiet_end\":360,\"reset_firmware\":true,\"special_function\":\"identify\",\"action\":\"special_action\"}";
 
   ApiDisplayResponse expected = {
       .outcome = ApiDisplayOutcome::Ok,
@@ -24,7 +28,11 @@ void test_parseResponse_apiDisplay_success(void)
       .filename = "empty_state",
       .update_firmware = true,
       .firmware_url = "https://example.com/firmware.bin",
+      .firmware_sha256 = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+      .firmware_patch_url = "https://example.com/firmware-1.5.7-1.5.8.patch",
       .refresh_rate = 123456,
+      .quiet_start = 1320,
+      .quiet_end = 360,
       .reset_firmware = true,
       .special_function = SPECIAL_FUNCTION::SF_IDENTIFY,
       .action = "special_action"};
@@ -51,7 +59,11 @@ void test_parseResponse_apiDisplay_missing_fields(void)
       .image_url = "",
       .update_firmware = false,
       .firmware_url = "",
+      .firmware_sha256 = "",
+      .firmware_patch_url = "",
       .refresh_rate = 0,
+      .quiet_start = 0,
+      .quiet_end = 0,
       .reset_firmware = false,
       .special_function = SPECIAL_FUNCTION::SF_NONE,
       .action = ""};
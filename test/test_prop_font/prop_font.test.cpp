@@ -0,0 +1,160 @@
+#include <unity.h>
+#include <prop_font.h>
+#include <string.h>
+
+static uint32_t decode(const char *text, size_t *consumed)
+{
+  const char *pos = text;
+  uint32_t codepoint = utf8_next(pos);
+  *consumed = pos - text;
+  return codepoint;
+}
+
+void test_utf8_decodes_every_length(void)
+{
+  size_t consumed;
+  TEST_ASSERT_EQUAL_HEX32('A', decode("A", &consumed));
+  TEST_ASSERT_EQUAL(1, consumed);
+  TEST_ASSERT_EQUAL_HEX32(0xE9, decode("\xC3\xA9", &consumed));
+  TEST_ASSERT_EQUAL(2, consumed);
+  TEST_ASSERT_EQUAL_HEX32(0x20AC, decode("\xE2\x82\xAC", &consumed));
+  TEST_ASSERT_EQUAL(3, consumed);
+  TEST_ASSERT_EQUAL_HEX32(0x1F600, decode("\xF0\x9F\x98\x80", &consumed));
+  TEST_ASSERT_EQUAL(4, consumed);
+  TEST_ASSERT_EQUAL_HEX32(0, decode("", &consumed));
+  TEST_ASSERT_EQUAL(0, consumed);
+}
+
+void test_utf8_rejects_malformed_sequences(void)
+{
+  size_t consumed;
+  // stray continuation byte
+  TEST_ASSERT_EQUAL_HEX32(UTF8_REPLACEMENT, decode("\x80" "A", &consumed));
+  TEST_ASSERT_EQUAL(1, consumed);
+  // overlong '/'
+  TEST_ASSERT_EQUAL_HEX32(UTF8_REPLACEMENT, decode("\xC0\xAF", &consumed));
+  TEST_ASSERT_EQUAL(2, consumed);
+  // surrogate
+  TEST_ASSERT_EQUAL_HEX32(UTF8_REPLACEMENT, decode("\xED\xA0\x80", &consumed));
+  // above U+10FFFF
+  TEST_ASSERT_EQUAL_HEX32(UTF8_REPLACEMENT, decode("\xF4\x90\x80\x80", &consumed));
+  // cut short by the next character, which is kept
+  TEST_ASSERT_EQUAL_HEX32(UTF8_REPLACEMENT, decode("\xE2\x82" "A", &consumed));
+  TEST_ASSERT_EQUAL(2, consumed);
+}
+
+void test_utf8_stops_at_the_end_of_the_string(void)
+{
+  const char text[] = "\xF0\x9F";
+  const char *pos = text;
+  TEST_ASSERT_EQUAL_HEX32(UTF8_REPLACEMENT, utf8_next(pos));
+  TEST_ASSERT_EQUAL_PTR(text + 2, pos);
+  TEST_ASSERT_EQUAL_HEX32(0, utf8_next(pos));
+  TEST_ASSERT_EQUAL_PTR(text + 2, pos);
+}
+
+void test_glyph_lookup_and_fallback(void)
+{
+  const PropGlyph &e = prop_font_glyph(PropFont24, 'e');
+  TEST_ASSERT_EQUAL_PTR(&e, &prop_font_glyph(PropFont24, 0xE9)); // é
+  TEST_ASSERT_EQUAL_PTR(&prop_font_glyph(PropFont24, '-'), &prop_font_glyph(PropFont24, 0x2014));
+  TEST_ASSERT_EQUAL_PTR(&prop_font_glyph(PropFont24, '?'), &prop_font_glyph(PropFont24, 0x4E2D));
+  TEST_ASSERT_EQUAL_PTR(&prop_font_glyph(PropFont24, '?'), &prop_font_glyph(PropFont24, UTF8_REPLACEMENT));
+  TEST_ASSERT_TRUE(prop_font_glyph(PropFont24, 'i').advance < prop_font_glyph(PropFont24, 'W').advance);
+}
+
+void test_width_is_the_sum_of_advances(void)
+{
+  uint16_t expected = prop_font_glyph(PropFont24, 'C').advance + prop_font_glyph(PropFont24, 'a').advance +
+                      prop_font_glyph(PropFont24, 'f').advance + prop_font_glyph(PropFont24, 'e').advance;
+  TEST_ASSERT_EQUAL(expected, prop_font_text_width(PropFont24, "Caf\xC3\xA9", 5));
+  TEST_ASSERT_EQUAL(expected - prop_font_glyph(PropFont24, 'e').advance,
+                    prop_font_text_width(PropFont24, "Caf\xC3\xA9", 3));
+}
+
+static void assertLine(const char *expected, const PropFontLine &line)
+{
+  TEST_ASSERT_EQUAL(strlen(expected), line.length);
+  TEST_ASSERT_EQUAL_MEMORY(expected, line.start, line.length);
+  TEST_ASSERT_EQUAL(prop_font_text_width(PropFont24, line.start, line.length), line.width);
+}
+
+void test_wrap_breaks_at_spaces_and_newlines(void)
+{
+  const char *text = "Please sign up   at usetrmnl.com\nwith Friendly ID";
+  uint16_t max_width = prop_font_text_width(PropFont24, "Please sign up ", 15);
+  PropFontLine lines[8];
+  size_t count = prop_font_wrap(PropFont24, text, max_width, lines, 8);
+
+  TEST_ASSERT_EQUAL(5, count);
+  assertLine("Please sign up", lines[0]);
+  assertLine("at", lines[1]);
+  assertLine("usetrmnl.com", lines[2]);
+  assertLine("with Friendly", lines[3]);
+  assertLine("ID", lines[4]);
+  for (size_t i = 0; i < count; i++)
+    TEST_ASSERT_TRUE(lines[i].width <= max_width);
+}
+
+void test_wrap_keeps_blank_lines(void)
+{
+  PropFontLine lines[4];
+  size_t count = prop_font_wrap(PropFont24, "one\n\ntwo", 800, lines, 4);
+  TEST_ASSERT_EQUAL(3, count);
+  assertLine("one", lines[0]);
+  assertLine("", lines[1]);
+  assertLine("two", lines[2]);
+}
+
+void test_wrap_breaks_long_words(void)
+{
+  uint16_t max_width = prop_font_text_width(PropFont24, "mmmm", 4);
+  PropFontLine lines[4];
+  size_t count = prop_font_wrap(PropFont24, "mmmmmmmmmm", max_width, lines, 4);
+  TEST_ASSERT_EQUAL(3, count);
+  assertLine("mmmm", lines[0]);
+  assertLine("mmmm", lines[1]);
+  assertLine("mm", lines[2]);
+
+  // narrower than any glyph: one character per line instead of no progress
+  count = prop_font_wrap(PropFont24, "\xC3\xA9t\xC3\xA9", 1, lines, 4);
+  TEST_ASSERT_EQUAL(3, count);
+  assertLine("\xC3\xA9", lines[0]);
+}
+
+void test_wrap_drops_what_does_not_fit(void)
+{
+  PropFontLine lines[2];
+  TEST_ASSERT_EQUAL(2, prop_font_wrap(PropFont24, "a\nb\nc", 800, lines, 2));
+  assertLine("b", lines[1]);
+  TEST_ASSERT_EQUAL(0, prop_font_wrap(PropFont24, "   ", 800, lines, 2));
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_utf8_decodes_every_length);
+  RUN_TEST(test_utf8_rejects_malformed_sequences);
+  RUN_TEST(test_utf8_stops_at_the_end_of_the_string);
+  RUN_TEST(test_glyph_lookup_and_fallback);
+  RUN_TEST(test_width_is_the_sum_of_advances);
+  RUN_TEST(test_wrap_breaks_at_spaces_and_newlines);
+  RUN_TEST(test_wrap_keeps_blank_lines);
+  RUN_TEST(test_wrap_breaks_long_words);
+  RUN_TEST(test_wrap_drops_what_does_not_fit);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include <unity.h>
+#include <refresh_policy.h>
+#include <string.h>
+
+static const size_t FRAME_SIZE = 800 / 8 * 480;
+
+static RefreshState state;
+static uint8_t frame[FRAME_SIZE];
+static uint32_t bands[REFRESH_BANDS];
+
+static void computeBands(void)
+{
+  memset(bands, 0, sizeof(bands));
+  refresh_bands_update(bands, FRAME_SIZE, 0, frame, FRAME_SIZE);
+}
+
+void test_first_refresh_is_full(void)
+{
+  computeBands();
+  TEST_ASSERT_EQUAL(100, refresh_dirty_percent(state, bands));
+  TEST_ASSERT_EQUAL(REFRESH_FULL_FIRST, refresh_choose(state, true, 20, 0));
+}
+
+void test_timer_wakes_are_fast_until_the_periodic_full(void)
+{
+  computeBands();
+  refresh_record(state, true, 20, bands);
+  for (int i = 0; i < REFRESH_FULL_EVERY; i++)
+  {
+    TEST_ASSERT_EQUAL(REFRESH_FAST, refresh_choose(state, true, 20, 0));
+    refresh_record(state, false, 20, bands);
+  }
+  TEST_ASSERT_EQUAL(REFRESH_FULL_COUNT, refresh_choose(state, true, 20, 0));
+
+  refresh_record(state, true, 20, bands);
+  TEST_ASSERT_EQUAL(REFRESH_FAST, refresh_choose(state, true, 20, 0));
+}
+
+void test_other_wakes_are_full(void)
+{
+  computeBands();
+  refresh_record(state, true, 20, bands);
+  TEST_ASSERT_EQUAL(REFRESH_FULL_WAKE, refresh_choose(state, false, 20, 0));
+}
+
+void test_temperature_change_is_full(void)
+{
+  computeBands();
+  refresh_record(state, true, 20, bands);
+  TEST_ASSERT_EQUAL(REFRESH_FAST, refresh_choose(state, true, 20 + REFRESH_TEMPERATURE_DELTA - 1, 0));
+  TEST_ASSERT_EQUAL(REFRESH_FULL_TEMPERATURE, refresh_choose(state, true, 20 - REFRESH_TEMPERATURE_DELTA, 0));
+  TEST_ASSERT_EQUAL(REFRESH_FAST, refresh_choose(state, true, REFRESH_NO_TEMPERATURE, 0));
+
+  // a fast refresh does not move the reference temperature
+  refresh_record(state, false, 22, bands);
+  TEST_ASSERT_EQUAL(REFRESH_FULL_TEMPERATURE, refresh_choose(state, true, 20 + REFRESH_TEMPERATURE_DELTA, 0));
+}
+
+void test_dirty_area_from_bands(void)
+{
+  computeBands();
+  refresh_record(state, true, 20, bands);
+  TEST_ASSERT_EQUAL(0, refresh_dirty_percent(state, bands));
+
+  // one byte in each of the first quarter of the bands
+  size_t band_size = FRAME_SIZE / REFRESH_BANDS;
+  for (size_t i = 0; i < REFRESH_BANDS / 4; i++)
+    frame[i * band_size + 7] ^= 0xFF;
+  computeBands();
+  TEST_ASSERT_EQUAL(25, refresh_dirty_percent(state, bands));
+  TEST_ASSERT_EQUAL(REFRESH_FAST, refresh_choose(state, true, 20, 25));
+
+  memset(frame, 0x00, sizeof(frame));
+  computeBands();
+  TEST_ASSERT_EQUAL(100, refresh_dirty_percent(state, bands));
+  TEST_ASSERT_EQUAL(REFRESH_FULL_DIRTY, refresh_choose(state, true, 20, 100));
+}
+
+void test_dirty_area_remembered(void)
+{
+  computeBands();
+  refresh_record(state, true, 20, bands);
+  TEST_ASSERT_EQUAL(0, state.dirty_percent); // nothing was known about the panel
+
+  memset(frame, 0x00, sizeof(frame));
+  computeBands();
+  refresh_record(state, true, 20, bands);
+  TEST_ASSERT_EQUAL(100, state.dirty_percent);
+
+  refresh_record(state, false, 20, bands);
+  TEST_ASSERT_EQUAL(0, state.dirty_percent);
+}
+
+void test_bands_from_pieces_match(void)
+{
+  computeBands();
+  uint32_t streamed[REFRESH_BANDS] = {0};
+  size_t offset = 0;
+  while (offset < FRAME_SIZE)
+  {
+    size_t size = FRAME_SIZE - offset < 333 ? FRAME_SIZE - offset : 333;
+    refresh_bands_update(streamed, FRAME_SIZE, offset, frame + offset, size);
+    offset += size;
+  }
+  TEST_ASSERT_EQUAL_MEMORY(bands, streamed, sizeof(bands));
+}
+
+void setUp(void)
+{
+  memset(&state, 0, sizeof(state));
+  for (size_t i = 0; i < FRAME_SIZE; i++)
+    frame[i] = i * 7;
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_first_refresh_is_full);
+  RUN_TEST(test_timer_wakes_are_fast_until_the_periodic_full);
+  RUN_TEST(test_other_wakes_are_full);
+  RUN_TEST(test_temperature_change_is_full);
+  RUN_TEST(test_dirty_area_from_bands);
+  RUN_TEST(test_dirty_area_remembered);
+  RUN_TEST(test_bands_from_pieces_match);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
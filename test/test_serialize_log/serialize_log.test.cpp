@@ -105,6 +105,41 @@ void test_serialize_log_with_retry(void)
   TEST_ASSERT_EQUAL_STRING(expected.c_str(), result.c_str());
 }
 
+void test_serialize_log_with_flight_record(void)
+{
+  auto inputWithFlightRecord = input;
+  inputWithFlightRecord.flightRecord = "reset=panic phase=decode wake=3 heap_low=21000 max_alloc_low=18000@download logs=3c0a1b20";
+
+  auto expected = compact(R"({
+    "creation_timestamp": 1609459200,
+    "device_status_stamp": {
+      "wifi_rssi_level": -50,
+      "wifi_status": "Connected",
+      "refresh_rate": 30000,
+      "time_since_last_sleep_start": 120,
+      "current_fw_version": "1.2.3",
+      "special_function": "None",
+      "battery_voltage": 4.2,
+      "wakeup_reason": "Timer",
+      "free_heap_size": 50000,
+      "max_alloc_size": 40000
+    },
+    "log_id": 456,
+    "log_message": "Test log message",
+    "log_codeline": 123,
+    "log_sourcefile": "test.cpp",
+    "additional_info": {
+      "filename_current": "current.png",
+      "filename_new": "new.png",
+      "flight_recorder": "reset=panic phase=decode wake=3 heap_low=21000 max_alloc_low=18000@download logs=3c0a1b20"
+    }
+  })");
+
+  String result = serialize_log(inputWithFlightRecord);
+
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), result.c_str());
+}
+
 void setUp(void) {
   // set stuff up here
 }
@@ -118,6 +153,7 @@ void process()
   UNITY_BEGIN();
   RUN_TEST(test_serialize_log);
   RUN_TEST(test_serialize_log_with_retry);
+  RUN_TEST(test_serialize_log_with_flight_record);
   UNITY_END();
 }
 
@@ -0,0 +1,208 @@
+#include <unity.h>
+#include <settings_cache.h>
+#include <map>
+#include <string>
+
+/** Store backed by std::map that counts flash writes */
+class FakeStore : public SettingsStore
+{
+public:
+  std::map<std::string, int64_t> numbers;
+  std::map<std::string, std::string> strings;
+  int writes = 0;
+  int reads = 0;
+
+  bool isKey(const char *key) override
+  {
+    return numbers.count(key) || strings.count(key);
+  }
+  bool getBool(const char *key) override
+  {
+    reads++;
+    return numbers[key] != 0;
+  }
+  int32_t getInt(const char *key) override
+  {
+    reads++;
+    return (int32_t)numbers[key];
+  }
+  uint32_t getUInt(const char *key) override
+  {
+    reads++;
+    return (uint32_t)numbers[key];
+  }
+  String getString(const char *key) override
+  {
+    reads++;
+    return String(strings[key].c_str());
+  }
+  size_t putBool(const char *key, bool value) override
+  {
+    writes++;
+    numbers[key] = value;
+    return 1;
+  }
+  size_t putInt(const char *key, int32_t value) override
+  {
+    writes++;
+    numbers[key] = value;
+    return 4;
+  }
+  size_t putUInt(const char *key, uint32_t value) override
+  {
+    writes++;
+    numbers[key] = value;
+    return 4;
+  }
+  size_t putString(const char *key, const String &value) override
+  {
+    writes++;
+    strings[key] = value.c_str();
+    return value.length();
+  }
+  bool remove(const char *key) override
+  {
+    writes++;
+    return numbers.erase(key) + strings.erase(key) > 0;
+  }
+};
+
+static const SettingDef defs[] = {
+    {"plugin", SettingType::Bool},
+    {"retry_count", SettingType::Int},
+    {"refresh_rate", SettingType::UInt},
+    {"filename", SettingType::String},
+};
+
+void test_reads_are_served_from_ram(void)
+{
+  FakeStore store;
+  store.numbers["refresh_rate"] = 900;
+  store.strings["filename"] = "plugin-1";
+  SettingsCache cache(store, defs, 4);
+  cache.load();
+  int reads_after_load = store.reads;
+
+  TEST_ASSERT_EQUAL(900, cache.getUInt("refresh_rate", 5));
+  TEST_ASSERT_EQUAL_STRING("plugin-1", cache.getString("filename", "").c_str());
+  TEST_ASSERT_FALSE(cache.isKey("plugin"));
+  TEST_ASSERT_TRUE(cache.getBool("plugin", true));
+  TEST_ASSERT_EQUAL(reads_after_load, store.reads);
+}
+
+void test_writes_are_coalesced_until_commit(void)
+{
+  FakeStore store;
+  SettingsCache cache(store, defs, 4);
+  cache.load();
+
+  for (int retry = 1; retry <= 4; retry++)
+    cache.putInt("retry_count", retry);
+  cache.putUInt("refresh_rate", 15);
+  cache.putUInt("refresh_rate", 900);
+  cache.putBool("plugin", false);
+
+  TEST_ASSERT_EQUAL(0, store.writes);
+  TEST_ASSERT_TRUE(cache.dirty());
+  TEST_ASSERT_EQUAL(4, cache.getInt("retry_count", 0));
+
+  TEST_ASSERT_EQUAL(3, cache.commit());
+  TEST_ASSERT_EQUAL(3, store.writes);
+  TEST_ASSERT_EQUAL(4, store.numbers["retry_count"]);
+  TEST_ASSERT_EQUAL(900, store.numbers["refresh_rate"]);
+  TEST_ASSERT_FALSE(cache.dirty());
+  TEST_ASSERT_EQUAL(0, cache.commit());
+}
+
+void test_unchanged_values_are_not_written(void)
+{
+  FakeStore store;
+  store.numbers["plugin"] = 0;
+  store.strings["filename"] = "plugin-1";
+  SettingsCache cache(store, defs, 4);
+  cache.load();
+
+  cache.putBool("plugin", false);
+  TEST_ASSERT_EQUAL(8, cache.putString("filename", "plugin-1"));
+
+  TEST_ASSERT_FALSE(cache.dirty());
+  TEST_ASSERT_EQUAL(0, cache.commit());
+}
+
+void test_remove_is_deferred(void)
+{
+  FakeStore store;
+  store.strings["filename"] = "plugin-1";
+  SettingsCache cache(store, defs, 4);
+  cache.load();
+
+  TEST_ASSERT_TRUE(cache.remove("filename"));
+  TEST_ASSERT_FALSE(cache.isKey("filename"));
+  TEST_ASSERT_TRUE(store.isKey("filename"));
+
+  cache.commit();
+  TEST_ASSERT_FALSE(store.isKey("filename"));
+}
+
+void test_load_drops_unsaved_changes(void)
+{
+  FakeStore store;
+  SettingsCache cache(store, defs, 4);
+  cache.load();
+  cache.putUInt("refresh_rate", 15);
+
+  cache.load();
+  TEST_ASSERT_FALSE(cache.dirty());
+  TEST_ASSERT_FALSE(cache.isKey("refresh_rate"));
+}
+
+void test_unknown_keys_pass_through(void)
+{
+  FakeStore store;
+  SettingsCache cache(store, defs, 4);
+  cache.load();
+
+  cache.putString("api_key", "secret");
+  TEST_ASSERT_EQUAL(1, store.writes);
+  TEST_ASSERT_TRUE(cache.isKey("api_key"));
+  TEST_ASSERT_EQUAL_STRING("secret", cache.getString("api_key", "").c_str());
+  TEST_ASSERT_EQUAL(7, cache.getUInt("log_id", 7));
+}
+
+void test_numeric_reads_ignore_declared_width(void)
+{
+  FakeStore store;
+  store.numbers["refresh_rate"] = 5;
+  SettingsCache cache(store, defs, 4);
+  cache.load();
+
+  // Preferences::getInt() on a key written with putUInt() returns the default
+  TEST_ASSERT_EQUAL(5, cache.getInt("refresh_rate", 0));
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_reads_are_served_from_ram);
+  RUN_TEST(test_writes_are_coalesced_until_commit);
+  RUN_TEST(test_unchanged_values_are_not_written);
+  RUN_TEST(test_remove_is_deferred);
+  RUN_TEST(test_load_drops_unsaved_changes);
+  RUN_TEST(test_unknown_keys_pass_through);
+  RUN_TEST(test_numeric_reads_ignore_declared_width);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
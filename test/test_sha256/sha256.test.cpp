@@ -0,0 +1,102 @@
+#include <unity.h>
+#include <sha256.h>
+#include <string.h>
+
+static const char *const ABC = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+static const char *const MILLION_A = "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0";
+
+static bool hashMatches(const char *text, const char *hex)
+{
+  Sha256 sha;
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  sha256_init(sha);
+  sha256_update(sha, (const uint8_t *)text, strlen(text));
+  sha256_finish(sha, digest);
+  return sha256_matches_hex(digest, hex);
+}
+
+void test_known_answers(void)
+{
+  TEST_ASSERT_TRUE(hashMatches("", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+  TEST_ASSERT_TRUE(hashMatches("abc", ABC));
+  // padding spills into a second block
+  TEST_ASSERT_TRUE(hashMatches("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+                               "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+}
+
+void test_pieces(void)
+{
+  static uint8_t a[1000000];
+  memset(a, 'a', sizeof(a));
+  Sha256 sha;
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  sha256_init(sha);
+  size_t done = 0;
+  for (size_t piece = 1; done < sizeof(a); piece = piece * 3 % 4099 + 1)
+  {
+    size_t n = piece < sizeof(a) - done ? piece : sizeof(a) - done;
+    sha256_update(sha, a + done, n);
+    done += n;
+  }
+  sha256_finish(sha, digest);
+  TEST_ASSERT_TRUE(sha256_matches_hex(digest, MILLION_A));
+}
+
+void test_resume(void)
+{
+  static uint8_t a[1000000];
+  memset(a, 'a', sizeof(a));
+  Sha256 first;
+  sha256_init(first);
+  sha256_update(first, a, 65536);
+
+  // only the state and the length are carried over
+  Sha256 second;
+  memset(&second, 0xAA, sizeof(second));
+  TEST_ASSERT_TRUE(sha256_resume(second, first.state, first.length));
+  sha256_update(second, a + 65536, sizeof(a) - 65536);
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  sha256_finish(second, digest);
+  TEST_ASSERT_TRUE(sha256_matches_hex(digest, MILLION_A));
+
+  TEST_ASSERT_FALSE(sha256_resume(second, first.state, 100));
+}
+
+void test_matches_hex(void)
+{
+  Sha256 sha;
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  sha256_init(sha);
+  sha256_update(sha, (const uint8_t *)"abc", 3);
+  sha256_finish(sha, digest);
+
+  TEST_ASSERT_TRUE(sha256_matches_hex(digest, "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD"));
+  TEST_ASSERT_FALSE(sha256_matches_hex(digest, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ae"));
+  TEST_ASSERT_FALSE(sha256_matches_hex(digest, "ba7816bf"));
+  TEST_ASSERT_FALSE(sha256_matches_hex(digest, "zz7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+  TEST_ASSERT_FALSE(sha256_matches_hex(digest, nullptr));
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_known_answers);
+  RUN_TEST(test_pieces);
+  RUN_TEST(test_resume);
+  RUN_TEST(test_matches_hex);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
@@ -0,0 +1,174 @@
+#include <unity.h>
+#include <sleep_schedule.h>
+#include <string.h>
+
+static ScheduleState state;
+
+static ScheduleInputs inputs(uint32_t refresh_rate)
+{
+  ScheduleInputs result;
+  result.refresh_rate = refresh_rate;
+  result.battery_mv = 4000;
+  result.time_of_day = SCHEDULE_NO_TIME;
+  result.quiet_start = 0;
+  result.quiet_end = 0;
+  return result;
+}
+
+// polls every `every` seconds for `count` polls, the image changing on each `change`th one
+static void poll(uint32_t every, int count, int change)
+{
+  for (int i = 1; i <= count; i++)
+    schedule_observe(state, i % change == 0, every);
+}
+
+void test_refresh_rate_until_learnt(void)
+{
+  ScheduleReason reason;
+  TEST_ASSERT_EQUAL(900, schedule_sleep(state, inputs(900), reason));
+  TEST_ASSERT_EQUAL(SCHEDULE_SERVER, reason);
+
+  // the first change ends an interval of unknown length
+  schedule_observe(state, true, 0);
+  poll(900, 8, 100);
+  TEST_ASSERT_EQUAL(900, schedule_sleep(state, inputs(900), reason));
+  TEST_ASSERT_EQUAL(SCHEDULE_SERVER, reason);
+}
+
+void test_change_rate(void)
+{
+  ScheduleReason reason;
+  schedule_observe(state, true, 0);
+  poll(900, 8, 4); // changes hourly
+  TEST_ASSERT_EQUAL(3600, state.change_interval_s);
+  TEST_ASSERT_EQUAL(1800, schedule_sleep(state, inputs(900), reason));
+  TEST_ASSERT_EQUAL(SCHEDULE_CHANGE_RATE, reason);
+
+  // changes at every poll: nothing to save
+  poll(900, 20, 1);
+  TEST_ASSERT_EQUAL(900, schedule_sleep(state, inputs(900), reason));
+  TEST_ASSERT_EQUAL(SCHEDULE_SERVER, reason);
+}
+
+void test_unchanged_image_capped(void)
+{
+  ScheduleReason reason;
+  schedule_observe(state, true, 0);
+  poll(900, 2, 2);
+  poll(900, 100, 1000);
+  TEST_ASSERT_EQUAL(900 * SCHEDULE_MAX_STRETCH, schedule_sleep(state, inputs(900), reason));
+  TEST_ASSERT_EQUAL(SCHEDULE_CHANGE_RATE, reason);
+}
+
+void test_last_sleep_when_unknown(void)
+{
+  ScheduleReason reason;
+  schedule_observe(state, true, 0);
+  schedule_sleep(state, inputs(600), reason);
+  schedule_observe(state, false, 0);
+  schedule_observe(state, true, 0);
+  TEST_ASSERT_EQUAL(1200, state.change_interval_s);
+}
+
+void test_battery(void)
+{
+  ScheduleReason reason;
+  ScheduleInputs in = inputs(900);
+  in.battery_mv = SCHEDULE_BATTERY_FULL_MV;
+  TEST_ASSERT_EQUAL(900, schedule_sleep(state, in, reason));
+  TEST_ASSERT_EQUAL(SCHEDULE_SERVER, reason);
+
+  in.battery_mv = (SCHEDULE_BATTERY_FULL_MV + SCHEDULE_BATTERY_LOW_MV) / 2;
+  TEST_ASSERT_EQUAL(900 * (1 + SCHEDULE_BATTERY_STRETCH) / 2, schedule_sleep(state, in, reason));
+  TEST_ASSERT_EQUAL(SCHEDULE_BATTERY, reason);
+
+  in.battery_mv = 3000;
+  TEST_ASSERT_EQUAL(900 * SCHEDULE_BATTERY_STRETCH, schedule_sleep(state, in, reason));
+
+  in.battery_mv = 0; // unknown
+  TEST_ASSERT_EQUAL(900, schedule_sleep(state, in, reason));
+}
+
+void test_battery_and_change_rate_capped(void)
+{
+  ScheduleReason reason;
+  schedule_observe(state, true, 0);
+  poll(900, 8, 4);
+  ScheduleInputs in = inputs(900);
+  in.battery_mv = 3000;
+  TEST_ASSERT_EQUAL(900 * SCHEDULE_MAX_STRETCH, schedule_sleep(state, in, reason));
+  TEST_ASSERT_EQUAL(SCHEDULE_BATTERY, reason);
+}
+
+void test_quiet_hours(void)
+{
+  ScheduleReason reason;
+  ScheduleInputs in = inputs(900);
+  in.quiet_start = 22 * 60;
+  in.quiet_end = 6 * 60;
+
+  in.time_of_day = 12 * 3600;
+  TEST_ASSERT_EQUAL(900, schedule_sleep(state, in, reason));
+  TEST_ASSERT_EQUAL(SCHEDULE_SERVER, reason);
+
+  // inside, across midnight
+  in.time_of_day = 23 * 3600;
+  TEST_ASSERT_EQUAL(7 * 3600, schedule_sleep(state, in, reason));
+  TEST_ASSERT_EQUAL(SCHEDULE_QUIET, reason);
+  in.time_of_day = 1 * 3600;
+  TEST_ASSERT_EQUAL(5 * 3600, schedule_sleep(state, in, reason));
+
+  // the next wake would fall inside
+  in.time_of_day = 22 * 3600 - 600;
+  TEST_ASSERT_EQUAL(8 * 3600 + 600, schedule_sleep(state, in, reason));
+  TEST_ASSERT_EQUAL(SCHEDULE_QUIET, reason);
+
+  // the window just ended
+  in.time_of_day = 6 * 3600;
+  TEST_ASSERT_EQUAL(900, schedule_sleep(state, in, reason));
+
+  // no clock
+  in.time_of_day = SCHEDULE_NO_TIME;
+  TEST_ASSERT_EQUAL(900, schedule_sleep(state, in, reason));
+}
+
+void test_quiet_hours_same_day(void)
+{
+  ScheduleReason reason;
+  ScheduleInputs in = inputs(900);
+  in.quiet_start = 1 * 60;
+  in.quiet_end = 5 * 60;
+  in.time_of_day = 2 * 3600;
+  TEST_ASSERT_EQUAL(3 * 3600, schedule_sleep(state, in, reason));
+  in.time_of_day = 23 * 3600;
+  TEST_ASSERT_EQUAL(900, schedule_sleep(state, in, reason));
+}
+
+void setUp(void)
+{
+  memset(&state, 0, sizeof(state));
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_refresh_rate_until_learnt);
+  RUN_TEST(test_change_rate);
+  RUN_TEST(test_unchanged_image_capped);
+  RUN_TEST(test_last_sleep_when_unknown);
+  RUN_TEST(test_battery);
+  RUN_TEST(test_battery_and_change_rate_capped);
+  RUN_TEST(test_quiet_hours);
+  RUN_TEST(test_quiet_hours_same_day);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
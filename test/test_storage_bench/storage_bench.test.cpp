@@ -0,0 +1,333 @@
+#include <unity.h>
+#include <lfs.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * Storage benchmark for the image rotation done on every new-image wake
+ * (write /tmp.img, rename it into the image cache, write the cache index the
+ * same way and read the image back),
+ * run with LittleFS on a RAM image of the "spiffs" partition of min_spiffs.csv.
+ *
+ * Flash operations are counted and turned into device time with the typical
+ * timings of the ESP32-C3 in-package flash; host time is printed as well but
+ * only says how much work the filesystem code does.
+ *
+ * pio test -e native_storage_bench
+ */
+static const lfs_size_t BLOCK_SIZE = 4096;
+static const lfs_size_t BLOCK_COUNT = 0x20000 / BLOCK_SIZE;
+
+// typical timings, QIO at 40 MHz
+static const double READ_US_PER_OP = 1.0;
+static const double READ_US_PER_BYTE = 0.05;
+static const double PROG_US_PER_PAGE = 600.0; // 256-byte page
+static const double ERASE_US_PER_BLOCK = 45000.0;
+
+static const size_t LOGO_SIZE = 48062;
+static const size_t INDEX_SIZE = 652; // sizeof(ImageCacheIndex)
+static const size_t IMAGE_CACHE_MAX_ENTRIES = 8;
+static const int ROTATIONS = 100;
+
+struct FlashCounters
+{
+  uint32_t read_ops;
+  uint32_t read_bytes;
+  uint32_t prog_pages;
+  uint32_t erases;
+};
+
+static uint8_t flash[BLOCK_SIZE * BLOCK_COUNT];
+static uint32_t block_erases[BLOCK_COUNT];
+static FlashCounters counters;
+
+static int flash_read(const struct lfs_config *c, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size)
+{
+  memcpy(buffer, flash + block * BLOCK_SIZE + off, size);
+  counters.read_ops++;
+  counters.read_bytes += size;
+  return 0;
+}
+
+static int flash_prog(const struct lfs_config *c, lfs_block_t block, lfs_off_t off, const void *buffer, lfs_size_t size)
+{
+  // NOR flash can only clear bits; anything else means a missing erase
+  uint8_t *dst = flash + block * BLOCK_SIZE + off;
+  const uint8_t *src = (const uint8_t *)buffer;
+  for (lfs_size_t i = 0; i < size; i++)
+    dst[i] &= src[i];
+  counters.prog_pages += (size + 255) / 256;
+  return 0;
+}
+
+static int flash_erase(const struct lfs_config *c, lfs_block_t block)
+{
+  memset(flash + block * BLOCK_SIZE, 0xFF, BLOCK_SIZE);
+  block_erases[block]++;
+  counters.erases++;
+  return 0;
+}
+
+static int flash_sync(const struct lfs_config *c)
+{
+  return 0;
+}
+
+static double device_ms(const FlashCounters &c)
+{
+  return (c.read_ops * READ_US_PER_OP + c.read_bytes * READ_US_PER_BYTE + c.prog_pages * PROG_US_PER_PAGE +
+          c.erases * ERASE_US_PER_BLOCK) /
+         1000.0;
+}
+
+enum BenchOp
+{
+  OP_EXISTS,
+  OP_REMOVE,
+  OP_RENAME,
+  OP_WRITE,
+  OP_OPEN,
+  OP_READ,
+  OP_COUNT,
+};
+
+static const char *const op_names[OP_COUNT] = {"exists", "remove", "rename", "write", "open", "read"};
+
+struct OpStats
+{
+  uint32_t calls;
+  FlashCounters flash;
+  double host_us;
+};
+
+static OpStats stats[OP_COUNT];
+static lfs_t lfs;
+static struct lfs_config cfg;
+
+/** Runs one filesystem call and charges its flash traffic to an operation */
+template <typename Fn>
+static int measure(BenchOp op, Fn fn)
+{
+  FlashCounters before = counters;
+  auto start = std::chrono::steady_clock::now();
+  int result = fn();
+  auto end = std::chrono::steady_clock::now();
+
+  OpStats &s = stats[op];
+  s.calls++;
+  s.flash.read_ops += counters.read_ops - before.read_ops;
+  s.flash.read_bytes += counters.read_bytes - before.read_bytes;
+  s.flash.prog_pages += counters.prog_pages - before.prog_pages;
+  s.flash.erases += counters.erases - before.erases;
+  s.host_us += std::chrono::duration<double, std::micro>(end - start).count();
+  return result;
+}
+
+static bool exists(const char *path)
+{
+  struct lfs_info info;
+  return measure(OP_EXISTS, [&]() -> int
+                 { return lfs_stat(&lfs, path, &info); }) == 0;
+}
+
+static int write_file(const char *path, const std::vector<uint8_t> &data)
+{
+  return measure(OP_WRITE, [&]() -> int
+                 {
+    lfs_file_t file;
+    int err = lfs_file_open(&lfs, &file, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    if (err)
+      return err;
+    lfs_ssize_t written = lfs_file_write(&lfs, &file, data.data(), data.size());
+    err = lfs_file_close(&lfs, &file);
+    if (written < 0)
+      return (int)written;
+    return written == (lfs_ssize_t)data.size() ? err : LFS_ERR_NOSPC; });
+}
+
+static int read_file(const char *path, std::vector<uint8_t> &data)
+{
+  lfs_file_t file;
+  int err = measure(OP_OPEN, [&]() -> int
+                    { return lfs_file_open(&lfs, &file, path, LFS_O_RDONLY); });
+  if (err)
+    return err;
+  return measure(OP_READ, [&]() -> int
+                 {
+    lfs_ssize_t read = lfs_file_read(&lfs, &file, data.data(), data.size());
+    lfs_file_close(&lfs, &file);
+    return read == (lfs_ssize_t)data.size() ? 0 : LFS_ERR_CORRUPT; });
+}
+
+static std::vector<uint8_t> image(size_t size, uint32_t seed)
+{
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    data[i] = seed >> 16;
+  }
+  return data;
+}
+
+static std::vector<std::string> cached; // image files in the order they were stored
+
+/** Same calls as image_store_set_current(): write the new image to a temporary file and rename it into the cache,
+ * then write the cache index the same way. The cache evicts by its byte budget before writing; here the
+ * filesystem tells when the oldest image, the rewind one first, has to go. */
+static int rotate(const char *extension, const std::vector<uint8_t> &data, int number)
+{
+  char path[24];
+  snprintf(path, sizeof(path), "/img_%08x.%s", (unsigned)number, extension);
+
+  if (cached.size() == IMAGE_CACHE_MAX_ENTRIES)
+  {
+    measure(OP_REMOVE, []() -> int
+            { return lfs_remove(&lfs, cached.front().c_str()); });
+    cached.erase(cached.begin());
+  }
+  int err = write_file("/tmp.img", data);
+  while (err == LFS_ERR_NOSPC && !cached.empty())
+  {
+    measure(OP_REMOVE, []() -> int
+            { return lfs_remove(&lfs, "/tmp.img"); });
+    measure(OP_REMOVE, []() -> int
+            { return lfs_remove(&lfs, cached.front().c_str()); });
+    cached.erase(cached.begin());
+    err = write_file("/tmp.img", data);
+  }
+  if (err)
+    return err;
+  err = measure(OP_RENAME, [&]() -> int
+                { return lfs_rename(&lfs, "/tmp.img", path); });
+  if (err)
+    return err;
+  cached.push_back(path);
+
+  err = write_file("/tmp.img", std::vector<uint8_t>(INDEX_SIZE, (uint8_t)number));
+  if (!err)
+    err = measure(OP_RENAME, []() -> int
+                  { return lfs_rename(&lfs, "/tmp.img", "/img_index"); });
+  if (err)
+    return err;
+
+  std::vector<uint8_t> read_back(data.size());
+  err = read_file(path, read_back);
+  if (err)
+    return err;
+  return read_back == data ? 0 : LFS_ERR_CORRUPT;
+}
+
+static void print_report(const char *title)
+{
+  printf("\n%s\n", title);
+  printf("%-8s %6s %10s %10s %10s %12s %12s\n", "op", "calls", "erases/op", "pages/op", "read KB/op", "device ms/op",
+         "host us/op");
+  for (int op = 0; op < OP_COUNT; op++)
+  {
+    const OpStats &s = stats[op];
+    if (!s.calls)
+      continue;
+    printf("%-8s %6u %10.2f %10.1f %10.2f %12.2f %12.2f\n", op_names[op], (unsigned)s.calls,
+           (double)s.flash.erases / s.calls, (double)s.flash.prog_pages / s.calls,
+           s.flash.read_bytes / 1024.0 / s.calls, device_ms(s.flash) / s.calls, s.host_us / s.calls);
+  }
+
+  uint32_t min_erases = UINT32_MAX, max_erases = 0;
+  for (uint32_t erases : block_erases)
+  {
+    min_erases = erases < min_erases ? erases : min_erases;
+    max_erases = erases > max_erases ? erases : max_erases;
+  }
+  printf("block erases: min %u, max %u\n", (unsigned)min_erases, (unsigned)max_erases);
+}
+
+void test_png_rotation(void)
+{
+  TEST_ASSERT_EQUAL(0, write_file("/logo.bmp", image(LOGO_SIZE, 1)));
+  memset(stats, 0, sizeof(stats));
+
+  for (int i = 0; i < ROTATIONS; i++)
+  {
+    size_t size = 10000 + (i * 7919) % 14000; // server PNGs are 10-24 KB
+    TEST_ASSERT_EQUAL(0, rotate("png", image(size, i + 2), i));
+  }
+
+  print_report("PNG rotation with /logo.bmp stored");
+  TEST_ASSERT_TRUE(exists("/logo.bmp"));
+}
+
+void test_bmp_rotation(void)
+{
+  memset(stats, 0, sizeof(stats));
+
+  for (int i = 0; i < ROTATIONS; i++)
+    TEST_ASSERT_EQUAL(0, rotate("bmp", image(LOGO_SIZE, i + 2), i));
+
+  print_report("BMP rotation");
+}
+
+void test_full_filesystem_keeps_other_files(void)
+{
+  std::vector<uint8_t> logo = image(LOGO_SIZE, 1);
+  TEST_ASSERT_EQUAL(0, write_file("/logo.bmp", logo));
+  TEST_ASSERT_EQUAL(0, write_file("/last.bmp", image(LOGO_SIZE, 2)));
+
+  // a third full-size BMP does not fit in 128 KB: the write fails, nothing else is lost
+  TEST_ASSERT_EQUAL(LFS_ERR_NOSPC, write_file("/current.bmp", image(LOGO_SIZE, 3)));
+  lfs_remove(&lfs, "/current.bmp");
+
+  std::vector<uint8_t> read_back(LOGO_SIZE);
+  TEST_ASSERT_EQUAL(0, read_file("/logo.bmp", read_back));
+  TEST_ASSERT_TRUE(read_back == logo);
+  TEST_ASSERT_TRUE(exists("/last.bmp"));
+}
+
+void setUp(void)
+{
+  cached.clear();
+  memset(flash, 0xFF, sizeof(flash));
+  memset(block_erases, 0, sizeof(block_erases));
+  memset(&counters, 0, sizeof(counters));
+  memset(stats, 0, sizeof(stats));
+
+  // the geometry esp_littlefs uses on the ESP32
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.read = flash_read;
+  cfg.prog = flash_prog;
+  cfg.erase = flash_erase;
+  cfg.sync = flash_sync;
+  cfg.read_size = 128;
+  cfg.prog_size = 128;
+  cfg.block_size = BLOCK_SIZE;
+  cfg.block_count = BLOCK_COUNT;
+  cfg.block_cycles = 512;
+  cfg.cache_size = 512;
+  cfg.lookahead_size = 128;
+
+  TEST_ASSERT_EQUAL(0, lfs_format(&lfs, &cfg));
+  TEST_ASSERT_EQUAL(0, lfs_mount(&lfs, &cfg));
+}
+
+void tearDown(void)
+{
+  lfs_unmount(&lfs);
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_png_rotation);
+  RUN_TEST(test_bmp_rotation);
+  RUN_TEST(test_full_filesystem_keeps_other_files);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
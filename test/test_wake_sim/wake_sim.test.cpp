@@ -0,0 +1,567 @@
+#include <unity.h>
+#include <wake_sim.h>
+#include <config.h>
+#include <sha256.h>
+#include <ota_delta.h>
+#include <sleep_schedule.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * Whole wake cycles of the firmware against the fake server of sim/, see
+ * wake_sim.h. Each wake leaves its log and a PNG of the panel in
+ * .pio/wake_sim/<test>/.
+ *
+ * pio test -e native_wake_sim
+ */
+
+#define DISPLAY_JSON(filename, refresh_rate)                                                  \
+  "{\"status\":0,\"image_url\":\"https://trmnl.app/images/" filename ".bmp\",\"filename\":\"" \
+  filename "\",\"refresh_rate\":" #refresh_rate ",\"update_firmware\":false,\"reset_firmware\":false}"
+
+// the button's special function and the action the server answers a double click with
+#define SPECIAL_FUNCTION_JSON(filename, function)                                                         \
+  "{\"status\":0,\"image_url\":\"https://trmnl.app/images/" filename ".bmp\",\"filename\":\"" filename   \
+  "\",\"refresh_rate\":900,\"update_firmware\":false,\"reset_firmware\":false,\"special_function\":\"" function \
+  "\",\"action\":\"" function "\"}"
+
+#define FIRMWARE_PATH "/firmware/1.6.0.bin"
+#define PATCH_PATH "/firmware/1.5.7-1.6.0.patch"
+
+static const size_t FRAME_SIZE = 800 / 8 * 480;
+static const size_t FIRMWARE_SIZE = 5 * 0x10000; // five OTA checkpoints
+
+static uint8_t bmp[DISPLAY_BMP_IMAGE_SIZE];
+static uint8_t expected[FRAME_SIZE];
+static uint8_t firmware[FIRMWARE_SIZE];
+static uint8_t running_firmware[FIRMWARE_SIZE]; // what the patch applies to
+static std::vector<uint8_t> patch;
+
+static void put32(uint8_t *out, uint32_t value)
+{
+  memcpy(out, &value, sizeof(value));
+}
+
+/**
+ * A 1 bit 800x480 BMP with half of the screen black and the top rows
+ * inverted, and what the panel shows for it
+ */
+static void makeImage(bool left_black, size_t inverted_rows)
+{
+  memset(bmp, 0, sizeof(bmp));
+  bmp[0] = 'B';
+  bmp[1] = 'M';
+  put32(bmp + 2, DISPLAY_BMP_IMAGE_SIZE);
+  put32(bmp + 10, 62);
+  put32(bmp + 14, 40);
+  put32(bmp + 18, 800);
+  put32(bmp + 22, 480);
+  bmp[26] = 1;
+  bmp[28] = 1;
+  put32(bmp + 34, FRAME_SIZE);
+  put32(bmp + 46, 2);
+  // palette: 0 black, 1 white
+  memset(bmp + 58, 255, 3);
+
+  // rows are stored from the bottom
+  for (size_t row = 0; row < 480; row++)
+  {
+    for (size_t column = 0; column < 100; column++)
+    {
+      bool black = ((column < 50) == left_black) != (row < inverted_rows);
+      bmp[62 + (479 - row) * 100 + column] = black ? 0x00 : 0xFF;
+      expected[row * 100 + column] = black ? 0x00 : 0xFF;
+    }
+  }
+}
+
+static void serveImage(const char *path, bool left_black, size_t inverted_rows)
+{
+  makeImage(left_black, inverted_rows);
+  sim_server_route(path, 200, "image/bmp", bmp, sizeof(bmp));
+}
+
+/** A registered device on a network in range, showing image "a" every 900 s */
+static void startDevice(const char *name)
+{
+  sim_begin(name);
+  sim_provision("home", "api-key", "ABC123");
+  sim_server_json("/api/display", DISPLAY_JSON("a", 900));
+  serveImage("/images/a.bmp", true, 0);
+}
+
+static void sha256(const uint8_t *data, size_t size, uint8_t *digest)
+{
+  Sha256 sha;
+  sha256_init(sha);
+  sha256_update(sha, data, size);
+  sha256_finish(sha, digest);
+}
+
+/**
+ * A patch from running_firmware to firmware, each block against the same
+ * offset: a literal for every changed byte and copies for the runs of zeros
+ */
+static void makePatch(void)
+{
+  uint8_t header[OTA_DELTA_HEADER_SIZE];
+  put32(header, OTA_DELTA_MAGIC);
+  put32(header + 4, FIRMWARE_SIZE);
+  sha256(running_firmware, FIRMWARE_SIZE, header + 8);
+  put32(header + 8 + SHA256_DIGEST_SIZE, FIRMWARE_SIZE);
+  patch.assign(header, header + sizeof(header));
+
+  for (size_t offset = 0; offset < FIRMWARE_SIZE; offset += OTA_DELTA_BLOCK_SIZE)
+  {
+    uint8_t diff[OTA_DELTA_BLOCK_SIZE];
+    for (size_t i = 0; i < OTA_DELTA_BLOCK_SIZE; i++)
+      diff[i] = firmware[offset + i] - running_firmware[offset + i];
+    std::vector<uint8_t> packed;
+    for (size_t pos = 0; pos < OTA_DELTA_BLOCK_SIZE;)
+    {
+      size_t run = 0;
+      while (pos > 0 && diff[pos - 1] == 0 && pos + run < OTA_DELTA_BLOCK_SIZE && run < LZSS_MAX_MATCH &&
+             diff[pos + run] == 0)
+        run++;
+      if (run >= LZSS_MIN_MATCH)
+      {
+        packed.push_back(0x80 | (run - LZSS_MIN_MATCH));
+        packed.push_back(0);
+        pos += run;
+      }
+      else
+      {
+        packed.push_back(0);
+        packed.push_back(diff[pos++]);
+      }
+    }
+    uint8_t block[OTA_DELTA_BLOCK_HEADER_SIZE];
+    put32(block, offset);
+    put32(block + 4, packed.size());
+    patch.insert(patch.end(), block, block + sizeof(block));
+    patch.insert(patch.end(), packed.begin(), packed.end());
+  }
+}
+
+/**
+ * An app image to update to, announced by /api/display with its SHA-256, or
+ * with a wrong one, and with a patch from running_firmware if asked for
+ */
+static void serveFirmware(bool right_hash, bool with_patch = false)
+{
+  uint32_t seed = 1;
+  for (size_t i = 0; i < FIRMWARE_SIZE; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    firmware[i] = seed >> 16;
+    // a release that changed a few constants
+    running_firmware[i] = firmware[i] + (i % 3000 == 1000);
+  }
+  firmware[0] = running_firmware[0] = 0xE9; // ESP image magic
+  sim_server_route(FIRMWARE_PATH, 200, "application/octet-stream", firmware, FIRMWARE_SIZE);
+
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  sha256(firmware, FIRMWARE_SIZE, digest);
+  if (!right_hash)
+    digest[0] ^= 1;
+
+  char json[512];
+  int n = snprintf(json, sizeof(json),
+                   "{\"status\":0,\"refresh_rate\":900,\"update_firmware\":true,\"reset_firmware\":false,"
+                   "\"firmware_url\":\"https://trmnl.app" FIRMWARE_PATH "\",\"firmware_sha256\":\"");
+  for (size_t i = 0; i < SHA256_DIGEST_SIZE; i++)
+    n += snprintf(json + n, sizeof(json) - n, "%02x", digest[i]);
+  if (with_patch)
+  {
+    makePatch();
+    sim_server_route(PATCH_PATH, 200, "application/octet-stream", patch.data(), patch.size());
+    n += snprintf(json + n, sizeof(json) - n, "\",\"firmware_patch_url\":\"https://trmnl.app" PATCH_PATH);
+  }
+  snprintf(json + n, sizeof(json) - n, "\"}");
+  sim_server_json("/api/display", json);
+}
+
+void test_power_on_shows_image(void)
+{
+  startDevice("power_on");
+  SimWake wake = sim_wake(SIM_WAKE_POWER_ON);
+
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_EQUAL_UINT64(900ULL * 1000000, wake.sleep_us);
+  TEST_ASSERT_EQUAL(1, sim_server_count("/api/display"));
+  TEST_ASSERT_EQUAL(1, sim_server_count("/images/a.bmp"));
+  TEST_ASSERT_EQUAL_MEMORY(expected, sim_screen(), FRAME_SIZE);
+  TEST_ASSERT_TRUE(wake.panel_asleep);
+  TEST_ASSERT_TRUE(wake.peak_heap > DISPLAY_BMP_IMAGE_SIZE);
+  TEST_ASSERT_TRUE(wake.peak_heap < SIM_HEAP_SIZE);
+
+  const SimRequest *request = sim_server_last("/api/display");
+  TEST_ASSERT_NOT_NULL(request);
+  TEST_ASSERT_EQUAL_STRING("GET", request->method);
+  TEST_ASSERT_NOT_NULL(strstr(request->headers, "Access-Token: api-key\r\n"));
+}
+
+void test_same_image_leaves_panel_alone(void)
+{
+  startDevice("same_image");
+  sim_wake(SIM_WAKE_POWER_ON);
+  SimWake wake = sim_wake_next();
+
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_EQUAL(2, sim_server_count("/api/display"));
+  TEST_ASSERT_EQUAL(1, sim_server_count("/images/a.bmp"));
+  TEST_ASSERT_EQUAL(0, wake.panel_resets);
+  TEST_ASSERT_EQUAL(0, wake.full_refreshes + wake.fast_refreshes + wake.partial_refreshes);
+  TEST_ASSERT_EQUAL_MEMORY(expected, sim_screen(), FRAME_SIZE);
+}
+
+void test_new_image_fast_refresh(void)
+{
+  startDevice("new_image");
+  sim_wake(SIM_WAKE_POWER_ON);
+  sim_server_json("/api/display", DISPLAY_JSON("b", 600));
+  serveImage("/images/b.bmp", true, 40);
+  SimWake wake = sim_wake_next();
+
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_EQUAL_UINT64(600ULL * 1000000, wake.sleep_us);
+  TEST_ASSERT_EQUAL(1, sim_server_count("/images/b.bmp"));
+  TEST_ASSERT_EQUAL(1, wake.fast_refreshes);
+  TEST_ASSERT_EQUAL(0, wake.full_refreshes);
+  TEST_ASSERT_EQUAL_MEMORY(expected, sim_screen(), FRAME_SIZE);
+}
+
+void test_playlist_rotation_inits_panel_once(void)
+{
+  startDevice("playlist");
+  sim_wake(SIM_WAKE_POWER_ON);
+  sim_server_json("/api/display", DISPLAY_JSON("b", 900));
+  serveImage("/images/b.bmp", false, 0);
+  sim_wake_next();
+
+  // the whole screen changes again: the panel is prepared for the full waveform from the start
+  sim_server_json("/api/display", DISPLAY_JSON("c", 900));
+  serveImage("/images/c.bmp", true, 0);
+  SimWake wake = sim_wake_next();
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_EQUAL(1, wake.full_refreshes);
+  TEST_ASSERT_EQUAL(1, wake.panel_resets);
+  TEST_ASSERT_EQUAL_MEMORY(expected, sim_screen(), FRAME_SIZE);
+}
+
+void test_playlist_return_redrawn_from_cache(void)
+{
+  startDevice("cache_hit");
+  sim_wake(SIM_WAKE_POWER_ON);
+  sim_server_json("/api/display", DISPLAY_JSON("b", 900));
+  serveImage("/images/b.bmp", false, 0);
+  SimWake wake = sim_wake_next();
+  // a downloaded image is written once
+  TEST_ASSERT_TRUE(wake.fs_write_bytes < 2 * DISPLAY_BMP_IMAGE_SIZE);
+
+  // back to "a": neither downloaded nor written again, only the cache index is
+  sim_server_json("/api/display", DISPLAY_JSON("a", 900));
+  serveImage("/images/a.bmp", true, 0);
+  wake = sim_wake_next();
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_TRUE(wake.fs_write_bytes < 4096);
+  TEST_ASSERT_EQUAL(1, sim_server_count("/images/a.bmp"));
+  TEST_ASSERT_EQUAL_MEMORY(expected, sim_screen(), FRAME_SIZE);
+}
+
+void test_bmp_rotation_fits_filesystem(void)
+{
+  startDevice("bmp_rotation");
+  sim_server_json("/api/log", "{}");
+  sim_wake(SIM_WAKE_POWER_ON);
+  sim_server_json("/api/display", DISPLAY_JSON("b", 900));
+  serveImage("/images/b.bmp", false, 0);
+  sim_wake_next();
+
+  // three full-size BMPs do not fit in 128 KB: the oldest image makes room, the write does not fail
+  sim_server_json("/api/display", DISPLAY_JSON("c", 900));
+  serveImage("/images/c.bmp", true, 40);
+  SimWake wake = sim_wake_next();
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_EQUAL_MEMORY(expected, sim_screen(), FRAME_SIZE);
+  TEST_ASSERT_EQUAL(0, sim_server_count("/api/log"));
+}
+
+void test_double_click_rewinds(void)
+{
+  static uint8_t shown_a[FRAME_SIZE];
+  startDevice("rewind");
+  sim_server_json("/api/display", SPECIAL_FUNCTION_JSON("a", "rewind"));
+  sim_wake(SIM_WAKE_POWER_ON);
+  memcpy(shown_a, expected, FRAME_SIZE);
+  sim_server_json("/api/display", SPECIAL_FUNCTION_JSON("b", "rewind"));
+  serveImage("/images/b.bmp", false, 0);
+  sim_wake(SIM_WAKE_TIMER);
+
+  SimWake wake = sim_wake(SIM_WAKE_DOUBLE_CLICK);
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_EQUAL(3, sim_server_count("/api/display"));
+  // shown from what the device kept of a
+  TEST_ASSERT_EQUAL(1, sim_server_count("/images/a.bmp"));
+  TEST_ASSERT_EQUAL_MEMORY(shown_a, sim_screen(), FRAME_SIZE);
+  TEST_ASSERT_TRUE(wake.full_refreshes + wake.fast_refreshes > 0);
+}
+
+void test_double_click_sends_to_me(void)
+{
+  startDevice("send_to_me");
+  sim_server_json("/api/display", SPECIAL_FUNCTION_JSON("a", "send_to_me"));
+  sim_wake(SIM_WAKE_POWER_ON);
+  sim_server_json("/api/display", SPECIAL_FUNCTION_JSON("b", "send_to_me"));
+  serveImage("/images/b.bmp", false, 0);
+  sim_wake(SIM_WAKE_TIMER);
+
+  SimWake wake = sim_wake(SIM_WAKE_DOUBLE_CLICK);
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_EQUAL(3, sim_server_count("/api/display"));
+  // b is drawn again from what the device kept of it
+  TEST_ASSERT_EQUAL(1, sim_server_count("/images/b.bmp"));
+  TEST_ASSERT_EQUAL_MEMORY(expected, sim_screen(), FRAME_SIZE);
+  TEST_ASSERT_TRUE(wake.full_refreshes + wake.fast_refreshes > 0);
+}
+
+void test_server_error_retries_soon(void)
+{
+  startDevice("server_error");
+  sim_wake(SIM_WAKE_POWER_ON);
+  sim_server_fail("/api/display", SIM_FAIL_STATUS, 1);
+
+  SimWake wake = sim_wake_next();
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_EQUAL_UINT64(API_FIRST_RETRY * 1000000ULL, wake.sleep_us);
+
+  wake = sim_wake_next();
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_EQUAL_UINT64(900ULL * 1000000, wake.sleep_us);
+  TEST_ASSERT_EQUAL(3, sim_server_count("/api/display"));
+}
+
+void test_truncated_download_reported(void)
+{
+  startDevice("truncated");
+  sim_server_json("/api/log", "{}");
+  sim_server_fail("/images/a.bmp", SIM_FAIL_TRUNCATE, 1);
+  SimWake wake = sim_wake(SIM_WAKE_POWER_ON);
+
+  // the rest of the image never comes: the stream timeout runs out, the error is logged and the logo stays
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_TRUE(wake.awake_ms > 15000);
+  TEST_ASSERT_TRUE(memcmp(expected, sim_screen(), FRAME_SIZE) != 0);
+  TEST_ASSERT_EQUAL(1, sim_server_count("/api/log"));
+  TEST_ASSERT_NOT_NULL(strstr(sim_server_last("/api/log")->body, "received bytes - 24031"));
+
+  wake = sim_wake_next();
+  TEST_ASSERT_EQUAL(2, sim_server_count("/images/a.bmp"));
+  TEST_ASSERT_EQUAL_MEMORY(expected, sim_screen(), FRAME_SIZE);
+}
+
+void test_network_sets_awake_time(void)
+{
+  startDevice("fast_network");
+  uint32_t fast = sim_wake(SIM_WAKE_POWER_ON).awake_ms;
+
+  startDevice("slow_network");
+  sim_config().latency_ms = 300;
+  sim_config().bandwidth = 20000;
+  uint32_t slow = sim_wake(SIM_WAKE_POWER_ON).awake_ms;
+
+  // the image alone takes over two seconds more at 20 kB/s
+  TEST_ASSERT_TRUE(slow > fast + 2000);
+}
+
+void test_firmware_download_resumes(void)
+{
+  startDevice("firmware_resume");
+  serveFirmware(true);
+  // each connection of the first wake breaks halfway through what it asked for
+  sim_server_fail(FIRMWARE_PATH, SIM_FAIL_TRUNCATE, 3);
+
+  SimWake wake = sim_wake(SIM_WAKE_POWER_ON);
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_FALSE(wake.firmware_updated);
+  TEST_ASSERT_EQUAL(3, sim_server_count(FIRMWARE_PATH));
+
+  // 160 kB, then half of the rest from the 128 kB checkpoint, then from 192 kB: the next wake starts at 256 kB
+  wake = sim_wake_next();
+  TEST_ASSERT_EQUAL(SIM_END_RESTART, wake.end);
+  TEST_ASSERT_TRUE(wake.firmware_updated);
+  TEST_ASSERT_EQUAL(4, sim_server_count(FIRMWARE_PATH));
+  TEST_ASSERT_NOT_NULL(strstr(sim_server_last(FIRMWARE_PATH)->headers, "Range: bytes=262144-\r\n"));
+  TEST_ASSERT_TRUE(wake.bytes_down < FIRMWARE_SIZE / 2);
+}
+
+void test_firmware_hash_mismatch_rejected(void)
+{
+  startDevice("firmware_mismatch");
+  serveFirmware(false);
+
+  SimWake wake = sim_wake(SIM_WAKE_POWER_ON);
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_FALSE(wake.firmware_updated);
+
+  // the progress is gone: the next try downloads the whole image again
+  wake = sim_wake_next();
+  TEST_ASSERT_FALSE(wake.firmware_updated);
+  TEST_ASSERT_EQUAL(2, sim_server_count(FIRMWARE_PATH));
+  TEST_ASSERT_NULL(strstr(sim_server_last(FIRMWARE_PATH)->headers, "Range:"));
+}
+
+void test_firmware_patch_applied(void)
+{
+  startDevice("firmware_patch");
+  serveFirmware(true, true);
+  sim_flash_app(running_firmware, FIRMWARE_SIZE);
+  // broken off once, the patch resumes from its last checkpoint
+  sim_server_fail(PATCH_PATH, SIM_FAIL_TRUNCATE, 1);
+
+  SimWake wake = sim_wake(SIM_WAKE_POWER_ON);
+  TEST_ASSERT_EQUAL(SIM_END_RESTART, wake.end);
+  TEST_ASSERT_TRUE(wake.firmware_updated);
+  TEST_ASSERT_EQUAL(2, sim_server_count(PATCH_PATH));
+  TEST_ASSERT_EQUAL(0, sim_server_count(FIRMWARE_PATH));
+  TEST_ASSERT_NOT_NULL(strstr(sim_server_last(PATCH_PATH)->headers, "Range: bytes="));
+  TEST_ASSERT_TRUE(patch.size() < FIRMWARE_SIZE / 10);
+  TEST_ASSERT_TRUE(wake.bytes_down < FIRMWARE_SIZE / 5);
+}
+
+void test_firmware_patch_for_other_version(void)
+{
+  startDevice("firmware_patch_other");
+  serveFirmware(true, true);
+  // the device runs something else: the patch does not apply and the whole image comes instead
+  sim_flash_app(firmware, FIRMWARE_SIZE / 2);
+
+  SimWake wake = sim_wake(SIM_WAKE_POWER_ON);
+  TEST_ASSERT_EQUAL(SIM_END_RESTART, wake.end);
+  TEST_ASSERT_TRUE(wake.firmware_updated);
+  TEST_ASSERT_EQUAL(1, sim_server_count(PATCH_PATH));
+  TEST_ASSERT_EQUAL(1, sim_server_count(FIRMWARE_PATH));
+}
+
+void test_image_change_rate_stretches_sleep(void)
+{
+  startDevice("change_rate");
+  sim_wake(SIM_WAKE_POWER_ON);
+  for (int i = 0; i < 3; i++)
+    TEST_ASSERT_EQUAL_UINT64(900ULL * 1000000, sim_wake_next().sleep_us);
+
+  // a new image an hour after the first one: polled every half hour
+  sim_server_json("/api/display", DISPLAY_JSON("b", 900));
+  serveImage("/images/b.bmp", true, 40);
+  SimWake wake = sim_wake_next();
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_TRUE(wake.sleep_us >= 1800ULL * 1000000);
+  TEST_ASSERT_TRUE(wake.sleep_us < 1900ULL * 1000000);
+}
+
+void test_low_battery_stretches_sleep(void)
+{
+  startDevice("low_battery");
+  sim_config().battery_mv = 3300;
+  SimWake wake = sim_wake(SIM_WAKE_POWER_ON);
+
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_EQUAL_UINT64(900ULL * SCHEDULE_BATTERY_STRETCH * 1000000, wake.sleep_us);
+}
+
+void test_quiet_hours_sleep_through(void)
+{
+  startDevice("quiet_hours");
+  // the clock starts at midnight UTC, quiet from 23:00 to 06:00
+  sim_server_json("/api/display", "{\"status\":0,\"image_url\":\"https://trmnl.app/images/a.bmp\",\"filename\":\"a\","
+                                  "\"refresh_rate\":900,\"quiet_start\":1380,\"quiet_end\":360,"
+                                  "\"update_firmware\":false,\"reset_firmware\":false}");
+  SimWake wake = sim_wake(SIM_WAKE_POWER_ON);
+
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_TRUE(wake.sleep_us <= 6 * 3600ULL * 1000000);
+  TEST_ASSERT_TRUE(wake.sleep_us > 6 * 3600ULL * 1000000 - 60ULL * 1000000);
+}
+
+void test_no_wifi_sleeps(void)
+{
+  startDevice("no_wifi");
+  sim_config().wifi_available = false;
+  SimWake wake = sim_wake(SIM_WAKE_POWER_ON);
+
+  TEST_ASSERT_EQUAL(SIM_END_SLEEP, wake.end);
+  TEST_ASSERT_EQUAL(0, sim_server_count("/api/display"));
+}
+
+void test_spiffs_logo_survives_littlefs_format(void)
+{
+  startDevice("spiffs_logo");
+  sim_config().wifi_available = false;
+  // the setup logo of a device registered under the SPIFFS firmware: the message screens draw it
+  makeImage(true, 0);
+  sim_spiffs_file("/logo.bmp", bmp, sizeof(bmp));
+
+  for (int wake = 0; wake < 2; wake++)
+  {
+    TEST_ASSERT_EQUAL(SIM_END_SLEEP, sim_wake(SIM_WAKE_POWER_ON).end);
+    // row 100 holds no text
+    TEST_ASSERT_EQUAL_MEMORY(expected + 100 * 800 / 8, sim_screen() + 100 * 800 / 8, 800 / 8);
+  }
+}
+
+void test_soft_reset_button_restarts(void)
+{
+  startDevice("soft_reset");
+  sim_wake(SIM_WAKE_POWER_ON);
+
+  // the reset runs before the settings are loaded from NVS
+  SimWake wake = sim_wake(SIM_WAKE_BUTTON_HOLD);
+  TEST_ASSERT_EQUAL(SIM_END_RESTART, wake.end);
+
+  // the WiFi credentials are gone: the captive portal waits for someone to set them
+  wake = sim_wake_next();
+  TEST_ASSERT_EQUAL(SIM_END_AWAKE, wake.end);
+  TEST_ASSERT_EQUAL(1, sim_server_count("/api/display"));
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_power_on_shows_image);
+  RUN_TEST(test_same_image_leaves_panel_alone);
+  RUN_TEST(test_new_image_fast_refresh);
+  RUN_TEST(test_playlist_rotation_inits_panel_once);
+  RUN_TEST(test_playlist_return_redrawn_from_cache);
+  RUN_TEST(test_bmp_rotation_fits_filesystem);
+  RUN_TEST(test_double_click_rewinds);
+  RUN_TEST(test_double_click_sends_to_me);
+  RUN_TEST(test_server_error_retries_soon);
+  RUN_TEST(test_truncated_download_reported);
+  RUN_TEST(test_network_sets_awake_time);
+  RUN_TEST(test_firmware_download_resumes);
+  RUN_TEST(test_firmware_hash_mismatch_rejected);
+  RUN_TEST(test_firmware_patch_applied);
+  RUN_TEST(test_firmware_patch_for_other_version);
+  RUN_TEST(test_image_change_rate_stretches_sleep);
+  RUN_TEST(test_low_battery_stretches_sleep);
+  RUN_TEST(test_quiet_hours_sleep_through);
+  RUN_TEST(test_no_wifi_sleeps);
+  RUN_TEST(test_spiffs_logo_survives_littlefs_format);
+  RUN_TEST(test_soft_reset_button_restarts);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}
@@ -0,0 +1,202 @@
+#include <unity.h>
+#include <wake_state.h>
+#include <map>
+#include <string>
+#include <string.h>
+
+/** Persistent store backed by std::map that counts flash writes */
+class FakeNvs : public SettingsStore
+{
+public:
+  std::map<std::string, int64_t> numbers;
+  std::map<std::string, std::string> strings;
+  int writes = 0;
+
+  bool isKey(const char *key) override
+  {
+    return numbers.count(key) || strings.count(key);
+  }
+  bool getBool(const char *key) override
+  {
+    return numbers[key] != 0;
+  }
+  int32_t getInt(const char *key) override
+  {
+    return (int32_t)numbers[key];
+  }
+  uint32_t getUInt(const char *key) override
+  {
+    return (uint32_t)numbers[key];
+  }
+  String getString(const char *key) override
+  {
+    return String(strings[key].c_str());
+  }
+  size_t putBool(const char *key, bool value) override
+  {
+    writes++;
+    numbers[key] = value;
+    return 1;
+  }
+  size_t putInt(const char *key, int32_t value) override
+  {
+    writes++;
+    numbers[key] = value;
+    return 4;
+  }
+  size_t putUInt(const char *key, uint32_t value) override
+  {
+    writes++;
+    numbers[key] = value;
+    return 4;
+  }
+  size_t putString(const char *key, const String &value) override
+  {
+    writes++;
+    strings[key] = value.c_str();
+    return value.length();
+  }
+  bool remove(const char *key) override
+  {
+    writes++;
+    return numbers.erase(key) + strings.erase(key) > 0;
+  }
+};
+
+static const SettingDef defs[] = {
+    {"api_key", SettingType::String, false},
+    {"refresh_rate", SettingType::UInt, false},
+    {"retry_count", SettingType::Int, true},
+    {"last_sleep", SettingType::UInt, true},
+    {"filename", SettingType::String, true},
+};
+
+static WakeState rtc; // stands in for the RTC_DATA_ATTR block
+static FakeNvs nvs;
+
+/** One wake: the cache is rebuilt from the stores, as after deep sleep */
+static void run_wake(int retry, uint32_t now, const char *filename)
+{
+  WakeStateStore rtc_store(rtc);
+  SettingsCache settings(nvs, defs, 5, &rtc_store);
+  settings.load();
+  settings.putInt("retry_count", retry);
+  settings.putUInt("last_sleep", now);
+  settings.putString("filename", filename);
+  settings.putUInt("refresh_rate", 900);
+  settings.commit();
+}
+
+void test_zeroed_block_is_invalid(void)
+{
+  memset(&rtc, 0, sizeof(rtc));
+  TEST_ASSERT_FALSE(wake_state_valid(rtc));
+
+  WakeStateStore store(rtc);
+  TEST_ASSERT_FALSE(store.restored());
+  TEST_ASSERT_TRUE(wake_state_valid(rtc));
+  TEST_ASSERT_FALSE(store.isKey("retry_count"));
+}
+
+void test_corruption_is_detected(void)
+{
+  wake_state_reset(rtc);
+  {
+    WakeStateStore store(rtc);
+    store.putUInt("last_sleep", 1700000000);
+  }
+  TEST_ASSERT_TRUE(wake_state_valid(rtc));
+
+  rtc.slots[0].number ^= 0x10;
+  TEST_ASSERT_FALSE(wake_state_valid(rtc));
+
+  WakeStateStore store(rtc);
+  TEST_ASSERT_FALSE(store.restored());
+  TEST_ASSERT_FALSE(store.isKey("last_sleep"));
+}
+
+void test_crc32_matches_reference(void)
+{
+  const char *check = "123456789";
+  TEST_ASSERT_EQUAL_HEX32(0xCBF43926, wake_state_crc32((const uint8_t *)check, 9));
+
+  uint32_t crc = wake_state_crc32_update(0, (const uint8_t *)check, 4);
+  TEST_ASSERT_EQUAL_HEX32(0xCBF43926, wake_state_crc32_update(crc, (const uint8_t *)check + 4, 5));
+}
+
+void test_steady_state_cycle_does_not_write_nvs(void)
+{
+  run_wake(1, 1000, "plugin-a");
+  int writes_after_first_wake = nvs.writes;
+  TEST_ASSERT_EQUAL(1, writes_after_first_wake); // refresh_rate only
+
+  run_wake(2, 1900, "plugin-b");
+  run_wake(3, 2800, "plugin-c");
+  TEST_ASSERT_EQUAL(writes_after_first_wake, nvs.writes);
+
+  WakeStateStore rtc_store(rtc);
+  SettingsCache settings(nvs, defs, 5, &rtc_store);
+  settings.load();
+  TEST_ASSERT_TRUE(rtc_store.restored());
+  TEST_ASSERT_EQUAL(3, settings.getInt("retry_count", 0));
+  TEST_ASSERT_EQUAL(2800, settings.getUInt("last_sleep", 0));
+  TEST_ASSERT_EQUAL_STRING("plugin-c", settings.getString("filename", "").c_str());
+}
+
+void test_power_loss_falls_back_to_nvs(void)
+{
+  nvs.strings["filename"] = "from-nvs";
+  nvs.numbers["retry_count"] = 2;
+  run_wake(5, 1000, "plugin-a");
+
+  memset(&rtc, 0, sizeof(rtc)); // power loss
+
+  WakeStateStore rtc_store(rtc);
+  SettingsCache settings(nvs, defs, 5, &rtc_store);
+  settings.load();
+  TEST_ASSERT_EQUAL_STRING("from-nvs", settings.getString("filename", "").c_str());
+  TEST_ASSERT_EQUAL(2, settings.getInt("retry_count", 0));
+  TEST_ASSERT_FALSE(settings.isKey("last_sleep"));
+}
+
+void test_long_strings_go_to_nvs(void)
+{
+  std::string long_name(WAKE_STATE_TEXT_SIZE + 10, 'x');
+  run_wake(1, 1000, long_name.c_str());
+
+  TEST_ASSERT_EQUAL_STRING(long_name.c_str(), nvs.strings["filename"].c_str());
+
+  WakeStateStore rtc_store(rtc);
+  TEST_ASSERT_FALSE(rtc_store.isKey("filename"));
+  SettingsCache settings(nvs, defs, 5, &rtc_store);
+  settings.load();
+  TEST_ASSERT_EQUAL_STRING(long_name.c_str(), settings.getString("filename", "").c_str());
+}
+
+void setUp(void)
+{
+  memset(&rtc, 0, sizeof(rtc));
+  nvs = FakeNvs();
+}
+
+void tearDown(void)
+{
+}
+
+void process()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_zeroed_block_is_invalid);
+  RUN_TEST(test_corruption_is_detected);
+  RUN_TEST(test_crc32_matches_reference);
+  RUN_TEST(test_steady_state_cycle_does_not_write_nvs);
+  RUN_TEST(test_power_loss_falls_back_to_nvs);
+  RUN_TEST(test_long_strings_go_to_nvs);
+  UNITY_END();
+}
+
+int main(int argc, char **argv)
+{
+  process();
+  return 0;
+}